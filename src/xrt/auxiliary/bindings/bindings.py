@@ -675,6 +675,132 @@ oxr_verify_{profile.validation_func_name}_ext(const struct oxr_extension_status
 ''')
 
 
+FNV_OFFSET_BASIS = 2166136261
+FNV_PRIME = 16777619
+
+
+def path_hash(path):
+    """FNV-1a hash of a path, must match oxr_bindings_path_hash."""
+    h = FNV_OFFSET_BASIS
+    for c in path.encode("utf-8"):
+        h ^= c
+        h = (h * FNV_PRIME) & 0xffffffff
+    return h
+
+
+def path_hash_mix(h):
+    """Final mixer used to place keys, must match oxr_bindings_path_hash_mix."""
+    h ^= h >> 16
+    h = (h * 0x85ebca6b) & 0xffffffff
+    h ^= h >> 13
+    h = (h * 0xc2b2ae35) & 0xffffffff
+    h ^= h >> 16
+    return h
+
+
+def next_pow2(v):
+    r = 1
+    while r < v:
+        r <<= 1
+    return r
+
+
+def collect_static_paths(b):
+    """Every path string the generated profile templates reference."""
+    paths = set()
+    for profile in b.profiles:
+        paths.add(profile.name)
+        for component in profile.components:
+            paths.add(component.subaction_path)
+            paths.update(component.get_full_openxr_paths())
+        for identifier in profile.identifiers:
+            paths.add(identifier.subaction_path)
+            if identifier.dpad:
+                paths.update(identifier.dpad.paths)
+    return sorted(paths)
+
+
+def build_static_path_perfect_hash(paths):
+    """Build a hash-and-displace perfect hash over the given paths.
+
+    Keys are first split into buckets on the plain hash, each bucket then gets
+    a displacement that places all of its keys into free slots."""
+    if len(paths) >= 0xffff:
+        raise RuntimeError("Too many static paths for the 16 bit slot table.")
+    hashes = [path_hash(p) for p in paths]
+    if len(set(hashes)) != len(hashes):
+        raise RuntimeError("Hash collision among static paths, change the hash function.")
+
+    bucket_count = next_pow2(max(1, len(paths) // 4))
+    slot_count = next_pow2(max(1, len(paths) * 2))
+
+    buckets = [[] for _ in range(bucket_count)]
+    for index, h in enumerate(hashes):
+        buckets[h & (bucket_count - 1)].append(index)
+
+    displacements = [0] * bucket_count
+    slots = [0] * slot_count  # Index + 1, zero marks an empty slot.
+
+    # Place the biggest buckets first, they are the hardest to fit.
+    order = sorted(range(bucket_count), key=lambda i: len(buckets[i]), reverse=True)
+    for bucket_index in order:
+        bucket = buckets[bucket_index]
+        if len(bucket) == 0:
+            continue
+        d = 0
+        while True:
+            placed = [path_hash_mix(hashes[i] ^ d) & (slot_count - 1) for i in bucket]
+            if len(set(placed)) == len(placed) and all(slots[s] == 0 for s in placed):
+                break
+            d += 1
+        displacements[bucket_index] = d
+        for i, s in zip(bucket, placed):
+            slots[s] = i + 1
+
+    return hashes, displacements, slots
+
+
+def generate_static_paths(f, b):
+    """Generate the static path table and its perfect hash lookup function."""
+    paths = collect_static_paths(b)
+    hashes, displacements, slots = build_static_path_perfect_hash(paths)
+
+    f.write('\n\nconst struct oxr_bindings_static_path oxr_bindings_static_paths[OXR_BINDINGS_STATIC_PATH_COUNT] = {\n')
+    for path, h in zip(paths, hashes):
+        f.write(f'\t{{"{path}", {len(path)}, 0x{h:08x}u}},\n')
+    f.write('};\n\n')
+
+    f.write(f'static const uint32_t static_path_displacements[{len(displacements)}] = {{\n')
+    for i in range(0, len(displacements), 8):
+        f.write('\t' + ' '.join(f'{d},' for d in displacements[i:i + 8]) + '\n')
+    f.write('};\n\n')
+
+    f.write(f'static const uint16_t static_path_slots[{len(slots)}] = {{\n')
+    for i in range(0, len(slots), 16):
+        f.write('\t' + ' '.join(f'{s},' for s in slots[i:i + 16]) + '\n')
+    f.write('};\n\n')
+
+    f.write(f'''bool
+oxr_bindings_static_path_find(const char *str, size_t length, uint32_t hash, uint32_t *out_index)
+{{
+\tuint32_t d = static_path_displacements[hash & {len(displacements) - 1}u];
+\tuint32_t slot = oxr_bindings_path_hash_mix(hash ^ d) & {len(slots) - 1}u;
+\tuint32_t index_plus_one = static_path_slots[slot];
+\tif (index_plus_one == 0) {{
+\t\treturn false;
+\t}}
+
+\tconst struct oxr_bindings_static_path *p = &oxr_bindings_static_paths[index_plus_one - 1];
+\tif (p->hash != hash || p->length != length || memcmp(p->str, str, length) != 0) {{
+\t\treturn false;
+\t}}
+
+\t*out_index = index_plus_one - 1;
+\treturn true;
+}}
+''')
+
+
 def generate_bindings_c(file, b):
     """Generate the file to verify subpaths on a interaction profile."""
     f = open(file, "w")
@@ -884,6 +1010,8 @@ void oxr_get_interaction_profile_path_cache(const struct oxr_bindings_path_cache
     *out_path_cache = &internal_path_cache;
 }}
 ''')
+
+    generate_static_paths(f, b)
     f.write("\n// clang-format on\n")
 
     f.close()
@@ -922,6 +1050,57 @@ struct oxr_bindings_path_cache {{
 
 void oxr_get_interaction_profile_path_cache(const struct oxr_bindings_path_cache **out_path_cache);
 
+#define OXR_BINDINGS_STATIC_PATH_COUNT {len(collect_static_paths(b))}
+
+/*!
+ * A path referenced by the profile templates, known at compile time.
+ */
+struct oxr_bindings_static_path {{
+    const char *str;
+    uint32_t length;
+    //! Precomputed @ref oxr_bindings_path_hash of the string.
+    uint32_t hash;
+}};
+
+extern const struct oxr_bindings_static_path oxr_bindings_static_paths[OXR_BINDINGS_STATIC_PATH_COUNT];
+
+/*!
+ * FNV-1a hash of a path string, the generator uses the same function to
+ * build the perfect hash table over @ref oxr_bindings_static_paths.
+ */
+static inline uint32_t
+oxr_bindings_path_hash(const char *str, size_t length)
+{{
+    uint32_t h = {FNV_OFFSET_BASIS}u;
+    for (size_t i = 0; i < length; i++) {{
+        h ^= (uint8_t)str[i];
+        h *= {FNV_PRIME}u;
+    }}
+    return h;
+}}
+
+/*!
+ * Mixes a path hash before it is used to pick a perfect hash slot.
+ */
+static inline uint32_t
+oxr_bindings_path_hash_mix(uint32_t h)
+{{
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+    return h;
+}}
+
+/*!
+ * Look up a path in the compile-time perfect hash table, @p hash must be the
+ * @ref oxr_bindings_path_hash of the string. On success @p out_index is the
+ * index into @ref oxr_bindings_static_paths.
+ */
+bool
+oxr_bindings_static_path_find(const char *str, size_t length, uint32_t hash, uint32_t *out_index);
+
 // clang-format off
 ''')
 
@@ -13,6 +13,81 @@
 #include <assert.h>
 
 
+/*
+ *
+ * Shared helpers.
+ *
+ * Both fifos write samples backwards, so going from the latest sample at age
+ * zero to older samples the timestamps never increase. Next to every sample
+ * the running sum of all samples up to and including it is kept, a window is
+ * then found with two binary searches and summed with one subtraction.
+ *
+ */
+
+static inline size_t
+ff_index(size_t num, size_t latest, size_t age)
+{
+	size_t pos = latest + age;
+	return pos >= num ? pos - num : pos;
+}
+
+/*!
+ * Returns the age of the newest sample that is at or before @p timestamp_ns,
+ * or strictly before it if @p strict is set, @p num if there is none.
+ */
+static size_t
+ff_search(const uint64_t *timestamps_ns, size_t num, size_t latest, uint64_t timestamp_ns, bool strict)
+{
+	size_t lo = 0;
+	size_t hi = num;
+
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		uint64_t ts = timestamps_ns[ff_index(num, latest, mid)];
+
+		if (strict ? ts < timestamp_ns : ts <= timestamp_ns) {
+			hi = mid;
+		} else {
+			lo = mid + 1;
+		}
+	}
+
+	return lo;
+}
+
+/*!
+ * Finds the samples between the two timepoints, returns false if there are
+ * none, otherwise the index of the newest and oldest sample of the window.
+ */
+static bool
+ff_find_window(const uint64_t *timestamps_ns,
+               size_t num,
+               size_t latest,
+               uint64_t start_ns,
+               uint64_t stop_ns,
+               size_t *out_newest,
+               size_t *out_oldest,
+               size_t *out_count)
+{
+	// Error, skip averaging.
+	if (start_ns > stop_ns) {
+		return false;
+	}
+
+	size_t first = ff_search(timestamps_ns, num, latest, stop_ns, false);
+	size_t end = ff_search(timestamps_ns, num, latest, start_ns, true);
+	if (first >= end) {
+		return false;
+	}
+
+	*out_newest = ff_index(num, latest, first);
+	*out_oldest = ff_index(num, latest, end - 1);
+	*out_count = end - first;
+
+	return true;
+}
+
+
 /*
  *
  * Filter fifo vec3_f32.
@@ -25,6 +100,12 @@ struct m_ff_vec3_f32
 	size_t latest;
 	struct xrt_vec3 *samples;
 	uint64_t *timestamps_ns;
+
+	//! Sum of all samples up to and including the sample at the same index.
+	struct xrt_vec3_f64 *sums;
+
+	//! Sum of all samples pushed, rebased every time the write index wraps.
+	struct xrt_vec3_f64 total;
 };
 
 
@@ -39,8 +120,10 @@ vec3_f32_init(struct m_ff_vec3_f32 *ff, size_t num)
 {
 	ff->samples = U_TYPED_ARRAY_CALLOC(struct xrt_vec3, num);
 	ff->timestamps_ns = U_TYPED_ARRAY_CALLOC(uint64_t, num);
+	ff->sums = U_TYPED_ARRAY_CALLOC(struct xrt_vec3_f64, num);
 	ff->num = num;
 	ff->latest = 0;
+	ff->total = (struct xrt_vec3_f64){0};
 }
 
 static void
@@ -56,10 +139,47 @@ vec3_f32_destroy(struct m_ff_vec3_f32 *ff)
 		ff->timestamps_ns = NULL;
 	}
 
+	if (ff->sums != NULL) {
+		free(ff->sums);
+		ff->sums = NULL;
+	}
+
 	ff->num = 0;
 	ff->latest = 0;
 }
 
+static inline void
+vec3_f32_push(struct m_ff_vec3_f32 *ff, const struct xrt_vec3 *sample, uint64_t timestamp_ns)
+{
+	// We write samples backwards in the queue.
+	size_t i = ff->latest == 0 ? ff->num - 1 : ff->latest - 1;
+	ff->latest = i;
+
+	/*
+	 * Wrapping around, the sample at the end is the oldest and is dropped,
+	 * take its sum off everything so the sums stay the size of the window.
+	 */
+	if (i == ff->num - 1) {
+		struct xrt_vec3_f64 base = ff->sums[i];
+		for (size_t k = 0; k < ff->num; k++) {
+			ff->sums[k].x -= base.x;
+			ff->sums[k].y -= base.y;
+			ff->sums[k].z -= base.z;
+		}
+		ff->total.x -= base.x;
+		ff->total.y -= base.y;
+		ff->total.z -= base.z;
+	}
+
+	ff->total.x += sample->x;
+	ff->total.y += sample->y;
+	ff->total.z += sample->z;
+
+	ff->samples[i] = *sample;
+	ff->timestamps_ns[i] = timestamp_ns;
+	ff->sums[i] = ff->total;
+}
+
 
 /*
  *
@@ -99,12 +219,20 @@ m_ff_vec3_f32_push(struct m_ff_vec3_f32 *ff, const struct xrt_vec3 *sample, uint
 {
 	assert(ff->timestamps_ns[ff->latest] <= timestamp_ns);
 
-	// We write samples backwards in the queue.
-	size_t i = ff->latest == 0 ? ff->num - 1 : --ff->latest;
-	ff->latest = i;
+	vec3_f32_push(ff, sample, timestamp_ns);
+}
 
-	ff->samples[i] = *sample;
-	ff->timestamps_ns[i] = timestamp_ns;
+void
+m_ff_vec3_f32_push_batch(struct m_ff_vec3_f32 *ff,
+                         const struct xrt_vec3 *samples,
+                         const uint64_t *timestamps_ns,
+                         size_t count)
+{
+	for (size_t k = 0; k < count; k++) {
+		assert(ff->timestamps_ns[ff->latest] <= timestamps_ns[k]);
+
+		vec3_f32_push(ff, &samples[k], timestamps_ns[k]);
+	}
 }
 
 bool
@@ -124,50 +252,22 @@ m_ff_vec3_f32_get(struct m_ff_vec3_f32 *ff, size_t num, struct xrt_vec3 *out_sam
 size_t
 m_ff_vec3_f32_filter(struct m_ff_vec3_f32 *ff, uint64_t start_ns, uint64_t stop_ns, struct xrt_vec3 *out_average)
 {
-	size_t num_sampled = 0;
-	size_t count = 0;
-	// Use double precision internally.
-	double x = 0;
-	double y = 0;
-	double z = 0;
-
-	// Error, skip averaging.
-	if (start_ns > stop_ns) {
-		count = ff->num;
+	size_t newest, oldest, num_sampled;
+	if (!ff_find_window(ff->timestamps_ns, ff->num, ff->latest, start_ns, stop_ns, &newest, &oldest, &num_sampled)) {
+		out_average->x = 0.0f;
+		out_average->y = 0.0f;
+		out_average->z = 0.0f;
+		return 0;
 	}
 
-	while (count < ff->num) {
-		size_t pos = (ff->latest + count) % ff->num;
-
-		// We have not yet reached where to start.
-		if (ff->timestamps_ns[pos] > stop_ns) {
-			count++;
-			continue;
-		}
-
-		// If the sample is before the start we have reach the end.
-		if (ff->timestamps_ns[pos] < start_ns) {
-			count++;
-			break;
-		}
-
-		x += ff->samples[pos].x;
-		y += ff->samples[pos].y;
-		z += ff->samples[pos].z;
-		num_sampled++;
-		count++;
-	}
-
-	// Avoid division by zero.
-	if (num_sampled > 0) {
-		x /= num_sampled;
-		y /= num_sampled;
-		z /= num_sampled;
-	}
+	// Use double precision internally.
+	double x = ff->sums[newest].x - ff->sums[oldest].x + ff->samples[oldest].x;
+	double y = ff->sums[newest].y - ff->sums[oldest].y + ff->samples[oldest].y;
+	double z = ff->sums[newest].z - ff->sums[oldest].z + ff->samples[oldest].z;
 
-	out_average->x = (float)x;
-	out_average->y = (float)y;
-	out_average->z = (float)z;
+	out_average->x = (float)(x / num_sampled);
+	out_average->y = (float)(y / num_sampled);
+	out_average->z = (float)(z / num_sampled);
 
 	return num_sampled;
 }
@@ -185,6 +285,12 @@ struct m_ff_f64
 	size_t latest;
 	double *samples;
 	uint64_t *timestamps_ns;
+
+	//! Sum of all samples up to and including the sample at the same index.
+	double *sums;
+
+	//! Sum of all samples pushed, rebased every time the write index wraps.
+	double total;
 };
 
 
@@ -199,8 +305,10 @@ ff_f64_init(struct m_ff_f64 *ff, size_t num)
 {
 	ff->samples = U_TYPED_ARRAY_CALLOC(double, num);
 	ff->timestamps_ns = U_TYPED_ARRAY_CALLOC(uint64_t, num);
+	ff->sums = U_TYPED_ARRAY_CALLOC(double, num);
 	ff->num = num;
 	ff->latest = 0;
+	ff->total = 0;
 }
 
 static void
@@ -216,10 +324,38 @@ ff_f64_destroy(struct m_ff_f64 *ff)
 		ff->timestamps_ns = NULL;
 	}
 
+	if (ff->sums != NULL) {
+		free(ff->sums);
+		ff->sums = NULL;
+	}
+
 	ff->num = 0;
 	ff->latest = 0;
 }
 
+static inline void
+ff_f64_push(struct m_ff_f64 *ff, double sample, uint64_t timestamp_ns)
+{
+	// We write samples backwards in the queue.
+	size_t i = ff->latest == 0 ? ff->num - 1 : ff->latest - 1;
+	ff->latest = i;
+
+	// Wrapping around, see vec3_f32_push.
+	if (i == ff->num - 1) {
+		double base = ff->sums[i];
+		for (size_t k = 0; k < ff->num; k++) {
+			ff->sums[k] -= base;
+		}
+		ff->total -= base;
+	}
+
+	ff->total += sample;
+
+	ff->samples[i] = sample;
+	ff->timestamps_ns[i] = timestamp_ns;
+	ff->sums[i] = ff->total;
+}
+
 
 /*
  *
@@ -259,12 +395,17 @@ m_ff_f64_push(struct m_ff_f64 *ff, const double *sample, uint64_t timestamp_ns)
 {
 	assert(ff->timestamps_ns[ff->latest] <= timestamp_ns);
 
-	// We write samples backwards in the queue.
-	size_t i = ff->latest == 0 ? ff->num - 1 : --ff->latest;
-	ff->latest = i;
+	ff_f64_push(ff, *sample, timestamp_ns);
+}
 
-	ff->samples[i] = *sample;
-	ff->timestamps_ns[i] = timestamp_ns;
+void
+m_ff_f64_push_batch(struct m_ff_f64 *ff, const double *samples, const uint64_t *timestamps_ns, size_t count)
+{
+	for (size_t k = 0; k < count; k++) {
+		assert(ff->timestamps_ns[ff->latest] <= timestamps_ns[k]);
+
+		ff_f64_push(ff, samples[k], timestamps_ns[k]);
+	}
 }
 
 bool
@@ -284,41 +425,15 @@ m_ff_f64_get(struct m_ff_f64 *ff, size_t num, double *out_sample, uint64_t *out_
 size_t
 m_ff_f64_filter(struct m_ff_f64 *ff, uint64_t start_ns, uint64_t stop_ns, double *out_average)
 {
-	size_t num_sampled = 0;
-	size_t count = 0;
-	double val = 0;
-
-	// Error, skip averaging.
-	if (start_ns > stop_ns) {
-		count = ff->num;
+	size_t newest, oldest, num_sampled;
+	if (!ff_find_window(ff->timestamps_ns, ff->num, ff->latest, start_ns, stop_ns, &newest, &oldest, &num_sampled)) {
+		*out_average = 0;
+		return 0;
 	}
 
-	while (count < ff->num) {
-		size_t pos = (ff->latest + count) % ff->num;
-
-		// We have not yet reached where to start.
-		if (ff->timestamps_ns[pos] > stop_ns) {
-			count++;
-			continue;
-		}
-
-		// If the sample is before the start we have reach the end.
-		if (ff->timestamps_ns[pos] < start_ns) {
-			count++;
-			break;
-		}
-
-		val += ff->samples[pos];
-		num_sampled++;
-		count++;
-	}
-
-	// Avoid division by zero.
-	if (num_sampled > 0) {
-		val /= num_sampled;
-	}
+	double val = ff->sums[newest] - ff->sums[oldest] + ff->samples[oldest];
 
-	*out_average = val;
+	*out_average = val / num_sampled;
 
 	return num_sampled;
 }
@@ -45,6 +45,17 @@ m_ff_vec3_f32_get_num(struct m_ff_vec3_f32 *ff);
 void
 m_ff_vec3_f32_push(struct m_ff_vec3_f32 *ff, const struct xrt_vec3 *sample, uint64_t timestamp_ns);
 
+/*!
+ * Pushes @p count samples in one go, for devices that deliver a packet of
+ * samples at a time. The samples must be in time order and not older than
+ * the last sample pushed.
+ */
+void
+m_ff_vec3_f32_push_batch(struct m_ff_vec3_f32 *ff,
+                         const struct xrt_vec3 *samples,
+                         const uint64_t *timestamps_ns,
+                         size_t count);
+
 /*!
  * Return the sample at the index, zero means the last sample push, one second
  * last and so on.
@@ -57,6 +68,9 @@ m_ff_vec3_f32_get(struct m_ff_vec3_f32 *ff, size_t num, struct xrt_vec3 *out_sam
  * of samples sampled, if no samples was found between the timpoints returns 0
  * and sets @p out_average to all zeros.
  *
+ * The fifo keeps running sums of its samples, so this is two binary searches
+ * and does not depend on how many samples are in the window.
+ *
  * @param ff          Filter fifo to search in.
  * @param start_ns    Timepoint furthest in the past, to start searching for
  *                    samples.
@@ -93,6 +107,14 @@ m_ff_f64_get_num(struct m_ff_f64 *ff);
 void
 m_ff_f64_push(struct m_ff_f64 *ff, const double *sample, uint64_t timestamp_ns);
 
+/*!
+ * Pushes @p count samples in one go, for devices that deliver a packet of
+ * samples at a time. The samples must be in time order and not older than
+ * the last sample pushed.
+ */
+void
+m_ff_f64_push_batch(struct m_ff_f64 *ff, const double *samples, const uint64_t *timestamps_ns, size_t count);
+
 /*!
  * Return the sample at the index, 0 means the last sample push, 1 second-to-last, etc.
  */
@@ -104,6 +126,9 @@ m_ff_f64_get(struct m_ff_f64 *ff, size_t num, double *out_sample, uint64_t *out_
  * of samples sampled, if no samples was found between the timpoints returns 0
  * and sets @p out_average to all zeros.
  *
+ * The fifo keeps running sums of its samples, so this is two binary searches
+ * and does not depend on how many samples are in the window.
+ *
  * @param ff          Filter fifo to search in.
  * @param start_ns    Timepoint furthest in the past, to start searching for
  *                    samples.
@@ -160,6 +185,17 @@ public:
 		m_ff_vec3_f32_push(mFifoPtr, &sample, timestamp_ns);
 	}
 
+	/*!
+	 * @copydoc m_ff_vec3_f32_push_batch
+	 *
+	 * Wrapper for @ref m_ff_vec3_f32_push_batch.
+	 */
+	inline void
+	push(const xrt_vec3 *samples, const uint64_t *timestamps_ns, size_t count)
+	{
+		m_ff_vec3_f32_push_batch(mFifoPtr, samples, timestamps_ns, count);
+	}
+
 	/*!
 	 * @copydoc m_ff_vec3_f32_get
 	 *
@@ -25,6 +25,9 @@
 #define DUR_300MS_IN_NS (300 * 1000 * 1000)
 #define DUR_20MS_IN_NS (20 * 1000 * 1000)
 
+//! Samples integrated at once by m_imu_3dof_update_batch, bigger batches are split.
+#define BATCH_MAX 16
+
 
 void
 m_imu_3dof_init(struct m_imu_3dof *f, int flags)
@@ -298,3 +301,98 @@ m_imu_3dof_update(struct m_imu_3dof *f,
 	 */
 	math_quat_normalize(&f->rot);
 }
+
+/*!
+ * Integrates @p count samples, the gyro deltas do not depend on the
+ * orientation so they are all made first in one tight loop, only composing
+ * them and the gravity correction has to go sample by sample.
+ */
+static void
+update_chunk(struct m_imu_3dof *f,
+             const uint64_t *timestamps_ns,
+             const struct xrt_vec3 *accels,
+             const struct xrt_vec3 *gyros,
+             size_t count)
+{
+	double dt[BATCH_MAX];
+	float gx[BATCH_MAX], gy[BATCH_MAX], gz[BATCH_MAX], glen[BATCH_MAX];
+	float qx[BATCH_MAX], qy[BATCH_MAX], qz[BATCH_MAX], qw[BATCH_MAX];
+
+	uint64_t last_ns = f->last.timestamp_ns;
+	for (size_t i = 0; i < count; i++) {
+		// This code assumes all timestamps makes some forward progress.
+		assert(timestamps_ns[i] >= last_ns);
+		dt[i] = (double)(timestamps_ns[i] - last_ns) / DUR_1S_IN_NS;
+		last_ns = timestamps_ns[i];
+	}
+
+	// The gyro kernel, plain arrays so the compiler can vectorize it.
+	struct xrt_vec3 bias = f->gyro_bias.value;
+	for (size_t i = 0; i < count; i++) {
+		gx[i] = gyros[i].x - bias.x;
+		gy[i] = gyros[i].y - bias.y;
+		gz[i] = gyros[i].z - bias.z;
+		glen[i] = sqrtf(gx[i] * gx[i] + gy[i] * gy[i] + gz[i] * gz[i]);
+	}
+	for (size_t i = 0; i < count; i++) {
+		float half_angle = glen[i] * (float)dt[i] * 0.5f;
+		bool moving = glen[i] > 0.0001f;
+		float s = moving ? sinf(half_angle) / glen[i] : 0.0f;
+
+		qx[i] = gx[i] * s;
+		qy[i] = gy[i] * s;
+		qz[i] = gz[i] * s;
+		qw[i] = moving ? cosf(half_angle) : 1.0f;
+	}
+
+	// Gyro bias is not fired in here, so all of them can go in at once.
+	m_ff_vec3_f32_push_batch(f->gyro_ff, gyros, timestamps_ns, count);
+
+	for (size_t i = 0; i < count; i++) {
+		struct xrt_vec3 world_accel = {0};
+		math_quat_rotate_vec3(&f->rot, &accels[i], &world_accel);
+		m_ff_vec3_f32_push(f->word_accel_ff, &world_accel, timestamps_ns[i]);
+
+		struct xrt_quat delta_orient = {qx[i], qy[i], qz[i], qw[i]};
+		math_quat_rotate(&f->rot, &delta_orient, &f->rot);
+
+		struct xrt_vec3 gyro_biased = {gx[i], gy[i], gz[i]};
+		gravity_correction(f, timestamps_ns[i], &accels[i], &gyro_biased, dt[i], glen[i]);
+	}
+
+	size_t last = count - 1;
+	f->last.gyro = gyros[last];
+	f->last.accel = accels[last];
+	f->last.delta_ms = dt[last] * 1000.0f;
+	f->last.timestamp_ns = timestamps_ns[last];
+	f->last.accel_length = m_vec3_len(accels[last]);
+	f->last.gyro_length = m_vec3_len(gyros[last]);
+	f->last.gyro_biased_length = glen[last];
+
+	math_quat_normalize(&f->rot);
+}
+
+void
+m_imu_3dof_update_batch(struct m_imu_3dof *f,
+                        const uint64_t *timestamps_ns,
+                        const struct xrt_vec3 *accels,
+                        const struct xrt_vec3 *gyros,
+                        size_t count)
+{
+	size_t i = 0;
+
+	/*
+	 * The first sample only starts the fusion, and firing the gyro bias
+	 * changes it for all samples after it, let the single path do those.
+	 */
+	while (i < count && (f->state == M_IMU_3DOF_STATE_START || f->gyro_bias.manually_fire)) {
+		m_imu_3dof_update(f, timestamps_ns[i], &accels[i], &gyros[i]);
+		i++;
+	}
+
+	while (i < count) {
+		size_t num = count - i < BATCH_MAX ? count - i : BATCH_MAX;
+		update_chunk(f, &timestamps_ns[i], &accels[i], &gyros[i], num);
+		i += num;
+	}
+}
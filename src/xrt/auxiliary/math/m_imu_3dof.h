@@ -90,6 +90,22 @@ m_imu_3dof_update(struct m_imu_3dof *f,
                   const struct xrt_vec3 *accel,
                   const struct xrt_vec3 *gyro);
 
+/*!
+ * Update the fusion with @p count samples in time order, for devices that
+ * deliver several IMU samples per packet. Gives the same result as calling
+ * @ref m_imu_3dof_update for each sample, up to floating point rounding, but
+ * the gyro integration is done for all samples at once and the orientation is
+ * only normalized at the end.
+ *
+ * A manual gyro bias fire is picked up at the start of the batch.
+ */
+void
+m_imu_3dof_update_batch(struct m_imu_3dof *f,
+                        const uint64_t *timestamps_ns,
+                        const struct xrt_vec3 *accels,
+                        const struct xrt_vec3 *gyros,
+                        size_t count);
+
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,192 @@
+// Copyright 2025, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Batch pose math on struct-of-arrays pose buffers.
+ * @author agent <agent@local>
+ * @ingroup aux_math
+ */
+
+#include "math/m_mathinclude.h"
+#include "math/m_pose_batch.h"
+
+#include <float.h>
+
+
+/*
+ *
+ * Helper functions.
+ *
+ */
+
+/*!
+ * Rotate the vector @p v by the quaternion @p q, written out so it can be used
+ * on lanes of a loop: t = 2 * cross(q.xyz, v), v' = v + q.w * t + cross(q.xyz, t).
+ */
+static inline void
+rotate(float qx,
+       float qy,
+       float qz,
+       float qw,
+       float vx,
+       float vy,
+       float vz,
+       float *out_x,
+       float *out_y,
+       float *out_z)
+{
+	float tx = 2.0f * (qy * vz - qz * vy);
+	float ty = 2.0f * (qz * vx - qx * vz);
+	float tz = 2.0f * (qx * vy - qy * vx);
+
+	*out_x = vx + qw * tx + (qy * tz - qz * ty);
+	*out_y = vy + qw * ty + (qz * tx - qx * tz);
+	*out_z = vz + qw * tz + (qx * ty - qy * tx);
+}
+
+
+/*
+ *
+ * 'Exported' functions.
+ *
+ */
+
+void
+m_pose_batch_load(struct m_pose_batch *batch, const struct xrt_pose *poses, uint32_t count)
+{
+	assert(count <= M_POSE_BATCH_MAX);
+
+	for (uint32_t i = 0; i < count; i++) {
+		m_pose_batch_set(batch, i, &poses[i]);
+	}
+
+	batch->count = count;
+}
+
+void
+m_pose_batch_store(const struct m_pose_batch *batch, struct xrt_pose *out_poses)
+{
+	for (uint32_t i = 0; i < batch->count; i++) {
+		m_pose_batch_get(batch, i, &out_poses[i]);
+	}
+}
+
+void
+m_pose_batch_transform(const struct xrt_pose *transform,
+                       const struct m_pose_batch *batch,
+                       struct m_pose_batch *out_batch)
+{
+	const float tpx = transform->position.x;
+	const float tpy = transform->position.y;
+	const float tpz = transform->position.z;
+	const float tqx = transform->orientation.x;
+	const float tqy = transform->orientation.y;
+	const float tqz = transform->orientation.z;
+	const float tqw = transform->orientation.w;
+
+	const uint32_t count = batch->count;
+
+	for (uint32_t i = 0; i < count; i++) {
+		const float qx = batch->qx[i];
+		const float qy = batch->qy[i];
+		const float qz = batch->qz[i];
+		const float qw = batch->qw[i];
+
+		float px, py, pz;
+		rotate(tqx, tqy, tqz, tqw, batch->px[i], batch->py[i], batch->pz[i], &px, &py, &pz);
+
+		// Hamilton product transform * pose.
+		float ox = tqw * qx + tqx * qw + tqy * qz - tqz * qy;
+		float oy = tqw * qy - tqx * qz + tqy * qw + tqz * qx;
+		float oz = tqw * qz + tqx * qy - tqy * qx + tqz * qw;
+		float ow = tqw * qw - tqx * qx - tqy * qy - tqz * qz;
+
+		/*
+		 * Ensure no errors have crept in, both inputs are unit length so
+		 * the length is very close to one, and one Newton step towards
+		 * the inverse square root starting from one is enough. Unlike
+		 * sqrtf this doesn't stop the loop from being vectorised.
+		 */
+		float inv_len = 1.5f - 0.5f * (ox * ox + oy * oy + oz * oz + ow * ow);
+
+		out_batch->px[i] = px + tpx;
+		out_batch->py[i] = py + tpy;
+		out_batch->pz[i] = pz + tpz;
+		out_batch->qx[i] = ox * inv_len;
+		out_batch->qy[i] = oy * inv_len;
+		out_batch->qz[i] = oz * inv_len;
+		out_batch->qw[i] = ow * inv_len;
+	}
+
+	out_batch->count = count;
+}
+
+void
+m_pose_batch_invert(const struct m_pose_batch *batch, struct m_pose_batch *out_batch)
+{
+	const uint32_t count = batch->count;
+
+	for (uint32_t i = 0; i < count; i++) {
+		// The conjugate is the inverse of a unit quaternion.
+		const float qx = -batch->qx[i];
+		const float qy = -batch->qy[i];
+		const float qz = -batch->qz[i];
+		const float qw = batch->qw[i];
+
+		float px, py, pz;
+		rotate(qx, qy, qz, qw, batch->px[i], batch->py[i], batch->pz[i], &px, &py, &pz);
+
+		out_batch->px[i] = -px;
+		out_batch->py[i] = -py;
+		out_batch->pz[i] = -pz;
+		out_batch->qx[i] = qx;
+		out_batch->qy[i] = qy;
+		out_batch->qz[i] = qz;
+		out_batch->qw[i] = qw;
+	}
+
+	out_batch->count = count;
+}
+
+void
+m_pose_batch_interpolate(const struct m_pose_batch *a,
+                         const struct m_pose_batch *b,
+                         float t,
+                         struct m_pose_batch *out_batch)
+{
+	assert(a->count == b->count);
+
+	// Same threshold as Eigen's slerp for falling back to a lerp.
+	const float limit = 1.0f - FLT_EPSILON;
+	const uint32_t count = a->count;
+
+	for (uint32_t i = 0; i < count; i++) {
+		const float d = a->qx[i] * b->qx[i] + a->qy[i] * b->qy[i] + a->qz[i] * b->qz[i] + a->qw[i] * b->qw[i];
+		const float abs_d = fabsf(d);
+
+		/*
+		 * Selects instead of branches keep the loop vectorisable, the
+		 * clamp keeps the unused slerp scales finite for close lanes.
+		 */
+		const float theta = acosf(abs_d < limit ? abs_d : limit);
+		const float inv_sin_theta = 1.0f / sinf(theta);
+		const bool close = abs_d >= limit;
+
+		float scale_a = close ? 1.0f - t : sinf((1.0f - t) * theta) * inv_sin_theta;
+		float scale_b = close ? t : sinf(t * theta) * inv_sin_theta;
+
+		// Take the short way around.
+		scale_b = d < 0.0f ? -scale_b : scale_b;
+
+		out_batch->qx[i] = scale_a * a->qx[i] + scale_b * b->qx[i];
+		out_batch->qy[i] = scale_a * a->qy[i] + scale_b * b->qy[i];
+		out_batch->qz[i] = scale_a * a->qz[i] + scale_b * b->qz[i];
+		out_batch->qw[i] = scale_a * a->qw[i] + scale_b * b->qw[i];
+
+		out_batch->px[i] = a->px[i] * (1.0f - t) + b->px[i] * t;
+		out_batch->py[i] = a->py[i] * (1.0f - t) + b->py[i] * t;
+		out_batch->pz[i] = a->pz[i] * (1.0f - t) + b->pz[i] * t;
+	}
+
+	out_batch->count = count;
+}
@@ -0,0 +1,181 @@
+// Copyright 2025, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Batch pose math on struct-of-arrays pose buffers.
+ * @author agent <agent@local>
+ * @ingroup aux_math
+ */
+
+#pragma once
+
+#include "xrt/xrt_defines.h"
+
+#include <assert.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/*!
+ * Max number of poses in a @ref m_pose_batch, enough for a full set of body
+ * joints.
+ *
+ * @ingroup aux_math
+ */
+#define M_POSE_BATCH_MAX (128)
+
+/*!
+ * A set of poses stored as struct-of-arrays. The components are laid out so
+ * that the loops over them are straight and branch free, letting the compiler
+ * vectorise them, which the scalar @ref math_pose_transform and friends going
+ * through Eigen one pose at a time can't do.
+ *
+ * @ingroup aux_math
+ */
+struct m_pose_batch
+{
+	float px[M_POSE_BATCH_MAX];
+	float py[M_POSE_BATCH_MAX];
+	float pz[M_POSE_BATCH_MAX];
+
+	float qx[M_POSE_BATCH_MAX];
+	float qy[M_POSE_BATCH_MAX];
+	float qz[M_POSE_BATCH_MAX];
+	float qw[M_POSE_BATCH_MAX];
+
+	//! Number of poses in use.
+	uint32_t count;
+};
+
+
+/*
+ *
+ * Helpers.
+ *
+ */
+
+/*!
+ * Set the pose at @p index.
+ *
+ * @ingroup aux_math
+ */
+static inline void
+m_pose_batch_set(struct m_pose_batch *batch, uint32_t index, const struct xrt_pose *pose)
+{
+	assert(index < M_POSE_BATCH_MAX);
+
+	batch->px[index] = pose->position.x;
+	batch->py[index] = pose->position.y;
+	batch->pz[index] = pose->position.z;
+	batch->qx[index] = pose->orientation.x;
+	batch->qy[index] = pose->orientation.y;
+	batch->qz[index] = pose->orientation.z;
+	batch->qw[index] = pose->orientation.w;
+}
+
+/*!
+ * Set the pose at @p index from a relation, components that are not valid are
+ * replaced with identity, same as @ref m_relation_chain_resolve does.
+ *
+ * @ingroup aux_math
+ */
+static inline void
+m_pose_batch_set_relation(struct m_pose_batch *batch, uint32_t index, const struct xrt_space_relation *rel)
+{
+	struct xrt_pose pose = XRT_POSE_IDENTITY;
+
+	if ((rel->relation_flags & XRT_SPACE_RELATION_ORIENTATION_VALID_BIT) != 0) {
+		pose.orientation = rel->pose.orientation;
+	}
+	if ((rel->relation_flags & XRT_SPACE_RELATION_POSITION_VALID_BIT) != 0) {
+		pose.position = rel->pose.position;
+	}
+
+	m_pose_batch_set(batch, index, &pose);
+}
+
+/*!
+ * Get the pose at @p index.
+ *
+ * @ingroup aux_math
+ */
+static inline void
+m_pose_batch_get(const struct m_pose_batch *batch, uint32_t index, struct xrt_pose *out_pose)
+{
+	assert(index < M_POSE_BATCH_MAX);
+
+	out_pose->position.x = batch->px[index];
+	out_pose->position.y = batch->py[index];
+	out_pose->position.z = batch->pz[index];
+	out_pose->orientation.x = batch->qx[index];
+	out_pose->orientation.y = batch->qy[index];
+	out_pose->orientation.z = batch->qz[index];
+	out_pose->orientation.w = batch->qw[index];
+}
+
+/*!
+ * Fill the batch from an array of @p count poses.
+ *
+ * @ingroup aux_math
+ */
+void
+m_pose_batch_load(struct m_pose_batch *batch, const struct xrt_pose *poses, uint32_t count);
+
+/*!
+ * Write out the poses in the batch to an array of at least
+ * @ref m_pose_batch::count poses.
+ *
+ * @ingroup aux_math
+ */
+void
+m_pose_batch_store(const struct m_pose_batch *batch, struct xrt_pose *out_poses);
+
+
+/*
+ *
+ * Operations.
+ *
+ */
+
+/*!
+ * Transform all of the poses in @p batch by @p transform, the same as calling
+ * @ref math_pose_transform on each of them. The resulting orientations are
+ * normalized like @ref m_relation_chain_resolve does. In place operation,
+ * @p batch and @p out_batch being the same, is allowed.
+ *
+ * @ingroup aux_math
+ */
+void
+m_pose_batch_transform(const struct xrt_pose *transform,
+                       const struct m_pose_batch *batch,
+                       struct m_pose_batch *out_batch);
+
+/*!
+ * Invert all of the poses in @p batch, the same as calling
+ * @ref math_pose_invert on each of them, the orientations are expected to be
+ * normalized. In place operation is allowed.
+ *
+ * @ingroup aux_math
+ */
+void
+m_pose_batch_invert(const struct m_pose_batch *batch, struct m_pose_batch *out_batch);
+
+/*!
+ * Interpolate each pose in @p a with the same pose in @p b, the orientation is
+ * slerped and the position lerped, the same as @ref math_pose_interpolate.
+ * Both batches must have the same count. In place operation is allowed.
+ *
+ * @ingroup aux_math
+ */
+void
+m_pose_batch_interpolate(const struct m_pose_batch *a,
+                         const struct m_pose_batch *b,
+                         float t,
+                         struct m_pose_batch *out_batch);
+
+
+#ifdef __cplusplus
+}
+#endif
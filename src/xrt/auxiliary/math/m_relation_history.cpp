@@ -46,9 +46,164 @@ struct m_relation_history
 {
 	HistoryBuffer<struct relation_history_entry, BufLen> impl;
 	mutable os::Mutex mutex;
+
+	enum m_relation_history_interpolation interp = M_RELATION_HISTORY_INTERPOLATION_LINEAR;
+
+	//! Age of the entry following the last interpolated timestamp, protected by the mutex.
+	mutable size_t last_successor_age = 0;
 };
 
 
+/*
+ *
+ * Helpers.
+ *
+ */
+
+static bool
+is_successor_age(const m_relation_history *rh, size_t age, int64_t at_timestamp_ns)
+{
+	const relation_history_entry *successor = rh->impl.get_at_age(age);
+	const relation_history_entry *predecessor = rh->impl.get_at_age(age + 1);
+
+	return successor != nullptr && predecessor != nullptr && successor->timestamp >= at_timestamp_ns &&
+	       predecessor->timestamp < at_timestamp_ns;
+}
+
+/*!
+ * Returns the age of the first entry not older than @p at_timestamp_ns, the
+ * timestamp must be after the oldest entry and not after the newest.
+ */
+static size_t
+find_successor_age(const m_relation_history *rh, int64_t at_timestamp_ns)
+{
+	/*
+	 * Queries mostly move forward in small steps, which moves the successor
+	 * towards the newest entry, while every push ages it by one.
+	 */
+	size_t cached = rh->last_successor_age;
+	for (size_t age : {cached, cached + 1, cached - 1}) {
+		if (is_successor_age(rh, age, at_timestamp_ns)) {
+			rh->last_successor_age = age;
+			return age;
+		}
+	}
+
+	// Find the first element *not less than* our value.
+	const auto b = rh->impl.begin();
+	const auto e = rh->impl.end();
+	const auto it = std::lower_bound(b, e, at_timestamp_ns, [](const relation_history_entry &rhe, int64_t timestamp) {
+		return rhe.timestamp < timestamp;
+	});
+	assert(it != e && it != b);
+
+	size_t age = rh->impl.size() - 1 - (size_t)(it - b);
+	rh->last_successor_age = age;
+	return age;
+}
+
+static void
+interpolate_linear(const xrt_space_relation &predecessor,
+                   const xrt_space_relation &successor,
+                   float amount_to_lerp,
+                   xrt_space_relation &result)
+{
+	// First-order implementation - lerp between the before and after
+	if (0 != (result.relation_flags & XRT_SPACE_RELATION_POSITION_VALID_BIT)) {
+		result.pose.position = m_vec3_lerp(predecessor.pose.position, successor.pose.position, amount_to_lerp);
+	}
+	if (0 != (result.relation_flags & XRT_SPACE_RELATION_ORIENTATION_VALID_BIT)) {
+		math_quat_slerp(&predecessor.pose.orientation, &successor.pose.orientation, amount_to_lerp,
+		                &result.pose.orientation);
+	}
+
+	//! @todo Does interpolating the velocities make any sense?
+	if (0 != (result.relation_flags & XRT_SPACE_RELATION_ANGULAR_VELOCITY_VALID_BIT)) {
+		result.angular_velocity =
+		    m_vec3_lerp(predecessor.angular_velocity, successor.angular_velocity, amount_to_lerp);
+	}
+	if (0 != (result.relation_flags & XRT_SPACE_RELATION_LINEAR_VELOCITY_VALID_BIT)) {
+		result.linear_velocity =
+		    m_vec3_lerp(predecessor.linear_velocity, successor.linear_velocity, amount_to_lerp);
+	}
+}
+
+/*!
+ * Cubic Hermite between the two entries, done where both the value and its
+ * velocity are valid, whatever is left keeps the linear result.
+ */
+static void
+interpolate_hermite(const xrt_space_relation &predecessor,
+                    const xrt_space_relation &successor,
+                    float s,
+                    double delta_s,
+                    xrt_space_relation &result)
+{
+	const enum xrt_space_relation_flags flags = result.relation_flags;
+	const float h = (float)delta_s;
+
+	const bool position = (flags & XRT_SPACE_RELATION_POSITION_VALID_BIT) != 0 &&
+	                      (flags & XRT_SPACE_RELATION_LINEAR_VELOCITY_VALID_BIT) != 0;
+	if (position) {
+		float s2 = s * s;
+		float s3 = s2 * s;
+
+		// Basis functions and their derivatives.
+		float h00 = 2 * s3 - 3 * s2 + 1;
+		float h10 = s3 - 2 * s2 + s;
+		float h01 = -2 * s3 + 3 * s2;
+		float h11 = s3 - s2;
+		float d00 = 6 * s2 - 6 * s;
+		float d10 = 3 * s2 - 4 * s + 1;
+		float d01 = -6 * s2 + 6 * s;
+		float d11 = 3 * s2 - 2 * s;
+
+		const xrt_vec3 &p0 = predecessor.pose.position;
+		const xrt_vec3 &p1 = successor.pose.position;
+		const xrt_vec3 &v0 = predecessor.linear_velocity;
+		const xrt_vec3 &v1 = successor.linear_velocity;
+
+		result.pose.position = p0 * h00 + v0 * (h10 * h) + p1 * h01 + v1 * (h11 * h);
+		result.linear_velocity = (p0 * d00 + p1 * d01) / h + v0 * d10 + v1 * d11;
+	}
+
+	const bool orientation = (flags & XRT_SPACE_RELATION_ORIENTATION_VALID_BIT) != 0 &&
+	                         (flags & XRT_SPACE_RELATION_ANGULAR_VELOCITY_VALID_BIT) != 0;
+	if (orientation) {
+		/*
+		 * A cubic Bezier curve is a Hermite curve with the inner control
+		 * points a third of the way along the velocities, on rotations
+		 * those come from integrating the angular velocities the same way
+		 * prediction does, then de Casteljau with slerp.
+		 */
+		xrt_space_relation ahead{};
+		xrt_space_relation behind{};
+		m_predict_relation(&predecessor, delta_s / 3.0, &ahead);
+		m_predict_relation(&successor, -delta_s / 3.0, &behind);
+
+		const xrt_quat &q0 = predecessor.pose.orientation;
+		const xrt_quat &q1 = ahead.pose.orientation;
+		const xrt_quat &q2 = behind.pose.orientation;
+		const xrt_quat &q3 = successor.pose.orientation;
+
+		xrt_quat a, b, c, d, e;
+		math_quat_slerp(&q0, &q1, s, &a);
+		math_quat_slerp(&q1, &q2, s, &b);
+		math_quat_slerp(&q2, &q3, s, &c);
+		math_quat_slerp(&a, &b, s, &d);
+		math_quat_slerp(&b, &c, s, &e);
+		math_quat_slerp(&d, &e, s, &result.pose.orientation);
+	}
+}
+
+
+/*
+ *
+ * 'Exported' functions.
+ *
+ */
+
+
 void
 m_relation_history_create(struct m_relation_history **rh_ptr)
 {
@@ -80,6 +235,13 @@ m_relation_history_push(struct m_relation_history *rh, struct xrt_space_relation
 	return ret;
 }
 
+void
+m_relation_history_set_interpolation(struct m_relation_history *rh, enum m_relation_history_interpolation interp)
+{
+	std::unique_lock<os::Mutex> lock(rh->mutex);
+	rh->interp = interp;
+}
+
 enum m_relation_history_result
 m_relation_history_get(const struct m_relation_history *rh,
                        int64_t at_timestamp_ns,
@@ -93,53 +255,52 @@ m_relation_history_get(const struct m_relation_history *rh,
 			*out_relation = {};
 			return M_RELATION_HISTORY_RESULT_INVALID;
 		}
-		const auto b = rh->impl.begin();
-		const auto e = rh->impl.end();
-
-		// Find the first element *not less than* our value. the lambda we pass is the comparison
-		// function, to compare against timestamps.
-		const auto it =
-		    std::lower_bound(b, e, at_timestamp_ns, [](const relation_history_entry &rhe, int64_t timestamp) {
-			    return rhe.timestamp < timestamp;
-		    });
-
-		if (it == e) {
-			// lower bound is at the end:
+
+		const relation_history_entry &newest = rh->impl.back();
+		const relation_history_entry &oldest = rh->impl.front();
+
+		if (at_timestamp_ns > newest.timestamp) {
 			// The desired timestamp is after what our buffer contains.
 			// (pose-prediction)
 			// Output flags match the most recent buffer entry.
-			int64_t diff_prediction_ns = static_cast<int64_t>(at_timestamp_ns) - rh->impl.back().timestamp;
+			int64_t diff_prediction_ns = static_cast<int64_t>(at_timestamp_ns) - newest.timestamp;
 			double delta_s = time_ns_to_s(diff_prediction_ns);
 
 			U_LOG_T("Extrapolating %f s past the back of the buffer!", delta_s);
 
-			m_predict_relation(&rh->impl.back().relation, delta_s, out_relation);
+			m_predict_relation(&newest.relation, delta_s, out_relation);
 			return M_RELATION_HISTORY_RESULT_PREDICTED;
 		}
-		if (at_timestamp_ns == it->timestamp) {
-			// exact match:
-			// Flags copied directly along with everything else.
+		if (at_timestamp_ns == oldest.timestamp) {
 			U_LOG_T("Exact match in the buffer!");
-			*out_relation = it->relation;
+			*out_relation = oldest.relation;
 			return M_RELATION_HISTORY_RESULT_EXACT;
 		}
-		if (it == b) {
-			// lower bound is at the beginning (and it's not an exact match):
+		if (at_timestamp_ns < oldest.timestamp) {
 			// The desired timestamp is before what our buffer contains.
 			// (an edge case where somebody asks for a really old pose and we do our best)
 			// Output flags are the same as the input flags for the history entry we use
-			int64_t diff_prediction_ns = static_cast<int64_t>(at_timestamp_ns) - rh->impl.front().timestamp;
+			int64_t diff_prediction_ns = static_cast<int64_t>(at_timestamp_ns) - oldest.timestamp;
 			double delta_s = time_ns_to_s(diff_prediction_ns);
 			U_LOG_T("Extrapolating %f s before the front of the buffer!", delta_s);
-			m_predict_relation(&rh->impl.front().relation, delta_s, out_relation);
+			m_predict_relation(&oldest.relation, delta_s, out_relation);
 			return M_RELATION_HISTORY_RESULT_REVERSE_PREDICTED;
 		}
-		U_LOG_T("Interpolating within buffer!");
 
-		// We precede *it and follow *(it - 1) (which we know exists because we already handled
-		// the it = begin() case)
-		const auto &predecessor = *(it - 1);
-		const auto &successor = *it;
+		// We are now after the oldest entry and not after the newest, so both neighbours exist.
+		size_t age = find_successor_age(rh, at_timestamp_ns);
+		const relation_history_entry &successor = *rh->impl.get_at_age(age);
+		const relation_history_entry &predecessor = *rh->impl.get_at_age(age + 1);
+
+		if (at_timestamp_ns == successor.timestamp) {
+			// exact match:
+			// Flags copied directly along with everything else.
+			U_LOG_T("Exact match in the buffer!");
+			*out_relation = successor.relation;
+			return M_RELATION_HISTORY_RESULT_EXACT;
+		}
+
+		U_LOG_T("Interpolating within buffer!");
 
 		// Do the thing.
 		int64_t diff_before = static_cast<int64_t>(at_timestamp_ns) - predecessor.timestamp;
@@ -151,26 +312,14 @@ m_relation_history_get(const struct m_relation_history *rh,
 		xrt_space_relation result{};
 		result.relation_flags = (enum xrt_space_relation_flags)(predecessor.relation.relation_flags &
 		                                                        successor.relation.relation_flags);
-		// First-order implementation - lerp between the before and after
-		if (0 != (result.relation_flags & XRT_SPACE_RELATION_POSITION_VALID_BIT)) {
-			result.pose.position = m_vec3_lerp(predecessor.relation.pose.position,
-			                                   successor.relation.pose.position, amount_to_lerp);
-		}
-		if (0 != (result.relation_flags & XRT_SPACE_RELATION_ORIENTATION_VALID_BIT)) {
 
-			math_quat_slerp(&predecessor.relation.pose.orientation, &successor.relation.pose.orientation,
-			                amount_to_lerp, &result.pose.orientation);
-		}
+		interpolate_linear(predecessor.relation, successor.relation, amount_to_lerp, result);
 
-		//! @todo Does interpolating the velocities make any sense?
-		if (0 != (result.relation_flags & XRT_SPACE_RELATION_ANGULAR_VELOCITY_VALID_BIT)) {
-			result.angular_velocity = m_vec3_lerp(predecessor.relation.angular_velocity,
-			                                      successor.relation.angular_velocity, amount_to_lerp);
-		}
-		if (0 != (result.relation_flags & XRT_SPACE_RELATION_LINEAR_VELOCITY_VALID_BIT)) {
-			result.linear_velocity = m_vec3_lerp(predecessor.relation.linear_velocity,
-			                                     successor.relation.linear_velocity, amount_to_lerp);
+		if (rh->interp == M_RELATION_HISTORY_INTERPOLATION_HERMITE) {
+			double delta_s = time_ns_to_s(diff_before + diff_after);
+			interpolate_hermite(predecessor.relation, successor.relation, amount_to_lerp, delta_s, result);
 		}
+
 		*out_relation = result;
 		return M_RELATION_HISTORY_RESULT_INTERPOLATED;
 
@@ -253,6 +402,7 @@ m_relation_history_clear(struct m_relation_history *rh)
 {
 	std::unique_lock<os::Mutex> lock(rh->mutex);
 	rh->impl.clear();
+	rh->last_successor_age = 0;
 }
 
 void
@@ -42,6 +42,23 @@ enum m_relation_history_result
 	M_RELATION_HISTORY_RESULT_REVERSE_PREDICTED, //!< The desired timestamp was older than the oldest entry
 };
 
+/**
+ * @brief How poses between two entries are interpolated.
+ *
+ * @relates m_relation_history
+ */
+enum m_relation_history_interpolation
+{
+	//! Lerp positions and slerp orientations, the default.
+	M_RELATION_HISTORY_INTERPOLATION_LINEAR = 0,
+
+	/*!
+	 * Cubic Hermite through the two entries using their stored velocities,
+	 * falls back to linear for anything without valid velocities on both.
+	 */
+	M_RELATION_HISTORY_INTERPOLATION_HERMITE,
+};
+
 /*!
  * Creates an opaque relation_history object.
  *
@@ -62,11 +79,20 @@ m_relation_history_create(struct m_relation_history **rh);
 bool
 m_relation_history_push(struct m_relation_history *rh, struct xrt_space_relation const *in_relation, int64_t timestamp);
 
+/*!
+ * Sets how poses between two entries are interpolated, see
+ * @ref m_relation_history_interpolation.
+ *
+ * @public @memberof m_relation_history
+ */
+void
+m_relation_history_set_interpolation(struct m_relation_history *rh, enum m_relation_history_interpolation interp);
+
 /*!
  * Interpolates or extrapolates to the desired timestamp.
  *
  * Read-only operation - doesn't remove anything from the buffer or anything like that - you can call this as often as
- * you want.
+ * you want. The last entry found is remembered, so queries that move forward in small steps don't need to search.
  *
  * @public @memberof m_relation_history
  */
@@ -181,6 +207,15 @@ public:
 		return m_relation_history_push(mPtr, &relation, ts);
 	}
 
+	/*!
+	 * @copydoc m_relation_history_set_interpolation
+	 */
+	void
+	set_interpolation(m_relation_history_interpolation interp) noexcept
+	{
+		m_relation_history_set_interpolation(mPtr, interp);
+	}
+
 	/*!
 	 * @copydoc m_relation_history_get
 	 */
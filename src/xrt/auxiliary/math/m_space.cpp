@@ -109,6 +109,44 @@ get_flags(const struct xrt_space_relation *r)
 	return flags;
 }
 
+/*!
+ * A step that is a constant offset, as pushed by @ref m_relation_chain_push_pose,
+ * fully valid and tracked but not moving. Composing two of them is just
+ * composing their poses.
+ */
+static bool
+is_constant_offset(const struct xrt_space_relation *r)
+{
+	const struct xrt_vec3 zero = XRT_VEC3_ZERO;
+
+	return r->relation_flags == XRT_SPACE_RELATION_BITMASK_ALL &&  //
+	       m_vec3_equal_exact(r->linear_velocity, zero) &&           //
+	       m_vec3_equal_exact(r->angular_velocity, zero);            //
+}
+
+/*!
+ * Get the step at @p index, or if it is a constant offset the precomposed
+ * run of constant offsets starting there, advancing @p index past them.
+ */
+static void
+next_step(const struct xrt_relation_chain *xrc, uint32_t *index, struct xrt_space_relation *out_step)
+{
+	uint32_t i = *index;
+
+	*out_step = xrc->steps[i++];
+
+	if (!is_constant_offset(out_step)) {
+		*index = i;
+		return;
+	}
+
+	for (; i < xrc->step_count && is_constant_offset(&xrc->steps[i]); i++) {
+		math_pose_transform(&xrc->steps[i].pose, &out_step->pose, &out_step->pose);
+	}
+
+	*index = i;
+}
+
 static void
 make_valid_pose(flags flags, const struct xrt_pose *in_pose, struct xrt_pose *out_pose)
 {
@@ -128,11 +166,18 @@ make_valid_pose(flags flags, const struct xrt_pose *in_pose, struct xrt_pose *ou
 static void
 apply_relation(const struct xrt_space_relation *a,
                const struct xrt_space_relation *b,
+               bool with_velocities,
                struct xrt_space_relation *out_relation)
 {
 	flags af = get_flags(a);
 	flags bf = get_flags(b);
 
+	// Not asked for, so don't pay for them.
+	if (!with_velocities) {
+		af.has_linear_velocity = false;
+		af.has_angular_velocity = false;
+	}
+
 	struct xrt_pose pose = XRT_POSE_IDENTITY;
 	struct xrt_vec3 linear_velocity = XRT_VEC3_ZERO;
 	struct xrt_vec3 angular_velocity = XRT_VEC3_ZERO;
@@ -277,24 +322,35 @@ apply_relation(const struct xrt_space_relation *a,
 	*out_relation = tmp;
 }
 
-
-/*
- *
- * Exported functions.
- *
- */
-
-extern "C" void
-m_relation_chain_resolve(const struct xrt_relation_chain *xrc, struct xrt_space_relation *out_relation)
+static void
+resolve(const struct xrt_relation_chain *xrc, bool with_velocities, struct xrt_space_relation *out_relation)
 {
 	if (xrc->step_count == 0 || has_step_with_no_pose(xrc)) {
 		*out_relation = XRT_SPACE_RELATION_ZERO;
 		return;
 	}
 
-	struct xrt_space_relation r = xrc->steps[0];
-	for (uint32_t i = 1; i < xrc->step_count; i++) {
-		apply_relation(&r, &xrc->steps[i], &r);
+	/*
+	 * Runs of constant offsets are composed on their own first, that is
+	 * only pose maths, instead of going through the full relation
+	 * composition with its flags and velocities for each of them.
+	 */
+	uint32_t i = 0;
+	struct xrt_space_relation r;
+	next_step(xrc, &i, &r);
+
+	if (!with_velocities) {
+		r.relation_flags = (enum xrt_space_relation_flags)(r.relation_flags &
+		                                                   ~(XRT_SPACE_RELATION_LINEAR_VELOCITY_VALID_BIT |
+		                                                     XRT_SPACE_RELATION_ANGULAR_VELOCITY_VALID_BIT));
+		r.linear_velocity = XRT_VEC3_ZERO;
+		r.angular_velocity = XRT_VEC3_ZERO;
+	}
+
+	while (i < xrc->step_count) {
+		struct xrt_space_relation step;
+		next_step(xrc, &i, &step);
+		apply_relation(&r, &step, with_velocities, &r);
 	}
 
 #if 0
@@ -311,6 +367,25 @@ m_relation_chain_resolve(const struct xrt_relation_chain *xrc, struct xrt_space_
 	*out_relation = r;
 }
 
+
+/*
+ *
+ * Exported functions.
+ *
+ */
+
+extern "C" void
+m_relation_chain_resolve(const struct xrt_relation_chain *xrc, struct xrt_space_relation *out_relation)
+{
+	resolve(xrc, true, out_relation);
+}
+
+extern "C" void
+m_relation_chain_resolve_pose(const struct xrt_relation_chain *xrc, struct xrt_space_relation *out_relation)
+{
+	resolve(xrc, false, out_relation);
+}
+
 extern "C" void
 m_space_relation_invert(struct xrt_space_relation *relation, struct xrt_space_relation *out_relation)
 {
@@ -220,6 +220,16 @@ m_relation_chain_push_inverted_pose_if_not_identity(struct xrt_relation_chain *x
 void
 m_relation_chain_resolve(const struct xrt_relation_chain *xrc, struct xrt_space_relation *out_relation);
 
+/*!
+ * Same as @ref m_relation_chain_resolve but skips all of the velocity maths,
+ * for callers that only need the pose. The velocities of @p out_relation are
+ * zero and their valid flags are not set.
+ *
+ * @public @memberof xrt_relation_chain
+ */
+void
+m_relation_chain_resolve_pose(const struct xrt_relation_chain *xrc, struct xrt_space_relation *out_relation);
+
 /*!
  * @}
  */
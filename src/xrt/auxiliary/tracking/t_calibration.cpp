@@ -12,15 +12,21 @@
 #include "util/u_sink.h"
 #include "util/u_misc.h"
 #include "util/u_debug.h"
-#include "util/u_frame.h"
 #include "util/u_format.h"
 #include "util/u_logging.h"
+#include "util/u_time.h"
+#include "util/u_worker.h"
+
+#include "os/os_time.h"
 
 #include "tracking/t_tracking.h"
 #include "tracking/t_calibration_opencv.hpp"
+#include "tracking/t_frame_cv_mat_wrapper.hpp"
+#include "tracking/t_helper_stereo_views.hpp"
 
 #include <opencv2/opencv.hpp>
 #include <sys/stat.h>
+#include <atomic>
 #include <utility>
 
 #if CV_MAJOR_VERSION >= 4
@@ -34,6 +40,7 @@
 DEBUG_GET_ONCE_BOOL_OPTION(hsv_filter, "T_DEBUG_HSV_FILTER", false)
 DEBUG_GET_ONCE_BOOL_OPTION(hsv_picker, "T_DEBUG_HSV_PICKER", false)
 DEBUG_GET_ONCE_BOOL_OPTION(hsv_viewer, "T_DEBUG_HSV_VIEWER", false)
+DEBUG_GET_ONCE_NUM_OPTION(coarse_max_cols, "T_CALIBRATION_COARSE_MAX_COLS", 640)
 
 namespace xrt::auxiliary::tracking {
 /*
@@ -61,6 +68,9 @@ typedef std::vector<MeasurementF64> ArrayOfMeasurementF64s;
 //! A array of bounding rects.
 typedef std::vector<cv::Rect> ArrayOfRects;
 
+//! Max number of times the image is halved for the coarse board search.
+#define MAX_COARSE_LEVELS (3)
+
 /*!
  * Current state for each view, one view for mono cameras, two for stereo.
  */
@@ -83,6 +93,9 @@ struct ViewState
 	bool maps_valid = false;
 	cv::Mat map1 = {};
 	cv::Mat map2 = {};
+
+	//! Downscaled images for the coarse board search, reused between frames.
+	std::vector<cv::Mat> pyramid = {};
 };
 
 /*!
@@ -92,12 +105,16 @@ class Calibration
 {
 public:
 	struct xrt_frame_sink base = {};
+	struct xrt_frame_node node = {};
 
 	struct
 	{
 		cv::Mat rgb = {};
 		struct xrt_frame *frame = {};
 		struct xrt_frame_sink *sink = {};
+
+		//! Recycles the frames sent to the gui.
+		std::shared_ptr<FrameMatPool> pool = FrameMatPool::create();
 	} gui;
 
 	struct
@@ -133,11 +150,50 @@ public:
 		uint32_t num_images = 20;
 	} load;
 
+	struct
+	{
+		struct u_worker_thread_pool *pool = {};
+
+		//! Used to detect the board in both views of a stereo frame at the same time.
+		struct u_worker_group *group = {};
+	} worker;
+
+	/*!
+	 * The final solve runs on the worker pool, the frame thread keeps on
+	 * showing frames with the progress until it is done.
+	 */
+	struct
+	{
+		struct u_worker_group *group = {};
+
+		bool started = false;
+		std::atomic<bool> done{false};
+
+		//! What the solve is currently doing, for the progress text.
+		std::atomic<const char *> stage{""};
+		uint64_t start_ns = 0;
+
+		bool stereo = false;
+		int cols = 0;
+		int rows = 0;
+
+		//! Results, only read once @p done is set.
+		double rp_error = 0.0;
+		struct t_stereo_camera_calibration *stereo_data = {};
+	} solve;
+
 	//! Should we use subpixel enhancing for checkerboard.
 	bool subpixel_enable = true;
 	//! What subpixel range for checkerboard enhancement.
 	int subpixel_size = 5;
 
+	/*!
+	 * The checkerboard search is done on an image halved until it is no
+	 * wider than this, the corners are then refined on the full image.
+	 * Zero disables the coarse search.
+	 */
+	int coarse_max_cols = 640;
+
 	//! Number of frames to wait for cooldown.
 	uint32_t num_cooldown_frames = 20;
 	//! Number of frames to wait for before collecting.
@@ -187,10 +243,8 @@ to_stdout(const char *name, const cv::Mat &mat)
 static void
 refresh_gui_frame(class Calibration &c, int rows, int cols)
 {
-	// Also dereferences the old frame.
-	u_frame_create_one_off(XRT_FORMAT_R8G8B8, cols, rows, &c.gui.frame);
-
-	c.gui.rgb = cv::Mat(rows, cols, CV_8UC3, c.gui.frame->data, c.gui.frame->stride);
+	// Also dereferences the old frame, rgb points at the new frame's data.
+	c.gui.pool->allocR8G8B8(rows, cols, &c.gui.frame, c.gui.rgb);
 }
 
 static void
@@ -301,28 +355,14 @@ do_view_chess(class Calibration &c, struct ViewState &view, cv::Mat &gray, cv::M
 	 * current_f32 here and convert below.
 	 */
 
-	int flags = 0;
-	flags += cv::CALIB_CB_FAST_CHECK;
-	flags += cv::CALIB_CB_ADAPTIVE_THRESH;
-	flags += cv::CALIB_CB_NORMALIZE_IMAGE;
-
-	bool found = cv::findChessboardCorners(gray,             // Image
-	                                       c.board.dims,     // patternSize
-	                                       view.current_f32, // corners
-	                                       flags);           // flags
-
-	// Improve the corner positions.
-	if (found && c.subpixel_enable) {
-		int crit_flag = 0;
-		crit_flag |= cv::TermCriteria::EPS;
-		crit_flag |= cv::TermCriteria::COUNT;
-		cv::TermCriteria term_criteria = {crit_flag, 30, 0.1};
-
-		cv::Size size(c.subpixel_size, c.subpixel_size);
-		cv::Size zero(-1, -1);
-
-		cv::cornerSubPix(gray, view.current_f32, size, zero, term_criteria);
-	}
+	bool found = calibration_find_chessboard_corners( //
+	    gray,                                         // gray
+	    c.board.dims,                                 // dims
+	    c.coarse_max_cols,                            // coarse_max_cols
+	    c.subpixel_enable,                            // subpixel_enable
+	    c.subpixel_size,                              // subpixel_size
+	    view.pyramid,                                 // pyramid
+	    view.current_f32);                            // out_corners
 
 	// Do the conversion here.
 	view.current_f64.clear(); // Doesn't effect capacity.
@@ -570,8 +610,6 @@ moved_state_check(struct ViewState &view)
 XRT_NO_INLINE static void
 process_stereo_samples(class Calibration &c, int cols, int rows)
 {
-	c.state.calibrated = true;
-
 	cv::Size image_size(cols, rows);
 	cv::Size new_image_size(cols, rows);
 
@@ -581,6 +619,8 @@ process_stereo_samples(class Calibration &c, int cols, int rows)
 	wrapped.view[1].image_size_pixels = wrapped.view[0].image_size_pixels;
 
 
+	c.solve.stage = "STEREO CALIBRATE";
+
 	float rp_error = 0.0f;
 	if (c.use_fisheye) {
 		int flags = 0;
@@ -619,8 +659,10 @@ process_stereo_samples(class Calibration &c, int cols, int rows)
 		                               flags);                         // flags
 	}
 
-	// Tell the user what has happened.
-	P("CALIBRATION DONE RP ERROR %f", rp_error);
+	// Told to the user on the frame thread once done.
+	c.solve.rp_error = rp_error;
+
+	c.solve.stage = "RECTIFICATION MAPS";
 
 	// Preview undistortion/rectification.
 	StereoRectificationMaps maps(wrapped.base);
@@ -655,9 +697,8 @@ process_stereo_samples(class Calibration &c, int cols, int rows)
 	// Validate that nothing has been re-allocated.
 	assert(wrapped.isDataStorageValid());
 
-	if (c.status != NULL) {
-		t_stereo_camera_calibration_reference(&c.status->stereo_data, wrapped.base);
-	}
+	// Handed to the status on the frame thread once done.
+	t_stereo_camera_calibration_reference(&c.solve.stereo_data, wrapped.base);
 }
 
 static void
@@ -683,6 +724,8 @@ process_view_samples(class Calibration &c, struct ViewState &view, int cols, int
 		U_LOG_RAW("};");
 	}
 
+	c.solve.stage = "CALIBRATE CAMERA";
+
 	if (c.use_fisheye) {
 		int crit_flag = 0;
 		crit_flag |= cv::TermCriteria::EPS;
@@ -749,7 +792,8 @@ process_view_samples(class Calibration &c, struct ViewState &view, int cols, int
 		                                                   false);         // centerPrincipalPoint
 	}
 
-	P("CALIBRATION DONE RP ERROR %f", rp_error);
+	// Told to the user on the frame thread once done.
+	c.solve.rp_error = rp_error;
 
 	// clang-format off
 	std::cout << "image_size: " << image_size << "\n";
@@ -759,6 +803,8 @@ process_view_samples(class Calibration &c, struct ViewState &view, int cols, int
 		std::cout << "distortion_mat:\n" << distortion_mat << "\n";
 	// clang-format on
 
+	c.solve.stage = "UNDISTORTION MAPS";
+
 	if (c.use_fisheye) {
 		cv::fisheye::initUndistortRectifyMap(intrinsics_mat,     // K
 		                                     distortion_mat,     // D
@@ -785,8 +831,74 @@ process_view_samples(class Calibration &c, struct ViewState &view, int cols, int
 		// Set the maps as valid.
 		view.maps_valid = true;
 	}
+}
+
+static void
+solve_task(void *ptr)
+{
+	auto &c = *(class Calibration *)ptr;
+
+	if (c.solve.stereo) {
+		process_stereo_samples(c, c.solve.cols, c.solve.rows);
+	} else {
+		process_view_samples(c, c.state.view[0], c.solve.cols, c.solve.rows);
+	}
+
+	// Publishes all of the results above to the frame thread.
+	c.solve.done = true;
+}
+
+/*!
+ * Kicks off the solve on the worker pool, no new samples are collected while
+ * it runs so it can freely read them.
+ */
+static void
+start_solve(class Calibration &c, bool stereo, int cols, int rows)
+{
+	if (c.solve.started) {
+		return;
+	}
+
+	c.solve.started = true;
+	c.solve.stereo = stereo;
+	c.solve.cols = cols;
+	c.solve.rows = rows;
+	c.solve.start_ns = os_monotonic_get_ns();
+	c.solve.stage = "STARTING";
+
+	u_worker_group_push(c.solve.group, solve_task, &c);
+
+	int num = (int)c.state.board_models_f32.size();
+	P("(%i/%i) SOLVING", num, num);
+}
+
+/*!
+ * Checks on a started solve, writing the progress or the result to the text.
+ * Returns true once the solve is done and the state is calibrated.
+ */
+static bool
+check_solve(class Calibration &c)
+{
+	if (!c.solve.done) {
+		time_duration_ns diff_ns = (time_duration_ns)(os_monotonic_get_ns() - c.solve.start_ns);
+		P("SOLVING %s %.1fs", c.solve.stage.load(), time_ns_to_s(diff_ns));
+		return false;
+	}
+
+	// Already done, this just cleans up the group.
+	u_worker_group_wait_all(c.solve.group);
+
+	// Tell the user what has happened.
+	P("CALIBRATION DONE RP ERROR %f", c.solve.rp_error);
 
 	c.state.calibrated = true;
+
+	if (c.status != NULL) {
+		t_stereo_camera_calibration_reference(&c.status->stereo_data, c.solve.stereo_data);
+		c.status->finished = true;
+	}
+
+	return true;
 }
 
 static void
@@ -964,7 +1076,7 @@ make_calibration_frame_mono(class Calibration &c)
 	do_capture_logic_mono(c, c.state.view[0], found, gray, rgb);
 
 	if (c.state.board_models_f32.size() >= c.num_collect_total) {
-		process_view_samples(c, c.state.view[0], rgb.cols, rgb.rows);
+		start_solve(c, false, rgb.cols, rgb.rows);
 	}
 
 	// Draw text and finally send the frame off.
@@ -990,14 +1102,20 @@ make_calibration_frame_sbs(class Calibration &c)
 	cv::Mat l_rgb(rows, cols, CV_8UC3, c.gui.frame->data, c.gui.frame->stride);
 	cv::Mat r_rgb(rows, cols, CV_8UC3, c.gui.frame->data + 3 * cols, c.gui.frame->stride);
 
-	bool found_left = do_view(c, c.state.view[0], l_gray, l_rgb);
-	bool found_right = do_view(c, c.state.view[1], r_gray, r_rgb);
+	// Each view only touches its own state and half of the rgb image.
+	bool found[2] = {false, false};
+	run_stereo_views(c.worker.group, [&](int i) {
+		found[i] = do_view(c, c.state.view[i], i == 0 ? l_gray : r_gray, i == 0 ? l_rgb : r_rgb);
+	});
+
+	bool found_left = found[0];
+	bool found_right = found[1];
 
 	do_capture_logic_stereo(c, gray, rgb, found_left, c.state.view[0], l_gray, l_rgb, found_right, c.state.view[1],
 	                        r_gray, r_rgb);
 
 	if (c.state.board_models_f32.size() >= c.num_collect_total) {
-		process_stereo_samples(c, cols, rows);
+		start_solve(c, true, cols, rows);
 	}
 
 	// Draw text and finally send the frame off.
@@ -1016,10 +1134,6 @@ make_calibration_frame(class Calibration &c, struct xrt_frame *xf)
 		make_gui_str(c);
 		return;
 	}
-
-	if (c.status != NULL && c.state.calibrated) {
-		c.status->finished = true;
-	}
 }
 
 static void
@@ -1153,7 +1267,7 @@ process_load_image(class Calibration &c, struct xrt_frame *xf)
 
 	for (uint32_t i = 0; i < c.load.num_images; i++) {
 		// Early out if the user requested less images.
-		if (c.state.calibrated) {
+		if (c.solve.started) {
 			break;
 		}
 
@@ -1222,6 +1336,14 @@ t_calibration_frame(struct xrt_frame_sink *xsink, struct xrt_frame *xf)
 		return;
 	}
 
+	// Only show the progress while solving, no new samples are collected.
+	if (c.solve.started && !c.state.calibrated && !check_solve(c)) {
+		print_txt(c.gui.rgb, c.text, 1.5);
+
+		send_rgb_frame(c);
+		return;
+	}
+
 	// Don't do anything if we are done.
 	if (c.state.calibrated) {
 		make_remap_view(c, xf);
@@ -1242,12 +1364,99 @@ t_calibration_frame(struct xrt_frame_sink *xsink, struct xrt_frame *xf)
 }
 
 
+extern "C" void
+t_calibration_node_break_apart(struct xrt_frame_node *node)
+{
+	auto &c = *container_of(node, Calibration, node);
+
+	// The solve can't be stopped, wait for it to finish.
+	u_worker_group_wait_all(c.solve.group);
+}
+
+extern "C" void
+t_calibration_node_destroy(struct xrt_frame_node *node)
+{
+	auto *c_ptr = container_of(node, Calibration, node);
+
+	u_worker_group_reference(&c_ptr->solve.group, NULL);
+	u_worker_group_reference(&c_ptr->worker.group, NULL);
+	u_worker_thread_pool_reference(&c_ptr->worker.pool, NULL);
+
+	t_stereo_camera_calibration_reference(&c_ptr->solve.stereo_data, NULL);
+	xrt_frame_reference(&c_ptr->gui.frame, NULL);
+
+	delete c_ptr;
+}
+
+
 /*
  *
  * Exported functions.
  *
  */
 
+bool
+calibration_find_chessboard_corners(cv::Mat &gray,
+                                    cv::Size dims,
+                                    int coarse_max_cols,
+                                    bool subpixel_enable,
+                                    int subpixel_size,
+                                    std::vector<cv::Mat> &pyramid,
+                                    std::vector<cv::Point2f> &out_corners)
+{
+	// Halve the image until it is narrow enough, no allocations once the frame size is stable.
+	cv::Mat *search = &gray;
+	int scale = 1;
+
+	for (int i = 0; i < MAX_COARSE_LEVELS; i++) {
+		if (coarse_max_cols <= 0 || search->cols <= coarse_max_cols) {
+			break;
+		}
+
+		if ((int)pyramid.size() <= i) {
+			pyramid.resize(i + 1);
+		}
+
+		cv::pyrDown(*search, pyramid[i]);
+		search = &pyramid[i];
+		scale *= 2;
+	}
+
+	int flags = 0;
+	flags += cv::CALIB_CB_FAST_CHECK;
+	flags += cv::CALIB_CB_ADAPTIVE_THRESH;
+	flags += cv::CALIB_CB_NORMALIZE_IMAGE;
+
+	bool found = cv::findChessboardCorners(*search,     // Image
+	                                       dims,        // patternSize
+	                                       out_corners, // corners
+	                                       flags);      // flags
+
+	// Back to full resolution, also for partial hits so drawing works.
+	if (scale > 1) {
+		for (cv::Point2f &p : out_corners) {
+			p *= (float)scale;
+		}
+	}
+
+	// Improve the corner positions, always needed after a coarse search.
+	if (found && (subpixel_enable || scale > 1)) {
+		int crit_flag = 0;
+		crit_flag |= cv::TermCriteria::EPS;
+		crit_flag |= cv::TermCriteria::COUNT;
+		cv::TermCriteria term_criteria = {crit_flag, 30, 0.1};
+
+		// The window needs to cover the error of the coarse corners.
+		int half = std::max(subpixel_size, scale * 2);
+		cv::Size size(half, half);
+		cv::Size zero(-1, -1);
+
+		cv::cornerSubPix(gray, out_corners, size, zero, term_criteria);
+	}
+
+	return found;
+}
+
 extern "C" int
 t_calibration_stereo_create(struct xrt_frame_context *xfctx,
                             const struct t_calibration_params *params,
@@ -1273,8 +1482,17 @@ t_calibration_stereo_create(struct xrt_frame_context *xfctx,
 	// Basic setup.
 	c.gui.sink = gui;
 	c.base.push_frame = t_calibration_frame;
+	c.node.break_apart = t_calibration_node_break_apart;
+	c.node.destroy = t_calibration_node_destroy;
 	*out_sink = &c.base;
 
+	// One thread for each view, the solve also runs here.
+	c.worker.pool = u_worker_thread_pool_create(1, 2, "Calibration");
+	c.worker.group = u_worker_group_create(c.worker.pool);
+	c.solve.group = u_worker_group_create(c.worker.pool);
+
+	xrt_frame_context_add(xfctx, &c.node);
+
 	// Copy the parameters.
 	c.use_fisheye = params->use_fisheye;
 	c.stereo_sbs = params->stereo_sbs;
@@ -1322,6 +1540,7 @@ t_calibration_stereo_create(struct xrt_frame_context *xfctx,
 	c.load.num_images = params->load.num_images;
 	c.mirror_rgb_image = params->mirror_rgb_image;
 	c.save_images = params->save_images;
+	c.coarse_max_cols = (int)debug_get_num_option_coarse_max_cols();
 	c.status = status;
 
 
@@ -179,6 +179,47 @@ calibration_get_undistort_map(t_camera_calibration &calib,
                               cv::InputArray rectify_transform_optional = cv::noArray(),
                               cv::Mat new_camera_matrix_optional = cv::Mat());
 
+/*!
+ * @brief Undistort and rectify a few points, the sparse counterpart of
+ * remapping a whole image with calibration_get_undistort_map().
+ *
+ * @param calib A single camera calibration structure.
+ * @param rectify_transform The rectification transform given to
+ * calibration_get_undistort_map(), may be empty.
+ * @param new_camera_matrix The camera or projection matrix given to
+ * calibration_get_undistort_map(), may be empty.
+ * @param[in,out] points Points in the original image, replaced with where
+ * they land in the remapped one.
+ */
+void
+calibration_undistort_points(t_camera_calibration &calib,
+                             const cv::Mat &rectify_transform,
+                             const cv::Mat &new_camera_matrix,
+                             std::vector<cv::Point2f> &points);
+
+/*!
+ * @brief Find the inner corners of a chessboard. On large images the search is
+ * done on @p gray halved until it is no wider than @p coarse_max_cols, the
+ * corners are then refined with cornerSubPix on @p gray itself.
+ *
+ * @param gray Full resolution image.
+ * @param dims Inner corners of the board, in columns and rows.
+ * @param coarse_max_cols Widest image searched, zero always searches @p gray.
+ * @param subpixel_enable Refine the corners even if @p gray was searched.
+ * @param subpixel_size Smallest half size of the cornerSubPix window.
+ * @param pyramid Storage for the downscaled images, reused between calls.
+ * @param[out] out_corners Corners in @p gray pixels, also for partial hits.
+ * @return true if the whole board was found.
+ */
+bool
+calibration_find_chessboard_corners(cv::Mat &gray,
+                                    cv::Size dims,
+                                    int coarse_max_cols,
+                                    bool subpixel_enable,
+                                    int subpixel_size,
+                                    std::vector<cv::Mat> &pyramid,
+                                    std::vector<cv::Point2f> &out_corners);
+
 /*!
  * @brief Rectification, rotation, projection data for a single view in a stereo
  * pair.
@@ -0,0 +1,736 @@
+// Copyright 2025, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Compact binary container for SLAM and hand tracking datasets.
+ * @author agent <agent@local>
+ * @ingroup aux_tracking
+ */
+
+#include "os/os_threading.h"
+#include "util/u_format.h"
+#include "util/u_logging.h"
+#include "util/u_misc.h"
+
+#include "t_capture.h"
+
+#include <assert.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+/*
+ *
+ * Structs and defines.
+ *
+ */
+
+// Structs are written as is, make sure they have no implicit padding.
+static_assert(sizeof(struct t_capture_file_header) == 32, "Unexpected file header size");
+static_assert(sizeof(struct t_capture_chunk_header) == 16, "Unexpected chunk header size");
+static_assert(sizeof(struct t_capture_frame_header) == 32, "Unexpected frame header size");
+static_assert(sizeof(struct t_capture_imu_sample) == 56, "Unexpected IMU sample size");
+static_assert(sizeof(struct t_capture_pose_sample) == 40, "Unexpected pose sample size");
+static_assert(sizeof(struct t_capture_index_entry) == 24, "Unexpected index entry size");
+
+//! Chunks start 8 byte aligned.
+#define ALIGN_SIZE(size) (((size) + 7) & ~(uint64_t)7)
+
+struct t_capture_writer
+{
+	//! Protects everything below.
+	struct os_mutex mutex;
+
+	FILE *file;
+
+	//! Offset of the next chunk.
+	uint64_t offset;
+
+	//! Set on the first write error, later writes are skipped.
+	bool failed;
+
+	uint32_t cam_count;
+
+	struct t_capture_index_entry *index;
+	size_t index_count;
+	size_t index_capacity;
+};
+
+/*!
+ * A frame pointing into the mapping of a reader.
+ *
+ * @implements xrt_frame
+ */
+struct t_capture_frame
+{
+	struct xrt_frame base;
+
+	struct t_capture_reader *reader;
+};
+
+
+/*
+ *
+ * Writer functions.
+ *
+ */
+
+static void
+write_locked(struct t_capture_writer *w, const void *data, size_t size)
+{
+	if (w->failed || size == 0) {
+		return;
+	}
+
+	if (fwrite(data, 1, size, w->file) != size) {
+		U_LOG_E("Failed to write to capture file, the rest of the recording is lost");
+		w->failed = true;
+		return;
+	}
+
+	w->offset += size;
+}
+
+static void
+write_padding_locked(struct t_capture_writer *w, uint64_t size)
+{
+	static const uint8_t zeros[8] = {0};
+	write_locked(w, zeros, ALIGN_SIZE(size) - size);
+}
+
+static void
+add_index_entry_locked(struct t_capture_writer *w, uint32_t type, uint32_t cam_index, int64_t timestamp_ns)
+{
+	if (w->index_count == w->index_capacity) {
+		w->index_capacity = w->index_capacity == 0 ? 1024 : w->index_capacity * 2;
+		U_ARRAY_REALLOC_OR_FREE(w->index, struct t_capture_index_entry, w->index_capacity);
+		if (w->index == NULL) {
+			U_LOG_E("Failed to grow capture index");
+			w->index_count = 0;
+			w->index_capacity = 0;
+			w->failed = true;
+			return;
+		}
+	}
+
+	w->index[w->index_count++] = (struct t_capture_index_entry){
+	    .timestamp_ns = timestamp_ns,
+	    .offset = w->offset,
+	    .type = type,
+	    .cam_index = cam_index,
+	};
+}
+
+static void
+write_chunk_header_locked(
+    struct t_capture_writer *w, uint32_t type, uint32_t count, uint64_t payload_size, uint32_t cam_index, int64_t ts)
+{
+	add_index_entry_locked(w, type, cam_index, ts);
+
+	struct t_capture_chunk_header ch = {
+	    .type = type,
+	    .count = count,
+	    .size = ALIGN_SIZE(payload_size),
+	};
+	write_locked(w, &ch, sizeof(ch));
+}
+
+static int
+write_index_locked(struct t_capture_writer *w)
+{
+	uint64_t index_offset = w->offset;
+
+	struct t_capture_chunk_header ch = {
+	    .type = T_CAPTURE_CHUNK_INDEX,
+	    .count = (uint32_t)w->index_count,
+	    .size = sizeof(struct t_capture_index_entry) * w->index_count,
+	};
+	write_locked(w, &ch, sizeof(ch));
+	write_locked(w, w->index, sizeof(struct t_capture_index_entry) * w->index_count);
+
+	if (w->failed) {
+		return -1;
+	}
+
+	// Readers only trust the index once the header points at it.
+	if (fseek(w->file, offsetof(struct t_capture_file_header, index_offset), SEEK_SET) != 0 ||
+	    fwrite(&index_offset, sizeof(index_offset), 1, w->file) != 1) {
+		U_LOG_E("Failed to write capture index offset");
+		return -1;
+	}
+
+	return 0;
+}
+
+
+/*
+ *
+ * Reader functions.
+ *
+ */
+
+static void
+capture_frame_destroy(struct xrt_frame *xf)
+{
+	struct t_capture_frame *cf = (struct t_capture_frame *)xf;
+	t_capture_reader_reference(&cf->reader, NULL);
+	free(cf);
+}
+
+static void
+reader_destroy(struct t_capture_reader *r)
+{
+	for (uint32_t i = 0; i < ARRAY_SIZE(r->frames); i++) {
+		free(r->frames[i]);
+	}
+	free(r->imus);
+	free(r->gts);
+
+	if (r->data != NULL) {
+		munmap(r->data, r->size);
+	}
+
+	free(r);
+}
+
+static int
+compare_frame_refs(const void *a, const void *b)
+{
+	const struct t_capture_frame_ref *fa = (const struct t_capture_frame_ref *)a;
+	const struct t_capture_frame_ref *fb = (const struct t_capture_frame_ref *)b;
+	return (fa->timestamp_ns > fb->timestamp_ns) - (fa->timestamp_ns < fb->timestamp_ns);
+}
+
+//! Returns the chunk at @p offset if it is fully inside the mapping.
+static const struct t_capture_chunk_header *
+get_chunk(const struct t_capture_reader *r, uint64_t offset)
+{
+	if (offset % 8 != 0 || offset > r->size || r->size - offset < sizeof(struct t_capture_chunk_header)) {
+		return NULL;
+	}
+
+	const struct t_capture_chunk_header *ch = (const struct t_capture_chunk_header *)(r->data + offset);
+	if (ch->size > r->size - offset - sizeof(*ch)) {
+		return NULL;
+	}
+
+	return ch;
+}
+
+static const void *
+get_payload(const struct t_capture_chunk_header *ch)
+{
+	return (const uint8_t *)ch + sizeof(*ch);
+}
+
+static bool
+is_frame_valid(const struct t_capture_reader *r, const struct t_capture_chunk_header *ch)
+{
+	if (ch->size < sizeof(struct t_capture_frame_header)) {
+		return false;
+	}
+
+	const struct t_capture_frame_header *fh = get_payload(ch);
+	if (fh->cam_index >= r->cam_count || fh->compression != T_CAPTURE_COMPRESSION_NONE) {
+		return false;
+	}
+	if (fh->format != XRT_FORMAT_L8 && fh->format != XRT_FORMAT_R8G8B8) {
+		return false;
+	}
+
+	uint64_t pixels_size = (uint64_t)fh->stride * fh->height;
+	return fh->stride >= fh->width * u_format_block_size(fh->format) &&
+	       pixels_size <= ch->size - sizeof(struct t_capture_frame_header);
+}
+
+/*!
+ * Walk all chunks from the start of the file, used when the file has no
+ * index because it was never closed. Stops at the first truncated chunk.
+ */
+static int
+scan_chunks(const struct t_capture_reader *r, struct t_capture_index_entry **out_entries, size_t *out_count)
+{
+	size_t capacity = 1024;
+	size_t count = 0;
+	struct t_capture_index_entry *entries = U_TYPED_ARRAY_CALLOC(struct t_capture_index_entry, capacity);
+
+	uint64_t offset = sizeof(struct t_capture_file_header);
+	const struct t_capture_chunk_header *ch = NULL;
+	while (entries != NULL && (ch = get_chunk(r, offset)) != NULL && ch->type != T_CAPTURE_CHUNK_INDEX) {
+		if (count == capacity) {
+			capacity *= 2;
+			U_ARRAY_REALLOC_OR_FREE(entries, struct t_capture_index_entry, capacity);
+			if (entries == NULL) {
+				break;
+			}
+		}
+
+		// Only the type and offset are needed, the rest is read from the chunk.
+		entries[count++] = (struct t_capture_index_entry){.offset = offset, .type = ch->type};
+		offset += sizeof(*ch) + ch->size;
+	}
+
+	if (entries == NULL) {
+		U_LOG_E("Failed to allocate capture index");
+		return -1;
+	}
+
+	*out_entries = entries;
+	*out_count = count;
+
+	return 0;
+}
+
+static int
+load_index(const struct t_capture_reader *r,
+           const struct t_capture_file_header *fh,
+           struct t_capture_index_entry **out_entries,
+           size_t *out_count)
+{
+	const struct t_capture_chunk_header *ch = fh->index_offset != 0 ? get_chunk(r, fh->index_offset) : NULL;
+	if (ch == NULL || ch->type != T_CAPTURE_CHUNK_INDEX ||
+	    ch->size < (uint64_t)ch->count * sizeof(struct t_capture_index_entry)) {
+		U_LOG_W("Capture file has no valid index, it was probably not closed, scanning it");
+		return scan_chunks(r, out_entries, out_count);
+	}
+
+	struct t_capture_index_entry *entries = U_TYPED_ARRAY_CALLOC(struct t_capture_index_entry, ch->count + 1);
+	if (entries == NULL) {
+		U_LOG_E("Failed to allocate capture index");
+		return -1;
+	}
+	memcpy(entries, get_payload(ch), sizeof(struct t_capture_index_entry) * ch->count);
+
+	*out_entries = entries;
+	*out_count = ch->count;
+
+	return 0;
+}
+
+static int
+reader_build(struct t_capture_reader *r, const struct t_capture_index_entry *entries, size_t entry_count)
+{
+	// First count everything so each array is allocated once.
+	uint32_t frame_counts[XRT_TRACKING_MAX_SLAM_CAMS] = {0};
+	uint64_t imu_count = 0;
+	uint64_t gt_count = 0;
+
+	for (size_t i = 0; i < entry_count; i++) {
+		const struct t_capture_chunk_header *ch = get_chunk(r, entries[i].offset);
+		if (ch == NULL || ch->type != entries[i].type) {
+			U_LOG_E("Capture index entry %zu points to an invalid chunk", i);
+			return -1;
+		}
+
+		switch (ch->type) {
+		case T_CAPTURE_CHUNK_FRAME:
+			if (!is_frame_valid(r, ch)) {
+				U_LOG_E("Invalid frame chunk at offset %" PRIu64, entries[i].offset);
+				return -1;
+			}
+			frame_counts[((const struct t_capture_frame_header *)get_payload(ch))->cam_index]++;
+			break;
+		case T_CAPTURE_CHUNK_IMU:
+			if (ch->size < (uint64_t)ch->count * sizeof(struct t_capture_imu_sample)) {
+				U_LOG_E("Invalid IMU chunk at offset %" PRIu64, entries[i].offset);
+				return -1;
+			}
+			imu_count += ch->count;
+			break;
+		case T_CAPTURE_CHUNK_GT:
+			if (ch->size < (uint64_t)ch->count * sizeof(struct t_capture_pose_sample)) {
+				U_LOG_E("Invalid groundtruth chunk at offset %" PRIu64, entries[i].offset);
+				return -1;
+			}
+			gt_count += ch->count;
+			break;
+		default: U_LOG_W("Skipping unknown capture chunk type %u", ch->type); break;
+		}
+	}
+
+	for (uint32_t i = 0; i < r->cam_count; i++) {
+		r->frames[i] = U_TYPED_ARRAY_CALLOC(struct t_capture_frame_ref, frame_counts[i] + 1);
+		if (r->frames[i] == NULL) {
+			return -1;
+		}
+	}
+	r->imus = U_TYPED_ARRAY_CALLOC(struct xrt_imu_sample, imu_count + 1);
+	r->gts = U_TYPED_ARRAY_CALLOC(struct xrt_pose_sample, gt_count + 1);
+	if (r->imus == NULL || r->gts == NULL) {
+		return -1;
+	}
+
+	for (size_t i = 0; i < entry_count; i++) {
+		const struct t_capture_chunk_header *ch = get_chunk(r, entries[i].offset);
+
+		if (ch->type == T_CAPTURE_CHUNK_FRAME) {
+			const struct t_capture_frame_header *fh = get_payload(ch);
+			r->frames[fh->cam_index][r->frame_counts[fh->cam_index]++] = (struct t_capture_frame_ref){
+			    .timestamp_ns = fh->timestamp_ns,
+			    .header = fh,
+			};
+		} else if (ch->type == T_CAPTURE_CHUNK_IMU) {
+			const struct t_capture_imu_sample *s = get_payload(ch);
+			for (uint32_t k = 0; k < ch->count; k++) {
+				r->imus[r->imu_count++] = (struct xrt_imu_sample){
+				    .timestamp_ns = s[k].timestamp_ns,
+				    .accel_m_s2 = {s[k].accel_m_s2[0], s[k].accel_m_s2[1], s[k].accel_m_s2[2]},
+				    .gyro_rad_secs = {s[k].gyro_rad_secs[0], s[k].gyro_rad_secs[1], s[k].gyro_rad_secs[2]},
+				};
+			}
+		} else if (ch->type == T_CAPTURE_CHUNK_GT) {
+			const struct t_capture_pose_sample *s = get_payload(ch);
+			for (uint32_t k = 0; k < ch->count; k++) {
+				struct xrt_pose_sample *out = &r->gts[r->gt_count++];
+				out->timestamp_ns = s[k].timestamp_ns;
+				out->pose.orientation = (struct xrt_quat){s[k].orientation[0], s[k].orientation[1],
+				                                          s[k].orientation[2], s[k].orientation[3]};
+				out->pose.position = (struct xrt_vec3){s[k].position[0], s[k].position[1], s[k].position[2]};
+			}
+		}
+	}
+
+	// Frames of different cameras are interleaved, and might be written out of order by the recorder.
+	for (uint32_t i = 0; i < r->cam_count; i++) {
+		qsort(r->frames[i], r->frame_counts[i], sizeof(struct t_capture_frame_ref), compare_frame_refs);
+	}
+
+	return 0;
+}
+
+
+/*
+ *
+ * 'Exported' writer functions.
+ *
+ */
+
+int
+t_capture_writer_create(const char *path, uint32_t cam_count, struct t_capture_writer **out_writer)
+{
+	if (cam_count > XRT_TRACKING_MAX_SLAM_CAMS) {
+		U_LOG_E("Too many cameras for a capture file (%u)", cam_count);
+		return -1;
+	}
+
+	FILE *file = fopen(path, "wb");
+	if (file == NULL) {
+		U_LOG_E("Failed to open '%s' for writing", path);
+		return -1;
+	}
+
+	struct t_capture_writer *w = U_TYPED_CALLOC(struct t_capture_writer);
+	if (w == NULL || os_mutex_init(&w->mutex) != 0) {
+		free(w);
+		(void)fclose(file);
+		return -1;
+	}
+
+	w->file = file;
+	w->cam_count = cam_count;
+
+	struct t_capture_file_header fh = {
+	    .magic = T_CAPTURE_MAGIC,
+	    .version = T_CAPTURE_VERSION,
+	    .cam_count = cam_count,
+	    .index_offset = 0,
+	};
+	write_locked(w, &fh, sizeof(fh));
+
+	*out_writer = w;
+
+	return w->failed ? -1 : 0;
+}
+
+int
+t_capture_writer_write_frame(struct t_capture_writer *w, uint32_t cam_index, struct xrt_frame *xf)
+{
+	if (cam_index >= w->cam_count || (xf->format != XRT_FORMAT_L8 && xf->format != XRT_FORMAT_R8G8B8)) {
+		U_LOG_E("Can't write frame of format %s from camera %u", u_format_str(xf->format), cam_index);
+		return -1;
+	}
+
+	uint32_t row_size = xf->width * u_format_block_size(xf->format);
+	uint64_t payload_size = sizeof(struct t_capture_frame_header) + (uint64_t)row_size * xf->height;
+
+	struct t_capture_frame_header fh = {
+	    .timestamp_ns = xf->timestamp,
+	    .cam_index = cam_index,
+	    .format = xf->format,
+	    .width = xf->width,
+	    .height = xf->height,
+	    .stride = row_size,
+	    .compression = T_CAPTURE_COMPRESSION_NONE,
+	};
+
+	os_mutex_lock(&w->mutex);
+
+	write_chunk_header_locked(w, T_CAPTURE_CHUNK_FRAME, 1, payload_size, cam_index, xf->timestamp);
+	write_locked(w, &fh, sizeof(fh));
+
+	if (xf->stride == row_size) {
+		write_locked(w, xf->data, (size_t)row_size * xf->height);
+	} else {
+		for (uint32_t y = 0; y < xf->height; y++) {
+			write_locked(w, xf->data + y * xf->stride, row_size);
+		}
+	}
+	write_padding_locked(w, payload_size);
+
+	bool failed = w->failed;
+
+	os_mutex_unlock(&w->mutex);
+
+	return failed ? -1 : 0;
+}
+
+int
+t_capture_writer_write_imu(struct t_capture_writer *w, const struct xrt_imu_sample *samples, uint32_t count)
+{
+	if (count == 0) {
+		return 0;
+	}
+
+	os_mutex_lock(&w->mutex);
+
+	uint64_t payload_size = sizeof(struct t_capture_imu_sample) * (uint64_t)count;
+	write_chunk_header_locked(w, T_CAPTURE_CHUNK_IMU, count, payload_size, 0, samples[0].timestamp_ns);
+
+	for (uint32_t i = 0; i < count; i++) {
+		const struct xrt_imu_sample *s = &samples[i];
+		struct t_capture_imu_sample out = {
+		    .timestamp_ns = s->timestamp_ns,
+		    .accel_m_s2 = {s->accel_m_s2.x, s->accel_m_s2.y, s->accel_m_s2.z},
+		    .gyro_rad_secs = {s->gyro_rad_secs.x, s->gyro_rad_secs.y, s->gyro_rad_secs.z},
+		};
+		write_locked(w, &out, sizeof(out));
+	}
+
+	bool failed = w->failed;
+
+	os_mutex_unlock(&w->mutex);
+
+	return failed ? -1 : 0;
+}
+
+int
+t_capture_writer_write_gt(struct t_capture_writer *w, const struct xrt_pose_sample *samples, uint32_t count)
+{
+	if (count == 0) {
+		return 0;
+	}
+
+	os_mutex_lock(&w->mutex);
+
+	uint64_t payload_size = sizeof(struct t_capture_pose_sample) * (uint64_t)count;
+	write_chunk_header_locked(w, T_CAPTURE_CHUNK_GT, count, payload_size, 0, samples[0].timestamp_ns);
+
+	for (uint32_t i = 0; i < count; i++) {
+		const struct xrt_pose *p = &samples[i].pose;
+		struct t_capture_pose_sample out = {
+		    .timestamp_ns = samples[i].timestamp_ns,
+		    .orientation = {p->orientation.x, p->orientation.y, p->orientation.z, p->orientation.w},
+		    .position = {p->position.x, p->position.y, p->position.z},
+		};
+		write_locked(w, &out, sizeof(out));
+	}
+
+	bool failed = w->failed;
+
+	os_mutex_unlock(&w->mutex);
+
+	return failed ? -1 : 0;
+}
+
+int
+t_capture_writer_destroy(struct t_capture_writer **writer_ptr)
+{
+	struct t_capture_writer *w = *writer_ptr;
+	if (w == NULL) {
+		return 0;
+	}
+
+	int ret = write_index_locked(w);
+	if (fclose(w->file) != 0) {
+		ret = -1;
+	}
+
+	os_mutex_destroy(&w->mutex);
+	free(w->index);
+	free(w);
+
+	*writer_ptr = NULL;
+
+	return ret;
+}
+
+
+/*
+ *
+ * 'Exported' reader functions.
+ *
+ */
+
+bool
+t_capture_is_capture_file(const char *path)
+{
+	FILE *file = fopen(path, "rb");
+	if (file == NULL) {
+		return false;
+	}
+
+	char magic[sizeof(T_CAPTURE_MAGIC)] = {0};
+	size_t read = fread(magic, 1, sizeof(magic), file);
+	(void)fclose(file);
+
+	return read == sizeof(magic) && memcmp(magic, T_CAPTURE_MAGIC, sizeof(magic)) == 0;
+}
+
+int
+t_capture_reader_open(const char *path, struct t_capture_reader **out_reader)
+{
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		U_LOG_E("Failed to open capture file '%s'", path);
+		return -1;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(struct t_capture_file_header)) {
+		U_LOG_E("Capture file '%s' is too small", path);
+		close(fd);
+		return -1;
+	}
+
+	// Private and writable so sinks writing into frames never touch the file.
+	void *data = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED) {
+		U_LOG_E("Failed to map capture file '%s'", path);
+		return -1;
+	}
+
+	struct t_capture_reader *r = U_TYPED_CALLOC(struct t_capture_reader);
+	if (r == NULL) {
+		munmap(data, st.st_size);
+		return -1;
+	}
+	r->data = data;
+	r->size = st.st_size;
+
+	const struct t_capture_file_header *fh = (const struct t_capture_file_header *)r->data;
+	if (memcmp(fh->magic, T_CAPTURE_MAGIC, sizeof(T_CAPTURE_MAGIC)) != 0 || fh->version != T_CAPTURE_VERSION ||
+	    fh->cam_count > XRT_TRACKING_MAX_SLAM_CAMS) {
+		U_LOG_E("'%s' is not a supported capture file", path);
+		reader_destroy(r);
+		return -1;
+	}
+	r->cam_count = fh->cam_count;
+
+	struct t_capture_index_entry *entries = NULL;
+	size_t entry_count = 0;
+	int ret = load_index(r, fh, &entries, &entry_count);
+	if (ret == 0) {
+		ret = reader_build(r, entries, entry_count);
+	}
+	free(entries);
+
+	if (ret != 0) {
+		U_LOG_E("Failed to read capture file '%s'", path);
+		reader_destroy(r);
+		return -1;
+	}
+
+	// Playback reads frames in order.
+	madvise(r->data, r->size, MADV_SEQUENTIAL);
+
+	t_capture_reader_reference(out_reader, r);
+
+	return 0;
+}
+
+void
+t_capture_reader_reference(struct t_capture_reader **dst, struct t_capture_reader *src)
+{
+	struct t_capture_reader *old_dst = *dst;
+
+	if (old_dst == src) {
+		return;
+	}
+
+	if (src) {
+		xrt_reference_inc(&src->reference);
+	}
+
+	*dst = src;
+
+	if (old_dst) {
+		if (xrt_reference_dec_and_is_zero(&old_dst->reference)) {
+			reader_destroy(old_dst);
+		}
+	}
+}
+
+bool
+t_capture_reader_find_frame(struct t_capture_reader *r, uint32_t cam_index, int64_t timestamp_ns, uint32_t *out_index)
+{
+	assert(cam_index < r->cam_count);
+
+	const struct t_capture_frame_ref *frames = r->frames[cam_index];
+	uint32_t lo = 0;
+	uint32_t hi = r->frame_counts[cam_index];
+
+	while (lo < hi) {
+		uint32_t mid = lo + (hi - lo) / 2;
+		if (frames[mid].timestamp_ns < timestamp_ns) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	if (lo == r->frame_counts[cam_index] || frames[lo].timestamp_ns != timestamp_ns) {
+		return false;
+	}
+
+	*out_index = lo;
+
+	return true;
+}
+
+void
+t_capture_reader_wrap_frame(struct t_capture_reader *r,
+                            uint32_t cam_index,
+                            uint32_t index,
+                            struct xrt_frame **out_frame)
+{
+	assert(cam_index < r->cam_count);
+	assert(index < r->frame_counts[cam_index]);
+
+	const struct t_capture_frame_header *fh = r->frames[cam_index][index].header;
+
+	struct t_capture_frame *cf = U_TYPED_CALLOC(struct t_capture_frame);
+	t_capture_reader_reference(&cf->reader, r);
+
+	struct xrt_frame *xf = &cf->base;
+	xf->destroy = capture_frame_destroy;
+	xf->width = fh->width;
+	xf->height = fh->height;
+	xf->stride = fh->stride;
+	xf->size = (size_t)fh->stride * fh->height;
+	xf->data = (uint8_t *)fh + sizeof(*fh); // Private mapping, so writable.
+	xf->format = (enum xrt_format)fh->format;
+	xf->stereo_format = XRT_STEREO_FORMAT_NONE;
+	xf->timestamp = fh->timestamp_ns;
+	xf->source_timestamp = fh->timestamp_ns;
+	xf->source_sequence = index;
+
+	xrt_frame_reference(out_frame, xf);
+}
@@ -0,0 +1,334 @@
+// Copyright 2025, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Compact binary container for SLAM and hand tracking datasets.
+ * @author agent <agent@local>
+ * @ingroup aux_tracking
+ *
+ * A capture file holds raw camera frames, IMU and groundtruth samples in a
+ * single file, as an alternative to EuRoC datasets that are made up of one
+ * encoded image per frame plus CSV files. Recording only needs to copy frames
+ * so it keeps up with full rate cameras, and playback maps the file and hands
+ * out frames that point straight into the mapping.
+ *
+ * Layout, all values are little endian and every chunk starts 8 byte aligned:
+ *
+ * - @ref t_capture_file_header
+ * - Any number of chunks, a @ref t_capture_chunk_header followed by its payload:
+ *   - @ref T_CAPTURE_CHUNK_FRAME: a @ref t_capture_frame_header and the pixels.
+ *   - @ref T_CAPTURE_CHUNK_IMU: `count` @ref t_capture_imu_sample.
+ *   - @ref T_CAPTURE_CHUNK_GT: `count` @ref t_capture_pose_sample.
+ * - A @ref T_CAPTURE_CHUNK_INDEX chunk of `count` @ref t_capture_index_entry,
+ *   one for each of the chunks above, written when the file is closed.
+ *
+ * The header points at the index once the file is closed, so readers only
+ * touch the index and not every frame. Files that were never closed, say
+ * because the recording crashed, are still readable by walking the chunks.
+ */
+
+#pragma once
+
+#include "xrt/xrt_compiler.h"
+#include "xrt/xrt_frame.h"
+#include "xrt/xrt_tracking.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! First bytes of every capture file.
+#define T_CAPTURE_MAGIC "XRTCAPT"
+
+//! Version written to new files, bumped on incompatible changes.
+#define T_CAPTURE_VERSION 1
+
+//! File extension used by the recorder and converter.
+#define T_CAPTURE_FILE_EXTENSION ".xrtcap"
+
+/*!
+ * Type of a chunk.
+ *
+ * @ingroup aux_tracking
+ */
+enum t_capture_chunk_type
+{
+	T_CAPTURE_CHUNK_FRAME = 1,
+	T_CAPTURE_CHUNK_IMU = 2,
+	T_CAPTURE_CHUNK_GT = 3,
+	T_CAPTURE_CHUNK_INDEX = 4,
+};
+
+/*!
+ * How the pixels of a frame chunk are stored.
+ *
+ * @ingroup aux_tracking
+ */
+enum t_capture_compression
+{
+	//! Rows are stored back to back without padding.
+	T_CAPTURE_COMPRESSION_NONE = 0,
+};
+
+/*!
+ * Start of a capture file.
+ *
+ * @ingroup aux_tracking
+ */
+struct t_capture_file_header
+{
+	char magic[8];         //!< @ref T_CAPTURE_MAGIC including the null terminator
+	uint32_t version;      //!< @ref T_CAPTURE_VERSION
+	uint32_t cam_count;    //!< Number of cameras frames were recorded from
+	uint64_t index_offset; //!< Offset of the index chunk, zero if the file was not closed
+	uint64_t reserved;
+};
+
+/*!
+ * Start of each chunk, the payload of `size` bytes follows.
+ *
+ * @ingroup aux_tracking
+ */
+struct t_capture_chunk_header
+{
+	uint32_t type;  //!< @ref t_capture_chunk_type
+	uint32_t count; //!< Number of samples or entries in the chunk, one for frames
+	uint64_t size;  //!< Size of the payload, a multiple of 8
+};
+
+/*!
+ * Payload header of a frame chunk, the pixels follow.
+ *
+ * @ingroup aux_tracking
+ */
+struct t_capture_frame_header
+{
+	int64_t timestamp_ns;
+	uint32_t cam_index;
+	uint32_t format; //!< @ref xrt_format, only L8 and R8G8B8 are written
+	uint32_t width;
+	uint32_t height;
+	uint32_t stride;
+	uint32_t compression; //!< @ref t_capture_compression
+};
+
+/*!
+ * IMU sample as stored in an IMU chunk.
+ *
+ * @ingroup aux_tracking
+ */
+struct t_capture_imu_sample
+{
+	int64_t timestamp_ns;
+	double accel_m_s2[3];
+	double gyro_rad_secs[3];
+};
+
+/*!
+ * Groundtruth pose as stored in a groundtruth chunk.
+ *
+ * @ingroup aux_tracking
+ */
+struct t_capture_pose_sample
+{
+	int64_t timestamp_ns;
+	float orientation[4]; //!< x, y, z, w
+	float position[3];
+	float padding;
+};
+
+/*!
+ * Entry of the index chunk, one per chunk.
+ *
+ * @ingroup aux_tracking
+ */
+struct t_capture_index_entry
+{
+	int64_t timestamp_ns; //!< Timestamp of the frame or of the first sample
+	uint64_t offset;      //!< Offset of the chunk header in the file
+	uint32_t type;        //!< @ref t_capture_chunk_type
+	uint32_t cam_index;   //!< Only used for frames
+};
+
+
+/*
+ *
+ * Writer.
+ *
+ */
+
+/*!
+ * Writes a capture file, all functions are thread safe.
+ *
+ * @ingroup aux_tracking
+ */
+struct t_capture_writer;
+
+/*!
+ * Create a new capture file at @p path, overwriting any existing file.
+ *
+ * @public @memberof t_capture_writer
+ */
+int
+t_capture_writer_create(const char *path, uint32_t cam_count, struct t_capture_writer **out_writer);
+
+/*!
+ * Write a L8 or R8G8B8 frame, padding at the end of rows is dropped.
+ *
+ * @public @memberof t_capture_writer
+ */
+int
+t_capture_writer_write_frame(struct t_capture_writer *writer, uint32_t cam_index, struct xrt_frame *xf);
+
+/*!
+ * Write @p count IMU samples as a single chunk.
+ *
+ * @public @memberof t_capture_writer
+ */
+int
+t_capture_writer_write_imu(struct t_capture_writer *writer, const struct xrt_imu_sample *samples, uint32_t count);
+
+/*!
+ * Write @p count groundtruth samples as a single chunk.
+ *
+ * @public @memberof t_capture_writer
+ */
+int
+t_capture_writer_write_gt(struct t_capture_writer *writer, const struct xrt_pose_sample *samples, uint32_t count);
+
+/*!
+ * Write the index, close the file and free the writer.
+ *
+ * @public @memberof t_capture_writer
+ */
+int
+t_capture_writer_destroy(struct t_capture_writer **writer_ptr);
+
+
+/*
+ *
+ * Reader.
+ *
+ */
+
+/*!
+ * Location of a frame in a mapped capture file.
+ *
+ * @ingroup aux_tracking
+ */
+struct t_capture_frame_ref
+{
+	int64_t timestamp_ns;
+	const struct t_capture_frame_header *header;
+};
+
+/*!
+ * A memory mapped capture file, frames are handed out without copying and
+ * hold a reference to the reader so the mapping outlives them. The mapping is
+ * private, so a sink writing into a frame never modifies the file.
+ *
+ * The fields are read only.
+ *
+ * @ingroup aux_tracking
+ */
+struct t_capture_reader
+{
+	struct xrt_reference reference;
+
+	uint8_t *data; //!< Start of the mapping
+	size_t size;   //!< Size of the mapping
+
+	uint32_t cam_count;
+
+	//! Frames of each camera sorted by timestamp.
+	struct t_capture_frame_ref *frames[XRT_TRACKING_MAX_SLAM_CAMS];
+	uint32_t frame_counts[XRT_TRACKING_MAX_SLAM_CAMS];
+
+	//! All IMU samples in recording order.
+	struct xrt_imu_sample *imus;
+	uint32_t imu_count;
+
+	//! All groundtruth samples in recording order.
+	struct xrt_pose_sample *gts;
+	uint32_t gt_count;
+};
+
+/*!
+ * Returns true if @p path is a file that starts with @ref T_CAPTURE_MAGIC.
+ *
+ * @ingroup aux_tracking
+ */
+bool
+t_capture_is_capture_file(const char *path);
+
+/*!
+ * Map and index the capture file at @p path.
+ *
+ * @public @memberof t_capture_reader
+ */
+int
+t_capture_reader_open(const char *path, struct t_capture_reader **out_reader);
+
+/*!
+ * Update the reference counts on readers, same semantics as
+ * @ref xrt_frame_reference.
+ *
+ * @public @memberof t_capture_reader
+ */
+void
+t_capture_reader_reference(struct t_capture_reader **dst, struct t_capture_reader *src);
+
+/*!
+ * Binary search the frames of camera @p cam_index for the one at
+ * @p timestamp_ns, returns false if there is none.
+ *
+ * @public @memberof t_capture_reader
+ */
+bool
+t_capture_reader_find_frame(struct t_capture_reader *reader,
+                            uint32_t cam_index,
+                            int64_t timestamp_ns,
+                            uint32_t *out_index);
+
+/*!
+ * Wrap frame @p index of camera @p cam_index in a @ref xrt_frame without
+ * copying the pixels, the frame keeps the reader alive.
+ *
+ * @public @memberof t_capture_reader
+ */
+void
+t_capture_reader_wrap_frame(struct t_capture_reader *reader,
+                            uint32_t cam_index,
+                            uint32_t index,
+                            struct xrt_frame **out_frame);
+
+
+/*
+ *
+ * EuRoC conversion, only available when built with OpenCV.
+ *
+ */
+
+/*!
+ * Convert the EuRoC dataset at @p euroc_path to a capture file, images are
+ * decoded and stored raw.
+ *
+ * @ingroup aux_tracking
+ */
+int
+t_capture_from_euroc(const char *euroc_path, const char *capture_path);
+
+/*!
+ * Convert the capture file at @p capture_path to a EuRoC dataset in the
+ * directory @p euroc_path, in the same layout as the EuRoC recorder.
+ *
+ * @ingroup aux_tracking
+ */
+int
+t_capture_to_euroc(const char *capture_path, const char *euroc_path);
+
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,322 @@
+// Copyright 2025, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Conversion between capture files and EuRoC datasets.
+ * @author agent <agent@local>
+ * @ingroup aux_tracking
+ */
+
+#include "util/u_logging.h"
+
+#include "t_capture.h"
+#include "t_euroc_recorder.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+#include <opencv2/imgcodecs.hpp>
+
+using std::ifstream;
+using std::ofstream;
+using std::string;
+using std::to_string;
+using std::vector;
+using std::filesystem::create_directories;
+using std::filesystem::exists;
+
+//! Number of IMU or groundtruth samples per chunk when converting.
+#define SAMPLES_PER_CHUNK 1024
+
+
+/*
+ *
+ * EuRoC reading.
+ *
+ */
+
+//! Reads the numbers of every line of a EuRoC CSV file, skipping the header.
+static bool
+read_csv_rows(const string &filename, vector<vector<double>> &rows, vector<int64_t> &timestamps)
+{
+	ifstream fin{filename};
+	if (!fin.is_open()) {
+		return false;
+	}
+
+	string line;
+	getline(fin, line); // Skip header line
+
+	while (getline(fin, line)) {
+		if (line.empty() || line[0] == '#') {
+			continue;
+		}
+
+		size_t i = line.find(',');
+		timestamps.push_back(stoll(line.substr(0, i)));
+
+		vector<double> row;
+		while (i != string::npos) {
+			size_t j = line.find(',', i + 1);
+			row.push_back(stod(line.substr(i + 1, j - i - 1)));
+			i = j;
+		}
+		rows.push_back(row);
+	}
+
+	return true;
+}
+
+static bool
+read_cam_csv(const string &cam_path, vector<int64_t> &timestamps, vector<string> &filenames)
+{
+	ifstream fin{cam_path + "/data.csv"};
+	if (!fin.is_open()) {
+		return false;
+	}
+
+	string line;
+	getline(fin, line); // Skip header line
+
+	while (getline(fin, line)) {
+		size_t i = line.find(',');
+		if (i == string::npos) {
+			continue;
+		}
+
+		string name = line.substr(i + 1);
+
+		// Standard euroc datasets use CRLF line endings, so let's remove the extra '\r'
+		if (!name.empty() && name.back() == '\r') {
+			name.pop_back();
+		}
+
+		timestamps.push_back(stoll(line.substr(0, i)));
+		filenames.push_back(cam_path + "/data/" + name);
+	}
+
+	return true;
+}
+
+static int
+write_euroc_frames(struct t_capture_writer *writer, const string &euroc_path, uint32_t cam_count)
+{
+	vector<vector<int64_t>> timestamps(cam_count);
+	vector<vector<string>> filenames(cam_count);
+	size_t frame_count = 0;
+	for (uint32_t i = 0; i < cam_count; i++) {
+		read_cam_csv(euroc_path + "/mav0/cam" + to_string(i), timestamps[i], filenames[i]);
+		frame_count = std::max(frame_count, timestamps[i].size());
+	}
+
+	// Interleave the cameras so playback reads the file front to back.
+	for (size_t f = 0; f < frame_count; f++) {
+		for (uint32_t i = 0; i < cam_count; i++) {
+			if (f >= filenames[i].size()) {
+				continue;
+			}
+
+			cv::Mat img = cv::imread(filenames[i][f], cv::IMREAD_ANYCOLOR);
+			if (img.empty() || (img.type() != CV_8UC1 && img.type() != CV_8UC3)) {
+				U_LOG_E("Unable to read '%s' as an 8 bit image", filenames[i][f].c_str());
+				return -1;
+			}
+
+			struct xrt_frame xf = {};
+			xf.width = img.cols;
+			xf.height = img.rows;
+			xf.stride = img.step;
+			xf.data = img.data;
+			xf.format = img.channels() == 3 ? XRT_FORMAT_R8G8B8 : XRT_FORMAT_L8;
+			xf.timestamp = timestamps[i][f];
+
+			if (t_capture_writer_write_frame(writer, i, &xf) != 0) {
+				return -1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+static int
+write_euroc_imus(struct t_capture_writer *writer, const string &euroc_path)
+{
+	vector<vector<double>> rows;
+	vector<int64_t> timestamps;
+	read_csv_rows(euroc_path + "/mav0/imu0/data.csv", rows, timestamps);
+
+	vector<xrt_imu_sample> samples;
+	for (size_t i = 0; i < rows.size(); i++) {
+		const vector<double> &v = rows[i]; // wx wy wz ax ay az
+		if (v.size() < 6) {
+			U_LOG_E("Malformed IMU sample at line %zu", i + 2);
+			return -1;
+		}
+		samples.push_back({timestamps[i], {v[3], v[4], v[5]}, {v[0], v[1], v[2]}});
+	}
+
+	for (size_t i = 0; i < samples.size(); i += SAMPLES_PER_CHUNK) {
+		uint32_t count = (uint32_t)std::min<size_t>(SAMPLES_PER_CHUNK, samples.size() - i);
+		if (t_capture_writer_write_imu(writer, &samples[i], count) != 0) {
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static int
+write_euroc_gt(struct t_capture_writer *writer, const string &euroc_path)
+{
+	// Same groundtruth devices as the EuRoC player, plus the one the recorder writes.
+	const char *gt_devices[] = {"gt", "vicon0", "mocap0", "state_groundtruth_estimate0", "leica0"};
+
+	vector<vector<double>> rows;
+	vector<int64_t> timestamps;
+	for (const char *device : gt_devices) {
+		if (read_csv_rows(euroc_path + "/mav0/" + device + "/data.csv", rows, timestamps)) {
+			break;
+		}
+	}
+
+	vector<xrt_pose_sample> samples;
+	for (size_t i = 0; i < rows.size(); i++) {
+		double v[7] = {0, 0, 0, 1, 0, 0, 0}; // px py pz qw qx qy qz, leica0 only has position
+		for (size_t k = 0; k < 7 && k < rows[i].size(); k++) {
+			v[k] = rows[i][k];
+		}
+
+		xrt_pose pose = {
+		    {(float)v[4], (float)v[5], (float)v[6], (float)v[3]},
+		    {(float)v[0], (float)v[1], (float)v[2]},
+		};
+		samples.push_back({timestamps[i], pose});
+	}
+
+	for (size_t i = 0; i < samples.size(); i += SAMPLES_PER_CHUNK) {
+		uint32_t count = (uint32_t)std::min<size_t>(SAMPLES_PER_CHUNK, samples.size() - i);
+		if (t_capture_writer_write_gt(writer, &samples[i], count) != 0) {
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+
+/*
+ *
+ * 'Exported' functions.
+ *
+ */
+
+extern "C" int
+t_capture_from_euroc(const char *euroc_path, const char *capture_path)
+{
+	string path = euroc_path;
+
+	uint32_t cam_count = 0;
+	while (cam_count < XRT_TRACKING_MAX_SLAM_CAMS && exists(path + "/mav0/cam" + to_string(cam_count))) {
+		cam_count++;
+	}
+
+	if (cam_count == 0 || !exists(path + "/mav0/imu0/data.csv")) {
+		U_LOG_E("'%s' is not a EuRoC dataset", euroc_path);
+		return -1;
+	}
+
+	struct t_capture_writer *writer = nullptr;
+	if (t_capture_writer_create(capture_path, cam_count, &writer) != 0) {
+		t_capture_writer_destroy(&writer);
+		return -1;
+	}
+
+	int ret = write_euroc_imus(writer, path);
+	if (ret == 0) {
+		ret = write_euroc_gt(writer, path);
+	}
+	if (ret == 0) {
+		ret = write_euroc_frames(writer, path, cam_count);
+	}
+
+	if (t_capture_writer_destroy(&writer) != 0) {
+		ret = -1;
+	}
+
+	return ret;
+}
+
+extern "C" int
+t_capture_to_euroc(const char *capture_path, const char *euroc_path)
+{
+	struct t_capture_reader *reader = nullptr;
+	if (t_capture_reader_open(capture_path, &reader) != 0) {
+		return -1;
+	}
+
+	string path = euroc_path;
+	int ret = 0;
+
+	create_directories(path + "/mav0/imu0");
+	ofstream imu_csv{path + "/mav0/imu0/data.csv"};
+	imu_csv << std::fixed << std::setprecision(CSV_PRECISION);
+	imu_csv << "#timestamp [ns],w_RS_S_x [rad s^-1],w_RS_S_y [rad s^-1],w_RS_S_z [rad s^-1],"
+	           "a_RS_S_x [m s^-2],a_RS_S_y [m s^-2],a_RS_S_z [m s^-2]" CSV_EOL;
+	for (uint32_t i = 0; i < reader->imu_count; i++) {
+		const xrt_imu_sample &s = reader->imus[i];
+		imu_csv << s.timestamp_ns << ",";
+		imu_csv << s.gyro_rad_secs.x << "," << s.gyro_rad_secs.y << "," << s.gyro_rad_secs.z << ",";
+		imu_csv << s.accel_m_s2.x << "," << s.accel_m_s2.y << "," << s.accel_m_s2.z << CSV_EOL;
+	}
+
+	if (reader->gt_count > 0) {
+		create_directories(path + "/mav0/gt");
+		ofstream gt_csv{path + "/mav0/gt/data.csv"};
+		gt_csv << std::fixed << std::setprecision(CSV_PRECISION);
+		gt_csv << "#timestamp [ns],p_RS_R_x [m],p_RS_R_y [m],p_RS_R_z [m],"
+		          "q_RS_w [],q_RS_x [],q_RS_y [],q_RS_z []" CSV_EOL;
+		for (uint32_t i = 0; i < reader->gt_count; i++) {
+			const xrt_pose_sample &s = reader->gts[i];
+			const xrt_vec3 &p = s.pose.position;
+			const xrt_quat &o = s.pose.orientation;
+			gt_csv << s.timestamp_ns << ",";
+			gt_csv << p.x << "," << p.y << "," << p.z << ",";
+			gt_csv << o.w << "," << o.x << "," << o.y << "," << o.z << CSV_EOL;
+		}
+	}
+
+	for (uint32_t c = 0; c < reader->cam_count && ret == 0; c++) {
+		string cam_path = path + "/mav0/cam" + to_string(c);
+		create_directories(cam_path + "/data");
+		ofstream cam_csv{cam_path + "/data.csv"};
+		cam_csv << "#timestamp [ns],filename" CSV_EOL;
+
+		for (uint32_t f = 0; f < reader->frame_counts[c]; f++) {
+			struct xrt_frame *xf = nullptr;
+			t_capture_reader_wrap_frame(reader, c, f, &xf);
+
+			int type = xf->format == XRT_FORMAT_L8 ? CV_8UC1 : CV_8UC3;
+			cv::Mat img{(int)xf->height, (int)xf->width, type, xf->data, xf->stride};
+			string filename = to_string(xf->timestamp) + ".png";
+			if (!cv::imwrite(cam_path + "/data/" + filename, img)) {
+				U_LOG_E("Failed to write '%s'", filename.c_str());
+				ret = -1;
+			}
+			cam_csv << xf->timestamp << "," << filename << CSV_EOL;
+
+			xrt_frame_reference(&xf, NULL);
+
+			if (ret != 0) {
+				break;
+			}
+		}
+	}
+
+	t_capture_reader_reference(&reader, NULL);
+
+	return ret;
+}
@@ -0,0 +1,406 @@
+// Copyright 2025, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Records SLAM samples into a capture file.
+ * @author agent <agent@local>
+ * @ingroup aux_tracking
+ */
+
+#include "os/os_threading.h"
+#include "os/os_time.h"
+#include "util/u_frame.h"
+#include "util/u_logging.h"
+#include "util/u_misc.h"
+#include "util/u_sink.h"
+#include "util/u_var.h"
+
+#include "t_capture.h"
+#include "t_capture_recorder.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+
+/*
+ *
+ * Structs and defines.
+ *
+ */
+
+//! Growable array of IMU or groundtruth samples.
+struct sample_buffer
+{
+	uint8_t *data;
+	size_t elem_size;
+	uint32_t count;
+	uint32_t capacity;
+};
+
+struct t_capture_recorder;
+
+//! Frame sink that knows which camera it is for.
+struct capture_recorder_cam_sink
+{
+	struct xrt_frame_sink base;
+	struct t_capture_recorder *cr;
+	uint32_t cam_index;
+};
+
+/*!
+ * Records into a @ref t_capture_writer.
+ *
+ * Frames are cloned on the pushing thread so the original is released right
+ * away, and then written by a queue thread per camera. As frames are stored
+ * raw the writing is just a copy into the file. IMU and groundtruth samples
+ * are batched and written as one chunk before each frame of the first camera.
+ *
+ * @implements xrt_frame_node
+ */
+struct t_capture_recorder
+{
+	struct xrt_frame_node node;
+
+	//! Public sinks, samples pushed here are recorded.
+	struct xrt_slam_sinks sinks;
+	struct xrt_imu_sink imu_sink;
+	struct xrt_pose_sink gt_sink;
+	struct capture_recorder_cam_sink receivers[XRT_TRACKING_MAX_SLAM_CAMS];
+
+	//! Sinks that write frames, behind a queue each.
+	struct capture_recorder_cam_sink writers[XRT_TRACKING_MAX_SLAM_CAMS];
+	struct xrt_frame_sink *writer_queues[XRT_TRACKING_MAX_SLAM_CAMS];
+
+	char path_prefix[256];
+	int cam_count;
+
+	//! Protects @ref recording and the pending samples, only held briefly.
+	struct os_mutex mutex;
+	bool recording;
+	struct sample_buffer pending_imus;
+	struct sample_buffer pending_gts;
+
+	//! Protects @ref writer and the flushing buffers, held while writing.
+	struct os_mutex write_mutex;
+	struct t_capture_writer *writer;
+	struct sample_buffer flushing_imus;
+	struct sample_buffer flushing_gts;
+
+	struct u_var_button recording_btn;
+};
+
+
+/*
+ *
+ * Helper functions.
+ *
+ */
+
+static void
+sample_buffer_push(struct sample_buffer *sb, const void *sample)
+{
+	if (sb->count == sb->capacity) {
+		uint32_t capacity = sb->capacity == 0 ? 256 : sb->capacity * 2;
+		uint8_t *data = realloc(sb->data, sb->elem_size * capacity);
+		if (data == NULL) {
+			U_LOG_E("Failed to grow sample buffer, dropping sample");
+			return;
+		}
+		sb->data = data;
+		sb->capacity = capacity;
+	}
+
+	memcpy(sb->data + sb->elem_size * sb->count++, sample, sb->elem_size);
+}
+
+static void
+sample_buffer_swap(struct sample_buffer *a, struct sample_buffer *b)
+{
+	struct sample_buffer tmp = *a;
+	*a = *b;
+	*b = tmp;
+}
+
+static void
+sample_buffer_free(struct sample_buffer *sb)
+{
+	free(sb->data);
+	sb->data = NULL;
+	sb->count = 0;
+	sb->capacity = 0;
+}
+
+//! Write all pending samples, must hold the write mutex.
+static void
+flush_samples_locked(struct t_capture_recorder *cr)
+{
+	// Swap the buffers so the IMU and groundtruth pushes don't wait on the file.
+	os_mutex_lock(&cr->mutex);
+	sample_buffer_swap(&cr->pending_imus, &cr->flushing_imus);
+	sample_buffer_swap(&cr->pending_gts, &cr->flushing_gts);
+	os_mutex_unlock(&cr->mutex);
+
+	if (cr->writer != NULL) {
+		t_capture_writer_write_imu(cr->writer, (struct xrt_imu_sample *)cr->flushing_imus.data,
+		                           cr->flushing_imus.count);
+		t_capture_writer_write_gt(cr->writer, (struct xrt_pose_sample *)cr->flushing_gts.data,
+		                          cr->flushing_gts.count);
+	}
+
+	cr->flushing_imus.count = 0;
+	cr->flushing_gts.count = 0;
+}
+
+
+/*
+ *
+ * Sink functions.
+ *
+ */
+
+static void
+receive_frame(struct xrt_frame_sink *xfs, struct xrt_frame *xf)
+{
+	struct capture_recorder_cam_sink *cs = (struct capture_recorder_cam_sink *)xfs;
+	struct t_capture_recorder *cr = cs->cr;
+
+	if (!cr->recording) {
+		return;
+	}
+
+	// Clone so that the original frame can be released quickly.
+	struct xrt_frame *copy = NULL;
+	u_frame_clone(xf, &copy);
+
+	xrt_sink_push_frame(cr->writer_queues[cs->cam_index], copy);
+
+	xrt_frame_reference(&copy, NULL);
+}
+
+static void
+write_frame(struct xrt_frame_sink *xfs, struct xrt_frame *xf)
+{
+	struct capture_recorder_cam_sink *cs = (struct capture_recorder_cam_sink *)xfs;
+	struct t_capture_recorder *cr = cs->cr;
+
+	os_mutex_lock(&cr->write_mutex);
+
+	// Frames still queued after stopping are dropped.
+	if (cr->writer != NULL) {
+		if (cs->cam_index == 0) {
+			flush_samples_locked(cr);
+		}
+		t_capture_writer_write_frame(cr->writer, cs->cam_index, xf);
+	}
+
+	os_mutex_unlock(&cr->write_mutex);
+}
+
+static void
+receive_imu(struct xrt_imu_sink *sink, struct xrt_imu_sample *sample)
+{
+	struct t_capture_recorder *cr = container_of(sink, struct t_capture_recorder, imu_sink);
+
+	os_mutex_lock(&cr->mutex);
+	if (cr->recording) {
+		sample_buffer_push(&cr->pending_imus, sample);
+	}
+	os_mutex_unlock(&cr->mutex);
+}
+
+static void
+receive_gt(struct xrt_pose_sink *sink, struct xrt_pose_sample *sample)
+{
+	struct t_capture_recorder *cr = container_of(sink, struct t_capture_recorder, gt_sink);
+
+	os_mutex_lock(&cr->mutex);
+	if (cr->recording) {
+		sample_buffer_push(&cr->pending_gts, sample);
+	}
+	os_mutex_unlock(&cr->mutex);
+}
+
+
+/*
+ *
+ * Frame node functions.
+ *
+ */
+
+static void
+capture_recorder_node_break_apart(struct xrt_frame_node *node)
+{
+	// Noop
+}
+
+static void
+capture_recorder_node_destroy(struct xrt_frame_node *node)
+{
+	struct t_capture_recorder *cr = container_of(node, struct t_capture_recorder, node);
+
+	// Closes the file, so what was recorded stays indexed.
+	if (cr->recording) {
+		t_capture_recorder_stop(&cr->sinks);
+	}
+
+	sample_buffer_free(&cr->pending_imus);
+	sample_buffer_free(&cr->pending_gts);
+	sample_buffer_free(&cr->flushing_imus);
+	sample_buffer_free(&cr->flushing_gts);
+
+	os_mutex_destroy(&cr->write_mutex);
+	os_mutex_destroy(&cr->mutex);
+
+	free(cr);
+}
+
+
+/*
+ *
+ * UI functions.
+ *
+ */
+
+static void
+capture_recorder_btn_cb(void *ptr)
+{
+	struct t_capture_recorder *cr = (struct t_capture_recorder *)ptr;
+
+	if (cr->recording) {
+		t_capture_recorder_stop(&cr->sinks);
+		(void)snprintf(cr->recording_btn.label, sizeof(cr->recording_btn.label), "Record capture file");
+	} else {
+		t_capture_recorder_start(&cr->sinks);
+		(void)snprintf(cr->recording_btn.label, sizeof(cr->recording_btn.label), "Stop recording");
+	}
+}
+
+
+/*
+ *
+ * 'Exported' functions.
+ *
+ */
+
+struct xrt_slam_sinks *
+t_capture_recorder_create(struct xrt_frame_context *xfctx,
+                          const char *record_path,
+                          int cam_count,
+                          bool record_from_start)
+{
+	struct t_capture_recorder *cr = U_TYPED_CALLOC(struct t_capture_recorder);
+
+	assert(cam_count <= XRT_TRACKING_MAX_SLAM_CAMS);
+	cr->cam_count = cam_count;
+	(void)snprintf(cr->path_prefix, sizeof(cr->path_prefix), "%s",
+	               record_path == NULL ? "capture_recording" : record_path);
+
+	os_mutex_init(&cr->mutex);
+	os_mutex_init(&cr->write_mutex);
+
+	cr->pending_imus.elem_size = sizeof(struct xrt_imu_sample);
+	cr->flushing_imus.elem_size = sizeof(struct xrt_imu_sample);
+	cr->pending_gts.elem_size = sizeof(struct xrt_pose_sample);
+	cr->flushing_gts.elem_size = sizeof(struct xrt_pose_sample);
+
+	cr->node.break_apart = capture_recorder_node_break_apart;
+	cr->node.destroy = capture_recorder_node_destroy;
+	xrt_frame_context_add(xfctx, &cr->node);
+
+	// receiver (clone) -> writer_queue -> writer (write to file)
+	cr->sinks.cam_count = cr->cam_count;
+	for (int i = 0; i < cr->cam_count; i++) {
+		cr->writers[i].base.push_frame = write_frame;
+		cr->writers[i].cr = cr;
+		cr->writers[i].cam_index = i;
+		u_sink_queue_create(xfctx, 0, &cr->writers[i].base, &cr->writer_queues[i]);
+
+		cr->receivers[i].base.push_frame = receive_frame;
+		cr->receivers[i].cr = cr;
+		cr->receivers[i].cam_index = i;
+		cr->sinks.cams[i] = &cr->receivers[i].base;
+	}
+
+	cr->imu_sink.push_imu = receive_imu;
+	cr->sinks.imu = &cr->imu_sink;
+	cr->gt_sink.push_pose = receive_gt;
+	cr->sinks.gt = &cr->gt_sink;
+
+	if (record_from_start) {
+		t_capture_recorder_start(&cr->sinks);
+	}
+
+	return &cr->sinks;
+}
+
+void
+t_capture_recorder_start(struct xrt_slam_sinks *cr_sinks)
+{
+	struct t_capture_recorder *cr = container_of(cr_sinks, struct t_capture_recorder, sinks);
+
+	if (cr->recording) {
+		U_LOG_W("We are already recording; unable to start.");
+		return;
+	}
+
+	time_t seconds = os_realtime_get_ns() / U_1_000_000_000;
+	char datetime[sizeof("YYYYMMDDHHmmss")] = {0};
+	(void)strftime(datetime, sizeof(datetime), "%Y%m%d%H%M%S", localtime(&seconds));
+
+	char path[512];
+	(void)snprintf(path, sizeof(path), "%s_%s" T_CAPTURE_FILE_EXTENSION, cr->path_prefix, datetime);
+
+	os_mutex_lock(&cr->write_mutex);
+
+	int ret = t_capture_writer_create(path, cr->cam_count, &cr->writer);
+	if (ret != 0) {
+		U_LOG_E("Failed to start recording to '%s'", path);
+		t_capture_writer_destroy(&cr->writer);
+		os_mutex_unlock(&cr->write_mutex);
+		return;
+	}
+
+	U_LOG_I("Recording to '%s'", path);
+
+	os_mutex_lock(&cr->mutex);
+	cr->recording = true;
+	os_mutex_unlock(&cr->mutex);
+
+	os_mutex_unlock(&cr->write_mutex);
+}
+
+void
+t_capture_recorder_stop(struct xrt_slam_sinks *cr_sinks)
+{
+	struct t_capture_recorder *cr = container_of(cr_sinks, struct t_capture_recorder, sinks);
+
+	if (!cr->recording) {
+		U_LOG_W("We are already not recording; unable to stop.");
+		return;
+	}
+
+	os_mutex_lock(&cr->mutex);
+	cr->recording = false;
+	os_mutex_unlock(&cr->mutex);
+
+	os_mutex_lock(&cr->write_mutex);
+	flush_samples_locked(cr);
+	if (t_capture_writer_destroy(&cr->writer) != 0) {
+		U_LOG_E("Failed to finish capture file, it can still be played but has no index");
+	}
+	os_mutex_unlock(&cr->write_mutex);
+}
+
+void
+t_capture_recorder_add_ui(struct xrt_slam_sinks *cr_sinks, void *root, const char *prefix)
+{
+	struct t_capture_recorder *cr = container_of(cr_sinks, struct t_capture_recorder, sinks);
+	cr->recording_btn.cb = capture_recorder_btn_cb;
+	cr->recording_btn.ptr = cr;
+
+	char tmp[256];
+	(void)snprintf(tmp, sizeof(tmp), "%s%s", prefix, cr->recording ? "Stop recording" : "Record capture file");
+	u_var_add_button(root, &cr->recording_btn, tmp);
+}
@@ -0,0 +1,67 @@
+// Copyright 2025, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Records SLAM samples into a capture file.
+ * @author agent <agent@local>
+ * @ingroup aux_tracking
+ */
+
+#pragma once
+
+#include "xrt/xrt_tracking.h"
+#include "xrt/xrt_frame.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!
+ * Create SLAM sinks to record samples into a capture file, see t_capture.h.
+ * Same usage as @ref euroc_recorder_create, but frames are stored raw instead
+ * of being encoded so recording keeps up with high frame rate cameras.
+ *
+ * @param xfctx Frame context for the sinks.
+ * @param record_path Path prefix of the file or NULL for a default, the current datetime is appended.
+ * @param cam_count Number of cameras to record
+ * @param record_from_start Whether to start recording immediately on creation.
+ * @return struct xrt_slam_sinks* Sinks to push samples to for recording.
+ *
+ * @ingroup aux_tracking
+ */
+struct xrt_slam_sinks *
+t_capture_recorder_create(struct xrt_frame_context *xfctx,
+                          const char *record_path,
+                          int cam_count,
+                          bool record_from_start);
+
+/*!
+ * Start recording samples sent to the recorder sinks, into a new file.
+ *
+ * @param cr_sinks The recorder sinks returned by @ref t_capture_recorder_create
+ */
+void
+t_capture_recorder_start(struct xrt_slam_sinks *cr_sinks);
+
+/*!
+ * Stop recording and close the file. You can start and stop as many times as
+ * you like.
+ *
+ * @param cr_sinks The recorder sinks returned by @ref t_capture_recorder_create
+ */
+void
+t_capture_recorder_stop(struct xrt_slam_sinks *cr_sinks);
+
+/*!
+ * Add capture recorder UI button to start recording after creation.
+ *
+ * @param cr_sinks The sinks returned by @ref t_capture_recorder_create
+ * @param root The pointer to add UI button to
+ * @param prefix Prefix in case you have multiple recorders, otherwise pass an empty string
+ */
+void
+t_capture_recorder_add_ui(struct xrt_slam_sinks *cr_sinks, void *root, const char *prefix);
+
+#ifdef __cplusplus
+}
+#endif
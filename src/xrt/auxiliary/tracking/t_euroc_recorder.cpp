@@ -14,11 +14,16 @@
 #include "util/u_sink.h"
 #include "util/u_var.h"
 #include "util/u_debug.h"
+#include "util/u_worker.h"
 #include "xrt/xrt_defines.h"
 #include "xrt/xrt_tracking.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <condition_variable>
 #include <ctime>
+#include <deque>
 #include <filesystem>
 #include <fstream>
 #include <mutex>
@@ -29,16 +34,43 @@
 #include <opencv2/imgcodecs.hpp>
 
 DEBUG_GET_ONCE_BOOL_OPTION(euroc_recorder_use_jpg, "EUROC_RECORDER_USE_JPG", false)
+DEBUG_GET_ONCE_NUM_OPTION(euroc_recorder_threads, "EUROC_RECORDER_THREADS", 4)
+DEBUG_GET_ONCE_NUM_OPTION(euroc_recorder_max_pending, "EUROC_RECORDER_MAX_PENDING", 64)
 
+using std::condition_variable;
+using std::deque;
 using std::lock_guard;
 using std::mutex;
 using std::ofstream;
 using std::queue;
 using std::string;
 using std::to_string;
+using std::unique_lock;
 using std::vector;
 using std::filesystem::create_directories;
 
+//! Max number of frame sets waiting for the frames of their other cameras.
+#define EUROC_RECORDER_MAX_FRAME_SETS 64
+
+/*!
+ * Keep or drop decision for the frames of all cameras with the same timestamp,
+ * made by the first camera to see the timestamp so a frame is either recorded
+ * on all cameras or on none of them.
+ */
+struct euroc_recorder_frame_set
+{
+	uint64_t timestamp;
+	bool keep;
+	int remaining; //!< Cameras that still haven't received their frame of this set
+};
+
+//! Image file name of the frames with @p timestamp.
+static string
+euroc_recorder_frame_filename(bool use_jpg, uint64_t timestamp)
+{
+	return to_string(timestamp) + (use_jpg ? ".jpg" : ".png");
+}
+
 struct euroc_recorder
 {
 	struct xrt_frame_node node;
@@ -46,8 +78,19 @@ struct euroc_recorder
 	string path;        //!< Full path of the current dataset being recorded or empty string if none
 	int cam_count = -1;
 
-	bool recording;                    //!< Whether samples are being recorded
-	struct u_var_button recording_btn; //!< UI button to start/stop `recording`
+	std::atomic<bool> recording{false}; //!< Whether samples are being recorded
+	struct u_var_button recording_btn;  //!< UI button to start/stop `recording`
+
+	//! Cloner sink calls that saw `recording` and may still touch the CSV streams or push encode tasks.
+	struct
+	{
+		mutex lock;              //!< Protects the fields below and the check of `recording`
+		condition_variable done; //!< Signaled when `count` drops to zero
+		int32_t count = 0;
+
+		//! Newest frame seen while not recording, its set was dropped on the cameras that got it.
+		uint64_t skip_until = 0;
+	} in_flight;
 
 	bool use_jpg; //! Whether or not we should save images as .jpg files
 
@@ -57,11 +100,27 @@ struct euroc_recorder
 	struct xrt_pose_sink cloner_gt_sink;
 	struct xrt_frame_sink cloner_sinks[XRT_TRACKING_MAX_SLAM_CAMS];
 
-	// Writer sinks: write copied frame to disk
-	struct xrt_slam_sinks writer_queues; //!< Queue sinks that write into writer sinks
+	// Writer sinks: write samples to the CSV files
 	struct xrt_imu_sink writer_imu_sink;
 	struct xrt_pose_sink writer_gt_sink;
-	struct xrt_frame_sink writer_sinks[XRT_TRACKING_MAX_SLAM_CAMS];
+
+	// Copied frames are encoded and written to disk by a pool of workers
+	struct u_worker_thread_pool *pool;
+	struct u_worker_group *group;
+	int32_t max_pending; //!< Max frames being encoded at once, further frames are dropped
+
+	struct
+	{
+		mutex lock;               //!< Protects the fields below
+		int32_t pending;          //!< Frames copied but not yet written to disk
+		int32_t peak_pending;     //!< Highest `pending` seen
+		uint64_t written;         //!< Frames written to disk
+		uint64_t dropped;         //!< Frames dropped because too many were pending
+		uint64_t failed;          //!< Frames that could not be written
+
+		//! Decisions waiting for the frames of the other cameras, oldest first.
+		deque<euroc_recorder_frame_set> frame_sets;
+	} stats;
 
 	queue<xrt_imu_sample> imu_queue{}; //!< IMU pushes get saved here and are delayed until left_frame pushes
 	mutex imu_queue_lock{};            //!< Lock for imu_queue
@@ -83,11 +142,27 @@ struct euroc_recorder
  *
  */
 
+static void
+euroc_recorder_delete_files(struct euroc_recorder *er)
+{
+	delete er->imu_csv;
+	delete er->gt_csv;
+	er->imu_csv = nullptr;
+	er->gt_csv = nullptr;
+	for (int i = 0; i < er->cam_count; i++) {
+		delete er->cams_csv[i];
+		er->cams_csv[i] = nullptr;
+	}
+}
+
 static void
 euroc_recorder_mkfiles(struct euroc_recorder *er)
 {
 	string path = er->path;
 
+	// Files of a previous recording, not recording so no cloner sink can reach them.
+	euroc_recorder_delete_files(er);
+
 	create_directories(path + "/mav0/imu0");
 	er->imu_csv = new ofstream{path + "/mav0/imu0/data.csv"};
 	*er->imu_csv << std::fixed << std::setprecision(CSV_PRECISION);
@@ -145,12 +220,7 @@ euroc_recorder_flush(struct euroc_recorder *er)
 		xrt_sink_push_pose(&er->writer_gt_sink, &sample);
 	}
 
-	// Flush csv streams. Not necessary, doing it only to increase flush frequency
-	er->imu_csv->flush();
-	er->gt_csv->flush();
-	for (int i = 0; i < er->cam_count; i++) {
-		er->cams_csv[i]->flush();
-	}
+	// The streams are buffered and only flushed when the recording stops.
 }
 
 extern "C" void
@@ -181,49 +251,47 @@ euroc_recorder_save_gt(xrt_pose_sink *sink, struct xrt_pose_sample *sample)
 	*er->gt_csv << o.w << "," << o.x << "," << o.y << "," << o.z << CSV_EOL;
 }
 
+//! A copied frame to encode and write to disk on the worker pool.
+struct euroc_recorder_encode_task
+{
+	struct euroc_recorder *er;
+	struct xrt_frame *frame;
+	string img_path;
+};
+
 static void
-euroc_recorder_save_frame(euroc_recorder *er, struct xrt_frame *frame, int cam_index)
+euroc_recorder_encode_task_func(void *ptr)
 {
-	string cam_name = "cam" + to_string(cam_index);
-	uint64_t ts = frame->timestamp;
+	euroc_recorder_encode_task *task = (euroc_recorder_encode_task *)ptr;
+	euroc_recorder *er = task->er;
+	xrt_frame *frame = task->frame;
 
 	assert(frame->format == XRT_FORMAT_L8 || frame->format == XRT_FORMAT_R8G8B8); // Only formats supported
 	auto img_type = frame->format == XRT_FORMAT_L8 ? CV_8UC1 : CV_8UC3;
-	string file_extension = er->use_jpg ? ".jpg" : ".png";
-	string filename = std::to_string(ts) + file_extension;
-	string img_path = er->path + "/mav0/" + cam_name + "/data/" + filename;
 	cv::Mat img{(int)frame->height, (int)frame->width, img_type, frame->data, frame->stride};
-	cv::imwrite(img_path, img);
+	bool written = cv::imwrite(task->img_path, img);
+	if (!written) {
+		U_LOG_E("Failed to write %s", task->img_path.c_str());
+	}
 
-	*er->cams_csv[cam_index] << ts << "," << filename << CSV_EOL;
-}
+	xrt_frame_reference(&task->frame, NULL);
+	delete task;
 
-#define DEFINE_SAVE_CAM(cam_id)                                                                                        \
-	extern "C" void euroc_recorder_save_cam##cam_id(struct xrt_frame_sink *sink, struct xrt_frame *frame)          \
-	{                                                                                                              \
-		euroc_recorder *er = container_of(sink, euroc_recorder, writer_sinks[cam_id]);                         \
-		if (cam_id == 0) {                                                                                     \
-			euroc_recorder_flush(er);                                                                      \
-		}                                                                                                      \
-		euroc_recorder_save_frame(er, frame, cam_id);                                                          \
+	lock_guard lock{er->stats.lock};
+	er->stats.pending--;
+	if (written) {
+		er->stats.written++;
+	} else {
+		er->stats.failed++;
 	}
+}
 
-DEFINE_SAVE_CAM(0)
-DEFINE_SAVE_CAM(1)
-DEFINE_SAVE_CAM(2)
-DEFINE_SAVE_CAM(3)
-DEFINE_SAVE_CAM(4)
-
-//! Be sure to define the same number of defined functions as
-//! XRT_TRACKING_MAX_SLAM_CAMS and to add them to to euroc_recorder_save_cam
-static void (*euroc_recorder_save_cam[XRT_TRACKING_MAX_SLAM_CAMS])(struct xrt_frame_sink *sink,
-                                                                   struct xrt_frame *frame) = {
-    euroc_recorder_save_cam0, //
-    euroc_recorder_save_cam1, //
-    euroc_recorder_save_cam2, //
-    euroc_recorder_save_cam3, //
-    euroc_recorder_save_cam4, //
-};
+//! Wait for all frames being encoded to be written.
+static void
+euroc_recorder_wait_pending(struct euroc_recorder *er)
+{
+	u_worker_group_wait_all(er->group);
+}
 
 
 /*
@@ -232,6 +300,58 @@ static void (*euroc_recorder_save_cam[XRT_TRACKING_MAX_SLAM_CAMS])(struct xrt_fr
  *
  */
 
+/*!
+ * Returns false if we are not recording, otherwise the streams and the group
+ * stay usable until the matching @ref euroc_recorder_end_push.
+ */
+static bool
+euroc_recorder_begin_push(struct euroc_recorder *er)
+{
+	lock_guard lock{er->in_flight.lock};
+	if (!er->recording) {
+		return false;
+	}
+	er->in_flight.count++;
+	return true;
+}
+
+/*!
+ * Same as @ref euroc_recorder_begin_push for frames, also keeps the frames of
+ * a timestamp that other cameras saw before the recording started out of it.
+ */
+static bool
+euroc_recorder_begin_frame_push(struct euroc_recorder *er, uint64_t timestamp)
+{
+	lock_guard lock{er->in_flight.lock};
+	if (!er->recording) {
+		er->in_flight.skip_until = std::max(er->in_flight.skip_until, timestamp);
+		return false;
+	}
+	if (timestamp <= er->in_flight.skip_until) {
+		return false;
+	}
+	er->in_flight.count++;
+	return true;
+}
+
+static void
+euroc_recorder_end_push(struct euroc_recorder *er)
+{
+	lock_guard lock{er->in_flight.lock};
+	if (--er->in_flight.count == 0) {
+		er->in_flight.done.notify_all();
+	}
+}
+
+//! Stop new cloner sink calls from recording and wait for the ones already in.
+static void
+euroc_recorder_stop_pushes(struct euroc_recorder *er)
+{
+	unique_lock lock{er->in_flight.lock};
+	er->recording = false;
+	er->in_flight.done.wait(lock, [er] { return er->in_flight.count == 0; });
+}
+
 extern "C" void
 euroc_recorder_receive_imu(xrt_imu_sink *sink, struct xrt_imu_sample *sample)
 {
@@ -240,7 +360,7 @@ euroc_recorder_receive_imu(xrt_imu_sink *sink, struct xrt_imu_sample *sample)
 	// write them to disk when writing left frames.
 	euroc_recorder *er = container_of(sink, euroc_recorder, cloner_imu_sink);
 
-	if (!er->recording) {
+	if (!euroc_recorder_begin_push(er)) {
 		return;
 	}
 
@@ -248,6 +368,8 @@ euroc_recorder_receive_imu(xrt_imu_sink *sink, struct xrt_imu_sample *sample)
 		lock_guard lock{er->imu_queue_lock};
 		er->imu_queue.push(*sample);
 	}
+
+	euroc_recorder_end_push(er);
 }
 
 extern "C" void
@@ -256,7 +378,7 @@ euroc_recorder_receive_gt(xrt_pose_sink *sink, struct xrt_pose_sample *sample)
 	// This works similarly to euroc_recorder_receive_imu, read its comments
 	euroc_recorder *er = container_of(sink, euroc_recorder, cloner_gt_sink);
 
-	if (!er->recording) {
+	if (!euroc_recorder_begin_push(er)) {
 		return;
 	}
 
@@ -264,23 +386,118 @@ euroc_recorder_receive_gt(xrt_pose_sink *sink, struct xrt_pose_sample *sample)
 		lock_guard lock{er->gt_queue_lock};
 		er->gt_queue.push(*sample);
 	}
+
+	euroc_recorder_end_push(er);
 }
 
 
+//! Release the slots reserved for frames of a set that will never arrive, called with the stats lock held.
 static void
-euroc_recorder_receive_frame(euroc_recorder *er, struct xrt_frame *src_frame, int cam_index)
+euroc_recorder_release_frame_set(struct euroc_recorder *er, const euroc_recorder_frame_set &set)
 {
-	if (!er->recording) {
+	if (set.keep) {
+		er->stats.pending -= set.remaining;
+	}
+}
+
+//! Add the frames of a complete kept set to the CSV files, called with the stats lock held.
+static void
+euroc_recorder_write_frame_set(struct euroc_recorder *er, uint64_t timestamp)
+{
+	string filename = euroc_recorder_frame_filename(er->use_jpg, timestamp);
+	for (int i = 0; i < er->cam_count; i++) {
+		*er->cams_csv[i] << timestamp << "," << filename << CSV_EOL;
+	}
+}
+
+/*!
+ * Decides if the frame with @p timestamp should be recorded. The first camera
+ * to see a timestamp decides for all cameras and reserves a slot for each of
+ * them, otherwise one camera could be written while another is dropped and the
+ * dataset would have unsynced frames. The CSV rows are only written once all
+ * cameras got their frame, so sets missing a frame stay out of all of them.
+ */
+static bool
+euroc_recorder_keep_frame(struct euroc_recorder *er, uint64_t timestamp)
+{
+	lock_guard lock{er->stats.lock};
+	auto &sets = er->stats.frame_sets;
+
+	for (auto it = sets.begin(); it != sets.end(); ++it) {
+		if (it->timestamp != timestamp) {
+			continue;
+		}
+
+		bool keep = it->keep;
+		if (!keep) {
+			er->stats.dropped++;
+		}
+		if (--it->remaining == 0) {
+			if (keep) {
+				euroc_recorder_write_frame_set(er, timestamp);
+			}
+			sets.erase(it);
+		}
+		return keep;
+	}
+
+	// Always let a full set in when nothing is pending, even if max_pending is smaller than the camera count.
+	int32_t count = er->cam_count;
+	bool keep = er->stats.pending == 0 || er->stats.pending + count <= er->max_pending;
+	if (keep) {
+		er->stats.pending += count;
+		er->stats.peak_pending = std::max(er->stats.peak_pending, er->stats.pending);
+	} else {
+		er->stats.dropped++;
+	}
+
+	if (count > 1) {
+		sets.push_back({timestamp, keep, count - 1});
+	} else if (keep) {
+		euroc_recorder_write_frame_set(er, timestamp);
+	}
+
+	// A camera missed a frame of the oldest set, give up on it.
+	if (sets.size() > EUROC_RECORDER_MAX_FRAME_SETS) {
+		euroc_recorder_release_frame_set(er, sets.front());
+		sets.pop_front();
+	}
+
+	return keep;
+}
+
+static void
+euroc_recorder_push_frame(euroc_recorder *er, struct xrt_frame *src_frame, int cam_index)
+{
+	if (cam_index == 0) {
+		euroc_recorder_flush(er);
+	}
+
+	// Don't let copies pile up if encoding can't keep up, drop the frame instead.
+	if (!euroc_recorder_keep_frame(er, src_frame->timestamp)) {
 		return;
 	}
 
 	// Let's clone the frame so that we can release the src_frame quickly
-	xrt_frame *copy = nullptr;
-	u_frame_clone(src_frame, &copy);
+	euroc_recorder_encode_task *task = new euroc_recorder_encode_task{er, nullptr, ""};
+	u_frame_clone(src_frame, &task->frame);
 
-	xrt_sink_push_frame(er->writer_queues.cams[cam_index], copy);
+	string filename = euroc_recorder_frame_filename(er->use_jpg, task->frame->timestamp);
+	task->img_path = er->path + "/mav0/cam" + to_string(cam_index) + "/data/" + filename;
 
-	xrt_frame_reference(&copy, NULL);
+	u_worker_group_push(er->group, euroc_recorder_encode_task_func, task);
+}
+
+static void
+euroc_recorder_receive_frame(euroc_recorder *er, struct xrt_frame *src_frame, int cam_index)
+{
+	if (!euroc_recorder_begin_frame_push(er, src_frame->timestamp)) {
+		return;
+	}
+
+	euroc_recorder_push_frame(er, src_frame, cam_index);
+
+	euroc_recorder_end_push(er);
 }
 
 #define DEFINE_RECEIVE_CAM(cam_id)                                                                                     \
@@ -322,11 +539,13 @@ extern "C" void
 euroc_recorder_node_destroy(struct xrt_frame_node *node)
 {
 	struct euroc_recorder *er = container_of(node, struct euroc_recorder, node);
-	delete er->imu_csv;
-	delete er->gt_csv;
-	for (int i = 0; i < er->cam_count; i++) {
-		delete er->cams_csv[i];
-	}
+
+	// Tasks write into the CSV files' directories and use the stats.
+	euroc_recorder_wait_pending(er);
+	u_worker_group_reference(&er->group, NULL);
+	u_worker_thread_pool_reference(&er->pool, NULL);
+
+	euroc_recorder_delete_files(er);
 	delete er;
 }
 
@@ -353,37 +572,39 @@ euroc_recorder_create(struct xrt_frame_context *xfctx, const char *record_path,
 
 	er->use_jpg = debug_get_bool_option_euroc_recorder_use_jpg();
 
+	// One extra thread is created for when a thread waits on the group.
+	int32_t thread_count = (int32_t)std::clamp(debug_get_num_option_euroc_recorder_threads(), 1L, 15L);
+	er->max_pending = (int32_t)std::max(debug_get_num_option_euroc_recorder_max_pending(), 1L);
+	er->pool = u_worker_thread_pool_create(thread_count, thread_count + 1, "EuRoC encode");
+	er->group = u_worker_group_create(er->pool);
+
 	// Setup sink pipeline
 
 	// We expose a "cloner" sink that will clone frames in memory so that original
 	// frames can be released as soon as possible. Not doing this could result in
-	// frame queues from the user being filled up. After that we write to disk. We
-	// also put queues between these to support sensors streaming on different
-	// threads.
-	// cloner_queue -> cloner_sink (clone ) -> writer_queue -> writer_sink (write to disk)
+	// frame queues from the user being filled up. The copies are then encoded and
+	// written to disk by a pool of workers, as encoding a single stream can take
+	// longer than the time between frames. We also put queues in front to support
+	// sensors streaming on different threads, and to never block them.
+	// cloner_queue -> cloner_sink (clone) -> worker pool (encode and write to disk)
 
 	er->cloner_queues.cam_count = er->cam_count;
-	er->writer_queues.cam_count = er->cam_count;
 	for (int i = 0; i < er->cam_count; i++) {
 
-		// If any of these asserts failed see docs on euroc_recorder_receive/save_cam
+		// If this assert failed see docs on euroc_recorder_receive_cam
 		assert(euroc_recorder_receive_cam[ARRAY_SIZE(euroc_recorder_receive_cam) - 1] != nullptr);
-		assert(euroc_recorder_save_cam[ARRAY_SIZE(euroc_recorder_save_cam) - 1] != nullptr);
 
 		u_sink_queue_create(xfctx, 0, &er->cloner_sinks[i], &er->cloner_queues.cams[i]);
 		er->cloner_sinks[i].push_frame = euroc_recorder_receive_cam[i];
-		u_sink_queue_create(xfctx, 0, &er->writer_sinks[i], &er->writer_queues.cams[i]);
-		er->writer_sinks[i].push_frame = euroc_recorder_save_cam[i];
 	}
 
+	// We use a std::queue for IMU and groundtruth samples
 	er->cloner_queues.imu = &er->cloner_imu_sink;
 	er->cloner_imu_sink.push_imu = euroc_recorder_receive_imu;
-	er->writer_queues.imu = nullptr; // We use a std::queue instead
 	er->writer_imu_sink.push_imu = euroc_recorder_save_imu;
 
 	er->cloner_queues.gt = &er->cloner_gt_sink;
 	er->cloner_gt_sink.push_pose = euroc_recorder_receive_gt;
-	er->writer_queues.gt = nullptr; // We use a std::queue instead
 	er->writer_gt_sink.push_pose = euroc_recorder_save_gt;
 
 	xrt_slam_sinks *public_sinks = &er->cloner_queues;
@@ -427,9 +648,28 @@ euroc_recorder_stop(struct xrt_slam_sinks *er_sinks)
 		return;
 	}
 
+	// After this no cloner sink touches the streams or pushes encode tasks.
+	euroc_recorder_stop_pushes(er);
 	er->path = "";
-	er->recording = false;
+
+	// The images and their CSV rows are complete once all pending frames are written.
+	euroc_recorder_wait_pending(er);
 	euroc_recorder_flush(er);
+
+	// Sets still missing frames won't get them now that we have stopped, leave them out of the CSV files.
+	{
+		lock_guard lock{er->stats.lock};
+		for (const euroc_recorder_frame_set &set : er->stats.frame_sets) {
+			euroc_recorder_release_frame_set(er, set);
+		}
+		er->stats.frame_sets.clear();
+	}
+
+	er->imu_csv->flush();
+	er->gt_csv->flush();
+	for (int i = 0; i < er->cam_count; i++) {
+		er->cams_csv[i]->flush();
+	}
 }
 
 static void
@@ -456,4 +696,15 @@ euroc_recorder_add_ui(struct xrt_slam_sinks *er_sinks, void *root, const char *p
 	char tmp[256];
 	(void)snprintf(tmp, sizeof(tmp), "%s%s", prefix, er->recording ? "Stop recording" : "Record EuRoC dataset");
 	u_var_add_button(root, &er->recording_btn, tmp);
+
+	(void)snprintf(tmp, sizeof(tmp), "%sFrames being written", prefix);
+	u_var_add_ro_i32(root, &er->stats.pending, tmp);
+	(void)snprintf(tmp, sizeof(tmp), "%sMost frames being written", prefix);
+	u_var_add_ro_i32(root, &er->stats.peak_pending, tmp);
+	(void)snprintf(tmp, sizeof(tmp), "%sFrames written", prefix);
+	u_var_add_ro_u64(root, &er->stats.written, tmp);
+	(void)snprintf(tmp, sizeof(tmp), "%sFrames dropped", prefix);
+	u_var_add_ro_u64(root, &er->stats.dropped, tmp);
+	(void)snprintf(tmp, sizeof(tmp), "%sFrames failed to write", prefix);
+	u_var_add_ro_u64(root, &er->stats.failed, tmp);
 }
@@ -109,6 +109,45 @@ calibration_get_undistort_map(t_camera_calibration &calib,
 	return ret;
 }
 
+void
+calibration_undistort_points(t_camera_calibration &calib,
+                             const cv::Mat &rectify_transform,
+                             const cv::Mat &new_camera_matrix,
+                             std::vector<cv::Point2f> &points)
+{
+	if (points.empty()) {
+		return;
+	}
+
+	CameraCalibrationWrapper wrap(calib);
+	cv::Mat camera_matrix = new_camera_matrix.empty() ? cv::Mat(wrap.intrinsics_mat) : new_camera_matrix;
+	std::vector<cv::Point2f> undistorted;
+
+	switch (calib.distortion_model) {
+	case T_DISTORTION_FISHEYE_KB4:
+		cv::fisheye::undistortPoints(points,              // distorted
+		                             undistorted,         // undistorted
+		                             wrap.intrinsics_mat, // K
+		                             wrap.distortion_mat, // D
+		                             rectify_transform,   // R
+		                             camera_matrix);      // P
+		break;
+	case T_DISTORTION_OPENCV_RADTAN_5:
+		// More iterations than the default, the points have to agree with the maps.
+		cv::undistortPoints(points,              // src
+		                    undistorted,         // dst
+		                    wrap.intrinsics_mat, // cameraMatrix
+		                    wrap.distortion_mat, // distCoeffs
+		                    rectify_transform,   // R
+		                    camera_matrix,       // P
+		                    cv::TermCriteria(cv::TermCriteria::COUNT | cv::TermCriteria::EPS, 20, 1e-6));
+		break;
+	default: assert(false);
+	}
+
+	points.swap(undistorted);
+}
+
 StereoRectificationMaps::StereoRectificationMaps(t_stereo_camera_calibration *data)
 {
 	CALIB_ASSERT_(data != NULL);
@@ -38,8 +38,9 @@ FrameMat::fillInFields(cv::Mat mat, xrt_format format, const Params &params)
 
 	this->matrix = mat;
 
-	// Main wrapping of cv::Mat by frame.
+	// Main wrapping of cv::Mat by frame, clear any fields from a previous use.
 	xrt_frame &frame = this->frame;
+	frame = {};
 	frame.reference.count = 1;
 	frame.destroy = destroyFrame;
 	frame.data = mat.ptr<uint8_t>();
@@ -68,7 +69,14 @@ void
 FrameMat::destroyFrame(xrt_frame *xf)
 {
 	FrameMat *fm = (FrameMat *)xf;
-	delete fm;
+	if (!fm->pool) {
+		delete fm;
+		return;
+	}
+
+	// This might be the last reference, keep the pool alive until it is done.
+	std::shared_ptr<FrameMatPool> pool = std::move(fm->pool);
+	pool->release(fm);
 }
 
 
@@ -113,4 +121,183 @@ FrameMat::wrapL8(const cv::Mat &mat, xrt_frame **fm_out, const Params /*&&?*/ pa
 }
 
 
+/*
+ *
+ * Pool functions.
+ *
+ */
+
+std::shared_ptr<FrameMatPool>
+FrameMatPool::create()
+{
+	// The constructor is private so make_shared can't be used.
+	std::shared_ptr<FrameMatPool> pool(new FrameMatPool());
+	pool->wrappers.reserve(kMaxFree);
+
+	return pool;
+}
+
+FrameMatPool::~FrameMatPool()
+{
+	for (FrameMat *fm : wrappers) {
+		delete fm;
+	}
+	for (Bucket &b : buckets) {
+		for (FrameMat *fm : b.free) {
+			delete fm;
+		}
+	}
+}
+
+std::vector<FrameMat *> &
+FrameMatPool::getFreeList(int type, int rows, int cols)
+{
+	for (Bucket &b : buckets) {
+		if (b.type == type && b.rows == rows && b.cols == cols) {
+			return b.free;
+		}
+	}
+
+	// Only allocates the first time a format and size is seen.
+	buckets.push_back(Bucket{type, rows, cols, {}});
+	buckets.back().free.reserve(kMaxFree);
+
+	return buckets.back().free;
+}
+
+FrameMat *
+FrameMatPool::getWrapper()
+{
+	FrameMat *fm = nullptr;
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		if (!wrappers.empty()) {
+			fm = wrappers.back();
+			wrappers.pop_back();
+		}
+	}
+
+	if (fm == nullptr) {
+		fm = new FrameMat();
+	}
+
+	fm->pool = shared_from_this();
+
+	return fm;
+}
+
+FrameMat *
+FrameMatPool::getWithMemory(int type, int rows, int cols)
+{
+	FrameMat *fm = nullptr;
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		std::vector<FrameMat *> &list = getFreeList(type, rows, cols);
+		if (!list.empty()) {
+			fm = list.back();
+			list.pop_back();
+		}
+	}
+
+	if (fm == nullptr) {
+		fm = new FrameMat();
+		fm->matrix = cv::Mat(rows, cols, type);
+		fm->pool_memory = true;
+	}
+
+	fm->pool = shared_from_this();
+
+	return fm;
+}
+
+void
+FrameMatPool::wrap(const cv::Mat &mat, xrt_format format, xrt_frame **xf_out, const FrameMat::Params &params)
+{
+	FrameMat *fm = getWrapper();
+	fm->fillInFields(mat, format, params);
+
+	// Unreference any old frames.
+	xrt_frame_reference(xf_out, NULL);
+
+	// Already has a ref count of one.
+	*xf_out = &fm->frame;
+}
+
+void
+FrameMatPool::alloc(int type,
+                    xrt_format format,
+                    int rows,
+                    int cols,
+                    xrt_frame **xf_out,
+                    cv::Mat &out_mat,
+                    const FrameMat::Params &params)
+{
+	FrameMat *fm = getWithMemory(type, rows, cols);
+	fm->fillInFields(fm->matrix, format, params);
+
+	// Doesn't claim ownership of the frame data, so no allocation.
+	out_mat = cv::Mat(rows, cols, type, fm->frame.data, fm->frame.stride);
+
+	// Unreference any old frames.
+	xrt_frame_reference(xf_out, NULL);
+
+	// Already has a ref count of one.
+	*xf_out = &fm->frame;
+}
+
+void
+FrameMatPool::wrapR8G8B8(const cv::Mat &mat, xrt_frame **xf_out, FrameMat::Params params)
+{
+	assert(mat.channels() == 3);
+	assert(mat.type() == CV_8UC3);
+
+	wrap(mat, XRT_FORMAT_R8G8B8, xf_out, params);
+}
+
+void
+FrameMatPool::wrapL8(const cv::Mat &mat, xrt_frame **xf_out, FrameMat::Params params)
+{
+	assert(mat.channels() == 1);
+	assert(mat.type() == CV_8UC1);
+
+	wrap(mat, XRT_FORMAT_L8, xf_out, params);
+}
+
+void
+FrameMatPool::allocR8G8B8(int rows, int cols, xrt_frame **xf_out, cv::Mat &out_mat, FrameMat::Params params)
+{
+	alloc(CV_8UC3, XRT_FORMAT_R8G8B8, rows, cols, xf_out, out_mat, params);
+}
+
+void
+FrameMatPool::allocL8(int rows, int cols, xrt_frame **xf_out, cv::Mat &out_mat, FrameMat::Params params)
+{
+	alloc(CV_8UC1, XRT_FORMAT_L8, rows, cols, xf_out, out_mat, params);
+}
+
+void
+FrameMatPool::release(FrameMat *fm)
+{
+	if (!fm->pool_memory) {
+		// Let go of the wrapped data now, not when the wrapper is reused.
+		fm->matrix.release();
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+
+		std::vector<FrameMat *> &list =
+		    fm->pool_memory ? getFreeList(fm->matrix.type(), fm->matrix.rows, fm->matrix.cols) : wrappers;
+
+		if (list.size() < kMaxFree) {
+			list.push_back(fm);
+			return;
+		}
+	}
+
+	// Enough of these are kept around already.
+	delete fm;
+}
+
+
 } // namespace xrt::auxiliary::tracking
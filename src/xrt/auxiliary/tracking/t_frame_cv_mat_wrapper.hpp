@@ -7,14 +7,22 @@
  * @ingroup aux_tracking
  */
 
+#pragma once
+
 #include "xrt/xrt_frame.h"
 
 #include <opencv2/opencv.hpp>
 
+#include <memory>
+#include <mutex>
+#include <vector>
+
 
 namespace xrt::auxiliary::tracking {
 
 
+class FrameMatPool;
+
 /*!
  * This class implements the @ref xrt_frame interface, allowing interfacing to
  * @p cv::Mat from C code. Keeps a reference to the cv::Mat and so the data
@@ -37,6 +45,12 @@ public:
 	// The cv::Mat that holds the data.
 	cv::Mat matrix = cv::Mat();
 
+	//! The pool this wrapper goes back to, only set while the frame is in use.
+	std::shared_ptr<FrameMatPool> pool = {};
+
+	//! Is @ref matrix memory owned by the pool, rather than a wrapped matrix.
+	bool pool_memory = false;
+
 
 public: // Methods
 	/*!
@@ -59,6 +73,8 @@ public: // Methods
 
 
 private:
+	friend class FrameMatPool;
+
 	~FrameMat();
 	FrameMat();
 
@@ -70,6 +86,99 @@ private:
 	destroyFrame(xrt_frame *frame);
 };
 
+/*!
+ * Recycles @ref FrameMat wrappers, and the memory of the frames it hands out,
+ * keyed by format and size. Once warmed up frames can go from a camera through
+ * trackers to debug sinks without any heap allocations. Frames in use keep the
+ * pool alive, so the owner can let go of it before all frames are returned.
+ */
+class FrameMatPool : public std::enable_shared_from_this<FrameMatPool>
+{
+public:
+	//! Max number of unused wrappers kept for each format and size.
+	static constexpr size_t kMaxFree = 8;
+
+	static std::shared_ptr<FrameMatPool>
+	create();
+
+	~FrameMatPool();
+
+	/*!
+	 * Same as @ref FrameMat::wrapR8G8B8 but the wrapper is from the pool.
+	 */
+	void
+	wrapR8G8B8(const cv::Mat &mat, xrt_frame **xf_out, FrameMat::Params params = {});
+
+	/*!
+	 * Same as @ref FrameMat::wrapL8 but the wrapper is from the pool.
+	 */
+	void
+	wrapL8(const cv::Mat &mat, xrt_frame **xf_out, FrameMat::Params params = {});
+
+	/*!
+	 * Get a 24bit RGB frame with memory from the pool, @p out_mat points at
+	 * the frame data but doesn't keep it alive, so it must not be used after
+	 * the reference to the frame is dropped. Any old frame in @p xf_out is
+	 * unreferenced.
+	 */
+	void
+	allocR8G8B8(int rows, int cols, xrt_frame **xf_out, cv::Mat &out_mat, FrameMat::Params params = {});
+
+	/*!
+	 * Same as @ref allocR8G8B8 but for 8bit frames.
+	 */
+	void
+	allocL8(int rows, int cols, xrt_frame **xf_out, cv::Mat &out_mat, FrameMat::Params params = {});
+
+
+private:
+	friend class FrameMat;
+
+	struct Bucket
+	{
+		int type;
+		int rows;
+		int cols;
+		std::vector<FrameMat *> free;
+	};
+
+	std::mutex mutex;
+
+	//! Unused wrappers without memory of their own.
+	std::vector<FrameMat *> wrappers;
+
+	//! Unused frames with memory, by type and size.
+	std::vector<Bucket> buckets;
+
+
+	FrameMatPool() = default;
+
+	std::vector<FrameMat *> &
+	getFreeList(int type, int rows, int cols);
+
+	FrameMat *
+	getWrapper();
+
+	FrameMat *
+	getWithMemory(int type, int rows, int cols);
+
+	void
+	wrap(const cv::Mat &mat, xrt_format format, xrt_frame **xf_out, const FrameMat::Params &params);
+
+	void
+	alloc(int type,
+	      xrt_format format,
+	      int rows,
+	      int cols,
+	      xrt_frame **xf_out,
+	      cv::Mat &out_mat,
+	      const FrameMat::Params &params);
+
+	//! Called when the reference count of a frame from this pool reaches zero.
+	void
+	release(FrameMat *fm);
+};
+
 
 
 } // namespace xrt::auxiliary::tracking
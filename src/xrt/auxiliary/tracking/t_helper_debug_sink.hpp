@@ -14,7 +14,7 @@
 #endif
 
 #include "util/u_sink.h"
-#include "util/u_frame.h"
+#include "tracking/t_frame_cv_mat_wrapper.hpp"
 #include <opencv2/opencv.hpp>
 
 namespace xrt::auxiliary::tracking {
@@ -35,6 +35,8 @@ public:
 
 	cv::Mat rgb[2] = {};
 
+	//! Recycles the frames pushed to the sink.
+	std::shared_ptr<FrameMatPool> pool = FrameMatPool::create();
 
 
 	HelperDebugSink(Kind kind)
@@ -88,8 +90,9 @@ public:
 		default: return;
 		}
 
-		// Create a new frame and also dereferences the old frame.
-		u_frame_create_one_off(XRT_FORMAT_R8G8B8, width, height, &frame);
+		// Get a frame from the pool and also dereferences the old frame.
+		cv::Mat full;
+		pool->allocR8G8B8(height, width, &frame, full);
 
 		// Copy needed info.
 		frame->source_sequence = xf->source_sequence;
@@ -97,22 +100,10 @@ public:
 
 		// Doesn't claim ownership of the frame data,
 		// points directly at the frame data.
-		rgb[0] = cv::Mat(   //
-		    rows,           // rows
-		    cols,           // cols
-		    CV_8UC3,        // channels
-		    frame->data,    // data
-		    frame->stride); // stride
+		rgb[0] = full(cv::Rect(0, 0, cols, rows));
 
 		if (second_view) {
-			// Doesn't claim ownership of the frame data,
-			// points directly at the frame data.
-			rgb[1] = cv::Mat(           //
-			    rows,                   // rows
-			    cols,                   // cols
-			    CV_8UC3,                // channels
-			    frame->data + 3 * cols, // data
-			    frame->stride);         // stride
+			rgb[1] = full(cv::Rect(cols, 0, cols, rows));
 		}
 	}
 
@@ -0,0 +1,51 @@
+// Copyright 2025, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Small helper for processing both views of a stereo frame at once.
+ * @author agent <agent@local>
+ * @ingroup aux_tracking
+ */
+
+#pragma once
+
+#ifndef __cplusplus
+#error "This header is C++-only."
+#endif
+
+#include "util/u_worker.h"
+
+namespace xrt::auxiliary::tracking {
+
+/*!
+ * Calls @p func with the view index 0 and 1 on @p group and waits for both.
+ * Waiting donates this thread to the pool, so a pool with one starting worker
+ * and two threads runs the views at the same time. @p func must only touch
+ * the state of its own view, results are read back once this returns.
+ */
+template <typename Func>
+void
+run_stereo_views(struct u_worker_group *group, const Func &func)
+{
+	struct Task
+	{
+		const Func *func;
+		int view_index;
+	};
+
+	Task tasks[2] = {
+	    {&func, 0},
+	    {&func, 1},
+	};
+
+	u_worker_group_func_t do_task = [](void *ptr) {
+		auto &task = *(Task *)ptr;
+		(*task.func)(task.view_index);
+	};
+
+	u_worker_group_push(group, do_task, &tasks[0]);
+	u_worker_group_push(group, do_task, &tasks[1]);
+	u_worker_group_wait_all(group);
+}
+
+} // namespace xrt::auxiliary::tracking
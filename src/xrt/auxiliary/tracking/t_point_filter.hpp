@@ -0,0 +1,91 @@
+// Copyright 2025, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Fixed size constant velocity Kalman filter for 3D points.
+ * @author agent <agent@local>
+ * @ingroup aux_tracking
+ */
+
+#pragma once
+
+#ifndef __cplusplus
+#error "This header is C++-only."
+#endif
+
+#include <Eigen/Core>
+#include <Eigen/Cholesky>
+
+
+namespace xrt::auxiliary::tracking {
+
+/*!
+ * @brief Constant velocity Kalman filter for a 3D point, measured directly.
+ *
+ * The state is position followed by velocity. This does the same maths as a
+ * `cv::KalmanFilter` set up with 6 states and 3 measurements, an identity
+ * measurement matrix and diagonal noise covariances, including keeping the
+ * predicted and corrected state apart. Everything is fixed size, so nothing is
+ * allocated on predict or correct.
+ */
+struct PointFilter
+{
+	EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+	using State = Eigen::Matrix<float, 6, 1>;
+	using Covariance = Eigen::Matrix<float, 6, 6>;
+
+	State state_pre = State::Zero();
+	State state_post = State::Zero();
+	Covariance cov_pre = Covariance::Zero();
+	Covariance cov_post = Covariance::Zero();
+
+	//! Diagonal of the process noise covariance.
+	float process_cov = 1.0f;
+
+	//! Diagonal of the measurement noise covariance.
+	float meas_cov = 1.0f;
+
+
+	PointFilter() = default;
+
+	PointFilter(float process_cov_, float meas_cov_) : process_cov(process_cov_), meas_cov(meas_cov_) {}
+
+	/*!
+	 * Advance the filter by @p dt and return the predicted position.
+	 */
+	Eigen::Vector3f
+	predict(float dt)
+	{
+		Covariance transition = Covariance::Identity();
+		transition.topRightCorner<3, 3>().diagonal().setConstant(dt);
+
+		state_pre = transition * state_post;
+		cov_pre = transition * cov_post * transition.transpose();
+		cov_pre.diagonal().array() += process_cov;
+
+		state_post = state_pre;
+		cov_post = cov_pre;
+
+		return state_pre.head<3>();
+	}
+
+	/*!
+	 * Correct the last prediction with a measured position.
+	 */
+	void
+	correct(const Eigen::Vector3f &measurement)
+	{
+		// The measurement matrix only picks out the position.
+		Eigen::Matrix<float, 3, 6> cov_meas = cov_pre.topRows<3>();
+		Eigen::Matrix3f innovation_cov = cov_meas.leftCols<3>();
+		innovation_cov.diagonal().array() += meas_cov;
+
+		Eigen::Matrix<float, 6, 3> gain = innovation_cov.ldlt().solve(cov_meas).transpose();
+
+		state_post = state_pre + gain * (measurement - state_pre.head<3>());
+		cov_post = cov_pre - gain * cov_meas;
+	}
+};
+
+} // namespace xrt::auxiliary::tracking
@@ -0,0 +1,246 @@
+// Copyright 2025, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Sparse bright blob extraction for LED trackers.
+ * @author agent <agent@local>
+ * @ingroup aux_tracking
+ */
+
+#include "tracking/t_sparse_blobs.hpp"
+
+#include <algorithm>
+#include <string.h>
+
+
+namespace xrt::auxiliary::tracking {
+
+namespace {
+
+//! Horizontal stretch of bright pixels, joined with others through a union-find.
+struct Run
+{
+	int32_t y;
+	int32_t x0; //!< First bright pixel.
+	int32_t x1; //!< Last bright pixel, inclusive.
+	uint32_t parent;
+};
+
+struct Accumulator
+{
+	double sum_x = 0;
+	double sum_y = 0;
+	int area = 0;
+	int32_t min_x = INT32_MAX;
+	int32_t max_x = INT32_MIN;
+	int32_t min_y = INT32_MAX;
+	int32_t max_y = INT32_MIN;
+	std::vector<uint32_t> runs; //!< Only filled when the convexity is needed.
+};
+
+struct Corner
+{
+	int64_t x;
+	int64_t y;
+};
+
+constexpr uint64_t kLowBytes = 0x0101010101010101ULL;
+constexpr uint64_t kHighBits = 0x8080808080808080ULL;
+
+/*!
+ * Non-zero if any byte of @p word is greater than the threshold @p bias was
+ * made from, the masking keeps the additions from carrying into the next byte.
+ */
+inline uint64_t
+any_byte_greater(uint64_t word, uint64_t bias)
+{
+	return (((word & ~kHighBits) + bias) | word) & kHighBits;
+}
+
+uint32_t
+find_root(std::vector<Run> &runs, uint32_t i)
+{
+	while (runs[i].parent != i) {
+		runs[i].parent = runs[runs[i].parent].parent;
+		i = runs[i].parent;
+	}
+	return i;
+}
+
+void
+join(std::vector<Run> &runs, uint32_t a, uint32_t b)
+{
+	a = find_root(runs, a);
+	b = find_root(runs, b);
+	if (a < b) {
+		runs[b].parent = a;
+	} else if (b < a) {
+		runs[a].parent = b;
+	}
+}
+
+void
+find_row_runs(const uint8_t *row, int32_t width, int32_t y, uint8_t threshold, std::vector<Run> &runs)
+{
+	// The word trick needs the top bit free for the carry.
+	bool use_words = threshold <= 127;
+	uint64_t bias = use_words ? kLowBytes * (uint64_t)(127 - threshold) : 0;
+
+	int32_t x = 0;
+	while (x < width) {
+		// Skip dark pixels, eight at a time.
+		while (use_words && x + 8 <= width) {
+			uint64_t word;
+			memcpy(&word, row + x, sizeof(word));
+			if (any_byte_greater(word, bias) != 0) {
+				break;
+			}
+			x += 8;
+		}
+		while (x < width && row[x] <= threshold) {
+			x++;
+		}
+		if (x >= width) {
+			break;
+		}
+
+		int32_t x0 = x;
+		while (x < width && row[x] > threshold) {
+			x++;
+		}
+		runs.push_back({y, x0, x - 1, (uint32_t)runs.size()});
+	}
+}
+
+int64_t
+cross(const Corner &o, const Corner &a, const Corner &b)
+{
+	return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+}
+
+//! Twice the area of the convex hull of the pixel corners of the given runs.
+int64_t
+hull_area_doubled(const std::vector<Run> &runs, const std::vector<uint32_t> &indices)
+{
+	std::vector<Corner> points;
+	points.reserve(indices.size() * 4);
+	for (uint32_t i : indices) {
+		const Run &r = runs[i];
+		points.push_back({r.x0, r.y});
+		points.push_back({r.x1 + 1, r.y});
+		points.push_back({r.x0, r.y + 1});
+		points.push_back({r.x1 + 1, r.y + 1});
+	}
+
+	std::sort(points.begin(), points.end(),
+	          [](const Corner &a, const Corner &b) { return a.x < b.x || (a.x == b.x && a.y < b.y); });
+
+	// Andrew's monotone chain.
+	std::vector<Corner> hull(points.size() * 2);
+	size_t k = 0;
+	for (size_t i = 0; i < points.size(); i++) {
+		while (k >= 2 && cross(hull[k - 2], hull[k - 1], points[i]) <= 0) {
+			k--;
+		}
+		hull[k++] = points[i];
+	}
+	for (size_t i = points.size() - 1, lower = k + 1; i > 0; i--) {
+		while (k >= lower && cross(hull[k - 2], hull[k - 1], points[i - 1]) <= 0) {
+			k--;
+		}
+		hull[k++] = points[i - 1];
+	}
+
+	int64_t area = 0;
+	for (size_t i = 0; i + 1 < k; i++) {
+		area += hull[i].x * hull[i + 1].y - hull[i + 1].x * hull[i].y;
+	}
+	return area;
+}
+
+} // namespace
+
+void
+find_bright_blobs(const uint8_t *data,
+                  uint32_t width,
+                  uint32_t height,
+                  size_t stride,
+                  const SparseBlobParams &params,
+                  std::vector<SparseBlob> &out_blobs)
+{
+	out_blobs.clear();
+
+	std::vector<Run> runs;
+	runs.reserve(256);
+
+	size_t prev_begin = 0;
+	size_t prev_end = 0;
+	for (uint32_t y = 0; y < height; y++) {
+		size_t cur_begin = runs.size();
+		find_row_runs(data + y * stride, (int32_t)width, (int32_t)y, params.threshold, runs);
+		size_t cur_end = runs.size();
+
+		// Join with the 8-connected runs of the row above, both rows are sorted on x.
+		size_t p = prev_begin;
+		for (size_t c = cur_begin; c < cur_end; c++) {
+			while (p < prev_end && runs[p].x1 < runs[c].x0 - 1) {
+				p++;
+			}
+			for (size_t q = p; q < prev_end && runs[q].x0 <= runs[c].x1 + 1; q++) {
+				join(runs, (uint32_t)c, (uint32_t)q);
+			}
+		}
+
+		prev_begin = cur_begin;
+		prev_end = cur_end;
+	}
+
+	bool want_convexity = params.min_convexity > 0.0f;
+	std::vector<int32_t> blob_of_root(runs.size(), -1);
+	std::vector<Accumulator> blobs;
+
+	for (uint32_t i = 0; i < runs.size(); i++) {
+		uint32_t root = find_root(runs, i);
+		if (blob_of_root[root] < 0) {
+			blob_of_root[root] = (int32_t)blobs.size();
+			blobs.emplace_back();
+		}
+
+		const Run &r = runs[i];
+		Accumulator &acc = blobs[blob_of_root[root]];
+		int len = r.x1 - r.x0 + 1;
+		acc.sum_x += len * (r.x0 + r.x1) * 0.5;
+		acc.sum_y += (double)len * r.y;
+		acc.area += len;
+		acc.min_x = std::min(acc.min_x, r.x0);
+		acc.max_x = std::max(acc.max_x, r.x1);
+		acc.min_y = std::min(acc.min_y, r.y);
+		acc.max_y = std::max(acc.max_y, r.y);
+		if (want_convexity) {
+			acc.runs.push_back(i);
+		}
+	}
+
+	for (const Accumulator &acc : blobs) {
+		if (acc.min_x == acc.max_x || acc.min_y == acc.max_y) {
+			continue;
+		}
+
+		SparseBlob blob = {};
+		blob.x = (float)(acc.sum_x / acc.area);
+		blob.y = (float)(acc.sum_y / acc.area);
+		blob.area = acc.area;
+		blob.convexity = 1.0f;
+
+		if (want_convexity) {
+			blob.convexity = (float)(2.0 * acc.area / (double)hull_area_doubled(runs, acc.runs));
+			if (blob.convexity < params.min_convexity) {
+				continue;
+			}
+		}
+
+		out_blobs.push_back(blob);
+	}
+}
+
+} // namespace xrt::auxiliary::tracking
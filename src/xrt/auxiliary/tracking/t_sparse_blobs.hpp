@@ -0,0 +1,80 @@
+// Copyright 2025, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Sparse bright blob extraction for LED trackers.
+ * @author agent <agent@local>
+ * @ingroup aux_tracking
+ */
+
+#pragma once
+
+#ifndef __cplusplus
+#error "This header is C++-only."
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+
+namespace xrt::auxiliary::tracking {
+
+/*!
+ * @brief A connected blob of bright pixels, in the coordinates of the image it
+ * was found in, pixel centers are at integer coordinates.
+ */
+struct SparseBlob
+{
+	float x;
+	float y;
+
+	//! Number of pixels in the blob.
+	int area;
+
+	//! Pixel area over the area of its convex hull, 1 for rectangles.
+	float convexity;
+};
+
+/*!
+ * @brief Parameters for find_bright_blobs().
+ */
+struct SparseBlobParams
+{
+	//! Pixels strictly brighter than this are part of a blob.
+	uint8_t threshold = 32;
+
+	//! Blobs less convex than this are dropped, zero skips computing the convexity.
+	float min_convexity = 0.0f;
+};
+
+/*!
+ * @brief Find the 8-connected blobs of bright pixels in a grey image.
+ *
+ * This is the sparse replacement for thresholding a remapped image and running
+ * `cv::SimpleBlobDetector` on it: the image is scanned once, dark stretches
+ * eight pixels at a time, and only runs of bright pixels are stored and
+ * joined. Blobs that are a single row or column are dropped, like the blob
+ * detector does since their contour has no area.
+ *
+ * Blobs close to each other are not merged. The trackers gave the blob
+ * detector a `minDistBetweenBlobs` of 5, but it only merges blobs found at
+ * different threshold levels and they used a single level, so it never did.
+ *
+ * @param data First pixel of the image.
+ * @param width Width in pixels.
+ * @param height Height in pixels.
+ * @param stride Bytes between rows.
+ * @param params Threshold and filtering.
+ * @param[out] out_blobs Found blobs, cleared first.
+ */
+void
+find_bright_blobs(const uint8_t *data,
+                  uint32_t width,
+                  uint32_t height,
+                  size_t stride,
+                  const SparseBlobParams &params,
+                  std::vector<SparseBlob> &out_blobs);
+
+} // namespace xrt::auxiliary::tracking
@@ -15,6 +15,8 @@
 #include "tracking/t_calibration_opencv.hpp"
 #include "tracking/t_tracker_psmv_fusion.hpp"
 #include "tracking/t_helper_debug_sink.hpp"
+#include "tracking/t_helper_stereo_views.hpp"
+#include "tracking/t_sparse_blobs.hpp"
 
 #include "util/u_var.h"
 #include "util/u_misc.h"
@@ -22,10 +24,13 @@
 #include "util/u_frame.h"
 #include "util/u_format.h"
 #include "util/u_trace_marker.h"
+#include "util/u_time.h"
+#include "util/u_worker.h"
 
 #include "math/m_api.h"
 
 #include "os/os_threading.h"
+#include "os/os_time.h"
 
 #include <stdio.h>
 #include <assert.h>
@@ -53,20 +58,31 @@ public:
 	cv::Mat distortion; // size may vary
 	enum t_camera_distortion_model distortion_model;
 
+	//! Kept for undistorting the blob centers.
+	t_camera_calibration calib;
+	cv::Mat rectify_rotation;
+	cv::Mat rectify_projection;
+
+	std::vector<SparseBlob> blobs;
+	std::vector<cv::Point2f> blob_points;
 	std::vector<cv::KeyPoint> keypoints;
 
+	//! Only made for the debug image.
 	cv::Mat frame_undist_rectified;
 
 	void
-	populate_from_calib(t_camera_calibration &calib, const RemapPair &rectification)
+	populate_from_calib(t_camera_calibration &calib_, const ViewRectification &rectification)
 	{
-		CameraCalibrationWrapper wrap(calib);
+		CameraCalibrationWrapper wrap(calib_);
 		intrinsics = wrap.intrinsics_mat;
 		distortion = wrap.distortion_mat.clone();
 		distortion_model = wrap.distortion_model;
+		calib = calib_;
 
-		undistort_rectify_map_x = rectification.remap_x;
-		undistort_rectify_map_y = rectification.remap_y;
+		undistort_rectify_map_x = rectification.rectify.remap_x;
+		undistort_rectify_map_y = rectification.rectify.remap_y;
+		rectify_rotation = rectification.rotation_mat;
+		rectify_projection = rectification.projection_mat;
 	}
 };
 
@@ -114,7 +130,14 @@ public:
 	cv::Vec3d r_cam_translation;
 	cv::Matx33d r_cam_rotation;
 
-	cv::Ptr<cv::SimpleBlobDetector> sbd;
+	SparseBlobParams blob_params;
+
+	//! Both views of a frame are processed at the same time on these.
+	struct u_worker_thread_pool *pool;
+	struct u_worker_group *group;
+
+	//! How long each view took for the last frame, in milliseconds.
+	float view_ms[2];
 
 	std::shared_ptr<PSMVFusionInterface> filter;
 
@@ -136,9 +159,37 @@ do_view(TrackerPSMV &t, View &view, cv::Mat &grey, cv::Mat &rgb)
 	XRT_TRACE_MARKER();
 
 	{
-		XRT_TRACE_IDENT(remap);
+		XRT_TRACE_IDENT(blobs);
+
+		// Find the blobs in the distorted image, only their centers get rectified.
+		find_bright_blobs(grey.data, grey.cols, grey.rows, grey.step, t.blob_params, view.blobs);
+	}
+
+	{
+		XRT_TRACE_IDENT(rectify);
+
+		view.blob_points.clear();
+		for (const SparseBlob &blob : view.blobs) {
+			view.blob_points.emplace_back(blob.x, blob.y);
+		}
+		calibration_undistort_points(view.calib, view.rectify_rotation, view.rectify_projection, view.blob_points);
+
+		view.keypoints.clear();
+		for (size_t i = 0; i < view.blob_points.size(); i++) {
+			const cv::Point2f &pt = view.blob_points[i];
+
+			// The rectified image is black outside of the remap.
+			if (pt.x < 0 || pt.y < 0 || pt.x >= grey.cols || pt.y >= grey.rows) {
+				continue;
+			}
+
+			float diameter = 2.0f * std::sqrt(view.blobs[i].area / (float)M_PI);
+			view.keypoints.emplace_back(pt, diameter);
+		}
+	}
 
-		// Undistort and rectify the whole image.
+	// Debug is wanted, rectify the whole image and draw the keypoints.
+	if (rgb.cols > 0) {
 		cv::remap(grey,                         // src
 		          view.frame_undist_rectified,  // dst
 		          view.undistort_rectify_map_x, // map1
@@ -146,31 +197,13 @@ do_view(TrackerPSMV &t, View &view, cv::Mat &grey, cv::Mat &rgb)
 		          cv::INTER_NEAREST,            // interpolation
 		          cv::BORDER_CONSTANT,          // borderMode
 		          cv::Scalar(0, 0, 0));         // borderValue
-	}
-
-	{
-		XRT_TRACE_IDENT(threshold);
 
 		cv::threshold(view.frame_undist_rectified, // src
 		              view.frame_undist_rectified, // dst
-		              32.0,                        // thresh
+		              t.blob_params.threshold,     // thresh
 		              255.0,                       // maxval
 		              0);                          // type
-	}
-
-	{
-		XRT_TRACE_IDENT(detect);
 
-		// Do blob detection with our masks.
-		//! @todo Re-enable masks.
-		t.sbd->detect(view.frame_undist_rectified, // image
-		              view.keypoints,              // keypoints
-		              cv::noArray());              // mask
-	}
-
-
-	// Debug is wanted, draw the keypoints.
-	if (rgb.cols > 0) {
 		cv::drawKeypoints(view.frame_undist_rectified,                // image
 		                  view.keypoints,                             // keypoints
 		                  rgb,                                        // outImage
@@ -287,8 +320,12 @@ process(TrackerPSMV &t, struct xrt_frame *xf)
 	cv::Mat l_grey(rows, cols, CV_8UC1, xf->data, stride);
 	cv::Mat r_grey(rows, cols, CV_8UC1, xf->data + cols, stride);
 
-	do_view(t, t.view[0], l_grey, t.debug.rgb[0]);
-	do_view(t, t.view[1], r_grey, t.debug.rgb[1]);
+	// Each view only touches its own View and debug image.
+	run_stereo_views(t.group, [&](int i) {
+		uint64_t start_ns = os_monotonic_get_ns();
+		do_view(t, t.view[i], i == 0 ? l_grey : r_grey, t.debug.rgb[i]);
+		t.view_ms[i] = (float)time_ns_to_ms_f((time_duration_ns)(os_monotonic_get_ns() - start_ns));
+	});
 
 	cv::Point3f last_point(t.tracked_object_position.x, t.tracked_object_position.y, t.tracked_object_position.z);
 	auto nearest_world = make_lowest_score_finder<cv::Point3f>([&](const cv::Point3f &world_point) {
@@ -529,6 +566,9 @@ t_psmv_node_destroy(struct xrt_frame_node *node)
 	auto *t_ptr = container_of(node, TrackerPSMV, node);
 	os_thread_helper_destroy(&t_ptr->oth);
 
+	u_worker_group_reference(&t_ptr->group, NULL);
+	u_worker_thread_pool_reference(&t_ptr->pool, NULL);
+
 	// Tidy variable setup.
 	u_var_remove_root(t_ptr);
 
@@ -590,6 +630,10 @@ t_psmv_create(struct xrt_frame_context *xfctx,
 		return ret;
 	}
 
+	// One worker, the run thread waiting on the group lets the second one in.
+	t.pool = u_worker_thread_pool_create(1, 2, "PSMV view");
+	t.group = u_worker_group_create(t.pool);
+
 	static int hack = 0;
 	switch (hack++) {
 	case 0:
@@ -610,37 +654,24 @@ t_psmv_create(struct xrt_frame_context *xfctx,
 	}
 
 	StereoRectificationMaps rectify(data);
-	t.view[0].populate_from_calib(data->view[0], rectify.view[0].rectify);
-	t.view[1].populate_from_calib(data->view[1], rectify.view[1].rectify);
+	t.view[0].populate_from_calib(data->view[0], rectify.view[0]);
+	t.view[1].populate_from_calib(data->view[1], rectify.view[1]);
 	t.disparity_to_depth = rectify.disparity_to_depth_mat;
 	StereoCameraCalibrationWrapper wrapped(data);
 	t.r_cam_rotation = wrapped.camera_rotation_mat;
 	t.r_cam_translation = wrapped.camera_translation_mat;
 	t.calibrated = true;
 
-	// clang-format off
-	cv::SimpleBlobDetector::Params blob_params;
-	blob_params.filterByArea = false;
-	blob_params.filterByConvexity = true;
-	blob_params.minConvexity = 0.8;
-	blob_params.filterByInertia = false;
-	blob_params.filterByColor = true;
-	blob_params.blobColor = 255; // 0 or 255 - color comes from binarized image?
-	blob_params.minArea = 1;
-	blob_params.maxArea = 1000;
-	blob_params.maxThreshold = 51; // using a wide threshold span slows things down bigtime
-	blob_params.minThreshold = 50;
-	blob_params.thresholdStep = 1;
-	blob_params.minDistBetweenBlobs = 5;
-	blob_params.minRepeatability = 1; // need this to avoid error?
-	// clang-format on
-
-	t.sbd = cv::SimpleBlobDetector::create(blob_params);
+	// Pixels brighter than this are the ball, it should make a round blob.
+	t.blob_params.threshold = 32;
+	t.blob_params.min_convexity = 0.8f;
 	xrt_frame_context_add(xfctx, &t.node);
 
 	// Everything is safe, now setup the variable tracking.
 	u_var_add_root(&t, "PSMV Tracker", true);
 	u_var_add_vec3_f32(&t, &t.tracked_object_position, "last.ball.pos");
+	u_var_add_ro_f32(&t, &t.view_ms[0], "Left view (ms)");
+	u_var_add_ro_f32(&t, &t.view_ms[1], "Right view (ms)");
 	u_var_add_sink_debug(&t, &t.debug.usd, "Debug");
 
 	*out_sink = &t.sink;
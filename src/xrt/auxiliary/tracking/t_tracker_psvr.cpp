@@ -13,6 +13,9 @@
 #include "tracking/t_tracking.h"
 #include "tracking/t_calibration_opencv.hpp"
 #include "tracking/t_helper_debug_sink.hpp"
+#include "tracking/t_helper_stereo_views.hpp"
+#include "tracking/t_point_filter.hpp"
+#include "tracking/t_sparse_blobs.hpp"
 
 #include "util/u_misc.h"
 #include "util/u_debug.h"
@@ -20,6 +23,8 @@
 #include "util/u_format.h"
 #include "util/u_var.h"
 #include "util/u_logging.h"
+#include "util/u_time.h"
+#include "util/u_worker.h"
 
 #include "math/m_mathinclude.h"
 #include "math/m_api.h"
@@ -27,6 +32,7 @@
 #include "math/m_imu_3dof.h"
 
 #include "os/os_threading.h"
+#include "os/os_time.h"
 
 #include <stdio.h>
 #include <assert.h>
@@ -139,20 +145,31 @@ struct View
 	cv::Mat distortion; // size may vary
 	enum t_camera_distortion_model distortion_model;
 
+	//! Kept for undistorting the blob centers.
+	t_camera_calibration calib;
+	cv::Mat rectify_rotation;
+	cv::Mat rectify_projection;
+
+	std::vector<SparseBlob> blobs;
+	std::vector<cv::Point2f> blob_points;
 	std::vector<cv::KeyPoint> keypoints;
 
+	//! Only made for the debug image.
 	cv::Mat frame_undist_rectified;
 
 	void
-	populate_from_calib(t_camera_calibration &calib, const RemapPair &rectification)
+	populate_from_calib(t_camera_calibration &calib_, const ViewRectification &rectification)
 	{
-		CameraCalibrationWrapper wrap(calib);
+		CameraCalibrationWrapper wrap(calib_);
 		intrinsics = wrap.intrinsics_mat;
 		distortion = wrap.distortion_mat.clone();
 		distortion_model = wrap.distortion_model;
+		calib = calib_;
 
-		undistort_rectify_map_x = rectification.remap_x;
-		undistort_rectify_map_y = rectification.remap_y;
+		undistort_rectify_map_x = rectification.rectify.remap_x;
+		undistort_rectify_map_y = rectification.rectify.remap_y;
+		rectify_rotation = rectification.rotation_mat;
+		rectify_projection = rectification.projection_mat;
 	}
 };
 
@@ -253,14 +270,15 @@ public:
 	model_vertex_t model_vertices[PSVR_NUM_LEDS]; // the model we match our
 	                                              // measurements against
 	std::vector<match_data_t> last_vertices;      // the last solved position of the HMD
+	std::vector<match_data_t> predicted_pose;     // per LED prediction for this frame
 
 	uint32_t last_optical_model;
 
-	cv::KalmanFilter track_filters[PSVR_NUM_LEDS];
+	PointFilter track_filters[PSVR_NUM_LEDS];
 
 
-	cv::KalmanFilter pose_filter; // we filter the final pose position of
-	                              // the HMD to smooth motion
+	PointFilter pose_filter; // we filter the final pose position of
+	                         // the HMD to smooth motion
 
 	View view[2];
 	bool calibrated;
@@ -271,8 +289,16 @@ public:
 	cv::Vec3d r_cam_translation;
 	cv::Matx33d r_cam_rotation;
 
-	cv::Ptr<cv::SimpleBlobDetector> sbd;
+	SparseBlobParams blob_params;
 	std::vector<cv::KeyPoint> l_blobs, r_blobs;
+
+	//! Both views of a frame are processed at the same time on these.
+	struct u_worker_thread_pool *pool;
+	struct u_worker_group *group;
+
+	//! How long each view took for the last frame, in milliseconds.
+	float view_ms[2];
+
 	std::vector<match_model_t> matches;
 
 	// we refine our measurement by rejecting outliers and merging 'too
@@ -318,93 +344,39 @@ dist_3d_cv(const cv::Point3f &a, const cv::Point3f &b)
 }
 
 static void
-init_filter(cv::KalmanFilter &kf, float process_cov, float meas_cov, float dt)
-{
-	kf.init(6, 3);
-	kf.transitionMatrix =
-	    (cv::Mat_<float>(6, 6) << 1.0, 0.0, 0.0, dt, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, dt, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0,
-	     dt, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0);
-
-	cv::setIdentity(kf.measurementMatrix, cv::Scalar::all(1.0f));
-	cv::setIdentity(kf.errorCovPost, cv::Scalar::all(0.0f));
-
-	// our filter parameters set the process and measurement noise
-	// covariances.
-
-	cv::setIdentity(kf.processNoiseCov, cv::Scalar::all(process_cov));
-	cv::setIdentity(kf.measurementNoiseCov, cv::Scalar::all(meas_cov));
-}
-
-static void
-filter_predict(std::vector<match_data_t> *pose, cv::KalmanFilter *filters, float dt)
+filter_predict(std::vector<match_data_t> *pose, PointFilter *filters, float dt)
 {
 	for (uint32_t i = 0; i < PSVR_NUM_LEDS; i++) {
 		match_data_t current_led;
-		cv::KalmanFilter *current_kf = filters + i;
-
-		// set our dt components in the transition matrix
-		current_kf->transitionMatrix.at<float>(0, 3) = dt;
-		current_kf->transitionMatrix.at<float>(1, 4) = dt;
-		current_kf->transitionMatrix.at<float>(2, 5) = dt;
 
 		current_led.vertex_index = i;
 		// current_led->tag = (led_tag_t)(i);
-		cv::Mat prediction = current_kf->predict();
-		current_led.position[0] = prediction.at<float>(0, 0);
-		current_led.position[1] = prediction.at<float>(1, 0);
-		current_led.position[2] = prediction.at<float>(2, 0);
+		current_led.position.head<3>() = filters[i].predict(dt);
 		pose->push_back(current_led);
 	}
 }
 
 static void
-filter_update(std::vector<match_data_t> *pose, cv::KalmanFilter *filters, float dt)
+filter_update(std::vector<match_data_t> *pose, PointFilter *filters)
 {
 	for (uint32_t i = 0; i < PSVR_NUM_LEDS; i++) {
 		match_data_t *current_led = &pose->at(i);
-		cv::KalmanFilter *current_kf = filters + i;
-
-		// set our dt components in the transition matrix
-		current_kf->transitionMatrix.at<float>(0, 3) = dt;
-		current_kf->transitionMatrix.at<float>(1, 4) = dt;
-		current_kf->transitionMatrix.at<float>(2, 5) = dt;
 
 		current_led->vertex_index = i;
-
-		cv::Mat measurement = cv::Mat(3, 1, CV_32F);
-		measurement.at<float>(0, 0) = current_led->position[0];
-		measurement.at<float>(1, 0) = current_led->position[1];
-		measurement.at<float>(2, 0) = current_led->position[2];
-		current_kf->correct(measurement);
+		filters[i].correct(current_led->position.head<3>());
 	}
 }
 
 static void
-pose_filter_predict(Eigen::Vector4f *pose, cv::KalmanFilter *filter, float dt)
+pose_filter_predict(Eigen::Vector4f *pose, PointFilter *filter, float dt)
 {
-	// set our dt components in the transition matrix
-	filter->transitionMatrix.at<float>(0, 3) = dt;
-	filter->transitionMatrix.at<float>(1, 4) = dt;
-	filter->transitionMatrix.at<float>(2, 5) = dt;
-
-	cv::Mat prediction = filter->predict();
-	(*pose)[0] = prediction.at<float>(0, 0);
-	(*pose)[1] = prediction.at<float>(1, 0);
-	(*pose)[2] = prediction.at<float>(2, 0);
+	pose->head<3>() = filter->predict(dt);
 }
 
 static void
-pose_filter_update(Eigen::Vector4f *position, cv::KalmanFilter *filter, float dt)
+pose_filter_update(Eigen::Vector4f *position, PointFilter *filter)
 {
-	filter->transitionMatrix.at<float>(0, 3) = dt;
-	filter->transitionMatrix.at<float>(1, 4) = dt;
-	filter->transitionMatrix.at<float>(2, 5) = dt;
-
-	cv::Mat measurement = cv::Mat(3, 1, CV_32F);
-	measurement.at<float>(0, 0) = position->x();
-	measurement.at<float>(1, 0) = position->y();
-	measurement.at<float>(2, 0) = position->z();
-	filter->correct(measurement);
+	filter->correct(position->head<3>());
 }
 
 static bool
@@ -1227,27 +1199,44 @@ create_match_list(TrackerPSVR &t)
 static void
 do_view(TrackerPSVR &t, View &view, cv::Mat &grey, cv::Mat &rgb)
 {
-	// Undistort and rectify the whole image.
-	cv::remap(grey,                         // src
-	          view.frame_undist_rectified,  // dst
-	          view.undistort_rectify_map_x, // map1
-	          view.undistort_rectify_map_y, // map2
-	          cv::INTER_NEAREST,            // interpolation - LINEAR seems
-	                                        // very slow on my setup
-	          cv::BORDER_CONSTANT,          // borderMode
-	          cv::Scalar(0, 0, 0));         // borderValue
-
-	cv::threshold(view.frame_undist_rectified, // src
-	              view.frame_undist_rectified, // dst
-	              32.0,                        // thresh
-	              255.0,                       // maxval
-	              0);
-	t.sbd->detect(view.frame_undist_rectified, // image
-	              view.keypoints,              // keypoints
-	              cv::noArray());              // mask
-
-	// Debug is wanted, draw the keypoints.
+	// Find the blobs in the distorted image, only their centers get rectified.
+	find_bright_blobs(grey.data, grey.cols, grey.rows, grey.step, t.blob_params, view.blobs);
+
+	view.blob_points.clear();
+	for (const SparseBlob &blob : view.blobs) {
+		view.blob_points.emplace_back(blob.x, blob.y);
+	}
+	calibration_undistort_points(view.calib, view.rectify_rotation, view.rectify_projection, view.blob_points);
+
+	view.keypoints.clear();
+	for (size_t i = 0; i < view.blob_points.size(); i++) {
+		const cv::Point2f &pt = view.blob_points[i];
+
+		// The rectified image is black outside of the remap.
+		if (pt.x < 0 || pt.y < 0 || pt.x >= grey.cols || pt.y >= grey.rows) {
+			continue;
+		}
+
+		float diameter = 2.0f * std::sqrt(view.blobs[i].area / (float)M_PI);
+		view.keypoints.emplace_back(pt, diameter);
+	}
+
+	// Debug is wanted, rectify the whole image and draw the keypoints.
 	if (rgb.cols > 0) {
+		cv::remap(grey,                         // src
+		          view.frame_undist_rectified,  // dst
+		          view.undistort_rectify_map_x, // map1
+		          view.undistort_rectify_map_y, // map2
+		          cv::INTER_NEAREST,            // interpolation
+		          cv::BORDER_CONSTANT,          // borderMode
+		          cv::Scalar(0, 0, 0));         // borderValue
+
+		cv::threshold(view.frame_undist_rectified, // src
+		              view.frame_undist_rectified, // dst
+		              t.blob_params.threshold,     // thresh
+		              255.0,                       // maxval
+		              0);                          // type
+
 		cv::drawKeypoints(view.frame_undist_rectified,                // image
 		                  view.keypoints,                             // keypoints
 		                  rgb,                                        // outImage
@@ -1522,8 +1511,8 @@ process(TrackerPSVR &t, struct xrt_frame *xf)
 		dt = 1.0f;
 	}
 
-	std::vector<match_data_t> predicted_pose;
-	filter_predict(&predicted_pose, t.track_filters, dt / 2.0f);
+	t.predicted_pose.clear();
+	filter_predict(&t.predicted_pose, t.track_filters, dt / 2.0f);
 
 
 	model_vertex_t measured_pose[PSVR_NUM_LEDS];
@@ -1544,8 +1533,12 @@ process(TrackerPSVR &t, struct xrt_frame *xf)
 	cv::Mat l_grey(rows, cols, CV_8UC1, xf->data, stride);
 	cv::Mat r_grey(rows, cols, CV_8UC1, xf->data + cols, stride);
 
-	do_view(t, t.view[0], l_grey, t.debug.rgb[0]);
-	do_view(t, t.view[1], r_grey, t.debug.rgb[1]);
+	// Each view only touches its own View and debug image.
+	run_stereo_views(t.group, [&](int i) {
+		uint64_t start_ns = os_monotonic_get_ns();
+		do_view(t, t.view[i], i == 0 ? l_grey : r_grey, t.debug.rgb[i]);
+		t.view_ms[i] = (float)time_ns_to_ms_f((time_duration_ns)(os_monotonic_get_ns() - start_ns));
+	});
 
 	// if we wish to confirm our camera input contents, dump frames
 	// to disk
@@ -1668,7 +1661,7 @@ process(TrackerPSVR &t, struct xrt_frame *xf)
 	// in world space, and model_center_transform will
 	// contain the pose matrix
 	std::vector<match_data_t> solved;
-	Eigen::Matrix4f model_center_transform = disambiguate(t, &t.match_vertices, &predicted_pose, &solved, 0);
+	Eigen::Matrix4f model_center_transform = disambiguate(t, &t.match_vertices, &t.predicted_pose, &solved, 0);
 
 
 	// derive our optical rotation correction from the
@@ -1745,7 +1738,7 @@ process(TrackerPSVR &t, struct xrt_frame *xf)
 			resolved.push_back(solved[i]);
 		}
 		solved.clear();
-		model_center_transform = solve_with_imu(t, &resolved, &predicted_pose, &solved, PSVR_SEARCH_RADIUS);
+		model_center_transform = solve_with_imu(t, &resolved, &t.predicted_pose, &solved, PSVR_SEARCH_RADIUS);
 	}
 
 	// move our applied correction towards the
@@ -1785,12 +1778,12 @@ process(TrackerPSVR &t, struct xrt_frame *xf)
 	}
 
 	if (!t.last_vertices.empty()) {
-		filter_update(&t.last_vertices, t.track_filters, dt / 1000.0f);
+		filter_update(&t.last_vertices, t.track_filters);
 	}
 
 
 	Eigen::Vector4f position = model_center_transform.col(3);
-	pose_filter_update(&position, &t.pose_filter, dt);
+	pose_filter_update(&position, &t.pose_filter);
 
 
 
@@ -2006,8 +1999,14 @@ t_psvr_node_destroy(struct xrt_frame_node *node)
 
 	os_thread_helper_destroy(&t_ptr->oth);
 
+	u_worker_group_reference(&t_ptr->group, NULL);
+	u_worker_thread_pool_reference(&t_ptr->pool, NULL);
+
 	m_imu_3dof_close(&t_ptr->fusion.imu_3dof);
 
+	// Tidy variable setup.
+	u_var_remove_root(t_ptr);
+
 	delete t_ptr;
 }
 
@@ -2053,17 +2052,15 @@ t_psvr_create(struct xrt_frame_context *xfctx,
 	PSVR_INFO("%s", __func__);
 	int ret;
 
-	using xrt::auxiliary::tracking::psvr::init_filter;
-
 	for (uint32_t i = 0; i < PSVR_NUM_LEDS; i++) {
-		init_filter(t.track_filters[i], PSVR_BLOB_PROCESS_NOISE, PSVR_BLOB_MEASUREMENT_NOISE, 1.0f);
+		t.track_filters[i] = PointFilter(PSVR_BLOB_PROCESS_NOISE, PSVR_BLOB_MEASUREMENT_NOISE);
 	}
 
-	init_filter(t.pose_filter, PSVR_POSE_PROCESS_NOISE, PSVR_POSE_MEASUREMENT_NOISE, 1.0f);
+	t.pose_filter = PointFilter(PSVR_POSE_PROCESS_NOISE, PSVR_POSE_MEASUREMENT_NOISE);
 
 	StereoRectificationMaps rectify(data);
-	t.view[0].populate_from_calib(data->view[0], rectify.view[0].rectify);
-	t.view[1].populate_from_calib(data->view[1], rectify.view[1].rectify);
+	t.view[0].populate_from_calib(data->view[0], rectify.view[0]);
+	t.view[1].populate_from_calib(data->view[1], rectify.view[1]);
 	t.disparity_to_depth = rectify.disparity_to_depth_mat;
 	StereoCameraCalibrationWrapper wrapped(data);
 	t.r_cam_rotation = wrapped.camera_rotation_mat;
@@ -2072,23 +2069,8 @@ t_psvr_create(struct xrt_frame_context *xfctx,
 
 
 
-	// clang-format off
-	cv::SimpleBlobDetector::Params blob_params;
-	blob_params.filterByArea = false;
-	blob_params.filterByConvexity = false;
-	blob_params.filterByInertia = false;
-	blob_params.filterByColor = true;
-	blob_params.blobColor = 255; // 0 or 255 - color comes from binarized image?
-	blob_params.minArea = 1;
-	blob_params.maxArea = 1000;
-	blob_params.maxThreshold = 51; // using a wide threshold span slows things down bigtime
-	blob_params.minThreshold = 50;
-	blob_params.thresholdStep = 1;
-	blob_params.minDistBetweenBlobs = 5;
-	blob_params.minRepeatability = 1; // need this to avoid error?
-	// clang-format on
-
-	t.sbd = cv::SimpleBlobDetector::create(blob_params);
+	// Pixels brighter than this are LEDs.
+	t.blob_params.threshold = 32;
 
 	t.target_optical_rotation_correction = Eigen::Quaternionf(1.0f, 0.0f, 0.0f, 0.0f);
 	t.optical_rotation_correction = Eigen::Quaternionf(1.0f, 0.0f, 0.0f, 0.0f);
@@ -2123,6 +2105,10 @@ t_psvr_create(struct xrt_frame_context *xfctx,
 		return ret;
 	}
 
+	// One worker, the run thread waiting on the group lets the second one in.
+	t.pool = u_worker_thread_pool_create(1, 2, "PSVR view");
+	t.group = u_worker_group_create(t.pool);
+
 	t.fusion.pos.x = 0.0f;
 	t.fusion.pos.y = 0.0f;
 	t.fusion.pos.z = 0.0f;
@@ -2139,6 +2125,8 @@ t_psvr_create(struct xrt_frame_context *xfctx,
 	// Everything is safe, now setup the variable tracking.
 	u_var_add_root(&t, "PSVR Tracker", true);
 	u_var_add_log_level(&t, &t.log_level, "Log level");
+	u_var_add_ro_f32(&t, &t.view_ms[0], "Left view (ms)");
+	u_var_add_ro_f32(&t, &t.view_ms[1], "Right view (ms)");
 	u_var_add_sink_debug(&t, &t.debug.usd, "Debug");
 
 	*out_sink = &t.sink;
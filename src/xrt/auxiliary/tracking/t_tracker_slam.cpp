@@ -25,6 +25,7 @@
 #include "math/m_relation_history.h"
 #include "math/m_space.h"
 #include "math/m_vec3.h"
+#include "tracking/t_capture_recorder.h"
 #include "tracking/t_euroc_recorder.h"
 #include "tracking/t_openvr_tracker.h"
 #include "tracking/t_tracking.h"
@@ -35,6 +36,9 @@
 #include <opencv2/core/mat.hpp>
 #include <opencv2/core/version.hpp>
 
+#include <array>
+#include <atomic>
+#include <cstring>
 #include <deque>
 #include <filesystem>
 #include <fstream>
@@ -42,6 +46,7 @@
 #include <map>
 #include <mutex>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 //! @todo Get preferred system from systems found at build time
@@ -91,6 +96,7 @@ namespace xrt::auxiliary::tracking::slam {
 constexpr int UI_TIMING_POSE_COUNT = 192;
 constexpr int UI_FEATURES_POSE_COUNT = 192;
 constexpr int UI_GTDIFF_POSE_COUNT = 192;
+constexpr size_t IMU_RING_SIZE = 1000;
 
 using os::Mutex;
 using std::deque;
@@ -157,8 +163,44 @@ operator<<(ostream &os, const feature_count_sample &s)
 	return os;
 }
 
-//! Writes a CSV file for a particular row type
-template <typename RowType> class CSVWriter
+//! Common interface so that the CSV thread can flush writers of any row type
+class CSVWriterBase
+{
+public:
+	struct os_thread_helper *flush_thread = nullptr; //!< Woken up when rows are queued
+
+	virtual ~CSVWriterBase() {}
+
+	//! Write queued rows to disk, only the CSV thread calls this
+	virtual void
+	flush() = 0;
+
+	//! Whether there are rows waiting for @ref flush
+	virtual bool
+	has_pending() = 0;
+
+protected:
+	//! Call without holding the writer's lock, the CSV thread takes them in the other order
+	void
+	wake_flush_thread()
+	{
+		if (flush_thread == nullptr) {
+			return;
+		}
+
+		os_thread_helper_lock(flush_thread);
+		os_thread_helper_signal_locked(flush_thread);
+		os_thread_helper_unlock(flush_thread);
+	}
+};
+
+/*!
+ * Writes a CSV file for a particular row type.
+ *
+ * Rows are only queued by @ref push, the file itself is written by @ref flush
+ * from a background thread so that tracking threads never wait on disk I/O.
+ */
+template <typename RowType> class CSVWriter : public CSVWriterBase
 {
 public:
 	bool enabled; // Modified through UI
@@ -171,7 +213,9 @@ private:
 	string filename;
 	ofstream file;
 	bool created = false;
-	Mutex mutex;
+	Mutex mutex;             //!< Protects @ref pending
+	vector<RowType> pending; //!< Rows pushed but not yet written
+	vector<RowType> writing; //!< Rows being written by @ref flush
 
 	void
 	create()
@@ -191,14 +235,44 @@ public:
 	    : enabled(e), column_names(cn), directory(dir), filename(fn)
 	{}
 
-	virtual ~CSVWriter() {}
-
 	void
 	push(RowType row)
+	{
+		{
+			unique_lock lock(mutex);
+
+			if (!enabled) {
+				return;
+			}
+
+			bool was_empty = pending.empty();
+			pending.push_back(std::move(row));
+
+			// The thread was already woken up for the earlier rows.
+			if (!was_empty) {
+				return;
+			}
+		}
+
+		wake_flush_thread();
+	}
+
+	bool
+	has_pending() override
 	{
 		unique_lock lock(mutex);
+		return !pending.empty();
+	}
+
+	void
+	flush() override
+	{
+		{
+			unique_lock lock(mutex);
+			std::swap(pending, writing);
+		}
 
-		if (!enabled) {
+		if (writing.empty()) {
 			return;
 		}
 
@@ -207,7 +281,11 @@ public:
 			create();
 		}
 
-		file << row;
+		for (const RowType &row : writing) {
+			file << row;
+		}
+		file.flush();
+		writing.clear();
 	}
 };
 
@@ -242,6 +320,121 @@ struct FeaturesWriter : public CSVWriter<feature_count_sample>
 	}
 };
 
+
+/*
+ *
+ * Lock-free storage
+ *
+ */
+
+/*!
+ * Sequence lock for a single writer and any number of readers.
+ *
+ * Neither side ever blocks: the writer marks the sequence odd while storing
+ * and readers retry if they caught a store halfway through.
+ */
+template <typename T> class SeqLock
+{
+	static_assert(std::is_trivially_copyable_v<T>, "SeqLock copies its value word by word");
+	static constexpr size_t WORD_COUNT = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+	std::atomic<uint64_t> seq{0};                 //!< Odd while storing, 2 * (version + 1) after
+	std::atomic<uint32_t> words[WORD_COUNT] = {}; //!< Stored value
+
+public:
+	//! Store @p value tagged with @p version, only one thread may call this
+	void
+	store(const T &value, uint64_t version)
+	{
+		uint32_t buf[WORD_COUNT] = {};
+		memcpy(buf, &value, sizeof(T));
+
+		seq.store(version * 2 + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		for (size_t i = 0; i < WORD_COUNT; i++) {
+			words[i].store(buf[i], std::memory_order_relaxed);
+		}
+		seq.store(version * 2 + 2, std::memory_order_release);
+	}
+
+	//! Load the last stored value and its version, false if nothing was stored yet
+	bool
+	load(T &out, uint64_t &out_version) const
+	{
+		uint32_t buf[WORD_COUNT];
+		uint64_t before = 0;
+		uint64_t after = 0;
+		do {
+			before = seq.load(std::memory_order_acquire);
+			for (size_t i = 0; i < WORD_COUNT; i++) {
+				buf[i] = words[i].load(std::memory_order_relaxed);
+			}
+			std::atomic_thread_fence(std::memory_order_acquire);
+			after = seq.load(std::memory_order_relaxed);
+		} while (before != after || (before & 1) != 0);
+
+		if (before == 0) {
+			return false;
+		}
+
+		memcpy(&out, buf, sizeof(T));
+		out_version = before / 2 - 1;
+		return true;
+	}
+};
+
+//! IMU sample as used for prediction
+struct imu_sample
+{
+	timepoint_ns ts;
+	xrt_vec3 gyro;
+	xrt_vec3 accel;
+};
+
+/*!
+ * Ring of the last @p N IMU samples with a single producer.
+ *
+ * Readers address samples by their push number and find out if the producer
+ * overwrote one instead of holding it back.
+ */
+template <size_t N> class ImuRing
+{
+	SeqLock<imu_sample> slots[N];
+	std::atomic<uint64_t> pushed{0};
+
+public:
+	void
+	push(const imu_sample &sample)
+	{
+		uint64_t i = pushed.load(std::memory_order_relaxed);
+		slots[i % N].store(sample, i);
+		pushed.store(i + 1, std::memory_order_release);
+	}
+
+	//! Number of samples pushed so far, the last @p N of them are readable
+	uint64_t
+	count() const
+	{
+		return pushed.load(std::memory_order_acquire);
+	}
+
+	//! Get the @p i-th pushed sample, fails if it was not pushed yet or was overwritten
+	bool
+	get(uint64_t i, imu_sample &out) const
+	{
+		uint64_t version = 0;
+		return slots[i % N].load(out, version) && version == i;
+	}
+};
+
+//! Latest SLAM relation, published by @ref flush_poses for the pose queries
+struct slam_pose_snapshot
+{
+	xrt_space_relation rel;
+	timepoint_ns ts;
+};
+
+
 /*!
  * Main implementation of @ref xrt_tracked_slam. This is an adapter class for
  * SLAM tracking that wraps an external SLAM implementation.
@@ -273,8 +466,9 @@ struct TrackerSlam
 
 	enum u_logging_level log_level; //!< Logging level for the SLAM tracker, set by SLAM_LOG var
 
-	struct xrt_slam_sinks *euroc_recorder; //!< EuRoC dataset recording sinks
-	struct openvr_tracker *ovr_tracker;    //!< OpenVR lighthouse tracker
+	struct xrt_slam_sinks *euroc_recorder;   //!< EuRoC dataset recording sinks
+	struct xrt_slam_sinks *capture_recorder; //!< Capture file recording sinks
+	struct openvr_tracker *ovr_tracker;      //!< OpenVR lighthouse tracker
 
 	// Used mainly for checking that the timestamps come in order
 	timepoint_ns last_imu_ts;                     //!< Last received IMU sample timestamp
@@ -286,14 +480,17 @@ struct TrackerSlam
 
 	//! Type of prediction to use
 	t_slam_prediction_type pred_type;
-	u_var_combo pred_combo;         //!< UI combo box to select @ref pred_type
-	RelationHistory slam_rels{};    //!< A history of relations produced purely from external SLAM tracker data
-	int dbg_pred_every = 1;         //!< Skip X SLAM poses so that you get tracked mostly by the prediction algo
-	int dbg_pred_counter = 0;       //!< SLAM pose counter for prediction debugging
-	struct os_mutex lock_ff;        //!< Lock for gyro_ff and accel_ff.
-	struct m_ff_vec3_f32 *gyro_ff;  //!< Last gyroscope samples
-	struct m_ff_vec3_f32 *accel_ff; //!< Last accelerometer samples
-	vector<u_sink_debug> ui_sink;   //!< Sink to display frames in UI of each camera
+	u_var_combo pred_combo;                  //!< UI combo box to select @ref pred_type
+	RelationHistory slam_rels{};             //!< A history of relations produced purely from external SLAM tracker data
+	int dbg_pred_every = 1;                  //!< Skip X SLAM poses so that you get tracked mostly by the prediction algo
+	int dbg_pred_counter = 0;                //!< SLAM pose counter for prediction debugging
+	ImuRing<IMU_RING_SIZE> imu_ring;         //!< Last IMU samples used for prediction
+	SeqLock<slam_pose_snapshot> latest_pose; //!< Latest relation in @ref slam_rels
+	uint64_t latest_pose_version = 0;        //!< Number of stores to @ref latest_pose
+	Mutex flush_mutex;                       //!< Serializes @ref flush_poses callers
+	struct m_ff_vec3_f32 *gyro_ff;           //!< Last gyroscope samples, only for the UI
+	struct m_ff_vec3_f32 *accel_ff;          //!< Last accelerometer samples, only for the UI
+	vector<u_sink_debug> ui_sink;            //!< Sink to display frames in UI of each camera
 
 	//! Used to correct accelerometer measurements when integrating into the prediction.
 	//! @todo Should be automatically computed instead of required to be filled manually through the UI.
@@ -337,6 +534,7 @@ struct TrackerSlam
 	TrajectoryWriter *slam_traj_writer;   //!< Estimated poses from the SLAM system
 	TrajectoryWriter *pred_traj_writer;   //!< Predicted poses
 	TrajectoryWriter *filt_traj_writer;   //!< Predicted and filtered poses
+	struct os_thread_helper csv_thread;   //!< Writes queued CSV rows to disk
 
 	//! Tracker timing info for performance evaluation
 	struct
@@ -396,6 +594,67 @@ struct TrackerSlam
 };
 
 
+/*
+ *
+ * CSV writing thread
+ *
+ */
+
+static std::array<CSVWriterBase *, 5>
+csv_writers(TrackerSlam &t)
+{
+	return {t.slam_times_writer, t.slam_features_writer, t.slam_traj_writer, t.pred_traj_writer,
+	        t.filt_traj_writer};
+}
+
+static void
+flush_csv_writers(TrackerSlam &t)
+{
+	for (CSVWriterBase *writer : csv_writers(t)) {
+		writer->flush();
+	}
+}
+
+static bool
+csv_writers_have_pending(TrackerSlam &t)
+{
+	for (CSVWriterBase *writer : csv_writers(t)) {
+		if (writer->has_pending()) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static void *
+csv_thread_run(void *ptr)
+{
+	TrackerSlam &t = *(TrackerSlam *)ptr;
+	os_thread_helper_name(&t.csv_thread, "SLAM CSV writer");
+
+	os_thread_helper_lock(&t.csv_thread);
+
+	while (os_thread_helper_is_running_locked(&t.csv_thread)) {
+		// Sleep until a writer queues rows, or until we are stopped.
+		if (!csv_writers_have_pending(t)) {
+			os_thread_helper_wait_locked(&t.csv_thread);
+
+			// Loop back to check if we should stop, also handles spurious wakeups.
+			continue;
+		}
+
+		// Don't hold the lock while on disk, the writers need it to wake us up.
+		os_thread_helper_unlock(&t.csv_thread);
+		flush_csv_writers(t);
+		os_thread_helper_lock(&t.csv_thread);
+	}
+
+	os_thread_helper_unlock(&t.csv_thread);
+
+	return NULL;
+}
+
+
 /*
  *
  * Timing functionality
@@ -734,6 +993,12 @@ gt_ui_push(TrackerSlam &t, timepoint_ns ts, xrt_pose tracked_pose)
 static bool
 flush_poses(TrackerSlam &t)
 {
+	// Both the frame and the query threads flush, whoever comes second can
+	// skip it and use the snapshot the other one is about to publish.
+	unique_lock flush_lock(t.flush_mutex, std::try_to_lock);
+	if (!flush_lock.owns_lock()) {
+		return false;
+	}
 
 	vit_pose_t *pose = NULL;
 	vit_result_t vres = t.vit.tracker_pop_pose(t.tracker, &pose);
@@ -761,11 +1026,12 @@ flush_poses(TrackerSlam &t)
 		xrt_quat nrot{data.ox, data.oy, data.oz, data.ow};
 
 		// Last relation
-		xrt_space_relation lr = XRT_SPACE_RELATION_ZERO;
-		int64_t lts;
-		t.slam_rels.get_latest(&lts, &lr);
-		xrt_vec3 lpos = lr.pose.position;
-		xrt_quat lrot = lr.pose.orientation;
+		slam_pose_snapshot last{XRT_SPACE_RELATION_ZERO, 0};
+		uint64_t last_version = 0;
+		t.latest_pose.load(last, last_version);
+		int64_t lts = last.ts;
+		xrt_vec3 lpos = last.rel.pose.position;
+		xrt_quat lrot = last.rel.pose.orientation;
 
 		double dt = time_ns_to_s(nts - lts);
 
@@ -783,6 +1049,7 @@ flush_poses(TrackerSlam &t)
 		// Push to relationship history unless we are debugging prediction
 		if (t.dbg_pred_counter % t.dbg_pred_every == 0) {
 			t.slam_rels.push(rel, nts);
+			t.latest_pose.store({rel, nts}, t.latest_pose_version++);
 		}
 		t.dbg_pred_counter = (t.dbg_pred_counter + 1) % t.dbg_pred_every;
 
@@ -790,6 +1057,7 @@ flush_poses(TrackerSlam &t)
 		t.slam_traj_writer->push({nts, rel.pose});
 		xrt_pose_sample pose_sample = {nts, rel.pose};
 		xrt_sink_push_pose(t.euroc_recorder->gt, &pose_sample);
+		xrt_sink_push_pose(t.capture_recorder->gt, &pose_sample);
 
 		auto tss = timing_ui_push(t, pose, nts);
 		t.slam_times_writer->push(tss);
@@ -813,21 +1081,15 @@ predict_pose_from_imu(TrackerSlam &t,
                       timepoint_ns base_rel_ts,
                       struct xrt_space_relation *out_relation)
 {
-	os_mutex_lock(&t.lock_ff);
-
-	// Find oldest imu index i that is newer than latest SLAM pose (or -1)
-	int i = 0;
-	uint64_t imu_ts = UINT64_MAX;
-	xrt_vec3 _;
-	while (m_ff_vec3_f32_get(t.gyro_ff, i, &_, &imu_ts)) {
-		if ((int64_t)imu_ts < base_rel_ts) {
-			i--; // Back to the oldest newer-than-SLAM IMU index (or -1)
-			break;
-		}
-		i++;
+	// Find oldest imu sample that is newer than latest SLAM pose
+	uint64_t end = t.imu_ring.count();
+	uint64_t begin = end;
+	imu_sample sample{};
+	while (begin > 0 && t.imu_ring.get(begin - 1, sample) && sample.ts >= base_rel_ts) {
+		begin--;
 	}
 
-	if (i == -1) {
+	if (begin == end) {
 		SLAM_WARN("No IMU samples received after latest SLAM pose (and frame)");
 	}
 
@@ -839,17 +1101,14 @@ predict_pose_from_imu(TrackerSlam &t,
 	xrt_vec3 &v = integ_rel.linear_velocity;
 	bool clamped = false; // If when_ns is older than the latest IMU ts
 
-	while (i >= 0) { // Decreasing i increases timestamp
-		// Get samples
-		xrt_vec3 g{};
-		xrt_vec3 a{};
-		uint64_t g_ts{};
-		uint64_t a_ts{};
-		bool got = true;
-		got &= m_ff_vec3_f32_get(t.gyro_ff, i, &g, &g_ts);
-		got &= m_ff_vec3_f32_get(t.accel_ff, i, &a, &a_ts);
-		timepoint_ns ts = g_ts;
-
+	for (uint64_t i = begin; i < end; i++) {
+		// Get samples, stop if the IMU thread already overwrote this one
+		if (!t.imu_ring.get(i, sample)) {
+			break;
+		}
+		xrt_vec3 g = sample.gyro;
+		xrt_vec3 a = sample.accel;
+		timepoint_ns ts = sample.ts;
 
 		// Checks
 		if (ts > when_ns) {
@@ -859,7 +1118,6 @@ predict_pose_from_imu(TrackerSlam &t,
 			// g = prev_g + ((when_ns - prev_ts) / (ts - prev_ts)) * (g - prev_g);
 			ts = when_ns; // clamp ts to when_ns
 		}
-		SLAM_DASSERT(got && g_ts == a_ts, "Failure getting synced gyro and accel samples");
 		SLAM_DASSERT(ts >= base_rel_ts, "Accessing imu sample that is older than latest SLAM pose");
 
 		// Update time
@@ -883,11 +1141,8 @@ predict_pose_from_imu(TrackerSlam &t,
 		if (clamped) {
 			break;
 		}
-		i--;
 	}
 
-	os_mutex_unlock(&t.lock_ff);
-
 	// Do the prediction based on the updated relation
 	double last_imu_to_now_dt = time_ns_to_s(when_ns - integ_rel_ts);
 	xrt_space_relation predicted_relation{};
@@ -896,6 +1151,39 @@ predict_pose_from_imu(TrackerSlam &t,
 	*out_relation = predicted_relation;
 }
 
+//! Average the IMU samples in [@p start_ns, @p stop_ns], also returns the newest sample timestamp if any.
+static void
+average_imu(TrackerSlam &t,
+            timepoint_ns start_ns,
+            timepoint_ns stop_ns,
+            xrt_vec3 *out_gyro,
+            xrt_vec3 *out_accel,
+            timepoint_ns *out_newest_ts)
+{
+	xrt_vec3 gyro_sum{};
+	xrt_vec3 accel_sum{};
+	int num_sampled = 0;
+
+	uint64_t end = t.imu_ring.count();
+	imu_sample sample{};
+	for (uint64_t i = end; i > 0 && t.imu_ring.get(i - 1, sample) && sample.ts >= start_ns; i--) {
+		if (i == end) {
+			*out_newest_ts = sample.ts;
+		}
+		if (sample.ts > stop_ns) {
+			continue;
+		}
+		gyro_sum += sample.gyro;
+		accel_sum += sample.accel;
+		num_sampled++;
+	}
+
+	if (num_sampled > 0) {
+		*out_gyro = gyro_sum / (float)num_sampled;
+		*out_accel = accel_sum / (float)num_sampled;
+	}
+}
+
 //! Return our best guess of the relation at time @p when_ns using all the data the tracker has.
 static void
 predict_pose(TrackerSlam &t, timepoint_ns when_ns, struct xrt_space_relation *out_relation)
@@ -906,9 +1194,11 @@ predict_pose(TrackerSlam &t, timepoint_ns when_ns, struct xrt_space_relation *ou
 	SLAM_DASSERT(valid_pred_type, "Invalid prediction type (%d)", t.pred_type);
 
 	// Get last relation computed purely from SLAM data
-	xrt_space_relation rel{};
-	int64_t rel_ts;
-	bool empty = !t.slam_rels.get_latest(&rel_ts, &rel);
+	slam_pose_snapshot latest{};
+	uint64_t latest_version = 0;
+	bool empty = !t.latest_pose.load(latest, latest_version);
+	xrt_space_relation rel = latest.rel;
+	int64_t rel_ts = latest.ts;
 
 	// Stop if there is no previous relation to use for prediction
 	if (empty) {
@@ -935,28 +1225,25 @@ predict_pose(TrackerSlam &t, timepoint_ns when_ns, struct xrt_space_relation *ou
 		return;
 	}
 
-	os_mutex_lock(&t.lock_ff);
+	xrt_vec3 avg_gyro{};
+	xrt_vec3 avg_accel{};
+	timepoint_ns newest_imu_ts = rel_ts;
+	average_imu(t, rel_ts, when_ns, &avg_gyro, &avg_accel, &newest_imu_ts);
 
 	// Update angular velocity with gyro data
 	if (t.pred_type >= SLAM_PRED_SP_SO_IA_SL) {
-		xrt_vec3 avg_gyro{};
-		m_ff_vec3_f32_filter(t.gyro_ff, rel_ts, when_ns, &avg_gyro);
 		math_quat_rotate_derivative(&rel.pose.orientation, &avg_gyro, &rel.angular_velocity);
 	}
 
 	// Update linear velocity with accel data
 	if (t.pred_type >= SLAM_PRED_SP_SO_IA_IL) {
-		xrt_vec3 avg_accel{};
-		m_ff_vec3_f32_filter(t.accel_ff, rel_ts, when_ns, &avg_accel);
 		xrt_vec3 world_accel{};
 		math_quat_rotate_vec3(&rel.pose.orientation, &avg_accel, &world_accel);
 		world_accel += t.gravity_correction;
-		double slam_to_imu_dt = time_ns_to_s(t.last_imu_ts - rel_ts);
+		double slam_to_imu_dt = time_ns_to_s(newest_imu_ts - rel_ts);
 		rel.linear_velocity += world_accel * slam_to_imu_dt;
 	}
 
-	os_mutex_unlock(&t.lock_ff);
-
 	// Do the prediction based on the updated relation
 	double slam_to_now_dt = time_ns_to_s(when_ns - rel_ts);
 	xrt_space_relation predicted_relation{};
@@ -1030,7 +1317,6 @@ setup_ui(TrackerSlam &t)
 	for (size_t i = 0; i < t.ui_sink.size(); i++) {
 		u_sink_debug_init(&t.ui_sink[i]);
 	}
-	os_mutex_init(&t.lock_ff);
 	m_ff_vec3_f32_alloc(&t.gyro_ff, 1000);
 	m_ff_vec3_f32_alloc(&t.accel_ff, 1000);
 	m_ff_vec3_f32_alloc(&t.filter.pos_ff, 1000);
@@ -1054,6 +1340,7 @@ setup_ui(TrackerSlam &t)
 
 	u_var_add_bool(&t, &t.gt.override_tracking, "Track with ground truth (if available)");
 	euroc_recorder_add_ui(t.euroc_recorder, &t, "");
+	t_capture_recorder_add_ui(t.capture_recorder, &t, "");
 
 	u_var_add_gui_header(&t, NULL, "Trajectory Filter");
 	u_var_add_bool(&t, &t.filter.use_moving_average_filter, "Enable moving average filter");
@@ -1266,6 +1553,7 @@ t_slam_gt_sink_push(struct xrt_pose_sink *sink, xrt_pose_sample *sample)
 
 	t.gt.trajectory->insert_or_assign(sample->timestamp_ns, sample->pose);
 	xrt_sink_push_pose(t.euroc_recorder->gt, sample);
+	xrt_sink_push_pose(t.capture_recorder->gt, sample);
 }
 
 //! Receive and register masks to use in the next image
@@ -1317,13 +1605,13 @@ t_slam_receive_imu(struct xrt_imu_sink *sink, struct xrt_imu_sample *s)
 	}
 
 	xrt_sink_push_imu(t.euroc_recorder->imu, s);
+	xrt_sink_push_imu(t.capture_recorder->imu, s);
 
 	struct xrt_vec3 gyro = {(float)w.x, (float)w.y, (float)w.z};
 	struct xrt_vec3 accel = {(float)a.x, (float)a.y, (float)a.z};
-	os_mutex_lock(&t.lock_ff);
+	t.imu_ring.push({ts, gyro, accel});
 	m_ff_vec3_f32_push(t.gyro_ff, &gyro, ts);
 	m_ff_vec3_f32_push(t.accel_ff, &accel, ts);
-	os_mutex_unlock(&t.lock_ff);
 }
 
 //! Push the frame to the external SLAM system
@@ -1411,6 +1699,7 @@ receive_frame(TrackerSlam &t, struct xrt_frame *frame, uint32_t cam_index)
 		receive_frame(t, frame, cam_id);                                                                       \
 		u_sink_debug_push_frame(&t.ui_sink[cam_id], frame);                                                    \
 		xrt_sink_push_frame(t.euroc_recorder->cams[cam_id], frame);                                            \
+		xrt_sink_push_frame(t.capture_recorder->cams[cam_id], frame);                                          \
 	}
 
 DEFINE_RECEIVE_CAM(0)
@@ -1456,6 +1745,9 @@ t_slam_node_destroy(struct xrt_frame_node *node)
 		t_openvr_tracker_destroy(t.ovr_tracker);
 	}
 	delete t.gt.trajectory;
+	// Wakes the CSV thread up and waits for it to finish.
+	os_thread_helper_destroy(&t.csv_thread);
+	flush_csv_writers(t);
 	delete t.slam_times_writer;
 	delete t.slam_features_writer;
 	delete t.slam_traj_writer;
@@ -1467,7 +1759,6 @@ t_slam_node_destroy(struct xrt_frame_node *node)
 	}
 	m_ff_vec3_f32_free(&t.gyro_ff);
 	m_ff_vec3_f32_free(&t.accel_ff);
-	os_mutex_destroy(&t.lock_ff);
 	m_ff_vec3_f32_free(&t.filter.pos_ff);
 	m_ff_vec3_f32_free(&t.filter.rot_ff);
 
@@ -1594,6 +1885,7 @@ t_slam_create(struct xrt_frame_context *xfctx,
 	xrt_frame_context_add(xfctx, &t.node);
 
 	t.euroc_recorder = euroc_recorder_create(xfctx, NULL, t.cam_count, false);
+	t.capture_recorder = t_capture_recorder_create(xfctx, NULL, t.cam_count, false);
 
 	t.last_imu_ts = INT64_MIN;
 	t.last_cam_ts = vector<timepoint_ns>(t.cam_count, INT64_MIN);
@@ -1614,6 +1906,11 @@ t_slam_create(struct xrt_frame_context *xfctx,
 	t.slam_traj_writer = new TrajectoryWriter(dir, "tracking.csv", write_csvs);
 	t.pred_traj_writer = new TrajectoryWriter(dir, "prediction.csv", write_csvs);
 	t.filt_traj_writer = new TrajectoryWriter(dir, "filtering.csv", write_csvs);
+	os_thread_helper_init(&t.csv_thread);
+	for (CSVWriterBase *writer : csv_writers(t)) {
+		writer->flush_thread = &t.csv_thread;
+	}
+	os_thread_helper_start(&t.csv_thread, csv_thread_run, &t);
 
 	setup_ui(t);
 
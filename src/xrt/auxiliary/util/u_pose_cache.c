@@ -0,0 +1,221 @@
+// Copyright 2025, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Short lived cache of device relations, shared between consumers.
+ * @author agent <agent@local>
+ * @ingroup aux_util
+ */
+
+#include "xrt/xrt_device.h"
+
+#include "os/os_time.h"
+
+#include "util/u_var.h"
+#include "util/u_misc.h"
+#include "util/u_pose_cache.h"
+
+#include <assert.h>
+#include <string.h>
+
+
+/*
+ *
+ * Helper functions.
+ *
+ */
+
+static inline bool
+is_disabled(const struct u_pose_cache *upc)
+{
+	return upc->max_age_ns <= 0;
+}
+
+static void
+count_locked(struct u_pose_cache *upc, bool hit)
+{
+	if (hit) {
+		upc->stats.hits++;
+	} else {
+		upc->stats.misses++;
+	}
+
+	uint64_t total = upc->stats.hits + upc->stats.misses;
+	upc->stats.hit_rate = (float)((double)upc->stats.hits * 100.0 / (double)total);
+}
+
+static struct u_pose_cache_entry *
+find_locked(struct u_pose_cache *upc, struct xrt_device *xdev, enum xrt_input_name name, int64_t at_timestamp_ns)
+{
+	int64_t now_ns = (int64_t)os_monotonic_get_ns();
+
+	for (uint32_t i = 0; i < ARRAY_SIZE(upc->entries); i++) {
+		struct u_pose_cache_entry *e = &upc->entries[i];
+
+		if (e->xdev != xdev || e->name != name || e->at_timestamp_ns != at_timestamp_ns) {
+			continue;
+		}
+
+		// Too old, let it be replaced.
+		if (now_ns - e->fetched_ns > upc->max_age_ns) {
+			return NULL;
+		}
+
+		return e;
+	}
+
+	return NULL;
+}
+
+/*!
+ * Returns the entry to store a new result in, reuses the entry for the same
+ * key if there is one so stale entries do not linger.
+ */
+static struct u_pose_cache_entry *
+get_slot_locked(struct u_pose_cache *upc, struct xrt_device *xdev, enum xrt_input_name name, int64_t at_timestamp_ns)
+{
+	for (uint32_t i = 0; i < ARRAY_SIZE(upc->entries); i++) {
+		struct u_pose_cache_entry *e = &upc->entries[i];
+		if (e->xdev == xdev && e->name == name && e->at_timestamp_ns == at_timestamp_ns) {
+			return e;
+		}
+	}
+
+	struct u_pose_cache_entry *e = &upc->entries[upc->next];
+	upc->next = (upc->next + 1) % ARRAY_SIZE(upc->entries);
+
+	return e;
+}
+
+
+/*
+ *
+ * 'Exported' functions.
+ *
+ */
+
+int
+u_pose_cache_init(struct u_pose_cache *upc, int64_t max_age_ns)
+{
+	U_ZERO(upc);
+	upc->max_age_ns = max_age_ns;
+
+	return os_mutex_init(&upc->mutex);
+}
+
+void
+u_pose_cache_fini(struct u_pose_cache *upc)
+{
+	os_mutex_destroy(&upc->mutex);
+}
+
+xrt_result_t
+u_pose_cache_get_tracked_pose(struct u_pose_cache *upc,
+                              struct xrt_device *xdev,
+                              enum xrt_input_name name,
+                              int64_t at_timestamp_ns,
+                              struct xrt_space_relation *out_relation)
+{
+	assert(name != 0);
+
+	if (is_disabled(upc)) {
+		return xrt_device_get_tracked_pose(xdev, name, at_timestamp_ns, out_relation);
+	}
+
+	os_mutex_lock(&upc->mutex);
+
+	struct u_pose_cache_entry *e = find_locked(upc, xdev, name, at_timestamp_ns);
+	count_locked(upc, e != NULL);
+	if (e != NULL) {
+		*out_relation = e->relation;
+		os_mutex_unlock(&upc->mutex);
+		return XRT_SUCCESS;
+	}
+
+	os_mutex_unlock(&upc->mutex);
+
+	// Don't hold the lock while calling into the device, it might block.
+	xrt_result_t xret = xrt_device_get_tracked_pose(xdev, name, at_timestamp_ns, out_relation);
+	if (xret != XRT_SUCCESS) {
+		return xret;
+	}
+
+	os_mutex_lock(&upc->mutex);
+
+	e = get_slot_locked(upc, xdev, name, at_timestamp_ns);
+	e->xdev = xdev;
+	e->name = name;
+	e->at_timestamp_ns = at_timestamp_ns;
+	e->fetched_ns = (int64_t)os_monotonic_get_ns();
+	e->relation = *out_relation;
+
+	os_mutex_unlock(&upc->mutex);
+
+	return XRT_SUCCESS;
+}
+
+void
+u_pose_cache_get_view_poses(struct u_pose_cache *upc,
+                            struct xrt_device *xdev,
+                            const struct xrt_vec3 *default_eye_relation,
+                            int64_t at_timestamp_ns,
+                            uint32_t view_count,
+                            struct xrt_space_relation *out_head_relation,
+                            struct xrt_fov *out_fovs,
+                            struct xrt_pose *out_poses)
+{
+	assert(view_count <= XRT_MAX_VIEWS);
+
+	if (is_disabled(upc)) {
+		xrt_device_get_view_poses(xdev, default_eye_relation, at_timestamp_ns, view_count, out_head_relation,
+		                          out_fovs, out_poses);
+		return;
+	}
+
+	os_mutex_lock(&upc->mutex);
+
+	// View poses use the zero input name, they also depend on the eye relation.
+	struct u_pose_cache_entry *e = find_locked(upc, xdev, 0, at_timestamp_ns);
+	if (e != NULL && (e->views.count != view_count ||
+	                  memcmp(&e->views.default_eye_relation, default_eye_relation, sizeof(struct xrt_vec3)) != 0)) {
+		e = NULL;
+	}
+
+	count_locked(upc, e != NULL);
+	if (e != NULL) {
+		*out_head_relation = e->relation;
+		memcpy(out_fovs, e->views.fovs, sizeof(struct xrt_fov) * view_count);
+		memcpy(out_poses, e->views.poses, sizeof(struct xrt_pose) * view_count);
+		os_mutex_unlock(&upc->mutex);
+		return;
+	}
+
+	os_mutex_unlock(&upc->mutex);
+
+	xrt_device_get_view_poses(xdev, default_eye_relation, at_timestamp_ns, view_count, out_head_relation, out_fovs,
+	                          out_poses);
+
+	os_mutex_lock(&upc->mutex);
+
+	e = get_slot_locked(upc, xdev, 0, at_timestamp_ns);
+	e->xdev = xdev;
+	e->name = 0;
+	e->at_timestamp_ns = at_timestamp_ns;
+	e->fetched_ns = (int64_t)os_monotonic_get_ns();
+	e->relation = *out_head_relation;
+	e->views.default_eye_relation = *default_eye_relation;
+	e->views.count = view_count;
+	memcpy(e->views.fovs, out_fovs, sizeof(struct xrt_fov) * view_count);
+	memcpy(e->views.poses, out_poses, sizeof(struct xrt_pose) * view_count);
+
+	os_mutex_unlock(&upc->mutex);
+}
+
+void
+u_pose_cache_add_vars(struct u_pose_cache *upc, void *root, const char *name)
+{
+	u_var_add_gui_header(root, NULL, name);
+	u_var_add_ro_u64(root, &upc->stats.hits, "Hits");
+	u_var_add_ro_u64(root, &upc->stats.misses, "Misses");
+	u_var_add_ro_f32(root, &upc->stats.hit_rate, "Hit rate (%)");
+}
@@ -0,0 +1,158 @@
+// Copyright 2025, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Short lived cache of device relations, shared between consumers.
+ * @author agent <agent@local>
+ * @ingroup aux_util
+ */
+
+#pragma once
+
+#include "xrt/xrt_compiler.h"
+#include "xrt/xrt_defines.h"
+#include "xrt/xrt_limits.h"
+
+#include "os/os_threading.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct xrt_device;
+
+/*!
+ * Number of entries in a @ref u_pose_cache, enough for every pose input of a
+ * handful of devices plus the view poses of the head.
+ */
+#define U_POSE_CACHE_MAX_ENTRIES (32)
+
+/*!
+ * Default max age of an entry, long enough to cover one frame phase (for
+ * instance all of the xrLocateSpace calls an application does for a frame)
+ * but much shorter then a frame.
+ */
+#define U_POSE_CACHE_DEFAULT_MAX_AGE_NS (1000 * 1000)
+
+/*!
+ * A single cached device relation, or set of view poses.
+ *
+ * @ingroup aux_util
+ */
+struct u_pose_cache_entry
+{
+	//! The device this was fetched from, NULL if the entry is empty.
+	struct xrt_device *xdev;
+
+	//! The input that was fetched, zero for view poses.
+	enum xrt_input_name name;
+
+	//! Requested timestamp, only exact matches are hits.
+	int64_t at_timestamp_ns;
+
+	//! When the entry was fetched, used to expire it.
+	int64_t fetched_ns;
+
+	//! Head relation for view poses, the tracked pose otherwise.
+	struct xrt_space_relation relation;
+
+	//! Only used for view poses.
+	struct
+	{
+		struct xrt_vec3 default_eye_relation;
+		uint32_t count;
+		struct xrt_fov fovs[XRT_MAX_VIEWS];
+		struct xrt_pose poses[XRT_MAX_VIEWS];
+	} views;
+};
+
+/*!
+ * A small thread safe cache that makes sure each device relation is only
+ * fetched once per timestamp within a short window, so the work done by
+ * devices does not scale with the number of consumers asking for the same
+ * relation. Entries older then @ref u_pose_cache::max_age_ns are refetched,
+ * a max age of zero disables the cache.
+ *
+ * @ingroup aux_util
+ */
+struct u_pose_cache
+{
+	//! Protects the entries and the statistics.
+	struct os_mutex mutex;
+
+	//! Max age of a entry, zero disables the cache.
+	int64_t max_age_ns;
+
+	//! Next entry to be replaced, entries are replaced round robin.
+	uint32_t next;
+
+	struct u_pose_cache_entry entries[U_POSE_CACHE_MAX_ENTRIES];
+
+	//! Statistics, protected by the mutex, readable by u_var.
+	struct
+	{
+		uint64_t hits;
+		uint64_t misses;
+
+		//! Percentage of hits, updated on each query.
+		float hit_rate;
+	} stats;
+};
+
+/*!
+ * Initialise the cache, @p max_age_ns of zero disables the cache.
+ *
+ * @public @memberof u_pose_cache
+ */
+int
+u_pose_cache_init(struct u_pose_cache *upc, int64_t max_age_ns);
+
+/*!
+ * Finalise the cache, does not free the struct.
+ *
+ * @public @memberof u_pose_cache
+ */
+void
+u_pose_cache_fini(struct u_pose_cache *upc);
+
+/*!
+ * Cached version of @ref xrt_device_get_tracked_pose, failed queries are not
+ * cached.
+ *
+ * @public @memberof u_pose_cache
+ */
+xrt_result_t
+u_pose_cache_get_tracked_pose(struct u_pose_cache *upc,
+                              struct xrt_device *xdev,
+                              enum xrt_input_name name,
+                              int64_t at_timestamp_ns,
+                              struct xrt_space_relation *out_relation);
+
+/*!
+ * Cached version of @ref xrt_device_get_view_poses.
+ *
+ * @public @memberof u_pose_cache
+ */
+void
+u_pose_cache_get_view_poses(struct u_pose_cache *upc,
+                            struct xrt_device *xdev,
+                            const struct xrt_vec3 *default_eye_relation,
+                            int64_t at_timestamp_ns,
+                            uint32_t view_count,
+                            struct xrt_space_relation *out_head_relation,
+                            struct xrt_fov *out_fovs,
+                            struct xrt_pose *out_poses);
+
+/*!
+ * Add the statistics of the cache to the given u_var root.
+ *
+ * @public @memberof u_pose_cache
+ */
+void
+u_pose_cache_add_vars(struct u_pose_cache *upc, void *root, const char *name);
+
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,52 @@
+// Copyright 2025, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Per frame cache of space relations.
+ * @author agent <agent@local>
+ * @ingroup aux_util
+ */
+
+#include "util/u_space_cache.h"
+
+
+/*
+ *
+ * 'Exported' functions.
+ *
+ */
+
+bool
+u_space_cache_find(const struct u_space_cache *cache,
+                   const void *key,
+                   bool *out_located,
+                   struct xrt_space_relation *out_relation)
+{
+	for (uint32_t i = 0; i < cache->count; i++) {
+		if (cache->entries[i].key != key) {
+			continue;
+		}
+
+		*out_located = cache->entries[i].located;
+		*out_relation = cache->entries[i].relation;
+		return true;
+	}
+
+	return false;
+}
+
+void
+u_space_cache_add(struct u_space_cache *cache,
+                  const void *key,
+                  bool located,
+                  const struct xrt_space_relation *relation)
+{
+	if (cache->count >= ARRAY_SIZE(cache->entries)) {
+		return;
+	}
+
+	uint32_t i = cache->count++;
+	cache->entries[i].key = key;
+	cache->entries[i].located = located;
+	cache->entries[i].relation = *relation;
+}
@@ -0,0 +1,79 @@
+// Copyright 2025, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Per frame cache of space relations.
+ * @author agent <agent@local>
+ * @ingroup aux_util
+ */
+
+#pragma once
+
+#include "xrt/xrt_compiler.h"
+#include "xrt/xrt_defines.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!
+ * Number of spaces a @ref u_space_cache holds, more than the reference spaces
+ * an application normally puts layers in.
+ */
+#define U_SPACE_CACHE_MAX_ENTRIES (16)
+
+/*!
+ * All layers in a frame are located at the same display time against the same
+ * head device, so each space only needs to be located once per frame. This
+ * matters most with many layers in the same space, where every locate might
+ * be a round trip to the service.
+ *
+ * The cache doesn't know what a space is, the caller picks the key, it is only
+ * valid for one timestamp and device and is meant to live on the stack. Zero
+ * initialise it before use.
+ *
+ * @ingroup aux_util
+ */
+struct u_space_cache
+{
+	uint32_t count;
+
+	struct
+	{
+		const void *key;
+		bool located;
+		struct xrt_space_relation relation;
+	} entries[U_SPACE_CACHE_MAX_ENTRIES];
+};
+
+/*!
+ * Look up the relation cached for @p key, returns false if it is not cached.
+ *
+ * @param[out] out_located    Whether the locate of the cached relation succeeded.
+ * @param[out] out_relation   The cached relation.
+ *
+ * @public @memberof u_space_cache
+ */
+bool
+u_space_cache_find(const struct u_space_cache *cache,
+                   const void *key,
+                   bool *out_located,
+                   struct xrt_space_relation *out_relation);
+
+/*!
+ * Cache the result of locating @p key, if the cache is full nothing is cached,
+ * still correct just slower.
+ *
+ * @public @memberof u_space_cache
+ */
+void
+u_space_cache_add(struct u_space_cache *cache,
+                  const void *key,
+                  bool located,
+                  const struct xrt_space_relation *relation);
+
+
+#ifdef __cplusplus
+}
+#endif
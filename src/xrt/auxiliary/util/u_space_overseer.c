@@ -17,9 +17,12 @@
 
 #include "math/m_space.h"
 
+#include "util/u_var.h"
 #include "util/u_misc.h"
+#include "util/u_debug.h"
 #include "util/u_hashmap.h"
 #include "util/u_logging.h"
+#include "util/u_pose_cache.h"
 #include "util/u_space_overseer.h"
 
 #include <assert.h>
@@ -33,6 +36,8 @@
  *
  */
 
+DEBUG_GET_ONCE_NUM_OPTION(pose_cache_max_age_us, "U_SPACE_OVERSEER_POSE_CACHE_MAX_AGE_US", 1000)
+
 /*!
  * Keeps track of what kind of space it is.
  */
@@ -98,6 +103,13 @@ struct u_space_overseer
 	//! Event sink to broadcast events to all sessions.
 	struct xrt_session_event_sink *broadcast;
 
+	/*!
+	 * Device poses used when traversing the graph, many locates in the
+	 * same frame share spaces (like view space) so each device pose is
+	 * only fetched once per timestamp. Has its own lock.
+	 */
+	struct u_pose_cache pose_cache;
+
 	/*!
 	 * The notify device, usually the head device. Used to notify when
 	 * reference spaces are used and not used. Must not change during
@@ -317,7 +329,10 @@ notify_ref_space_usage_device(struct u_space_overseer *uso, enum xrt_reference_s
  * order.
  */
 static void
-push_then_traverse(struct xrt_relation_chain *xrc, struct u_space *space, int64_t at_timestamp_ns)
+push_then_traverse(struct u_space_overseer *uso,
+                   struct xrt_relation_chain *xrc,
+                   struct u_space *space,
+                   int64_t at_timestamp_ns)
 {
 	switch (space->type) {
 	case U_SPACE_TYPE_NULL: break; // No-op
@@ -326,7 +341,7 @@ push_then_traverse(struct xrt_relation_chain *xrc, struct u_space *space, int64_
 		assert(space->pose.xname != 0);
 
 		struct xrt_space_relation xsr;
-		xrt_device_get_tracked_pose(space->pose.xdev, space->pose.xname, at_timestamp_ns, &xsr);
+		u_pose_cache_get_tracked_pose(&uso->pose_cache, space->pose.xdev, space->pose.xname, at_timestamp_ns, &xsr);
 		m_relation_chain_push_relation(xrc, &xsr);
 	} break;
 	case U_SPACE_TYPE_OFFSET: m_relation_chain_push_pose_if_not_identity(xrc, &space->offset.pose); break;
@@ -335,7 +350,7 @@ push_then_traverse(struct xrt_relation_chain *xrc, struct u_space *space, int64_
 
 	// Please tail-call optimise this miss compiler.
 	assert(space->next != NULL);
-	push_then_traverse(xrc, space->next, at_timestamp_ns);
+	push_then_traverse(uso, xrc, space->next, at_timestamp_ns);
 }
 
 /*!
@@ -345,7 +360,10 @@ push_then_traverse(struct xrt_relation_chain *xrc, struct u_space *space, int64_
  * the reversed order.
  */
 static void
-traverse_then_push_inverse(struct xrt_relation_chain *xrc, struct u_space *space, int64_t at_timestamp_ns)
+traverse_then_push_inverse(struct u_space_overseer *uso,
+                           struct xrt_relation_chain *xrc,
+                           struct u_space *space,
+                           int64_t at_timestamp_ns)
 {
 	// Done traversing.
 	switch (space->type) {
@@ -357,7 +375,7 @@ traverse_then_push_inverse(struct xrt_relation_chain *xrc, struct u_space *space
 
 	// Can't tail-call optimise this one :(
 	assert(space->next != NULL);
-	traverse_then_push_inverse(xrc, space->next, at_timestamp_ns);
+	traverse_then_push_inverse(uso, xrc, space->next, at_timestamp_ns);
 
 	switch (space->type) {
 	case U_SPACE_TYPE_NULL: break; // No-op
@@ -366,7 +384,7 @@ traverse_then_push_inverse(struct xrt_relation_chain *xrc, struct u_space *space
 		assert(space->pose.xname != 0);
 
 		struct xrt_space_relation xsr;
-		xrt_device_get_tracked_pose(space->pose.xdev, space->pose.xname, at_timestamp_ns, &xsr);
+		u_pose_cache_get_tracked_pose(&uso->pose_cache, space->pose.xdev, space->pose.xname, at_timestamp_ns, &xsr);
 		m_relation_chain_push_inverted_relation(xrc, &xsr);
 	} break;
 	case U_SPACE_TYPE_OFFSET: m_relation_chain_push_inverted_pose_if_not_identity(xrc, &space->offset.pose); break;
@@ -385,8 +403,8 @@ build_relation_chain_read_locked(struct u_space_overseer *uso,
 	assert(base != NULL);
 	assert(target != NULL);
 
-	push_then_traverse(xrc, target, at_timestamp_ns);
-	traverse_then_push_inverse(xrc, base, at_timestamp_ns);
+	push_then_traverse(uso, xrc, target, at_timestamp_ns);
+	traverse_then_push_inverse(uso, xrc, base, at_timestamp_ns);
 }
 
 static void
@@ -1060,6 +1078,10 @@ destroy(struct xrt_space_overseer *xso)
 		xrt_space_reference(xslocalfloor_ptr, NULL);
 	}
 
+	u_var_remove_root(uso);
+
+	u_pose_cache_fini(&uso->pose_cache);
+
 	pthread_rwlock_destroy(&uso->lock);
 
 	free(uso);
@@ -1103,8 +1125,14 @@ u_space_overseer_create(struct xrt_session_event_sink *broadcast)
 	ret = u_hashmap_int_create(&uso->xto_map);
 	assert(ret == 0);
 
+	ret = u_pose_cache_init(&uso->pose_cache, debug_get_num_option_pose_cache_max_age_us() * 1000);
+	assert(ret == 0);
+
 	create_and_set_root_space(uso);
 
+	u_var_add_root(uso, "Space overseer", true);
+	u_pose_cache_add_vars(&uso->pose_cache, uso, "Device pose cache");
+
 	return uso;
 }
 
@@ -340,7 +340,7 @@ calc_pose_data(struct comp_renderer *r,
 		struct xrt_relation_chain xrc = {0};
 		m_relation_chain_push_pose_if_not_identity(&xrc, &eye_pose);
 		m_relation_chain_push_relation(&xrc, &head_relation);
-		m_relation_chain_resolve(&xrc, &result);
+		m_relation_chain_resolve_pose(&xrc, &result);
 
 		// Results to callers.
 		out_fovs[i] = fov;
@@ -63,8 +63,13 @@ slot_clear_locked(struct multi_compositor *mc, struct multi_layer_slot *slot)
 		}
 	}
 
-	U_ZERO(slot);
+	// Layers past layer_count are always zero, only clear the used ones.
+	memset(slot->layers, 0, sizeof(slot->layers[0]) * slot->layer_count);
+
+	U_ZERO(&slot->data);
 	slot->data.frame_id = -1;
+	slot->layer_count = 0;
+	slot->active = false;
 }
 
 /*!
@@ -76,11 +81,23 @@ slot_move_into_cleared(struct multi_layer_slot *dst, struct multi_layer_slot *sr
 	assert(!dst->active);
 	assert(dst->data.frame_id == -1);
 
-	// All references are kept.
-	*dst = *src;
+	/*
+	 * All references are kept, the slots are big (MULTI_MAX_LAYERS) but
+	 * usually only have a few layers so only move the used layers. Layers
+	 * past layer_count are always zero in both slots.
+	 */
+	size_t size = sizeof(src->layers[0]) * src->layer_count;
+	memcpy(dst->layers, src->layers, size);
+	memset(src->layers, 0, size);
+
+	dst->data = src->data;
+	dst->layer_count = src->layer_count;
+	dst->active = src->active;
 
-	U_ZERO(src);
+	U_ZERO(&src->data);
 	src->data.frame_id = -1;
+	src->layer_count = 0;
+	src->active = false;
 }
 
 /*!
@@ -638,8 +655,8 @@ multi_compositor_layer_begin(struct xrt_compositor *xc, const struct xrt_layer_f
 	 */
 	wait_for_wait_thread(mc);
 
+	// The slot has been moved, so it is already cleared.
 	assert(mc->progress.layer_count == 0);
-	U_ZERO(&mc->progress);
 
 	mc->progress.active = true;
 	mc->progress.data = *data;
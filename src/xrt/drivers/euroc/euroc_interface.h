@@ -16,6 +16,8 @@
 extern "C" {
 #endif
 
+struct t_capture_reader;
+
 /*!
  * @defgroup drv_euroc Euroc driver
  * @ingroup drv
@@ -40,7 +42,7 @@ struct euroc_player_playback_config
 	bool skip_perc;           //!< Whether @ref skip_first represents percentage or seconds
 	float skip_first;         //!< How much of the first dataset samples to skip, @see skip_perc
 	float scale;              //!< Scale of each frame; e.g., 0.5 (half), 1.0 (avoids resize)
-	bool max_speed;           //!< If true, push samples as fast as possible, other wise @see speed
+	bool max_speed;           //!< If true, push samples in order as fast as possible, other wise @see speed
 	double speed;             //!< Intended reproduction speed if @ref max_speed is false
 	bool send_all_imus_first; //!< If enabled all imu samples will be sent before img samples
 	bool paused;              //!< Whether to pause the playback
@@ -63,6 +65,8 @@ struct euroc_player_dataset_info
 	const char *gt_device_name;
 	uint32_t width;
 	uint32_t height;
+	//! Set if `path` is a capture file, so it is only mapped once, see @ref euroc_player_config_fini
+	struct t_capture_reader *capture;
 };
 
 /*!
@@ -85,6 +89,15 @@ struct euroc_player_config
 void
 euroc_player_fill_default_config_for(struct euroc_player_config *config, const char *path);
 
+/*!
+ * Releases what @ref euroc_player_fill_default_config_for acquired, the player
+ * keeps its own references so this can be called right after creating it.
+ *
+ * @ingroup drv_euroc
+ */
+void
+euroc_player_config_fini(struct euroc_player_config *config);
+
 /*!
  * Create an euroc player from a path to a dataset.
  *
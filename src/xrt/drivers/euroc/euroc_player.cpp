@@ -16,6 +16,8 @@
 #include "util/u_time.h"
 #include "util/u_var.h"
 #include "util/u_sink.h"
+#include "util/u_worker.h"
+#include "tracking/t_capture.h"
 #include "tracking/t_frame_cv_mat_wrapper.hpp"
 #include "math/m_api.h"
 #include "math/m_filter_fifo.h"
@@ -24,12 +26,15 @@
 #include "euroc_interface.h"
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <cstring>
 #include <stdint.h>
 #include <stdio.h>
 #include <fstream>
 #include <future>
+#include <mutex>
 #include <thread>
 
 //! @see euroc_player_playback_config
@@ -47,22 +52,30 @@ DEBUG_GET_ONCE_BOOL_OPTION(send_all_imus_first, "EUROC_SEND_ALL_IMUS_FIRST", fal
 DEBUG_GET_ONCE_BOOL_OPTION(use_source_ts, "EUROC_USE_SOURCE_TS", false)
 DEBUG_GET_ONCE_BOOL_OPTION(play_from_start, "EUROC_PLAY_FROM_START", false)
 DEBUG_GET_ONCE_BOOL_OPTION(print_progress, "EUROC_PRINT_PROGRESS", false)
+DEBUG_GET_ONCE_NUM_OPTION(prefetch_count, "EUROC_PREFETCH_COUNT", 8)
+DEBUG_GET_ONCE_NUM_OPTION(prefetch_threads, "EUROC_PREFETCH_THREADS", 4)
 
 #define EUROC_PLAYER_STR "Euroc Player"
 
 //! Match max cameras to slam sinks max camera count
 #define EUROC_MAX_CAMS XRT_TRACKING_MAX_SLAM_CAMS
 
+//! Upper limit of frames to decode ahead, each holds an image per camera
+#define EUROC_MAX_PREFETCH_COUNT 64
+
 using std::async;
+using std::condition_variable;
 using std::find_if;
 using std::ifstream;
 using std::is_same_v;
 using std::launch;
 using std::max_element;
+using std::mutex;
 using std::pair;
 using std::stof;
 using std::string;
 using std::to_string;
+using std::unique_lock;
 using std::vector;
 
 using img_sample = pair<timepoint_ns, string>;
@@ -71,6 +84,19 @@ using imu_samples = vector<xrt_imu_sample>;
 using img_samples = vector<img_sample>;
 using gt_trajectory = vector<xrt_pose_sample>;
 
+struct euroc_prefetcher;
+
+/*!
+ * Frames pushed downstream come from here, so that steady state playback
+ * doesn't allocate wrappers or converted images for every frame.
+ */
+struct euroc_frame_pool
+{
+	std::shared_ptr<xrt::auxiliary::tracking::FrameMatPool> pool = xrt::auxiliary::tracking::FrameMatPool::create();
+
+	cv::Mat gray[EUROC_MAX_CAMS]; //!< Scratch for capture frames that are both turned gray and scaled
+};
+
 enum euroc_player_ui_state
 {
 	UNINITIALIZED = 0,
@@ -114,6 +140,10 @@ struct euroc_player
 	vector<img_samples> *imgs; //!< List of all image names to read from the dataset per camera
 	gt_trajectory *gt;         //!< List of all groundtruth poses read from the dataset
 
+	struct euroc_prefetcher *prefetch; //!< Decodes frames ahead of playback, only alive while streaming
+	struct t_capture_reader *capture;  //!< Set when playing a capture file instead of a EuRoC dataset
+	struct euroc_frame_pool *frames;   //!< Recycles the frames pushed downstream
+
 	// Timestamp correction fields (can be disabled through `use_source_ts`)
 	timepoint_ns base_ts;   //!< First sample timestamp, stream timestamps are relative to this
 	timepoint_ns start_ts;  //!< When did the dataset started to be played
@@ -303,9 +333,38 @@ euroc_player_match_cams_seqs(struct euroc_player *ep)
 	}
 }
 
+//! Load the samples of a capture file, frames stay in the mapping and are found by timestamp.
+static void
+euroc_player_preload_capture(struct euroc_player *ep)
+{
+	struct t_capture_reader *r = ep->capture;
+
+	ep->imus->assign(r->imus, r->imus + r->imu_count);
+
+	for (size_t i = 0; i < ep->imgs->size(); i++) {
+		img_samples &samples = ep->imgs->at(i);
+		samples.clear();
+		samples.reserve(r->frame_counts[i]);
+		for (uint32_t f = 0; f < r->frame_counts[i]; f++) {
+			samples.push_back({r->frames[i][f].timestamp_ns, string{}});
+		}
+	}
+
+	euroc_player_match_cams_seqs(ep);
+
+	if (ep->dataset.has_gt) {
+		ep->gt->assign(r->gts, r->gts + r->gt_count);
+	}
+}
+
 static void
 euroc_player_preload(struct euroc_player *ep)
 {
+	if (ep->capture != nullptr) {
+		euroc_player_preload_capture(ep);
+		return;
+	}
+
 	ep->imus->clear();
 	euroc_player_preload_imu_data(ep->dataset.path, ep->imus);
 
@@ -353,10 +412,28 @@ euroc_player_user_skip(struct euroc_player *ep)
 
 //! Determine and fill attributes of the dataset pointed by `path`
 //! Assertion fails if `path` does not point to an euroc dataset
+//! For capture files the opened reader is kept in `dataset`
 static void
 euroc_player_fill_dataset_info(const char *path, euroc_player_dataset_info *dataset)
 {
 	(void)snprintf(dataset->path, sizeof(dataset->path), "%s", path);
+
+	if (t_capture_is_capture_file(path)) {
+		struct t_capture_reader *r = nullptr;
+		int ret = t_capture_reader_open(path, &r);
+		EUROC_ASSERT(ret == 0, "Invalid capture file %s", path);
+		EUROC_ASSERT(r->cam_count > 0 && r->frame_counts[0] > 0 && r->imu_count > 0, "Empty capture file %s", path);
+
+		const struct t_capture_frame_header *fh = r->frames[0][0].header;
+		dataset->cam_count = (int)r->cam_count;
+		dataset->is_colored = fh->format == XRT_FORMAT_R8G8B8;
+		dataset->has_gt = r->gt_count > 0;
+		dataset->width = fh->width;
+		dataset->height = fh->height;
+		dataset->capture = r;
+		return;
+	}
+
 	img_samples samples;
 	imu_samples _1;
 	gt_trajectory _2;
@@ -421,29 +498,194 @@ euroc_player_mapped_playback_ts(struct euroc_player *ep, timepoint_ns ts)
 	return euroc_player_mapped_ts(ep, ts);
 }
 
+/*!
+ * A frame number worth of decoded images, one per camera. The images are
+ * reused for later frames once nobody else holds a reference to them.
+ */
+struct euroc_prefetch_slot
+{
+	uint64_t seq;                              //!< Frame number held, index in `imgs[i]`
+	int pending;                               //!< Cameras still being decoded, protected by mutex
+	bool allow_color;                          //!< Playback option at the time of scheduling
+	float scale;                               //!< Playback option at the time of scheduling
+	cv::Mat imgs[EUROC_MAX_CAMS];              //!< Decoded and scaled images
+	cv::Mat decoded[EUROC_MAX_CAMS];           //!< Decode target if scaling, never handed out
+	vector<uint8_t> file_bufs[EUROC_MAX_CAMS]; //!< Encoded file contents
+};
+
+//! Argument for a single decode task, one per slot and camera.
+struct euroc_prefetch_task
+{
+	struct euroc_player *ep;
+	struct euroc_prefetch_slot *slot;
+	int cam_index;
+};
+
+/*!
+ * Decodes the next frames ahead of time on a @ref u_worker_thread_pool so that
+ * decoding (and resizing) doesn't eat into the time between frames, which
+ * would otherwise skew the timing of the samples sent to the SLAM system.
+ * Slots form a ring indexed by `seq % slots.size()`.
+ */
+struct euroc_prefetcher
+{
+	struct u_worker_thread_pool *pool = nullptr;
+	struct u_worker_group *group = nullptr;
+
+	mutex mtx;
+	condition_variable cv;
+
+	vector<euroc_prefetch_slot> slots;
+	vector<euroc_prefetch_task> tasks; //!< `slots.size() * cam_count`, pointers to these are given to tasks
+};
+
+//! @returns true if nobody else holds the data of @p mat, so it can be written to.
+static bool
+euroc_player_mat_is_unique(const cv::Mat &mat)
+{
+	return mat.u != nullptr && mat.u->refcount == 1;
+}
+
+//! Read the whole file into @p buf, reusing its storage.
+static bool
+euroc_player_read_file(const string &filename, vector<uint8_t> &buf)
+{
+	ifstream fin{filename, std::ios::binary | std::ios::ate};
+	if (!fin.is_open()) {
+		return false;
+	}
+
+	std::streamsize size = fin.tellg();
+	fin.seekg(0, std::ios::beg);
+	buf.resize(size);
+	return (bool)fin.read(reinterpret_cast<char *>(buf.data()), size);
+}
+
+//! Load and decode the image of camera @p cam_index for the slot's frame, runs on a worker thread.
 static void
-euroc_player_load_next_frame(struct euroc_player *ep, int cam_index, struct xrt_frame *&xf)
+euroc_player_decode_img(struct euroc_player *ep, struct euroc_prefetch_slot *slot, int cam_index)
 {
-	using xrt::auxiliary::tracking::FrameMat;
-	img_sample sample = ep->imgs->at(cam_index).at(ep->img_seq);
+	const img_sample &sample = ep->imgs->at(cam_index).at(slot->seq);
+	EUROC_TRACE(ep, "cam%d decode seq = %" PRIu64 " filename = %s", cam_index, slot->seq, sample.second.c_str());
+
+	cv::Mat &img = slot->imgs[cam_index];
+
+	// Frames from previous playback might still be held downstream, don't write into those.
+	if (!euroc_player_mat_is_unique(img)) {
+		img.release();
+	}
+
+	vector<uint8_t> &buf = slot->file_bufs[cam_index];
+	bool read = euroc_player_read_file(sample.second, buf);
+	EUROC_ASSERT(read, "Unable to read %s", sample.second.c_str());
+
+	cv::ImreadModes read_mode = slot->allow_color ? cv::IMREAD_ANYCOLOR : cv::IMREAD_GRAYSCALE;
+	if (slot->scale == 1.0) {
+		cv::imdecode(buf, read_mode, &img); // If colored, reads in BGR order
+	} else {
+		cv::Mat &decoded = slot->decoded[cam_index];
+		cv::imdecode(buf, read_mode, &decoded);
+		cv::resize(decoded, img, cv::Size(), slot->scale, slot->scale);
+	}
+
+	EUROC_ASSERT(!img.empty(), "Unable to decode %s", sample.second.c_str());
+}
+
+static void
+euroc_player_prefetch_task(void *ptr)
+{
+	struct euroc_prefetch_task *task = (struct euroc_prefetch_task *)ptr;
+	struct euroc_prefetcher *pf = task->ep->prefetch;
+
+	euroc_player_decode_img(task->ep, task->slot, task->cam_index);
+
+	unique_lock<mutex> lock{pf->mtx};
+	task->slot->pending--;
+	pf->cv.notify_all();
+}
+
+//! Schedule decoding of all the camera images of frame @p seq, if there is such a frame.
+static void
+euroc_player_prefetch_schedule(struct euroc_player *ep, uint64_t seq)
+{
+	struct euroc_prefetcher *pf = ep->prefetch;
+	if (seq >= ep->imgs->at(0).size()) {
+		return;
+	}
+
+	size_t slot_index = seq % pf->slots.size();
+	struct euroc_prefetch_slot &slot = pf->slots[slot_index];
+	int cam_count = ep->playback.cam_count;
+
 	ep->playback.scale = CLAMP(ep->playback.scale, 1.0 / 16, 4);
 
-	// Load will be influenced by these playback options
-	bool allow_color = ep->playback.color;
-	float scale = ep->playback.scale;
+	{
+		unique_lock<mutex> lock{pf->mtx};
+		EUROC_ASSERT(slot.pending == 0, "Scheduling into a slot that is still being decoded");
+		slot.seq = seq;
+		slot.pending = cam_count;
+		slot.allow_color = ep->playback.color;
+		slot.scale = ep->playback.scale;
+	}
 
-	// Load image from disk
-	timepoint_ns timestamp = euroc_player_mapped_playback_ts(ep, sample.first);
-	string img_name = sample.second;
-	EUROC_TRACE(ep, "cam%d img t = %ld filename = %s", cam_index, timestamp, img_name.c_str());
-	cv::ImreadModes read_mode = allow_color ? cv::IMREAD_ANYCOLOR : cv::IMREAD_GRAYSCALE;
-	cv::Mat img = cv::imread(img_name, read_mode); // If colored, reads in BGR order
-
-	if (scale != 1.0) {
-		cv::Mat tmp;
-		cv::resize(img, tmp, cv::Size(), scale, scale);
-		img = tmp;
+	for (int i = 0; i < cam_count; i++) {
+		u_worker_group_push(pf->group, euroc_player_prefetch_task, &pf->tasks[slot_index * cam_count + i]);
+	}
+}
+
+static void
+euroc_player_prefetch_start(struct euroc_player *ep)
+{
+	int64_t slot_count = CLAMP(debug_get_num_option_prefetch_count(), 1, EUROC_MAX_PREFETCH_COUNT);
+	int64_t thread_count = CLAMP(debug_get_num_option_prefetch_threads(), 1, 15);
+	int cam_count = ep->playback.cam_count;
+
+	// One extra thread is created for when a thread waits on the group.
+	struct euroc_prefetcher *pf = new euroc_prefetcher{};
+	pf->pool = u_worker_thread_pool_create(thread_count, thread_count + 1, "EuRoC decode");
+	pf->group = u_worker_group_create(pf->pool);
+	pf->slots = vector<euroc_prefetch_slot>(slot_count);
+	pf->tasks.resize(slot_count * cam_count);
+	for (int64_t s = 0; s < slot_count; s++) {
+		for (int i = 0; i < cam_count; i++) {
+			pf->tasks[s * cam_count + i] = {ep, &pf->slots[s], i};
+		}
 	}
+	ep->prefetch = pf;
+
+	for (int64_t s = 0; s < slot_count; s++) {
+		euroc_player_prefetch_schedule(ep, ep->img_seq + s);
+	}
+}
+
+static void
+euroc_player_prefetch_stop(struct euroc_player *ep)
+{
+	struct euroc_prefetcher *pf = ep->prefetch;
+	if (pf == nullptr) {
+		return;
+	}
+
+	// Tasks point into the prefetcher, let them finish first.
+	u_worker_group_wait_all(pf->group);
+	u_worker_group_reference(&pf->group, NULL);
+	u_worker_thread_pool_reference(&pf->pool, NULL);
+
+	ep->prefetch = nullptr;
+	delete pf;
+}
+
+//! Wraps the prefetched image of camera @p cam_index into @p xf, the timestamp is mapped now and not at decode time.
+static void
+euroc_player_wrap_frame(struct euroc_player *ep, struct euroc_prefetch_slot &slot, int cam_index, struct xrt_frame *&xf)
+{
+	using xrt::auxiliary::tracking::FrameMat;
+	using xrt::auxiliary::tracking::FrameMatPool;
+	const img_sample &sample = ep->imgs->at(cam_index).at(slot.seq);
+	const cv::Mat &img = slot.imgs[cam_index];
+
+	timepoint_ns timestamp = euroc_player_mapped_playback_ts(ep, sample.first);
+	EUROC_TRACE(ep, "cam%d img t = %ld filename = %s", cam_index, timestamp, sample.second.c_str());
 
 	// Create xrt_frame, it will be freed by FrameMat destructor
 	EUROC_ASSERT(xf == NULL || xf->reference.count > 0, "Must be given a valid or NULL frame ptr");
@@ -451,13 +693,77 @@ euroc_player_load_next_frame(struct euroc_player *ep, int cam_index, struct xrt_
 	//! @todo Not using xrt_stereo_format because we use two sinks. It would
 	//! probably be better to refactor everything to use stereo frames instead.
 	FrameMat::Params params{XRT_STEREO_FORMAT_NONE, static_cast<uint64_t>(timestamp)};
-	auto wrap = img.channels() == 3 ? FrameMat::wrapR8G8B8 : FrameMat::wrapL8;
-	wrap(img, &xf, params);
+	FrameMatPool &pool = *ep->frames->pool;
+	if (img.channels() == 3) {
+		pool.wrapR8G8B8(img, &xf, params);
+	} else {
+		pool.wrapL8(img, &xf, params);
+	}
 
 	// Fields that aren't set by FrameMat
 	xf->owner = ep;
 	xf->source_timestamp = sample.first;
-	xf->source_sequence = ep->img_seq;
+	xf->source_sequence = slot.seq;
+	xf->source_id = ep->base.source_id;
+}
+
+/*!
+ * Wraps frame @p seq of camera @p cam_index of a capture file into @p xf, it
+ * points straight into the mapped file unless it needs to be scaled or turned
+ * into grayscale.
+ */
+static void
+euroc_player_wrap_capture_frame(struct euroc_player *ep, int cam_index, uint64_t seq, struct xrt_frame *&xf)
+{
+	const img_sample &sample = ep->imgs->at(cam_index).at(seq);
+
+	uint32_t index = 0;
+	bool found = t_capture_reader_find_frame(ep->capture, cam_index, sample.first, &index);
+	EUROC_ASSERT(found, "cam%d has no frame at t = %" PRId64, cam_index, sample.first);
+	t_capture_reader_wrap_frame(ep->capture, cam_index, index, &xf);
+
+	ep->playback.scale = CLAMP(ep->playback.scale, 1.0 / 16, 4);
+	bool to_gray = !ep->playback.color && xf->format == XRT_FORMAT_R8G8B8;
+	if (ep->playback.scale != 1.0 || to_gray) {
+		int type = xf->format == XRT_FORMAT_R8G8B8 ? CV_8UC3 : CV_8UC1;
+		cv::Mat src{(int)xf->height, (int)xf->width, type, xf->data, xf->stride};
+
+		// Same size as cv::resize picks from the scale.
+		double scale = ep->playback.scale;
+		int rows = scale != 1.0 ? cvRound(src.rows * scale) : src.rows;
+		int cols = scale != 1.0 ? cvRound(src.cols * scale) : src.cols;
+
+		// The new image doesn't point into the mapping, get it from the pool.
+		struct xrt_frame *converted = NULL;
+		cv::Mat img;
+		if (to_gray || type == CV_8UC1) {
+			ep->frames->pool->allocL8(rows, cols, &converted, img);
+		} else {
+			ep->frames->pool->allocR8G8B8(rows, cols, &converted, img);
+		}
+
+		if (to_gray && scale != 1.0) {
+			cv::Mat &gray = ep->frames->gray[cam_index];
+			cv::cvtColor(src, gray, cv::COLOR_BGR2GRAY);
+			cv::resize(gray, img, img.size());
+		} else if (to_gray) {
+			cv::cvtColor(src, img, cv::COLOR_BGR2GRAY);
+		} else {
+			cv::resize(src, img, img.size());
+		}
+
+		xrt_frame_reference(&xf, NULL);
+		xf = converted;
+	}
+
+	timepoint_ns timestamp = euroc_player_mapped_playback_ts(ep, sample.first);
+	EUROC_TRACE(ep, "cam%d img t = %ld capture index = %u", cam_index, timestamp, index);
+	EUROC_ASSERT(timestamp >= 0, "Unexpected negative timestamp");
+
+	xf->timestamp = timestamp;
+	xf->owner = ep;
+	xf->source_timestamp = sample.first;
+	xf->source_sequence = seq;
 	xf->source_id = ep->base.source_id;
 }
 
@@ -465,10 +771,27 @@ static void
 euroc_player_push_next_frame(struct euroc_player *ep)
 {
 	int cam_count = ep->playback.cam_count;
+	struct euroc_prefetcher *pf = ep->prefetch;
+	struct xrt_frame *xfs[EUROC_MAX_CAMS] = {};
 
-	vector<xrt_frame *> xfs(cam_count, nullptr);
-	for (int i = 0; i < cam_count; i++) {
-		euroc_player_load_next_frame(ep, i, xfs[i]);
+	if (ep->capture != nullptr) {
+		// Nothing to decode, frames come straight from the mapping.
+		for (int i = 0; i < cam_count; i++) {
+			euroc_player_wrap_capture_frame(ep, i, ep->img_seq, xfs[i]);
+		}
+	} else {
+		struct euroc_prefetch_slot &slot = pf->slots[ep->img_seq % pf->slots.size()];
+
+		// Normally already decoded, only blocks if decoding can't keep up.
+		{
+			unique_lock<mutex> lock{pf->mtx};
+			EUROC_ASSERT(slot.seq == ep->img_seq, "Prefetch slot holds the wrong frame");
+			pf->cv.wait(lock, [&slot] { return slot.pending == 0; });
+		}
+
+		for (int i = 0; i < cam_count; i++) {
+			euroc_player_wrap_frame(ep, slot, i, xfs[i]);
+		}
 	}
 
 	// TODO: Some SLAM systems expect synced frames, but that's not an
@@ -477,7 +800,7 @@ euroc_player_push_next_frame(struct euroc_player *ep)
 		EUROC_ASSERT(xfs[i - 1]->timestamp == xfs[i]->timestamp, "Unsynced frames");
 	}
 
-	ep->img_seq++;
+	uint64_t seq = ep->img_seq++;
 
 	for (int i = 0; i < cam_count; i++) {
 		xrt_sink_push_frame(ep->in_sinks.cams[i], xfs[i]);
@@ -487,6 +810,11 @@ euroc_player_push_next_frame(struct euroc_player *ep)
 		xrt_frame_reference(&xfs[i], NULL);
 	}
 
+	// The slot is free again, reuse it for the frame furthest ahead.
+	if (pf != nullptr) {
+		euroc_player_prefetch_schedule(ep, seq + pf->slots.size());
+	}
+
 	size_t fcount = ep->imgs->at(0).size();
 	(void)snprintf(ep->progress_text, sizeof(ep->progress_text),
 	               "Playback %.2f%% - Frame %" PRId64 "/%" PRId64 " - IMU %" PRId64 "/%" PRId64,
@@ -575,28 +903,75 @@ euroc_player_get_stream_set(struct euroc_player *ep)
 	return make_tuple(samples, sample_seq, push_next_sample, sleep_until_next_sample);
 }
 
+/*!
+ * Used for real time playback, one thread per stream. Returns early with
+ * @p switch_mode set once max speed gets enabled, so that the other stream
+ * returns too and both can be streamed in order.
+ */
 template <typename SamplesType>
 static void
-euroc_player_stream_samples(struct euroc_player *ep)
+euroc_player_stream_samples(struct euroc_player *ep, std::atomic<bool> &switch_mode)
 {
 	// These fields correspond to IMU or frame streams depending on SamplesType
 	const auto [samples, sample_seq, push_next_sample, sleep_until_next_sample] =
 	    euroc_player_get_stream_set<SamplesType>(ep);
 
-	while (*sample_seq < samples->size() && ep->is_running) {
+	while (*sample_seq < samples->size() && ep->is_running && !switch_mode) {
 		while (ep->playback.paused) {
 			constexpr int64_t PAUSE_POLL_INTERVAL_NS = 15L * U_TIME_1MS_IN_NS;
 			os_nanosleep(PAUSE_POLL_INTERVAL_NS);
 		}
 
-		if (!ep->playback.max_speed) {
-			sleep_until_next_sample(ep);
+		if (ep->playback.max_speed) {
+			switch_mode = true;
+			break;
 		}
 
+		sleep_until_next_sample(ep);
+
 		push_next_sample(ep);
 	}
 }
 
+//! Whether there are IMU samples or frames left to stream.
+static bool
+euroc_player_has_samples_left(struct euroc_player *ep)
+{
+	return ep->imu_seq < ep->imus->size() || ep->img_seq < ep->imgs->at(0).size();
+}
+
+/*!
+ * Used for max speed playback, streams IMU samples and frames from a single
+ * thread in timestamp order, as fast as the sinks accept them. With two
+ * threads the IMU stream would run far ahead of the frames as decoding them
+ * takes much longer. Returns early once max speed gets disabled.
+ */
+static void
+euroc_player_stream_all_samples_in_order(struct euroc_player *ep)
+{
+	while (ep->is_running && euroc_player_has_samples_left(ep)) {
+		bool has_imu = ep->imu_seq < ep->imus->size();
+		bool has_img = ep->img_seq < ep->imgs->at(0).size();
+
+		while (ep->playback.paused) {
+			constexpr int64_t PAUSE_POLL_INTERVAL_NS = 15L * U_TIME_1MS_IN_NS;
+			os_nanosleep(PAUSE_POLL_INTERVAL_NS);
+		}
+
+		if (!ep->playback.max_speed) {
+			break;
+		}
+
+		bool img_first = has_img && (!has_imu || euroc_player_get_next_euroc_ts<img_samples>(ep) <=
+		                                             euroc_player_get_next_euroc_ts<imu_samples>(ep));
+		if (img_first) {
+			euroc_player_push_next_frame(ep);
+		} else {
+			euroc_player_push_next_imu(ep);
+		}
+	}
+}
+
 static void *
 euroc_player_stream(void *ptr)
 {
@@ -609,6 +984,11 @@ euroc_player_stream(void *ptr)
 	ep->start_ts = os_monotonic_get_ts();
 	euroc_player_user_skip(ep);
 
+	// Start decoding frames ahead of time, capture files are not encoded
+	if (ep->capture == nullptr) {
+		euroc_player_prefetch_start(ep);
+	}
+
 	// Push all IMU samples now if requested
 	if (ep->playback.send_all_imus_first) {
 		while (ep->imu_seq < ep->imus->size()) {
@@ -621,15 +1001,31 @@ euroc_player_stream(void *ptr)
 		euroc_player_push_all_gt(ep);
 	}
 
-	// Launch image and IMU producers
-	auto serve_imus = async(launch::async, [ep] { euroc_player_stream_samples<imu_samples>(ep); });
-	auto serve_imgs = async(launch::async, [ep] { euroc_player_stream_samples<img_samples>(ep); });
-	// Note that the only fields of `ep` being modified in the threads are: img_seq, imu_seq and
-	// progress_text in single locations, thus no race conditions should occur.
+	// Max speed can be toggled from the UI while streaming, switch modes when it is.
+	while (ep->is_running && euroc_player_has_samples_left(ep)) {
+		if (ep->playback.max_speed) {
+			// As fast as possible, but keep the streams in order
+			euroc_player_stream_all_samples_in_order(ep);
+			continue;
+		}
 
-	// Wait for the end of both streams
-	serve_imgs.get();
-	serve_imus.get();
+		// Launch image and IMU producers
+		std::atomic<bool> switch_mode{false};
+		auto serve_imus = async(launch::async, [ep, &switch_mode] {
+			euroc_player_stream_samples<imu_samples>(ep, switch_mode);
+		});
+		auto serve_imgs = async(launch::async, [ep, &switch_mode] {
+			euroc_player_stream_samples<img_samples>(ep, switch_mode);
+		});
+		// Note that the only fields of `ep` being modified in the threads are: img_seq, imu_seq and
+		// progress_text in single locations, thus no race conditions should occur.
+
+		// Wait for the end of both streams, or for both to stop when switching modes
+		serve_imgs.get();
+		serve_imus.get();
+	}
+
+	euroc_player_prefetch_stop(ep);
 
 	ep->is_running = false;
 
@@ -801,6 +1197,11 @@ euroc_player_destroy(struct xrt_frame_node *node)
 	delete ep->imus;
 	delete ep->imgs;
 
+	t_capture_reader_reference(&ep->capture, NULL);
+
+	// Frames still held downstream keep the pool itself alive.
+	delete ep->frames;
+
 	u_var_remove_root(ep);
 	for (int i = 0; i < ep->dataset.cam_count; i++) {
 		u_sink_debug_destroy(&ep->ui_cam_sinks[i]);
@@ -951,6 +1352,12 @@ euroc_player_fill_default_config_for(struct euroc_player_config *config, const c
 	config->playback = playback;
 }
 
+extern "C" void
+euroc_player_config_fini(struct euroc_player_config *config)
+{
+	t_capture_reader_reference(&config->dataset.capture, NULL);
+}
+
 // Euroc driver creation
 
 extern "C" struct xrt_fs *
@@ -968,8 +1375,14 @@ euroc_player_create(struct xrt_frame_context *xfctx, const char *path, struct eu
 	ep->log_level = config->log_level;
 	ep->dataset = config->dataset;
 	ep->playback = config->playback;
+	ep->frames = new euroc_frame_pool{};
+
+	// The player holds its own reference in ep->capture.
+	t_capture_reader_reference(&ep->capture, config->dataset.capture);
+	ep->dataset.capture = nullptr;
 
 	if (default_config != nullptr) {
+		euroc_player_config_fini(default_config);
 		free(default_config);
 	}
 
@@ -985,6 +1398,15 @@ euroc_player_create(struct xrt_frame_context *xfctx, const char *path, struct eu
 	           ep->dataset.path, ep->dataset.cam_count, ep->dataset.is_colored, ep->dataset.width,
 	           ep->dataset.height);
 
+	// Configs that were not filled in by us might not have the reader yet.
+	if (ep->capture == nullptr && t_capture_is_capture_file(ep->dataset.path)) {
+		int ret = t_capture_reader_open(ep->dataset.path, &ep->capture);
+		EUROC_ASSERT(ret == 0, "Unable to open capture file %s", ep->dataset.path);
+	}
+	if (ep->capture != nullptr) {
+		EUROC_ASSERT((int)ep->capture->cam_count >= ep->dataset.cam_count, "Capture file has too few cameras");
+	}
+
 	// Using pointers to not mix vector with a C-compatible struct
 	ep->gt = new gt_trajectory{};
 	ep->imus = new imu_samples{};
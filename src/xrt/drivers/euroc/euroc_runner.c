@@ -127,6 +127,7 @@ euroc_run_dataset(const char *euroc_path,
 
 	xrt_frame_context_destroy_nodes(&xfctx);
 	free(st_config);
+	euroc_player_config_fini(ep_config);
 	free(ep_config);
 }
 
@@ -303,30 +303,44 @@ read_sample_and_apply_calibration(struct psvr_device *psvr,
 	*out_gyro = gyro;
 }
 
+/*!
+ * Both samples of a sensor packet are handed to the fusion in one go, under
+ * a single lock.
+ */
 static void
-update_fusion_locked(struct psvr_device *psvr, struct psvr_parsed_sample *sample, uint64_t timestamp_ns)
+update_fusion_locked(struct psvr_device *psvr,
+                     struct psvr_parsed_sample samples[2],
+                     const uint64_t timestamps_ns[2])
 {
-	struct xrt_vec3 mag = {0.0f, 0.0f, 0.0f};
-	(void)mag;
+	struct xrt_vec3 accels[2];
+	struct xrt_vec3 gyros[2];
+
+	for (int i = 0; i < 2; i++) {
+		read_sample_and_apply_calibration(psvr, &samples[i], &accels[i], &gyros[i]);
+	}
 
-	read_sample_and_apply_calibration(psvr, sample, &psvr->read.accel, &psvr->read.gyro);
+	// Show the latest sample.
+	psvr->read.accel = accels[1];
+	psvr->read.gyro = gyros[1];
 
 	if (psvr->tracker != NULL) {
-		struct xrt_tracking_sample sample;
-		sample.accel_m_s2 = psvr->read.accel;
-		sample.gyro_rad_secs = psvr->read.gyro;
+		for (int i = 0; i < 2; i++) {
+			struct xrt_tracking_sample sample;
+			sample.accel_m_s2 = accels[i];
+			sample.gyro_rad_secs = gyros[i];
 
-		xrt_tracked_psvr_push_imu(psvr->tracker, timestamp_ns, &sample);
+			xrt_tracked_psvr_push_imu(psvr->tracker, timestamps_ns[i], &sample);
+		}
 	} else {
-		m_imu_3dof_update(&psvr->fusion, timestamp_ns, &psvr->read.accel, &psvr->read.gyro);
+		m_imu_3dof_update_batch(&psvr->fusion, timestamps_ns, accels, gyros, 2);
 	}
 }
 
 static void
-update_fusion(struct psvr_device *psvr, struct psvr_parsed_sample *sample, uint64_t timestamp_ns)
+update_fusion(struct psvr_device *psvr, struct psvr_parsed_sample samples[2], const uint64_t timestamps_ns[2])
 {
 	os_mutex_lock(&psvr->device_mutex);
-	update_fusion_locked(psvr, sample, timestamp_ns);
+	update_fusion_locked(psvr, samples, timestamps_ns);
 	os_mutex_unlock(&psvr->device_mutex);
 }
 
@@ -403,17 +417,16 @@ handle_tracker_sensor_msg(struct psvr_device *psvr, unsigned char *buffer, int s
 	// Move it back in time.
 	timepoint_ns timestamp_ns = (uint64_t)now_ns - (uint64_t)inter_sample_duration_ns;
 
-	// Make sure timestamps are always after a previous timestamp.
-	timestamp_ns = ensure_forward_progress_timestamps(psvr, timestamp_ns);
+	uint64_t timestamps_ns[2];
 
-	// Update the fusion with first sample.
-	update_fusion(psvr, &s->samples[0], timestamp_ns);
+	// Make sure timestamps are always after a previous timestamp.
+	timestamps_ns[0] = (uint64_t)ensure_forward_progress_timestamps(psvr, timestamp_ns);
 
 	// Make sure timestamps are always after a previous timestamp.
-	timestamp_ns = ensure_forward_progress_timestamps(psvr, now_ns);
+	timestamps_ns[1] = (uint64_t)ensure_forward_progress_timestamps(psvr, now_ns);
 
-	// Update the fusion with second sample.
-	update_fusion(psvr, &s->samples[1], timestamp_ns);
+	// Update the fusion with both samples.
+	update_fusion(psvr, s->samples, timestamps_ns);
 }
 
 static void
@@ -106,7 +106,13 @@ rift_s_hmd_handle_report(struct rift_s_hmd *hmd, timepoint_ns local_ts, rift_s_h
 	const float temperature_scale = 1.0 / imu_config->temperature_scale;
 	const float temperature_offset = imu_config->temperature_offset;
 
-	for (int i = 0; i < 3; i++) {
+	/* All of the samples of the report are handed to the tracker at once */
+	uint64_t timestamps_ns[RIFT_S_TRACKER_MAX_IMU_SAMPLES];
+	struct xrt_vec3 accels[RIFT_S_TRACKER_MAX_IMU_SAMPLES];
+	struct xrt_vec3 gyros[RIFT_S_TRACKER_MAX_IMU_SAMPLES];
+	int count = 0;
+
+	for (int i = 0; i < RIFT_S_TRACKER_MAX_IMU_SAMPLES; i++) {
 		rift_s_hmd_imu_sample_t *s = report->samples + i;
 
 		if (s->marker & 0x80)
@@ -142,13 +148,18 @@ rift_s_hmd_handle_report(struct rift_s_hmd *hmd, timepoint_ns local_ts, rift_s_h
 			gyro.x, gyro.y, gyro.z);
 #endif
 
-		// Send the sample to the pose tracker
-		rift_s_tracker_imu_update(hmd->tracker, hmd->last_imu_timestamp_ns, &accel, &gyro);
+		timestamps_ns[count] = hmd->last_imu_timestamp_ns;
+		accels[count] = accel;
+		gyros[count] = gyro;
+		count++;
 
 		hmd->last_imu_timestamp_ns += (uint64_t)dt * OS_NS_PER_USEC;
 		hmd->last_imu_timestamp32 += dt;
 		dt = TICK_LEN_US;
 	}
+
+	// Send the samples to the pose tracker
+	rift_s_tracker_imu_update(hmd->tracker, timestamps_ns, accels, gyros, count);
 }
 
 static bool
@@ -493,10 +493,13 @@ clock_hw2mono_get(struct rift_s_tracker *t, uint64_t device_ts, timepoint_ns *ou
 
 void
 rift_s_tracker_imu_update(struct rift_s_tracker *t,
-                          uint64_t device_timestamp_ns,
-                          const struct xrt_vec3 *accel,
-                          const struct xrt_vec3 *gyro)
+                          const uint64_t *device_timestamps_ns,
+                          const struct xrt_vec3 *accels,
+                          const struct xrt_vec3 *gyros,
+                          int count)
 {
+	assert(count <= RIFT_S_TRACKER_MAX_IMU_SAMPLES);
+
 	os_mutex_lock(&t->mutex);
 
 	/* Ignore packets before we're ready and clock is stable */
@@ -505,39 +508,66 @@ rift_s_tracker_imu_update(struct rift_s_tracker *t,
 		return;
 	}
 
-	/* Get the smoothed monotonic time estimate for this IMU sample */
-	timepoint_ns local_timestamp_ns;
+	timepoint_ns local_timestamps_ns[RIFT_S_TRACKER_MAX_IMU_SAMPLES];
 
-	clock_hw2mono_get(t, device_timestamp_ns, &local_timestamp_ns);
+	/* Samples that go to the fusion, all of the report in one batch */
+	uint64_t fusion_timestamps_ns[RIFT_S_TRACKER_MAX_IMU_SAMPLES];
+	struct xrt_vec3 fusion_accels[RIFT_S_TRACKER_MAX_IMU_SAMPLES];
+	struct xrt_vec3 fusion_gyros[RIFT_S_TRACKER_MAX_IMU_SAMPLES];
+	size_t fusion_count = 0;
 
-	if (t->fusion.last_imu_local_timestamp_ns != 0 && local_timestamp_ns < t->fusion.last_imu_local_timestamp_ns) {
-		RIFT_S_WARN("IMU time went backward by %" PRId64 " ns",
-		            local_timestamp_ns - t->fusion.last_imu_local_timestamp_ns);
-	} else {
-		m_imu_3dof_update(&t->fusion.i3dof, local_timestamp_ns, accel, gyro);
-	}
+	for (int i = 0; i < count; i++) {
+		uint64_t device_timestamp_ns = device_timestamps_ns[i];
+
+		/* Get the smoothed monotonic time estimate for this IMU sample */
+		timepoint_ns local_timestamp_ns;
+
+		clock_hw2mono_get(t, device_timestamp_ns, &local_timestamp_ns);
+
+		if (t->fusion.last_imu_local_timestamp_ns != 0 &&
+		    local_timestamp_ns < t->fusion.last_imu_local_timestamp_ns) {
+			RIFT_S_WARN("IMU time went backward by %" PRId64 " ns",
+			            local_timestamp_ns - t->fusion.last_imu_local_timestamp_ns);
+		} else {
+			fusion_timestamps_ns[fusion_count] = local_timestamp_ns;
+			fusion_accels[fusion_count] = accels[i];
+			fusion_gyros[fusion_count] = gyros[i];
+			fusion_count++;
+		}
 
-	RIFT_S_TRACE("IMU timestamp %" PRIu64 " (dt %f) hw2mono local ts %" PRIu64 " (dt %f) offset %" PRId64,
-	             device_timestamp_ns,
-	             (double)(device_timestamp_ns - t->fusion.last_imu_timestamp_ns) / 1000000000.0, local_timestamp_ns,
-	             (double)(local_timestamp_ns - t->fusion.last_imu_local_timestamp_ns) / 1000000000.0, t->hw2mono);
+		RIFT_S_TRACE("IMU timestamp %" PRIu64 " (dt %f) hw2mono local ts %" PRIu64 " (dt %f) offset %" PRId64,
+		             device_timestamp_ns,
+		             (double)(device_timestamp_ns - t->fusion.last_imu_timestamp_ns) / 1000000000.0,
+		             local_timestamp_ns,
+		             (double)(local_timestamp_ns - t->fusion.last_imu_local_timestamp_ns) / 1000000000.0,
+		             t->hw2mono);
 
-	t->fusion.last_angular_velocity = *gyro;
-	t->fusion.last_imu_timestamp_ns = device_timestamp_ns;
-	t->fusion.last_imu_local_timestamp_ns = local_timestamp_ns;
+		t->fusion.last_angular_velocity = gyros[i];
+		t->fusion.last_imu_timestamp_ns = device_timestamp_ns;
+		t->fusion.last_imu_local_timestamp_ns = local_timestamp_ns;
+
+		local_timestamps_ns[i] = local_timestamp_ns;
+	}
+
+	if (fusion_count > 0) {
+		m_imu_3dof_update_batch(&t->fusion.i3dof, fusion_timestamps_ns, fusion_accels, fusion_gyros,
+		                        fusion_count);
+	}
 
 	t->pose.orientation = t->fusion.i3dof.rot;
 
 	os_mutex_unlock(&t->mutex);
 
 	if (t->slam_sinks.imu) {
-		/* Push IMU sample to the SLAM tracker */
-		struct xrt_vec3_f64 accel64 = {accel->x, accel->y, accel->z};
-		struct xrt_vec3_f64 gyro64 = {gyro->x, gyro->y, gyro->z};
-		struct xrt_imu_sample sample = {
-		    .timestamp_ns = local_timestamp_ns, .accel_m_s2 = accel64, .gyro_rad_secs = gyro64};
-
-		xrt_sink_push_imu(t->slam_sinks.imu, &sample);
+		/* Push IMU samples to the SLAM tracker */
+		for (int i = 0; i < count; i++) {
+			struct xrt_vec3_f64 accel64 = {accels[i].x, accels[i].y, accels[i].z};
+			struct xrt_vec3_f64 gyro64 = {gyros[i].x, gyros[i].y, gyros[i].z};
+			struct xrt_imu_sample sample = {
+			    .timestamp_ns = local_timestamps_ns[i], .accel_m_s2 = accel64, .gyro_rad_secs = gyro64};
+
+			xrt_sink_push_imu(t->slam_sinks.imu, &sample);
+		}
 	}
 }
 
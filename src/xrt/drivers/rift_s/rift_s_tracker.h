@@ -139,11 +139,18 @@ rift_s_tracker_get_hand_tracking_device(struct rift_s_tracker *t);
 void
 rift_s_tracker_clock_update(struct rift_s_tracker *t, uint64_t device_timestamp_ns, timepoint_ns local_timestamp_ns);
 
+//! Most IMU samples handed to @ref rift_s_tracker_imu_update at once, one HMD report worth.
+#define RIFT_S_TRACKER_MAX_IMU_SAMPLES 3
+
+/*!
+ * Update the fusion with the @p count IMU samples of a report, in order.
+ */
 void
 rift_s_tracker_imu_update(struct rift_s_tracker *t,
-                          uint64_t device_timestamp_ns,
-                          const struct xrt_vec3 *accel,
-                          const struct xrt_vec3 *gyro);
+                          const uint64_t *device_timestamps_ns,
+                          const struct xrt_vec3 *accels,
+                          const struct xrt_vec3 *gyros,
+                          int count);
 
 void
 rift_s_tracker_push_slam_frames(struct rift_s_tracker *t,
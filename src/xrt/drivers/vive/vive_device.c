@@ -406,6 +406,12 @@ update_imu(struct vive_device *d, const void *buffer)
 	int i;
 	int j;
 
+	// New samples of this report, handed to the fusion in one go.
+	uint64_t timestamps_ns[3];
+	struct xrt_vec3 accels[3];
+	struct xrt_vec3 gyros[3];
+	size_t count = 0;
+
 	/*
 	 * The three samples are updated round-robin. New messages
 	 * can contain already seen samples in any place, but the
@@ -509,22 +515,31 @@ update_imu(struct vive_device *d, const void *buffer)
 
 		d->imu.sequence = seq;
 
-		struct xrt_space_relation rel = {0};
-		rel.relation_flags =
-		    XRT_SPACE_RELATION_ORIENTATION_VALID_BIT | XRT_SPACE_RELATION_ORIENTATION_TRACKED_BIT;
-
-		os_mutex_lock(&d->fusion.mutex);
-		m_imu_3dof_update(&d->fusion.i3dof, d->imu.last_sample_ts_ns, &acceleration, &angular_velocity);
-		rel.pose.orientation = d->fusion.i3dof.rot;
-		os_mutex_unlock(&d->fusion.mutex);
-
-		m_relation_history_push(d->fusion.relation_hist, &rel, now_ns);
+		timestamps_ns[count] = d->imu.last_sample_ts_ns;
+		accels[count] = acceleration;
+		gyros[count] = angular_velocity;
+		count++;
 
 		assert(j > 0);
 		uint32_t age = j <= 0 ? 0 : (uint32_t)(j - 1);
 
 		vive_source_push_imu_packet(d->source, age, d->imu.last_sample_ts_ns, raw_accel, raw_gyro);
 	}
+
+	if (count == 0) {
+		return;
+	}
+
+	struct xrt_space_relation rel = {0};
+	rel.relation_flags = XRT_SPACE_RELATION_ORIENTATION_VALID_BIT | XRT_SPACE_RELATION_ORIENTATION_TRACKED_BIT;
+
+	os_mutex_lock(&d->fusion.mutex);
+	m_imu_3dof_update_batch(&d->fusion.i3dof, timestamps_ns, accels, gyros, count);
+	rel.pose.orientation = d->fusion.i3dof.rot;
+	os_mutex_unlock(&d->fusion.mutex);
+
+	// All samples share the same arrival time, so push the final state once.
+	m_relation_history_push(d->fusion.relation_hist, &rel, now_ns);
 }
 
 static void
@@ -453,23 +453,26 @@ hololens_handle_sensors_all(struct wmr_hmd *wh, const unsigned char *buffer, int
 		math_quat_rotate_vec3(&wh->config.sensors.transforms.P_oxr_acc.orientation, ca, ca);
 	}
 
-	// Fusion tracking
-	os_mutex_lock(&wh->fusion.mutex);
+	uint64_t timestamps_ns[IMU_SAMPLES_PER_PACKET];
 	for (int i = 0; i < IMU_SAMPLES_PER_PACKET; i++) {
-		m_imu_3dof_update(                                              //
-		    &wh->fusion.i3dof,                                          //
-		    wh->packet.gyro_timestamp[i] * WMR_MS_HOLOLENS_NS_PER_TICK, //
-		    &calib_accel[i],                                            //
-		    &calib_gyro[i]);                                            //
+		timestamps_ns[i] = wh->packet.gyro_timestamp[i] * WMR_MS_HOLOLENS_NS_PER_TICK;
 	}
+
+	// Fusion tracking
+	os_mutex_lock(&wh->fusion.mutex);
+	m_imu_3dof_update_batch( //
+	    &wh->fusion.i3dof,   //
+	    timestamps_ns,       //
+	    calib_accel,         //
+	    calib_gyro,          //
+	    IMU_SAMPLES_PER_PACKET);
 	wh->fusion.last_imu_timestamp_ns = now_ns;
 	wh->fusion.last_angular_velocity = calib_gyro[3];
 	os_mutex_unlock(&wh->fusion.mutex);
 
 	// SLAM tracking
 	for (int i = 0; i < IMU_SAMPLES_PER_PACKET; i++) {
-		timepoint_ns t = wh->packet.gyro_timestamp[i] * WMR_MS_HOLOLENS_NS_PER_TICK;
-		wmr_source_push_imu_packet(wh->tracking.source, t, raw_accel[i], raw_gyro[i]);
+		wmr_source_push_imu_packet(wh->tracking.source, timestamps_ns[i], raw_accel[i], raw_gyro[i]);
 	}
 }
 
@@ -120,6 +120,9 @@ struct t_hand_tracking_sync
 {
 	/*!
 	 * Process left and right view and get back a result synchronously.
+	 *
+	 * A pipelined tracker may return the hands of an earlier frame, the
+	 * timestamp says which frame, and is 0 if there is no result yet.
 	 */
 	void (*process)(struct t_hand_tracking_sync *ht_sync,
 	                struct xrt_frame *left_frame,
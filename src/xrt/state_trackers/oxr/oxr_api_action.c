@@ -13,7 +13,10 @@
 #include "oxr_logger.h"
 #include "oxr_handle.h"
 
+#include "os/os_time.h"
+
 #include "util/u_debug.h"
+#include "util/u_time.h"
 #include "util/u_trace_marker.h"
 
 #include "oxr_api_funcs.h"
@@ -181,6 +184,7 @@ oxr_xrAttachSessionActionSets(XrSession session, const XrSessionActionSetsAttach
 {
 	OXR_TRACE_MARKER();
 
+	int64_t start_ns = os_monotonic_get_ns();
 	struct oxr_session *sess;
 	struct oxr_logger log;
 	OXR_VERIFY_SESSION_AND_INIT_LOG(&log, session, sess, "xrAttachSessionActionSets");
@@ -204,7 +208,16 @@ oxr_xrAttachSessionActionSets(XrSession session, const XrSessionActionSetsAttach
 		OXR_VERIFY_ACTIONSET_NOT_NULL(&log, bindInfo->actionSets[i], act_set);
 	}
 
-	return oxr_session_attach_action_sets(&log, sess, bindInfo);
+	XrResult ret = oxr_session_attach_action_sets(&log, sess, bindInfo);
+	if (XR_FAILED(ret)) {
+		return ret;
+	}
+
+	struct oxr_instance *inst = sess->sys->inst;
+	inst->startup_timing.session_attach_ms = time_ns_to_ms_f(os_monotonic_get_ns() - start_ns);
+	oxr_instance_log_startup_timing(&log, inst);
+
+	return ret;
 }
 
 XRAPI_ATTR XrResult XRAPI_CALL
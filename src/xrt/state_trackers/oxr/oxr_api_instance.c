@@ -9,7 +9,10 @@
 
 #include "xrt/xrt_compiler.h"
 
+#include "os/os_time.h"
+
 #include "util/u_debug.h"
+#include "util/u_time.h"
 #include "util/u_trace_marker.h"
 
 #include "oxr_objects.h"
@@ -134,6 +137,7 @@ oxr_xrCreateInstance(const XrInstanceCreateInfo *createInfo, XrInstance *out_ins
 {
 	OXR_TRACE_MARKER();
 
+	int64_t start_ns = os_monotonic_get_ns();
 	XrResult ret;
 	struct oxr_logger log;
 	oxr_log_init(&log, "xrCreateInstance");
@@ -205,6 +209,8 @@ oxr_xrCreateInstance(const XrInstanceCreateInfo *createInfo, XrInstance *out_ins
 		return ret;
 	}
 
+	inst->startup_timing.instance_create_ms = time_ns_to_ms_f(os_monotonic_get_ns() - start_ns);
+
 	*out_instance = oxr_instance_to_openxr(inst);
 
 	return XR_SUCCESS;
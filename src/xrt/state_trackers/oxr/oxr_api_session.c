@@ -15,7 +15,10 @@
 #include "math/m_space.h"
 #include "xrt/xrt_compiler.h"
 
+#include "os/os_time.h"
+
 #include "util/u_debug.h"
+#include "util/u_time.h"
 #include "util/u_trace_marker.h"
 
 #include "oxr_frame_sync.h"
@@ -34,6 +37,7 @@ oxr_xrCreateSession(XrInstance instance, const XrSessionCreateInfo *createInfo,
 {
 	OXR_TRACE_MARKER();
 
+	int64_t start_ns = os_monotonic_get_ns();
 	XrResult ret;
 	struct oxr_instance *inst;
 	struct oxr_session *sess;
@@ -60,6 +64,8 @@ oxr_xrCreateSession(XrInstance instance, const XrSessionCreateInfo *createInfo,
 	}
 	*link = sess;
 
+	inst->startup_timing.session_create_ms = time_ns_to_ms_f(os_monotonic_get_ns() - start_ns);
+
 	return XR_SUCCESS;
 }
 
@@ -839,7 +845,7 @@ oxr_xrBeginPlaneDetectionEXT(XrPlaneDetectorEXT planeDetector, const XrPlaneDete
 	struct xrt_relation_chain xrc = {0};
 	m_relation_chain_push_pose_if_not_identity(&xrc, &T_base_bb); // T_base_bb
 	m_relation_chain_push_inverted_relation(&xrc, &T_base_xdev);  // T_xdev_base
-	m_relation_chain_resolve(&xrc, &T_xdev_bb);
+	m_relation_chain_resolve_pose(&xrc, &T_xdev_bb);
 
 	if (T_xdev_bb.relation_flags == 0) {
 		return XR_ERROR_SPACE_NOT_LOCATABLE_EXT;
@@ -1001,7 +1007,7 @@ oxr_xrGetPlaneDetectionsEXT(XrPlaneDetectorEXT planeDetector,
 		struct xrt_relation_chain xrc = {0};
 		m_relation_chain_push_relation(&xrc, &T_xdev_plane);
 		m_relation_chain_push_relation(&xrc, &T_base_xdev);
-		m_relation_chain_resolve(&xrc, &T_base_plane);
+		m_relation_chain_resolve_pose(&xrc, &T_base_plane);
 
 		OXR_XRT_POSE_TO_XRPOSEF(T_base_plane.pose, pd->xr_locations[i].pose);
 
@@ -16,7 +16,10 @@
 #include "xrt/xrt_gfx_gl.h"
 #include "xrt/xrt_gfx_gles.h"
 
+#include "os/os_time.h"
+
 #include "util/u_debug.h"
+#include "util/u_time.h"
 #include "util/u_trace_marker.h"
 
 #include "oxr_objects.h"
@@ -53,6 +56,7 @@ oxr_xrGetSystem(XrInstance instance, const XrSystemGetInfo *getInfo, XrSystemId
 {
 	OXR_TRACE_MARKER();
 
+	int64_t start_ns = os_monotonic_get_ns();
 	struct oxr_instance *inst;
 	struct oxr_logger log;
 	OXR_VERIFY_INSTANCE_AND_INIT_LOG(&log, instance, inst, "xrGetSystem");
@@ -70,6 +74,8 @@ oxr_xrGetSystem(XrInstance instance, const XrSystemGetInfo *getInfo, XrSystemId
 
 	*systemId = selected->systemId;
 
+	inst->startup_timing.system_get_ms = time_ns_to_ms_f(os_monotonic_get_ns() - start_ns);
+
 	return XR_SUCCESS;
 }
 
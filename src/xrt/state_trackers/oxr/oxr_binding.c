@@ -116,11 +116,8 @@ interaction_profile_find_or_create_in_instance(struct oxr_logger *log,
 	struct profile_template *templ = NULL;
 
 	for (size_t x = 0; x < OXR_BINDINGS_PROFILE_TEMPLATE_COUNT; x++) {
-		XrPath t_path = XR_NULL_PATH;
-
-		oxr_path_get_or_create(log, inst, profile_templates[x].path, strlen(profile_templates[x].path),
-		                       &t_path);
-		if (t_path == path) {
+		// Cached at instance creation, no need to look up the string again.
+		if (profile_templates[x].path_cache == path) {
 			templ = &profile_templates[x];
 			break;
 		}
@@ -131,6 +128,10 @@ interaction_profile_find_or_create_in_instance(struct oxr_logger *log,
 		return false;
 	}
 
+	/*
+	 * Profiles are only materialized when the application suggests bindings
+	 * for them, most applications only touch a few of the templates.
+	 */
 	struct oxr_interaction_profile *p = U_TYPED_CALLOC(struct oxr_interaction_profile);
 
 	p->xname = templ->name;
@@ -185,13 +186,41 @@ interaction_profile_find_or_create_in_instance(struct oxr_logger *log,
 
 	// Add to the list of currently created interaction profiles.
 	U_ARRAY_REALLOC_OR_FREE(inst->profiles, struct oxr_interaction_profile *, (inst->profile_count + 1));
-	inst->profiles[inst->profile_count++] = p;
+	inst->profiles[inst->profile_count] = NULL;
+	oxr_interaction_profile_reference(&inst->profiles[inst->profile_count++], p);
 
 	*out_p = p;
 
 	return true;
 }
 
+/*!
+ * Makes sure the instance holds the only reference to the profile, copying it
+ * if it is shared with any session, so it can be modified.
+ */
+static struct oxr_interaction_profile *
+interaction_profile_make_unique_in_instance(struct oxr_logger *log,
+                                            struct oxr_instance *inst,
+                                            struct oxr_interaction_profile *p)
+{
+	if (p->reference.count <= 1) {
+		return p;
+	}
+
+	for (size_t x = 0; x < inst->profile_count; x++) {
+		if (inst->profiles[x] != p) {
+			continue;
+		}
+
+		// The sessions keeps the old profile alive.
+		oxr_interaction_profile_reference(&inst->profiles[x], oxr_clone_profile(p));
+		return inst->profiles[x];
+	}
+
+	assert(false && "Profile not in instance");
+	return p;
+}
+
 static void
 reset_binding_keys(struct oxr_binding *binding)
 {
@@ -447,6 +476,7 @@ oxr_clone_profile(const struct oxr_interaction_profile *src_profile)
 	struct oxr_interaction_profile *dst_profile = U_TYPED_CALLOC(struct oxr_interaction_profile);
 
 	*dst_profile = *src_profile;
+	dst_profile->reference.count = 0;
 
 	dst_profile->binding_count = 0;
 	dst_profile->bindings = NULL;
@@ -520,39 +550,65 @@ oxr_clone_profile(const struct oxr_interaction_profile *src_profile)
 }
 
 static void
-oxr_destroy_profiles(struct oxr_interaction_profile **profiles, const size_t profile_count)
+oxr_destroy_profile(struct oxr_interaction_profile *p)
 {
-	if (profiles == NULL)
-		return;
+	for (size_t y = 0; y < p->binding_count; y++) {
+		struct oxr_binding *b = &p->bindings[y];
 
-	for (size_t x = 0; x < profile_count; x++) {
-		struct oxr_interaction_profile *p = profiles[x];
+		reset_binding_keys(b);
+		free(b->paths);
+		b->paths = NULL;
+		b->path_count = 0;
+		b->input = 0;
+		b->output = 0;
+	}
+
+	for (size_t y = 0; y < p->dpad_count; ++y) {
+		struct oxr_dpad_emulation *d = &p->dpads[y];
+		free(d->paths);
+	}
 
-		for (size_t y = 0; y < p->binding_count; y++) {
-			struct oxr_binding *b = &p->bindings[y];
+	free(p->bindings);
+	p->bindings = NULL;
+	p->binding_count = 0;
 
-			reset_binding_keys(b);
-			free(b->paths);
-			b->paths = NULL;
-			b->path_count = 0;
-			b->input = 0;
-			b->output = 0;
-		}
+	free(p->dpads);
 
-		for (size_t y = 0; y < p->dpad_count; ++y) {
-			struct oxr_dpad_emulation *d = &p->dpads[y];
-			free(d->paths);
-		}
+	oxr_dpad_state_deinit(&p->dpad_state);
+
+	free(p);
+}
+
+void
+oxr_interaction_profile_reference(struct oxr_interaction_profile **dst, struct oxr_interaction_profile *src)
+{
+	struct oxr_interaction_profile *old_dst = *dst;
+
+	if (old_dst == src) {
+		return;
+	}
 
-		free(p->bindings);
-		p->bindings = NULL;
-		p->binding_count = 0;
+	if (src) {
+		xrt_reference_inc(&src->reference);
+	}
+
+	*dst = src;
 
-		free(p->dpads);
+	if (old_dst) {
+		if (xrt_reference_dec_and_is_zero(&old_dst->reference)) {
+			oxr_destroy_profile(old_dst);
+		}
+	}
+}
 
-		oxr_dpad_state_deinit(&p->dpad_state);
+static void
+oxr_destroy_profiles(struct oxr_interaction_profile **profiles, const size_t profile_count)
+{
+	if (profiles == NULL)
+		return;
 
-		free(p);
+	for (size_t x = 0; x < profile_count; x++) {
+		oxr_interaction_profile_reference(&profiles[x], NULL);
 	}
 
 	free(profiles);
@@ -597,6 +653,9 @@ oxr_action_suggest_interaction_profile_bindings(struct oxr_logger *log,
 		goto out;
 	}
 
+	// Sessions that have already attached keep seeing the old bindings.
+	p = interaction_profile_make_unique_in_instance(log, inst, p);
+
 	struct oxr_binding *bindings = p->bindings;
 	size_t binding_count = p->binding_count;
 
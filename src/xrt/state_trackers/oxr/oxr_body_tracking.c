@@ -13,6 +13,7 @@
 
 #include "math/m_api.h"
 #include "math/m_mathinclude.h"
+#include "math/m_pose_batch.h"
 #include "math/m_space.h"
 
 #include "oxr_objects.h"
@@ -164,18 +165,23 @@ oxr_locate_body_joints_fb(struct oxr_logger *log,
 	locations->confidence = body_joint_set_fb->confidence;
 	locations->skeletonChangedCount = body_joint_set_fb->skeleton_changed_count;
 
-	for (size_t joint_index = 0; joint_index < XRT_BODY_JOINT_COUNT_FB; ++joint_index) {
+	// Move all of the joints into the base space in one go.
+	struct m_pose_batch joints;
+	joints.count = XRT_BODY_JOINT_COUNT_FB;
+	for (uint32_t joint_index = 0; joint_index < XRT_BODY_JOINT_COUNT_FB; ++joint_index) {
+		m_pose_batch_set_relation(&joints, joint_index, &src_body_joints[joint_index].relation);
+	}
+	m_pose_batch_transform(&T_base_body.pose, &joints, &joints);
+
+	for (uint32_t joint_index = 0; joint_index < XRT_BODY_JOINT_COUNT_FB; ++joint_index) {
 		const struct xrt_body_joint_location_fb *src_joint = &src_body_joints[joint_index];
 		XrBodyJointLocationFB *dst_joint = &locations->jointLocations[joint_index];
 
 		dst_joint->locationFlags = xrt_to_xr_space_location_flags(src_joint->relation.relation_flags);
 
-		struct xrt_space_relation result;
-		struct xrt_relation_chain chain = {0};
-		m_relation_chain_push_relation(&chain, &src_joint->relation);
-		m_relation_chain_push_relation(&chain, &T_base_body);
-		m_relation_chain_resolve(&chain, &result);
-		OXR_XRT_POSE_TO_XRPOSEF(result.pose, dst_joint->pose);
+		struct xrt_pose pose;
+		m_pose_batch_get(&joints, joint_index, &pose);
+		OXR_XRT_POSE_TO_XRPOSEF(pose, dst_joint->pose);
 	}
 	return XR_SUCCESS;
 }
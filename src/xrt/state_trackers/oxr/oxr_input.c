@@ -1725,8 +1725,10 @@ oxr_clone_profiles_to_session(struct oxr_logger *log, struct oxr_instance *inst,
 	sess->profiles_on_attachment_size = inst->profile_count;
 	sess->profiles_on_attachment = U_TYPED_ARRAY_CALLOC(struct oxr_interaction_profile *, inst->profile_count);
 
+	// Shared copy-on-write, the instance copies a profile before changing it.
 	for (size_t profile_idx = 0; profile_idx < inst->profile_count; ++profile_idx) {
-		sess->profiles_on_attachment[profile_idx] = oxr_clone_profile(inst->profiles[profile_idx]);
+		oxr_interaction_profile_reference(&sess->profiles_on_attachment[profile_idx],
+		                                  inst->profiles[profile_idx]);
 	}
 }
 
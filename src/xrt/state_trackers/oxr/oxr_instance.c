@@ -49,6 +49,7 @@ DEBUG_GET_ONCE_BOOL_OPTION(debug_views, "OXR_DEBUG_VIEWS", false)
 DEBUG_GET_ONCE_BOOL_OPTION(debug_spaces, "OXR_DEBUG_SPACES", false)
 DEBUG_GET_ONCE_BOOL_OPTION(debug_bindings, "OXR_DEBUG_BINDINGS", false)
 DEBUG_GET_ONCE_BOOL_OPTION(lifecycle_verbose, "OXR_LIFECYCLE_VERBOSE", false)
+DEBUG_GET_ONCE_BOOL_OPTION(debug_startup_timing, "OXR_DEBUG_STARTUP_TIMING", false)
 DEBUG_GET_ONCE_TRISTATE_OPTION(parallel_views, "OXR_PARALLEL_VIEWS")
 
 
@@ -236,6 +237,7 @@ oxr_instance_create(struct oxr_logger *log,
 	inst->debug_spaces = debug_get_bool_option_debug_spaces();
 	inst->debug_views = debug_get_bool_option_debug_views();
 	inst->debug_bindings = debug_get_bool_option_debug_bindings();
+	inst->debug_startup_timing = debug_get_bool_option_debug_startup_timing();
 
 	m_ret = os_mutex_init(&inst->event.mutex);
 	if (m_ret < 0) {
@@ -406,6 +408,11 @@ oxr_instance_create(struct oxr_logger *log,
 	apply_quirks(log, inst);
 
 	u_var_add_root((void *)inst, "XrInstance", true);
+	u_var_add_gui_header(inst, NULL, "Startup timing");
+	u_var_add_ro_f32(inst, &inst->startup_timing.instance_create_ms, "xrCreateInstance (ms)");
+	u_var_add_ro_f32(inst, &inst->startup_timing.system_get_ms, "xrGetSystem (ms)");
+	u_var_add_ro_f32(inst, &inst->startup_timing.session_create_ms, "xrCreateSession (ms)");
+	u_var_add_ro_f32(inst, &inst->startup_timing.session_attach_ms, "xrAttachSessionActionSets (ms)");
 
 #ifdef XRT_FEATURE_CLIENT_DEBUG_GUI
 	u_debug_gui_start(inst->debug_ui, inst->xinst, sys->xsysd);
@@ -489,6 +496,25 @@ oxr_instance_create(struct oxr_logger *log,
 }
 
 
+void
+oxr_instance_log_startup_timing(struct oxr_logger *log, struct oxr_instance *inst)
+{
+	if (!inst->debug_startup_timing) {
+		return;
+	}
+
+	oxr_log(log,
+	        "Startup timing\n"
+	        "\txrCreateInstance: %.3fms\n"
+	        "\txrGetSystem: %.3fms\n"
+	        "\txrCreateSession: %.3fms\n"
+	        "\txrAttachSessionActionSets: %.3fms",
+	        inst->startup_timing.instance_create_ms, //
+	        inst->startup_timing.system_get_ms,      //
+	        inst->startup_timing.session_create_ms,  //
+	        inst->startup_timing.session_attach_ms); //
+}
+
 XrResult
 oxr_instance_get_properties(struct oxr_logger *log, struct oxr_instance *inst, XrInstanceProperties *instanceProperties)
 {
@@ -28,6 +28,7 @@
 #include "util/u_hashset.h"
 #include "util/u_hashmap.h"
 #include "util/u_device.h"
+#include "util/u_pose_cache.h"
 
 #include "oxr_extension_support.h"
 #include "oxr_subaction.h"
@@ -236,6 +237,15 @@ oxr_instance_create(struct oxr_logger *log,
                     const struct oxr_extension_status *extensions,
                     struct oxr_instance **out_inst);
 
+/*!
+ * Log the time taken by the startup API calls, only if enabled with the
+ * OXR_DEBUG_STARTUP_TIMING environment variable.
+ *
+ * @public @memberof oxr_instance
+ */
+void
+oxr_instance_log_startup_timing(struct oxr_logger *log, struct oxr_instance *inst);
+
 /*!
  * @public @memberof oxr_instance
  */
@@ -632,9 +642,25 @@ oxr_get_profile_for_device_name(struct oxr_logger *log,
                                 enum xrt_device_name name,
                                 struct oxr_interaction_profile **out_p);
 
+/*!
+ * Deep copy a interaction profile, the returned profile has no references,
+ * use @ref oxr_interaction_profile_reference to take one.
+ */
 struct oxr_interaction_profile *
 oxr_clone_profile(const struct oxr_interaction_profile *src_profile);
 
+/*!
+ * Update the reference counts on interaction profile(s).
+ *
+ * @param[in,out] dst Pointer to a object reference: if the object reference is
+ *                    non-null will decrement its counter. The reference that
+ *                    @p dst points to will be set to @p src.
+ * @param[in] src New object for @p dst to refer to (may be null).
+ *                If non-null, will have its refcount increased.
+ */
+void
+oxr_interaction_profile_reference(struct oxr_interaction_profile **dst, struct oxr_interaction_profile *src);
+
 /*!
  * Free all memory allocated by the binding system.
  *
@@ -1667,14 +1693,24 @@ struct oxr_instance
 		struct u_hashset *loc_store;
 	} action_sets;
 
-	//! Path store, for looking up paths.
-	struct u_hashset *path_store;
-	//! Mapping from ID to path.
-	struct oxr_path **path_array;
+	/*!
+	 * Path store, paths from the bindings are pre-interned at init and
+	 * found through a compile-time perfect hash, all other paths are
+	 * interned into a string arena and found through @ref path_index.
+	 */
+	struct oxr_path *path_array;
 	//! Total length of path array.
 	size_t path_array_length;
 	//! Number of paths in the array (0 is always null).
 	size_t path_num;
+	//! Open addressing index of dynamic path IDs, zero marks an empty slot.
+	uint32_t *path_index;
+	//! Length of the index, always a power of two.
+	size_t path_index_length;
+	//! Number of dynamic paths in the index, static paths are not in it.
+	size_t path_index_count;
+	//! String arena for dynamic paths, never moved once allocated.
+	struct oxr_path_arena *path_arena;
 
 	// Event queue.
 	struct
@@ -1733,10 +1769,23 @@ struct oxr_instance
 	//! Debug messengers
 	struct oxr_debug_messenger *messengers[XRT_MAX_HANDLE_CHILDREN];
 
+	/*!
+	 * Time taken by the startup API calls, in milliseconds, measured on the
+	 * last call of each and exposed through the u_var tracking.
+	 */
+	struct
+	{
+		float instance_create_ms;
+		float system_get_ms;
+		float session_create_ms;
+		float session_attach_ms;
+	} startup_timing;
+
 	bool lifecycle_verbose;
 	bool debug_views;
 	bool debug_spaces;
 	bool debug_bindings;
+	bool debug_startup_timing;
 
 #ifdef XRT_FEATURE_RENDERDOC
 	RENDERDOC_API_1_4_1 *rdoc_api;
@@ -1806,6 +1855,12 @@ struct oxr_session
 	 */
 	struct os_precise_sleeper sleeper;
 
+	/*!
+	 * View poses of the head device, applications often call
+	 * xrLocateViews several times per frame with the same display time.
+	 */
+	struct u_pose_cache view_pose_cache;
+
 	/*!
 	 * An array of action set attachments that this session owns.
 	 *
@@ -1991,6 +2046,13 @@ struct oxr_dpad_emulation
  */
 struct oxr_interaction_profile
 {
+	/*!
+	 * Profiles are shared copy-on-write between the instance and the
+	 * sessions that have attached action sets, so only the holder of the
+	 * last reference frees it and a shared profile is never modified.
+	 */
+	struct xrt_reference reference;
+
 	XrPath path;
 
 	//! Used to lookup @ref xrt_binding_profile for fallback.
@@ -11,26 +11,54 @@
 #include <string.h>
 #include <stdlib.h>
 
-#include "math/m_api.h"
 #include "util/u_misc.h"
+#include "bindings/b_generated_bindings.h"
 
 #include "oxr_objects.h"
 #include "oxr_logger.h"
 
 
 /*!
- * Internal representation of a path, item follows this struct in memory and
- * that in turn is followed by the string.
+ * Size of a single string arena block, paths are limited to
+ * XR_MAX_PATH_LENGTH so a block always holds many paths.
+ */
+#define OXR_PATH_ARENA_BLOCK_SIZE (16 * 1024)
+
+/*!
+ * Initial number of slots in the dynamic path index, must be a power of two.
+ */
+#define OXR_PATH_INDEX_INITIAL_LENGTH 256
+
+
+/*!
+ * Internal representation of a path, lives in the instance path array and is
+ * indexed by the XrPath. The string is either a static string from the
+ * generated bindings or lives in the path string arena.
  *
  * @ingroup oxr_main
  */
 struct oxr_path
 {
 	uint64_t debug;
-	XrPath id;
+	const char *str;
+	uint32_t length;
+	uint32_t hash;
 	void *attached;
 };
 
+/*!
+ * A block of the path string arena, strings are never moved once allocated so
+ * pointers returned by @ref oxr_path_get_string stay valid.
+ *
+ * @ingroup oxr_main
+ */
+struct oxr_path_arena
+{
+	struct oxr_path_arena *next;
+	size_t used;
+	char data[OXR_PATH_ARENA_BLOCK_SIZE];
+};
+
 
 /*
  *
@@ -39,29 +67,105 @@ struct oxr_path
  */
 
 static inline XrPath
-to_xr_path(struct oxr_path *path)
+static_index_to_xr_path(uint32_t index)
 {
-	return path->id;
+	// Static paths are interned right after XR_NULL_PATH.
+	return (XrPath)index + 1;
 }
 
-static inline struct u_hashset_item *
-get_item(struct oxr_path *path)
+
+/*
+ *
+ * Static functions.
+ *
+ */
+
+static const char *
+arena_store(struct oxr_instance *inst, const char *str, size_t length)
 {
-	return (struct u_hashset_item *)&path[1];
+	struct oxr_path_arena *arena = inst->path_arena;
+	size_t needed = length + 1; // Null terminate it.
+
+	if (arena == NULL || arena->used + needed > sizeof(arena->data)) {
+		arena = U_TYPED_CALLOC(struct oxr_path_arena);
+		if (arena == NULL) {
+			return NULL;
+		}
+
+		arena->next = inst->path_arena;
+		inst->path_arena = arena;
+	}
+
+	char *store = &arena->data[arena->used];
+	memcpy(store, str, length);
+	store[length] = '\0';
+	arena->used += needed;
+
+	return store;
 }
 
-static inline struct oxr_path *
-from_item(struct u_hashset_item *item)
+static void
+index_insert(uint32_t *index, size_t index_length, uint32_t hash, uint32_t id)
 {
-	return &((struct oxr_path *)item)[-1];
+	size_t mask = index_length - 1;
+	size_t slot = hash & mask;
+
+	while (index[slot] != 0) {
+		slot = (slot + 1) & mask;
+	}
+
+	index[slot] = id;
 }
 
+static XrResult
+index_grow(struct oxr_logger *log, struct oxr_instance *inst)
+{
+	size_t new_length = inst->path_index_length * 2;
 
-/*
- *
- * Static functions.
- *
- */
+	uint32_t *new_index = U_TYPED_ARRAY_CALLOC(uint32_t, new_length);
+	if (new_index == NULL) {
+		return oxr_error(log, XR_ERROR_RUNTIME_FAILURE, "Failed to grow path index");
+	}
+
+	// Only rehash the slots, the hash is stored on the path.
+	for (size_t i = 0; i < inst->path_index_length; i++) {
+		uint32_t id = inst->path_index[i];
+		if (id != 0) {
+			index_insert(new_index, new_length, inst->path_array[id].hash, id);
+		}
+	}
+
+	free(inst->path_index);
+	inst->path_index = new_index;
+	inst->path_index_length = new_length;
+
+	return XR_SUCCESS;
+}
+
+static bool
+find_path(const struct oxr_instance *inst, const char *str, size_t length, uint32_t hash, XrPath *out_id)
+{
+	uint32_t static_index;
+	if (oxr_bindings_static_path_find(str, length, hash, &static_index)) {
+		*out_id = static_index_to_xr_path(static_index);
+		return true;
+	}
+
+	size_t mask = inst->path_index_length - 1;
+	size_t slot = hash & mask;
+
+	// The index is never full, so this always terminates.
+	for (uint32_t id = inst->path_index[slot]; id != 0; id = inst->path_index[slot]) {
+		const struct oxr_path *path = &inst->path_array[id];
+		if (path->hash == hash && path->length == length && memcmp(path->str, str, length) == 0) {
+			*out_id = id;
+			return true;
+		}
+		slot = (slot + 1) & mask;
+	}
+
+	return false;
+}
 
 static XrResult
 oxr_ensure_array_length(struct oxr_logger *log, struct oxr_instance *inst, XrPath *out_id)
@@ -73,12 +177,18 @@ oxr_ensure_array_length(struct oxr_logger *log, struct oxr_instance *inst, XrPat
 		return XR_SUCCESS;
 	}
 
+	// Grow geometrically, IDs index into the array so it may move.
 	size_t new_size = inst->path_array_length;
-	while (new_size < num) {
-		new_size += 64;
+	while (new_size <= num) {
+		new_size *= 2;
 	}
 
-	U_ARRAY_REALLOC_OR_FREE(inst->path_array, struct oxr_path *, new_size);
+	U_ARRAY_REALLOC_OR_FREE(inst->path_array, struct oxr_path, new_size);
+	if (inst->path_array == NULL) {
+		inst->path_array_length = 0;
+		inst->path_num = 0;
+		return oxr_error(log, XR_ERROR_RUNTIME_FAILURE, "Failed to grow path array");
+	}
 	inst->path_array_length = new_size;
 
 	*out_id = inst->path_num++;
@@ -87,61 +197,62 @@ oxr_ensure_array_length(struct oxr_logger *log, struct oxr_instance *inst, XrPat
 }
 
 static XrResult
-oxr_allocate_path(
-    struct oxr_logger *log, struct oxr_instance *inst, const char *str, size_t length, struct oxr_path **out_path)
+oxr_allocate_path(struct oxr_logger *log,
+                  struct oxr_instance *inst,
+                  const char *str,
+                  size_t length,
+                  uint32_t hash,
+                  XrPath *out_id)
 {
-	struct u_hashset_item *item = NULL;
-	struct oxr_path *path = NULL;
-	size_t size = 0;
-	int ret;
-
-	size += sizeof(struct oxr_path);       // Main path object.
-	size += sizeof(struct u_hashset_item); // Embedded hashset item.
-	size += length;                        // String.
-	size += 1;                             // Null terminate it.
-
-	// Now allocate and setup the path.
-	path = U_CALLOC_WITH_CAST(struct oxr_path, size);
-	if (path == NULL) {
-		return oxr_error(log, XR_ERROR_RUNTIME_FAILURE, "Failed to allocate path");
-	}
-	path->debug = OXR_XR_DEBUG_PATH;
+	XrResult ret;
 
-	// Setup the item.
-	item = get_item(path);
-	item->hash = math_hash_string(str, length);
-	item->length = length;
+	// Keep the load factor of the index at or below one half.
+	if ((inst->path_index_count + 1) * 2 > inst->path_index_length) {
+		ret = index_grow(log, inst);
+		if (ret != XR_SUCCESS) {
+			return ret;
+		}
+	}
 
-	// Yes a const cast! D:
-	char *store = (char *)item->c_str;
-	for (size_t i = 0; i < length; i++) {
-		store[i] = str[i];
+	const char *store = arena_store(inst, str, length);
+	if (store == NULL) {
+		return oxr_error(log, XR_ERROR_RUNTIME_FAILURE, "Failed to allocate path");
 	}
-	store[length] = '\0';
 
-	// Insert and return.
-	ret = u_hashset_insert_item(inst->path_store, item);
-	if (ret) {
-		free(path);
-		return oxr_error(log, XR_ERROR_RUNTIME_FAILURE, "Failed to insert item");
+	XrPath id = XR_NULL_PATH;
+	ret = oxr_ensure_array_length(log, inst, &id);
+	if (ret != XR_SUCCESS) {
+		return ret;
 	}
 
-	oxr_ensure_array_length(log, inst, &path->id);
-	inst->path_array[path->id] = path;
+	struct oxr_path *path = &inst->path_array[id];
+	U_ZERO(path);
+	path->debug = OXR_XR_DEBUG_PATH;
+	path->str = store;
+	path->length = (uint32_t)length;
+	path->hash = hash;
+
+	index_insert(inst->path_index, inst->path_index_length, hash, (uint32_t)id);
+	inst->path_index_count++;
 
-	*out_path = path;
+	*out_id = id;
 
 	return XR_SUCCESS;
 }
 
+/*!
+ * The returned pointer points into the path array, which is reallocated when
+ * a path is allocated, so it must not be held across a call that may create
+ * a path.
+ */
 struct oxr_path *
 get_path_or_null(struct oxr_logger *log, const struct oxr_instance *inst, XrPath xr_path)
 {
-	if (xr_path >= inst->path_array_length) {
+	if (xr_path == XR_NULL_PATH || xr_path >= inst->path_num) {
 		return NULL;
 	}
 
-	return inst->path_array[xr_path];
+	return &inst->path_array[xr_path];
 }
 
 
@@ -172,39 +283,23 @@ XrResult
 oxr_path_get_or_create(
     struct oxr_logger *log, struct oxr_instance *inst, const char *str, size_t length, XrPath *out_path)
 {
-	struct u_hashset_item *item;
-	struct oxr_path *path = NULL;
-	XrResult ret;
-	int h_ret;
+	// Hash once, used by both the static and dynamic lookup.
+	uint32_t hash = oxr_bindings_path_hash(str, length);
 
-	// Look it up the instance path store.
-	h_ret = u_hashset_find_str(inst->path_store, str, length, &item);
-	if (h_ret == 0) {
-		*out_path = to_xr_path(from_item(item));
+	if (find_path(inst, str, length, hash, out_path)) {
 		return XR_SUCCESS;
 	}
 
 	// Create the path since it was not found.
-	ret = oxr_allocate_path(log, inst, str, length, &path);
-	if (ret != XR_SUCCESS) {
-		return ret;
-	}
-
-	*out_path = to_xr_path(path);
-
-	return XR_SUCCESS;
+	return oxr_allocate_path(log, inst, str, length, hash, out_path);
 }
 
 XrResult
 oxr_path_only_get(struct oxr_logger *log, struct oxr_instance *inst, const char *str, size_t length, XrPath *out_path)
 {
-	struct u_hashset_item *item;
-	int h_ret;
+	uint32_t hash = oxr_bindings_path_hash(str, length);
 
-	// Look it up the instance path store.
-	h_ret = u_hashset_find_str(inst->path_store, str, length, &item);
-	if (h_ret == 0) {
-		*out_path = to_xr_path(from_item(item));
+	if (find_path(inst, str, length, hash, out_path)) {
 		return XR_SUCCESS;
 	}
 
@@ -221,32 +316,41 @@ oxr_path_get_string(
 		return XR_ERROR_PATH_INVALID;
 	}
 
-	*out_str = get_item(path)->c_str;
-	*out_length = get_item(path)->length;
+	*out_str = path->str;
+	*out_length = path->length;
 
 	return XR_SUCCESS;
 }
 
-void
-destroy_callback(struct u_hashset_item *item, void *priv)
-{
-	struct oxr_path *path = from_item(item);
-
-	free(path);
-}
-
 XrResult
 oxr_path_init(struct oxr_logger *log, struct oxr_instance *inst)
 {
-	int h_ret = u_hashset_create(&inst->path_store);
-	if (h_ret != 0) {
-		return oxr_error(log, XR_ERROR_RUNTIME_FAILURE, "Failed to create hashset");
+	// Reserve space for XR_NULL_PATH, the static paths and some dynamic ones.
+	size_t new_size = 1 + OXR_BINDINGS_STATIC_PATH_COUNT + 64;
+	inst->path_array = U_TYPED_ARRAY_CALLOC(struct oxr_path, new_size);
+	inst->path_index = U_TYPED_ARRAY_CALLOC(uint32_t, OXR_PATH_INDEX_INITIAL_LENGTH);
+	if (inst->path_array == NULL || inst->path_index == NULL) {
+		return oxr_error(log, XR_ERROR_RUNTIME_FAILURE, "Failed to allocate path store");
 	}
-
-	size_t new_size = 64;
-	U_ARRAY_REALLOC_OR_FREE(inst->path_array, struct oxr_path *, new_size);
 	inst->path_array_length = new_size;
-	inst->path_num = 1; // Reserve space for XR_NULL_PATH
+	inst->path_index_length = OXR_PATH_INDEX_INITIAL_LENGTH;
+
+	/*
+	 * Intern all of the static paths, they point straight at the generated
+	 * strings and are found through the perfect hash so they never need to
+	 * be hashed, copied or inserted into the dynamic index.
+	 */
+	for (uint32_t i = 0; i < OXR_BINDINGS_STATIC_PATH_COUNT; i++) {
+		const struct oxr_bindings_static_path *sp = &oxr_bindings_static_paths[i];
+		struct oxr_path *path = &inst->path_array[static_index_to_xr_path(i)];
+
+		path->debug = OXR_XR_DEBUG_PATH;
+		path->str = sp->str;
+		path->length = sp->length;
+		path->hash = sp->hash;
+	}
+
+	inst->path_num = 1 + OXR_BINDINGS_STATIC_PATH_COUNT;
 
 	return XR_SUCCESS;
 }
@@ -254,18 +358,19 @@ oxr_path_init(struct oxr_logger *log, struct oxr_instance *inst)
 void
 oxr_path_destroy(struct oxr_logger *log, struct oxr_instance *inst)
 {
-	if (inst->path_array != NULL) {
-		free(inst->path_array);
-	}
-
+	free(inst->path_array);
 	inst->path_array = NULL;
 	inst->path_num = 0;
 	inst->path_array_length = 0;
 
-	if (inst->path_store == NULL) {
-		return;
-	}
+	free(inst->path_index);
+	inst->path_index = NULL;
+	inst->path_index_length = 0;
+	inst->path_index_count = 0;
 
-	u_hashset_clear_and_call_for_each(inst->path_store, destroy_callback, inst);
-	u_hashset_destroy(&inst->path_store);
+	while (inst->path_arena != NULL) {
+		struct oxr_path_arena *next = inst->path_arena->next;
+		free(inst->path_arena);
+		inst->path_arena = next;
+	}
 }
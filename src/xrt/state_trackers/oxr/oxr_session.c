@@ -30,11 +30,13 @@
 #include "util/u_debug.h"
 #include "util/u_misc.h"
 #include "util/u_time.h"
+#include "util/u_var.h"
 #include "util/u_visibility_mask.h"
 #include "util/u_verify.h"
 
 #include "math/m_api.h"
 #include "math/m_mathinclude.h"
+#include "math/m_pose_batch.h"
 #include "math/m_space.h"
 
 #include "oxr_objects.h"
@@ -595,14 +597,15 @@ oxr_session_locate_views(struct oxr_logger *log,
 	struct xrt_fov fovs[XRT_MAX_VIEWS] = {0};
 	struct xrt_pose poses[XRT_MAX_VIEWS] = {0};
 
-	xrt_device_get_view_poses( //
-	    xdev,                  //
-	    &default_eye_relation, //
-	    xdisplay_time,         //
-	    view_count,            //
-	    &T_xdev_head,          //
-	    fovs,                  //
-	    poses);
+	u_pose_cache_get_view_poses( //
+	    &sess->view_pose_cache,  //
+	    xdev,                    //
+	    &default_eye_relation,   //
+	    xdisplay_time,           //
+	    view_count,              //
+	    &T_xdev_head,            //
+	    fovs,                    //
+	    poses);                  //
 
 	// The xdev pose in the base space.
 	struct xrt_space_relation T_base_xdev = XRT_SPACE_RELATION_ZERO;
@@ -626,7 +629,7 @@ oxr_session_locate_views(struct oxr_logger *log,
 	struct xrt_relation_chain xrc = {0};
 	m_relation_chain_push_relation(&xrc, &T_xdev_head);
 	m_relation_chain_push_relation(&xrc, &T_base_xdev);
-	m_relation_chain_resolve(&xrc, &T_base_head);
+	m_relation_chain_resolve_pose(&xrc, &T_base_head);
 
 	if (print) {
 		for (uint32_t i = 0; i < view_count; i++) {
@@ -655,7 +658,7 @@ oxr_session_locate_views(struct oxr_logger *log,
 		struct xrt_relation_chain xrc = {0};
 		m_relation_chain_push_pose_if_not_identity(&xrc, &view_pose);
 		m_relation_chain_push_relation(&xrc, &T_base_head);
-		m_relation_chain_resolve(&xrc, &result);
+		m_relation_chain_resolve_pose(&xrc, &result);
 		OXR_XRT_POSE_TO_XRPOSEF(result.pose, views[i].pose);
 
 
@@ -943,6 +946,8 @@ oxr_session_destroy(struct oxr_logger *log, struct oxr_handle_base *hb)
 	xrt_comp_native_destroy(&sess->xcn);
 	xrt_session_destroy(&sess->xs);
 
+	u_var_remove_root((void *)sess);
+	u_pose_cache_fini(&sess->view_pose_cache);
 	os_precise_sleeper_deinit(&sess->sleeper);
 	oxr_frame_sync_fini(&sess->frame_sync);
 	os_mutex_destroy(&sess->active_wait_frames_lock);
@@ -973,6 +978,12 @@ oxr_session_allocate_and_init(struct oxr_logger *log,
 	// Init the wait frame precise sleeper.
 	os_precise_sleeper_init(&sess->sleeper);
 
+	// Init the view pose cache, covers repeated xrLocateViews calls.
+	u_pose_cache_init(&sess->view_pose_cache, U_POSE_CACHE_DEFAULT_MAX_AGE_NS);
+
+	u_var_add_root((void *)sess, "XrSession", true);
+	u_pose_cache_add_vars(&sess->view_pose_cache, sess, "View pose cache");
+
 	sess->active_wait_frames = 0;
 	os_mutex_init(&sess->active_wait_frames_lock);
 
@@ -1327,7 +1338,11 @@ oxr_session_hand_joints(struct oxr_logger *log,
 	struct xrt_relation_chain xrc = {0};
 	m_relation_chain_push_relation(&xrc, &T_xdev_hand);
 	m_relation_chain_push_relation(&xrc, &T_base_xdev);
-	m_relation_chain_resolve(&xrc, &T_base_hand);
+	if (vel != NULL) {
+		m_relation_chain_resolve(&xrc, &T_base_hand);
+	} else {
+		m_relation_chain_resolve_pose(&xrc, &T_base_hand);
+	}
 
 	// Can we not relate to this space or did we not get values?
 	if (T_base_hand.relation_flags == 0 || !value.is_active) {
@@ -1348,24 +1363,33 @@ oxr_session_hand_joints(struct oxr_logger *log,
 	// We know we are active.
 	locations->isActive = true;
 
+	// Move all of the joint poses into the base space in one go.
+	struct m_pose_batch joints;
+	joints.count = locations->jointCount;
+	for (uint32_t i = 0; i < locations->jointCount; i++) {
+		m_pose_batch_set_relation(&joints, i, &value.values.hand_joint_set_default[i].relation);
+	}
+	m_pose_batch_transform(&T_base_hand.pose, &joints, &joints);
+
 	for (uint32_t i = 0; i < locations->jointCount; i++) {
 		locations->jointLocations[i].locationFlags =
 		    xrt_to_xr_space_location_flags(value.values.hand_joint_set_default[i].relation.relation_flags);
 		locations->jointLocations[i].radius = value.values.hand_joint_set_default[i].radius;
 
-		struct xrt_space_relation r = value.values.hand_joint_set_default[i].relation;
-
-		struct xrt_space_relation result;
-		struct xrt_relation_chain chain = {0};
-		m_relation_chain_push_relation(&chain, &r);
-		m_relation_chain_push_relation(&chain, &T_base_hand);
-		m_relation_chain_resolve(&chain, &result);
-
-		xrt_to_xr_pose(&result.pose, &locations->jointLocations[i].pose);
+		struct xrt_pose pose;
+		m_pose_batch_get(&joints, i, &pose);
+		xrt_to_xr_pose(&pose, &locations->jointLocations[i].pose);
 
 		if (vel) {
 			XrHandJointVelocityEXT *v = &vel->jointVelocities[i];
 
+			// The velocities need the full chain, for the flags and lever arm.
+			struct xrt_space_relation result;
+			struct xrt_relation_chain chain = {0};
+			m_relation_chain_push_relation(&chain, &value.values.hand_joint_set_default[i].relation);
+			m_relation_chain_push_relation(&chain, &T_base_hand);
+			m_relation_chain_resolve(&chain, &result);
+
 			v->velocityFlags = 0;
 			if ((result.relation_flags & XRT_SPACE_RELATION_LINEAR_VELOCITY_VALID_BIT)) {
 				v->velocityFlags |= XR_SPACE_VELOCITY_LINEAR_VALID_BIT;
@@ -17,6 +17,7 @@
 
 #include "util/u_debug.h"
 #include "util/u_misc.h"
+#include "util/u_space_cache.h"
 #include "util/u_time.h"
 #include "util/u_verify.h"
 
@@ -1170,6 +1171,32 @@ verify_passthrough_layer(struct xrt_compositor *xc,
  *
  */
 
+/*!
+ * Locate the head device in the given space, using and filling the per frame
+ * cache, returns false if the head is not located in the space.
+ */
+static bool
+locate_head_in_space(struct oxr_logger *log,
+                     struct oxr_session *sess,
+                     struct u_space_cache *space_cache,
+                     struct oxr_space *spc,
+                     uint64_t timestamp,
+                     struct xrt_space_relation *out_T_space_xdev)
+{
+	bool located = false;
+	if (u_space_cache_find(space_cache, spc, &located, out_T_space_xdev)) {
+		return located;
+	}
+
+	struct xrt_device *head_xdev = GET_XDEV_BY_ROLE(sess->sys, head);
+	XrResult ret = oxr_space_locate_device(log, head_xdev, spc, timestamp, out_T_space_xdev);
+	located = ret == XR_SUCCESS && out_T_space_xdev->relation_flags != 0;
+
+	u_space_cache_add(space_cache, spc, located, out_T_space_xdev);
+
+	return located;
+}
+
 /**
  * Turn the poses supplied with a composition layer into the poses the compositor wants.
  *
@@ -1178,6 +1205,7 @@ verify_passthrough_layer(struct xrt_compositor *xc,
  * @param spc space that @p pose_ptr is supplied in
  * @param pose_ptr pose supplied with layer
  * @param inv_offset inverse of the tracking origin offset
+ * @param space_cache per frame cache of located spaces
  * @param timestamp timestamp for pose
  * @param[out] out_pose Resulting view-space pose
  * @return true if successfully transformed into a view space pose
@@ -1188,6 +1216,7 @@ handle_space(struct oxr_logger *log,
              struct oxr_space *spc,
              const struct xrt_pose *pose_ptr,
              const struct xrt_pose *inv_offset,
+             struct u_space_cache *space_cache,
              uint64_t timestamp,
              struct xrt_pose *out_pose)
 {
@@ -1207,20 +1236,14 @@ handle_space(struct oxr_logger *log,
 		struct xrt_relation_chain xrc = {0};
 		m_relation_chain_push_pose(&xrc, &T_space_layer);             // T_offset_layer
 		m_relation_chain_push_pose_if_not_identity(&xrc, &spc->pose); // T_space_offset
-		m_relation_chain_resolve(&xrc, &rel);
+		m_relation_chain_resolve_pose(&xrc, &rel);
 		*out_pose = rel.pose;
 		return true;
 	}
 
 	// The compositor doesn't know about spaces, so we want the space in the xdev's "space".
-	struct xrt_device *head_xdev = GET_XDEV_BY_ROLE(sess->sys, head);
 	struct xrt_space_relation T_space_xdev = XRT_SPACE_RELATION_ZERO;
-
-	XrResult ret = oxr_space_locate_device(log, head_xdev, spc, timestamp, &T_space_xdev);
-	if (ret != XR_SUCCESS) {
-		return false;
-	}
-	if (T_space_xdev.relation_flags == 0) {
+	if (!locate_head_in_space(log, sess, space_cache, spc, timestamp, &T_space_xdev)) {
 		return false;
 	}
 
@@ -1228,7 +1251,7 @@ handle_space(struct oxr_logger *log,
 	struct xrt_relation_chain xrc = {0};
 	m_relation_chain_push_pose_if_not_identity(&xrc, &T_space_layer);
 	m_relation_chain_push_inverted_relation(&xrc, &T_space_xdev); // T_xdev_space
-	m_relation_chain_resolve(&xrc, &T_xdev_layer);
+	m_relation_chain_resolve_pose(&xrc, &T_xdev_layer);
 
 	*out_pose = T_xdev_layer.pose;
 
@@ -1242,6 +1265,7 @@ submit_quad_layer(struct oxr_session *sess,
                   XrCompositionLayerQuad *quad,
                   struct xrt_device *head,
                   struct xrt_pose *inv_offset,
+                  struct u_space_cache *space_cache,
                   uint64_t oxr_timestamp,
                   uint64_t xrt_timestamp)
 {
@@ -1253,7 +1277,7 @@ submit_quad_layer(struct oxr_session *sess,
 	struct xrt_pose *pose_ptr = (struct xrt_pose *)&quad->pose;
 
 	struct xrt_pose pose;
-	if (!handle_space(log, sess, spc, pose_ptr, inv_offset, oxr_timestamp, &pose)) {
+	if (!handle_space(log, sess, spc, pose_ptr, inv_offset, space_cache, oxr_timestamp, &pose)) {
 		return XR_SUCCESS;
 	}
 
@@ -1293,6 +1317,7 @@ submit_projection_layer(struct oxr_session *sess,
                         XrCompositionLayerProjection *proj,
                         struct xrt_device *head,
                         struct xrt_pose *inv_offset,
+                        struct u_space_cache *space_cache,
                         uint64_t oxr_timestamp,
                         uint64_t xrt_timestamp)
 {
@@ -1317,7 +1342,7 @@ submit_projection_layer(struct oxr_session *sess,
 		scs[i] = XRT_CAST_OXR_HANDLE_TO_PTR(struct oxr_swapchain *, proj->views[i].subImage.swapchain);
 		pose_ptr = (struct xrt_pose *)&proj->views[i].pose;
 
-		if (!handle_space(log, sess, spc, pose_ptr, inv_offset, oxr_timestamp, &pose[i])) {
+		if (!handle_space(log, sess, spc, pose_ptr, inv_offset, space_cache, oxr_timestamp, &pose[i])) {
 			return XR_SUCCESS;
 		}
 	}
@@ -1401,6 +1426,7 @@ submit_cube_layer(struct oxr_session *sess,
                   const XrCompositionLayerCubeKHR *cube,
                   struct xrt_device *head,
                   struct xrt_pose *inv_offset,
+                  struct u_space_cache *space_cache,
                   uint64_t oxr_timestamp,
                   uint64_t xrt_timestamp)
 {
@@ -1439,7 +1465,7 @@ submit_cube_layer(struct oxr_session *sess,
 	    .position = XRT_VEC3_ZERO,
 	};
 
-	if (!handle_space(log, sess, spc, &pose, inv_offset, oxr_timestamp, &data.cube.pose)) {
+	if (!handle_space(log, sess, spc, &pose, inv_offset, space_cache, oxr_timestamp, &data.cube.pose)) {
 		return XR_SUCCESS;
 	}
 
@@ -1456,6 +1482,7 @@ submit_cylinder_layer(struct oxr_session *sess,
                       const XrCompositionLayerCylinderKHR *cylinder,
                       struct xrt_device *head,
                       struct xrt_pose *inv_offset,
+                      struct u_space_cache *space_cache,
                       uint64_t oxr_timestamp,
                       uint64_t xrt_timestamp)
 {
@@ -1468,7 +1495,7 @@ submit_cylinder_layer(struct oxr_session *sess,
 	struct xrt_pose *pose_ptr = (struct xrt_pose *)&cylinder->pose;
 
 	struct xrt_pose pose;
-	if (!handle_space(log, sess, spc, pose_ptr, inv_offset, oxr_timestamp, &pose)) {
+	if (!handle_space(log, sess, spc, pose_ptr, inv_offset, space_cache, oxr_timestamp, &pose)) {
 		return XR_SUCCESS;
 	}
 
@@ -1508,6 +1535,7 @@ submit_equirect1_layer(struct oxr_session *sess,
                        const XrCompositionLayerEquirectKHR *equirect,
                        struct xrt_device *head,
                        struct xrt_pose *inv_offset,
+                       struct u_space_cache *space_cache,
                        uint64_t oxr_timestamp,
                        uint64_t xrt_timestamp)
 {
@@ -1519,7 +1547,7 @@ submit_equirect1_layer(struct oxr_session *sess,
 	struct xrt_pose *pose_ptr = (struct xrt_pose *)&equirect->pose;
 
 	struct xrt_pose pose;
-	if (!handle_space(log, sess, spc, pose_ptr, inv_offset, oxr_timestamp, &pose)) {
+	if (!handle_space(log, sess, spc, pose_ptr, inv_offset, space_cache, oxr_timestamp, &pose)) {
 		return XR_SUCCESS;
 	}
 
@@ -1571,6 +1599,7 @@ submit_equirect2_layer(struct oxr_session *sess,
                        const XrCompositionLayerEquirect2KHR *equirect,
                        struct xrt_device *head,
                        struct xrt_pose *inv_offset,
+                       struct u_space_cache *space_cache,
                        uint64_t oxr_timestamp,
                        uint64_t xrt_timestamp)
 {
@@ -1582,7 +1611,7 @@ submit_equirect2_layer(struct oxr_session *sess,
 	struct xrt_pose *pose_ptr = (struct xrt_pose *)&equirect->pose;
 
 	struct xrt_pose pose;
-	if (!handle_space(log, sess, spc, pose_ptr, inv_offset, oxr_timestamp, &pose)) {
+	if (!handle_space(log, sess, spc, pose_ptr, inv_offset, space_cache, oxr_timestamp, &pose)) {
 		return XR_SUCCESS;
 	}
 
@@ -1622,6 +1651,7 @@ submit_passthrough_layer(struct oxr_session *sess,
                          const XrCompositionLayerPassthroughFB *passthrough,
                          struct xrt_device *head,
                          struct xrt_pose *inv_offset,
+                         struct u_space_cache *space_cache,
                          uint64_t oxr_timestamp,
                          uint64_t xrt_timestamp)
 {
@@ -1797,6 +1827,8 @@ oxr_session_frame_end(struct oxr_logger *log, struct oxr_session *sess, const Xr
 	struct xrt_pose inv_offset = {0};
 	math_pose_invert(&xdev->tracking_origin->initial_offset, &inv_offset);
 
+	struct u_space_cache space_cache = {0};
+
 	struct xrt_layer_frame_data data = {
 	    .frame_id = sess->frame_id.begun,
 	    .display_time_ns = xrt_display_time_ns,
@@ -1814,31 +1846,31 @@ oxr_session_frame_end(struct oxr_logger *log, struct oxr_session *sess, const Xr
 		switch (layer->type) {
 		case XR_TYPE_COMPOSITION_LAYER_PROJECTION:
 			submit_projection_layer(sess, xc, log, (XrCompositionLayerProjection *)layer, xdev, &inv_offset,
-			                        frameEndInfo->displayTime, xrt_display_time_ns);
+			                        &space_cache, frameEndInfo->displayTime, xrt_display_time_ns);
 			break;
 		case XR_TYPE_COMPOSITION_LAYER_QUAD:
-			submit_quad_layer(sess, xc, log, (XrCompositionLayerQuad *)layer, xdev, &inv_offset,
+			submit_quad_layer(sess, xc, log, (XrCompositionLayerQuad *)layer, xdev, &inv_offset, &space_cache,
 			                  frameEndInfo->displayTime, xrt_display_time_ns);
 			break;
 		case XR_TYPE_COMPOSITION_LAYER_CUBE_KHR:
-			submit_cube_layer(sess, xc, log, (XrCompositionLayerCubeKHR *)layer, xdev, &inv_offset,
+			submit_cube_layer(sess, xc, log, (XrCompositionLayerCubeKHR *)layer, xdev, &inv_offset, &space_cache,
 			                  frameEndInfo->displayTime, xrt_display_time_ns);
 			break;
 		case XR_TYPE_COMPOSITION_LAYER_CYLINDER_KHR:
 			submit_cylinder_layer(sess, xc, log, (XrCompositionLayerCylinderKHR *)layer, xdev, &inv_offset,
-			                      frameEndInfo->displayTime, xrt_display_time_ns);
+			                      &space_cache, frameEndInfo->displayTime, xrt_display_time_ns);
 			break;
 		case XR_TYPE_COMPOSITION_LAYER_EQUIRECT_KHR:
 			submit_equirect1_layer(sess, xc, log, (XrCompositionLayerEquirectKHR *)layer, xdev, &inv_offset,
-			                       frameEndInfo->displayTime, xrt_display_time_ns);
+			                       &space_cache, frameEndInfo->displayTime, xrt_display_time_ns);
 			break;
 		case XR_TYPE_COMPOSITION_LAYER_EQUIRECT2_KHR:
-			submit_equirect2_layer(sess, xc, log, (XrCompositionLayerEquirect2KHR *)layer, xdev,
-			                       &inv_offset, frameEndInfo->displayTime, xrt_display_time_ns);
+			submit_equirect2_layer(sess, xc, log, (XrCompositionLayerEquirect2KHR *)layer, xdev, &inv_offset,
+			                       &space_cache, frameEndInfo->displayTime, xrt_display_time_ns);
 			break;
 		case XR_TYPE_COMPOSITION_LAYER_PASSTHROUGH_FB:
-			submit_passthrough_layer(sess, xc, log, (XrCompositionLayerPassthroughFB *)layer, xdev,
-			                         &inv_offset, frameEndInfo->displayTime, xrt_display_time_ns);
+			submit_passthrough_layer(sess, xc, log, (XrCompositionLayerPassthroughFB *)layer, xdev, &inv_offset,
+			                         &space_cache, frameEndInfo->displayTime, xrt_display_time_ns);
 			break;
 		default: assert(false && "invalid layer type");
 		}
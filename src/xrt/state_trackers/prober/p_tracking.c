@@ -275,6 +275,8 @@ p_factory_ensure_slam_frameserver(struct p_factory *fact)
 		U_LOG_W("SLAM tracking support is disabled, the Euroc driver will not be tracked");
 #endif
 
+		euroc_player_config_fini(&ep_config);
+
 		xrt_fs_slam_stream_start(fact->xfs, sinks);
 
 		return true;
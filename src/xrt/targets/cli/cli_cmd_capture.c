@@ -0,0 +1,57 @@
+// Copyright 2025, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Converts between capture files and EuRoC datasets.
+ * @author agent <agent@local>
+ */
+
+#include "xrt/xrt_compiler.h"
+#include "xrt/xrt_config_have.h"
+#include "xrt/xrt_config_os.h"
+
+#include "cli_common.h"
+
+#if defined(XRT_HAVE_OPENCV) && !defined(XRT_OS_WINDOWS)
+#include "tracking/t_capture.h"
+#endif
+
+#include <string.h>
+#include <stdio.h>
+
+#define P(...) fprintf(stderr, __VA_ARGS__)
+
+int
+cli_cmd_capture(int argc, const char **argv)
+{
+#if defined(XRT_HAVE_OPENCV) && !defined(XRT_OS_WINDOWS)
+	if (argc != 5) {
+		P("Converts between capture files (" T_CAPTURE_FILE_EXTENSION ") and EuRoC datasets.\n");
+		P("Usage: %s %s from-euroc <euroc_path> <capture_file>\n", argv[0], argv[1]);
+		P("       %s %s to-euroc <capture_file> <euroc_path>\n", argv[0], argv[1]);
+		return 1;
+	}
+
+	int ret = 0;
+	if (strcmp(argv[2], "from-euroc") == 0) {
+		ret = t_capture_from_euroc(argv[3], argv[4]);
+	} else if (strcmp(argv[2], "to-euroc") == 0) {
+		ret = t_capture_to_euroc(argv[3], argv[4]);
+	} else {
+		P("Unknown conversion '%s'\n", argv[2]);
+		return 1;
+	}
+
+	if (ret != 0) {
+		P("Failed to convert '%s'!\n", argv[3]);
+		return 1;
+	}
+
+	P("Wrote '%s'\n", argv[4]);
+
+	return 0;
+#else
+	P("Not compiled with OpenCV, or on Windows, capture files are not supported!\n");
+	return 1;
+#endif
+}
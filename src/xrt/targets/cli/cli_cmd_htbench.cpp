@@ -0,0 +1,396 @@
+// Copyright 2025, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Offline benchmark of Mercury hand tracking on EuRoC datasets.
+ * @author agent <agent@local>
+ */
+
+#include "xrt/xrt_config_build.h"
+#include "xrt/xrt_config_drivers.h"
+
+#include "cli_common.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define P(...) fprintf(stderr, __VA_ARGS__)
+
+#if defined(XRT_MODULE_MERCURY_HANDTRACKING) && defined(XRT_BUILD_DRIVER_EUROC)
+
+#include "euroc/euroc_interface.h"
+#include "os/os_time.h"
+#include "math/m_vec3.h"
+#include "tracking/t_hand_tracking.h"
+#include "tracking/t_tracking.h"
+#include "util/u_file.h"
+#include "util/u_logging.h"
+#include "util/u_misc.h"
+#include "util/u_time.h"
+#include "xrt/xrt_frame.h"
+#include "xrt/xrt_frameserver.h"
+
+#include "hg_debug_instrumentation.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using xrt::tracking::hand::mercury::hg_tuneable_values;
+using xrt::tracking::hand::mercury::t_hand_tracking_sync_mercury_get_tuneable_values_pointer;
+
+
+/*
+ *
+ * Structs and defines.
+ *
+ */
+
+//! Timings of one stage of the tracker, one sample per frame it ran in.
+struct htbench_stage
+{
+	const char *name;
+	std::vector<float> samples_ms;
+};
+
+enum htbench_stage_index
+{
+	HTBENCH_FRAME,
+	HTBENCH_DETECTION,
+	HTBENCH_DETECTION_MODEL,
+	HTBENCH_KEYPOINT_PREPARE,
+	HTBENCH_KEYPOINT_MODEL,
+	HTBENCH_OPTIMIZER,
+	HTBENCH_STAGE_COUNT,
+};
+
+struct htbench
+{
+	//! Left and right views from the player, processed when the right one arrives.
+	struct xrt_frame_sink sinks[2];
+	struct xrt_frame *left;
+
+	struct t_hand_tracking_sync *sync;
+	struct hg_tuneable_values *values;
+
+	FILE *csv;
+
+	struct htbench_stage stages[HTBENCH_STAGE_COUNT] = {
+	    {"Frame (total)", {}},
+	    {"Detection", {}},
+	    {"Detection model", {}},
+	    {"Stereographic projection", {}},
+	    {"Keypoint model", {}},
+	    {"Optimizer (kine_lm)", {}},
+	};
+
+	uint64_t frame_count;
+	timepoint_ns first_frame_ns;
+	timepoint_ns last_frame_ns;
+
+	//! Last two outputs of each hand, for jitter.
+	struct xrt_hand_joint_set history[2][2];
+	int history_count[2];
+	uint64_t tracked_count[2];
+
+	//! Sum of squared second differences of joint positions, and how many there are.
+	double jitter_sum_m2[2];
+	uint64_t jitter_count[2];
+};
+
+
+/*
+ *
+ * Helpers.
+ *
+ */
+
+static float
+percentile(const std::vector<float> &sorted, float p)
+{
+	size_t i = (size_t)(p * (float)(sorted.size() - 1) + 0.5f);
+	return sorted[std::min(i, sorted.size() - 1)];
+}
+
+/*!
+ * Frame to frame acceleration of every joint, which is zero for a hand
+ * standing still or moving at a constant speed, so what is left is mostly
+ * jitter.
+ */
+static void
+accumulate_jitter(struct htbench *hb, int hand, const struct xrt_hand_joint_set *set)
+{
+	if (!set->is_active) {
+		hb->history_count[hand] = 0;
+		return;
+	}
+
+	hb->tracked_count[hand]++;
+
+	if (hb->history_count[hand] == 2) {
+		const struct xrt_hand_joint_value *a = hb->history[hand][0].values.hand_joint_set_default;
+		const struct xrt_hand_joint_value *b = hb->history[hand][1].values.hand_joint_set_default;
+		const struct xrt_hand_joint_value *c = set->values.hand_joint_set_default;
+
+		for (int i = 0; i < XRT_HAND_JOINT_COUNT; i++) {
+			struct xrt_vec3 pa = a[i].relation.pose.position;
+			struct xrt_vec3 pb = b[i].relation.pose.position;
+			struct xrt_vec3 pc = c[i].relation.pose.position;
+
+			struct xrt_vec3 d = {pc.x - 2 * pb.x + pa.x, pc.y - 2 * pb.y + pa.y, pc.z - 2 * pb.z + pa.z};
+			hb->jitter_sum_m2[hand] += m_vec3_dot(d, d);
+			hb->jitter_count[hand]++;
+		}
+	}
+
+	if (hb->history_count[hand] == 2) {
+		hb->history[hand][0] = hb->history[hand][1];
+		hb->history[hand][1] = *set;
+	} else {
+		hb->history[hand][hb->history_count[hand]++] = *set;
+	}
+}
+
+static void
+push_stage(struct htbench *hb, enum htbench_stage_index stage, bool ran, float ms)
+{
+	if (ran) {
+		hb->stages[stage].samples_ms.push_back(ms);
+	}
+}
+
+static void
+process_frames(struct htbench *hb, struct xrt_frame *left, struct xrt_frame *right)
+{
+	struct xrt_hand_joint_set hands[2] = {};
+	int64_t timestamp_ns = 0;
+
+	timepoint_ns start_ns = os_monotonic_get_ns();
+	t_ht_sync_process(hb->sync, left, right, &hands[0], &hands[1], &timestamp_ns);
+	timepoint_ns end_ns = os_monotonic_get_ns();
+
+	if (hb->frame_count++ == 0) {
+		hb->first_frame_ns = start_ns;
+	}
+	hb->last_frame_ns = end_ns;
+
+	const struct hg_tuneable_values *v = hb->values;
+	float frame_ms = time_ns_to_ms_f(end_ns - start_ns);
+
+	push_stage(hb, HTBENCH_FRAME, true, frame_ms);
+	push_stage(hb, HTBENCH_DETECTION, v->detection_batch_size > 0, v->detection_ms);
+	push_stage(hb, HTBENCH_DETECTION_MODEL, v->detection_batch_size > 0, v->detection_model_ms);
+	push_stage(hb, HTBENCH_KEYPOINT_PREPARE, v->keypoint_batch_size > 0, v->keypoint_prepare_ms);
+	push_stage(hb, HTBENCH_KEYPOINT_MODEL, v->keypoint_batch_size > 0, v->keypoint_model_ms);
+	push_stage(hb, HTBENCH_OPTIMIZER, v->optimizer_count > 0, v->optimizer_ms);
+
+	for (int hand = 0; hand < 2; hand++) {
+		accumulate_jitter(hb, hand, &hands[hand]);
+	}
+
+	if (hb->csv != NULL) {
+		fprintf(hb->csv, "%" PRId64 ",%f,%f,%f,%f,%f,%f,%d,%d,%d,%d\n", timestamp_ns, frame_ms,
+		        v->detection_ms, v->detection_model_ms, v->keypoint_prepare_ms, v->keypoint_model_ms,
+		        v->optimizer_ms, v->detection_batch_size, v->keypoint_batch_size, hands[0].is_active,
+		        hands[1].is_active);
+	}
+}
+
+static void
+receive_left(struct xrt_frame_sink *sink, struct xrt_frame *xf)
+{
+	struct htbench *hb = container_of(sink, struct htbench, sinks[0]);
+	xrt_frame_reference(&hb->left, xf);
+}
+
+static void
+receive_right(struct xrt_frame_sink *sink, struct xrt_frame *xf)
+{
+	struct htbench *hb = container_of(sink, struct htbench, sinks[1]);
+
+	// The player pushes both views of a frame one after the other.
+	if (hb->left == NULL || hb->left->timestamp != xf->timestamp) {
+		U_LOG_W("Dropping right view without a matching left view");
+		return;
+	}
+
+	process_frames(hb, hb->left, xf);
+	xrt_frame_reference(&hb->left, NULL);
+}
+
+static void
+print_results(struct htbench *hb)
+{
+	double seconds = time_ns_to_s(hb->last_frame_ns - hb->first_frame_ns);
+
+	printf("\n%-26s %8s %9s %9s %9s %9s %9s\n", "Stage", "Frames", "Mean", "P50", "P90", "P99", "Max");
+	for (struct htbench_stage &stage : hb->stages) {
+		std::vector<float> &s = stage.samples_ms;
+		if (s.empty()) {
+			printf("%-26s %8d\n", stage.name, 0);
+			continue;
+		}
+
+		std::sort(s.begin(), s.end());
+		double sum = 0;
+		for (float ms : s) {
+			sum += ms;
+		}
+
+		printf("%-26s %8zu %7.2fms %7.2fms %7.2fms %7.2fms %7.2fms\n", stage.name, s.size(), sum / s.size(),
+		       percentile(s, 0.5f), percentile(s, 0.9f), percentile(s, 0.99f), s.back());
+	}
+
+	printf("\nThroughput: %.1f frames/s (%" PRIu64 " frames in %.2fs)\n",
+	       seconds > 0 ? (double)hb->frame_count / seconds : 0.0, hb->frame_count, seconds);
+
+	const char *hand_names[2] = {"Left", "Right"};
+	for (int hand = 0; hand < 2; hand++) {
+		double tracked = hb->frame_count > 0 ? (double)hb->tracked_count[hand] / hb->frame_count : 0.0;
+		double jitter_mm = 0;
+		if (hb->jitter_count[hand] > 0) {
+			jitter_mm = sqrt(hb->jitter_sum_m2[hand] / hb->jitter_count[hand]) * 1000.0;
+		}
+
+		printf("%s hand: tracked in %.1f%% of frames, jitter %.3fmm RMS\n", hand_names[hand], tracked * 100.0,
+		       jitter_mm);
+	}
+}
+
+static struct euroc_player_config *
+make_euroc_player_config(const char *euroc_path)
+{
+	struct euroc_player_config *ep_config = U_TYPED_CALLOC(struct euroc_player_config);
+	euroc_player_fill_default_config_for(ep_config, euroc_path);
+
+	// Same overrides as the SLAM batch runner, unless they were explicitly provided
+	if (getenv("EUROC_LOG") == NULL) {
+		ep_config->log_level = U_LOGGING_INFO;
+	}
+	if (getenv("EUROC_PRINT_PROGRESS") == NULL) {
+		ep_config->playback.print_progress = true;
+	}
+	if (getenv("EUROC_USE_SOURCE_TS") == NULL) {
+		ep_config->playback.use_source_ts = true;
+	}
+
+	// The tracker needs every frame, and paces the player through its sinks.
+	ep_config->playback.play_from_start = true;
+	ep_config->playback.max_speed = true;
+	ep_config->playback.gt = false;
+	ep_config->playback.color = false;
+	ep_config->playback.cam_count = 2;
+
+	return ep_config;
+}
+
+#endif
+
+
+/*
+ *
+ * 'Exported' functions.
+ *
+ */
+
+int
+cli_cmd_htbench(int argc, const char **argv)
+{
+#if !defined(XRT_MODULE_MERCURY_HANDTRACKING)
+	P("Mercury hand tracking not built.\n");
+	return EXIT_FAILURE;
+#elif !defined(XRT_BUILD_DRIVER_EUROC)
+	P("Euroc driver not built, can't reproduce datasets.\n");
+	return EXIT_FAILURE;
+#else
+	if (argc != 4 && argc != 5) {
+		P("Benchmarks Mercury hand tracking on a stereo EuRoC dataset, as fast as it can go.\n");
+		P("Usage: %s %s <euroc_path> <stereo_calibration.json> [<per_frame_output.csv>]\n", argv[0], argv[1]);
+		return EXIT_FAILURE;
+	}
+
+	const char *euroc_path = argv[2];
+	const char *calib_path = argv[3];
+	const char *csv_path = argc == 5 ? argv[4] : NULL;
+
+	struct euroc_player_config *ep_config = make_euroc_player_config(euroc_path);
+	if (ep_config->dataset.cam_count < 2) {
+		P("'%s' is not a stereo dataset.\n", euroc_path);
+		euroc_player_config_fini(ep_config);
+		free(ep_config);
+		return EXIT_FAILURE;
+	}
+
+	struct t_stereo_camera_calibration *calib = NULL;
+	if (!t_stereo_camera_calibration_load(calib_path, &calib)) {
+		P("Could not load stereo calibration '%s'.\n", calib_path);
+		euroc_player_config_fini(ep_config);
+		free(ep_config);
+		return EXIT_FAILURE;
+	}
+
+	char models_dir[1024] = {0};
+	if (u_file_get_hand_tracking_models_dir(models_dir, ARRAY_SIZE(models_dir)) < 0) {
+		P("Could not find the hand tracking models, run ./scripts/get-ht-models.sh.\n");
+		t_stereo_camera_calibration_reference(&calib, NULL);
+		euroc_player_config_fini(ep_config);
+		free(ep_config);
+		return EXIT_FAILURE;
+	}
+
+	struct htbench hb = {};
+	hb.sinks[0].push_frame = receive_left;
+	hb.sinks[1].push_frame = receive_right;
+
+	if (csv_path != NULL) {
+		hb.csv = fopen(csv_path, "w");
+		if (hb.csv == NULL) {
+			P("Could not open '%s' for writing.\n", csv_path);
+			t_stereo_camera_calibration_reference(&calib, NULL);
+			euroc_player_config_fini(ep_config);
+			free(ep_config);
+			return EXIT_FAILURE;
+		}
+		fprintf(hb.csv,
+		        "#timestamp [ns],frame [ms],detection [ms],detection model [ms],stereographic projection [ms],"
+		        "keypoint model [ms],optimizer [ms],detection batch,keypoint batch,left active,right active\n");
+	}
+
+	// Datasets have no image boundary or rotation information, use the defaults.
+	struct t_hand_tracking_create_info create_info = {};
+	hb.sync = t_hand_tracking_sync_mercury_create(calib, create_info, models_dir);
+	hb.values = t_hand_tracking_sync_mercury_get_tuneable_values_pointer(hb.sync);
+
+	// Frame context that will manage the player lifetime
+	struct xrt_frame_context xfctx = {};
+
+	struct xrt_slam_sinks sinks = {};
+	sinks.cam_count = 2;
+	sinks.cams[0] = &hb.sinks[0];
+	sinks.cams[1] = &hb.sinks[1];
+
+	struct xrt_fs *xfs = euroc_player_create(&xfctx, euroc_path, ep_config);
+	xrt_fs_slam_stream_start(xfs, &sinks);
+
+	while (xrt_fs_is_running(xfs)) {
+		os_nanosleep(0.2 * U_TIME_1S_IN_NS);
+	}
+
+	xrt_frame_context_destroy_nodes(&xfctx);
+	xrt_frame_reference(&hb.left, NULL);
+
+	print_results(&hb);
+
+	if (hb.csv != NULL) {
+		fclose(hb.csv);
+	}
+
+	t_ht_sync_destroy(&hb.sync);
+	t_stereo_camera_calibration_reference(&calib, NULL);
+	euroc_player_config_fini(ep_config);
+	free(ep_config);
+
+	return EXIT_SUCCESS;
+#endif
+}
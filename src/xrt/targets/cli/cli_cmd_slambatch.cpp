@@ -0,0 +1,630 @@
+// Copyright 2022-2025, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  EuRoC datasets batch evaluation tool
+ * @author Mateo de Mayo <mateo.demayo@collabora.com>
+ * @author agent <agent@local>
+ */
+
+#include "xrt/xrt_config_build.h"
+#include "xrt/xrt_config_have.h"
+#include "xrt/xrt_config_drivers.h"
+#include "xrt/xrt_config_os.h"
+
+#include "cli_common.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define P(...) fprintf(stderr, __VA_ARGS__)
+#define I(...) U_LOG(U_LOGGING_INFO, __VA_ARGS__)
+
+#if defined(XRT_FEATURE_SLAM) && defined(XRT_BUILD_DRIVER_EUROC)
+
+#include "euroc/euroc_interface.h"
+#include "os/os_threading.h"
+#include "os/os_time.h"
+#include "util/u_json.h"
+#include "util/u_logging.h"
+#include "util/u_time.h"
+
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef XRT_OS_LINUX
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using std::string;
+using std::vector;
+using Eigen::Isometry3d;
+using Eigen::Quaterniond;
+using Eigen::Vector3d;
+
+
+/*
+ *
+ * Structs and defines.
+ *
+ */
+
+//! Groundtruth poses are matched to tracked ones if they are at most this far apart.
+#define SLAMBATCH_MAX_GT_OFFSET_NS (20 * U_TIME_1MS_IN_NS)
+
+//! Time between the two poses compared for the relative pose error.
+#define SLAMBATCH_RPE_DELTA_NS (1 * U_TIME_1S_IN_NS)
+
+struct slambatch_pose
+{
+	timepoint_ns ts;
+	Isometry3d pose;
+};
+
+//! Mean and percentiles of a list of samples.
+struct slambatch_stats
+{
+	size_t count = 0;
+	double mean = 0;
+	double median = 0;
+	double p95 = 0;
+	double max = 0;
+};
+
+//! Tracking pipeline stage from the timing CSV, measured between two columns.
+struct slambatch_stage
+{
+	string name;
+	double mean_ms;
+};
+
+//! A dataset to run and what came out of running it.
+struct slambatch_run
+{
+	const char *dataset_path;
+	const char *slam_config;
+	const char *output_path;
+
+	bool done = false;
+	double wall_time_s = 0;
+	size_t pose_count = 0;
+	size_t matched_count = 0; //!< Tracked poses with a groundtruth pose close enough.
+
+	bool has_gt = false;
+	double ate_rmse_m = 0;
+	double rpe_trans_rmse_m = 0;
+	double rpe_rot_rmse_deg = 0;
+
+	//! Only filled if the SLAM system reports pose timing.
+	slambatch_stats latency_ms;
+	vector<slambatch_stage> stages;
+};
+
+struct slambatch
+{
+	vector<slambatch_run> runs;
+	std::atomic<size_t> next_run{0};
+
+	int job_count = 1;
+	bool pin_jobs = true;
+	const char *report_path = NULL;
+};
+
+static volatile bool should_exit = false;
+
+
+/*
+ *
+ * Helpers.
+ *
+ */
+
+static void *
+wait_for_exit_key(void *ptr)
+{
+	getchar();
+	should_exit = true;
+	return NULL;
+}
+
+static slambatch_stats
+compute_stats(vector<double> samples)
+{
+	slambatch_stats s{};
+	if (samples.empty()) {
+		return s;
+	}
+
+	std::sort(samples.begin(), samples.end());
+	double sum = 0;
+	for (double v : samples) {
+		sum += v;
+	}
+
+	s.count = samples.size();
+	s.mean = sum / samples.size();
+	s.median = samples[(samples.size() - 1) / 2];
+	s.p95 = samples[(size_t)((samples.size() - 1) * 0.95)];
+	s.max = samples.back();
+	return s;
+}
+
+/*!
+ * Reads the first eight columns of a pose CSV, "ts px py pz qw qx qy qz".
+ * Both the EuRoC groundtruth files and the tracker TrajectoryWriter use it.
+ */
+static bool
+read_trajectory(const string &path, vector<slambatch_pose> &out)
+{
+	std::ifstream file(path);
+	if (!file.is_open()) {
+		return false;
+	}
+
+	string line;
+	while (std::getline(file, line)) {
+		if (line.empty() || line[0] == '#') {
+			continue;
+		}
+
+		long long ts = 0;
+		double p[3];
+		double q[4];
+		int n = sscanf(line.c_str(), "%lld,%lf,%lf,%lf,%lf,%lf,%lf,%lf", &ts, &p[0], &p[1], &p[2], &q[0], &q[1],
+		               &q[2], &q[3]);
+		if (n != 8) {
+			continue;
+		}
+
+		Isometry3d pose = Isometry3d::Identity();
+		pose.linear() = Quaterniond{q[0], q[1], q[2], q[3]}.normalized().toRotationMatrix();
+		pose.translation() = Vector3d{p[0], p[1], p[2]};
+		out.push_back({ts, pose});
+	}
+
+	std::sort(out.begin(), out.end(), [](const auto &a, const auto &b) { return a.ts < b.ts; });
+	return true;
+}
+
+static bool
+read_groundtruth(const char *dataset_path, vector<slambatch_pose> &out)
+{
+	// Same devices the EuRoC player looks for, in the same order
+	const char *gt_devices[] = {"vicon0", "mocap0", "state_groundtruth_estimate0", "leica0"};
+	for (const char *dev : gt_devices) {
+		string path = string{dataset_path} + "/mav0/" + dev + "/data.csv";
+		if (read_trajectory(path, out) && !out.empty()) {
+			return true;
+		}
+	}
+	return false;
+}
+
+//! Nearest groundtruth pose to @p ts or NULL if none is close enough.
+static const slambatch_pose *
+find_gt(const vector<slambatch_pose> &gt, timepoint_ns ts)
+{
+	auto it = std::lower_bound(gt.begin(), gt.end(), ts, [](const auto &p, timepoint_ns t) { return p.ts < t; });
+
+	const slambatch_pose *best = NULL;
+	if (it != gt.end()) {
+		best = &*it;
+	}
+	if (it != gt.begin() && (best == NULL || ts - std::prev(it)->ts < best->ts - ts)) {
+		best = &*std::prev(it);
+	}
+
+	if (best == NULL || std::abs(best->ts - ts) > SLAMBATCH_MAX_GT_OFFSET_NS) {
+		return NULL;
+	}
+	return best;
+}
+
+/*!
+ * Absolute trajectory error after a rigid alignment of the tracked positions
+ * onto the groundtruth, and translational and rotational relative pose errors
+ * over @ref SLAMBATCH_RPE_DELTA_NS, all as root mean squares.
+ */
+static void
+compute_trajectory_errors(slambatch_run &run, const vector<slambatch_pose> &est, const vector<slambatch_pose> &gt)
+{
+	vector<const slambatch_pose *> matched_est;
+	vector<const slambatch_pose *> matched_gt;
+	for (const slambatch_pose &e : est) {
+		const slambatch_pose *g = find_gt(gt, e.ts);
+		if (g != NULL) {
+			matched_est.push_back(&e);
+			matched_gt.push_back(g);
+		}
+	}
+
+	size_t n = matched_est.size();
+	run.matched_count = n;
+	if (n < 3) {
+		return;
+	}
+
+	Eigen::Matrix3Xd src(3, n);
+	Eigen::Matrix3Xd dst(3, n);
+	for (size_t i = 0; i < n; i++) {
+		src.col(i) = matched_est[i]->pose.translation();
+		dst.col(i) = matched_gt[i]->pose.translation();
+	}
+
+	// Tracked and groundtruth frames are only related by a rigid transform, no scale for VIO.
+	Eigen::Matrix4d align = Eigen::umeyama(src, dst, false);
+	Eigen::Matrix3Xd aligned = (align.topLeftCorner<3, 3>() * src).colwise() + align.topRightCorner<3, 1>();
+	run.ate_rmse_m = std::sqrt((aligned - dst).colwise().squaredNorm().mean());
+
+	double trans_sq_sum = 0;
+	double rot_sq_sum = 0;
+	size_t rpe_count = 0;
+	size_t j = 0;
+	for (size_t i = 0; i < n; i++) {
+		j = std::max(j, i + 1);
+		while (j < n && matched_est[j]->ts - matched_est[i]->ts < SLAMBATCH_RPE_DELTA_NS) {
+			j++;
+		}
+		if (j == n) {
+			break;
+		}
+
+		Isometry3d est_delta = matched_est[i]->pose.inverse() * matched_est[j]->pose;
+		Isometry3d gt_delta = matched_gt[i]->pose.inverse() * matched_gt[j]->pose;
+		Isometry3d error = gt_delta.inverse() * est_delta;
+
+		double angle_deg = Eigen::AngleAxisd{error.rotation()}.angle() * 180.0 / M_PI;
+		trans_sq_sum += error.translation().squaredNorm();
+		rot_sq_sum += angle_deg * angle_deg;
+		rpe_count++;
+	}
+
+	if (rpe_count > 0) {
+		run.rpe_trans_rmse_m = std::sqrt(trans_sq_sum / rpe_count);
+		run.rpe_rot_rmse_deg = std::sqrt(rot_sq_sum / rpe_count);
+	}
+	run.has_gt = true;
+}
+
+/*!
+ * Reads the TimingWriter output. The first column is the dataset timestamp
+ * since runs use the source timestamps, the rest are measured on this machine.
+ */
+static void
+compute_timing(slambatch_run &run, const string &path)
+{
+	std::ifstream file(path);
+	string line;
+	vector<string> columns;
+	vector<double> latencies_ms;
+	vector<double> stage_sums_ms;
+	size_t row_count = 0;
+
+	while (std::getline(file, line)) {
+		if (line.empty()) {
+			continue;
+		}
+
+		std::stringstream ss(line[0] == '#' ? line.substr(1) : line);
+		string cell;
+		vector<string> cells;
+		while (std::getline(ss, cell, ',')) {
+			cells.push_back(cell);
+		}
+
+		if (line[0] == '#') {
+			columns = cells;
+			stage_sums_ms.assign(columns.size(), 0);
+			continue;
+		}
+
+		// Without the pose timing extension only "sampled" and "received_by_monado" are there
+		if (columns.size() <= 2 || cells.size() != columns.size()) {
+			continue;
+		}
+
+		vector<long long> tss;
+		for (const string &c : cells) {
+			tss.push_back(atoll(c.c_str()));
+		}
+		for (size_t i = 2; i < tss.size(); i++) {
+			stage_sums_ms[i] += (double)(tss[i] - tss[i - 1]) / U_TIME_1MS_IN_NS;
+		}
+		latencies_ms.push_back((double)(tss.back() - tss[1]) / U_TIME_1MS_IN_NS);
+		row_count++;
+	}
+
+	run.latency_ms = compute_stats(latencies_ms);
+	for (size_t i = 2; i < columns.size() && row_count > 0; i++) {
+		run.stages.push_back({columns[i - 1] + " -> " + columns[i], stage_sums_ms[i] / row_count});
+	}
+}
+
+//! Splits the CPUs evenly between jobs, the SLAM threads inherit the mask of the job thread.
+static void
+pin_job_thread(int job_index, int job_count)
+{
+#ifdef XRT_OS_LINUX
+	int cpu_count = (int)std::thread::hardware_concurrency();
+	if (cpu_count <= 0 || job_count <= 1) {
+		return;
+	}
+
+	int per_job = std::max(1, cpu_count / job_count);
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	for (int i = 0; i < per_job; i++) {
+		CPU_SET((job_index * per_job + i) % cpu_count, &set);
+	}
+
+	int ret = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+	if (ret != 0) {
+		U_LOG_W("Failed to set CPU affinity for job %d", job_index);
+	}
+#else
+	(void)job_index;
+	(void)job_count;
+#endif
+}
+
+
+/*
+ *
+ * Running.
+ *
+ */
+
+static void
+run_dataset(slambatch_run &run, size_t index, size_t count)
+{
+	I("Running dataset %zu out of %zu", index + 1, count);
+	I("Dataset path: %s", run.dataset_path);
+	I("SLAM config path: %s", run.slam_config);
+	I("Output path: %s", run.output_path);
+
+	timepoint_ns start = os_monotonic_get_ns();
+	euroc_run_dataset(run.dataset_path, run.slam_config, run.output_path, &should_exit);
+	run.wall_time_s = time_ns_to_s(os_monotonic_get_ns() - start);
+
+	if (should_exit) {
+		return;
+	}
+
+	vector<slambatch_pose> est;
+	if (!read_trajectory(string{run.output_path} + "/tracking.csv", est)) {
+		U_LOG_E("No tracking.csv written to %s, is SLAM_WRITE_CSVS disabled?", run.output_path);
+		return;
+	}
+	run.pose_count = est.size();
+
+	vector<slambatch_pose> gt;
+	if (read_groundtruth(run.dataset_path, gt)) {
+		compute_trajectory_errors(run, est, gt);
+	}
+
+	compute_timing(run, string{run.output_path} + "/timing.csv");
+	run.done = true;
+
+	I("Finished dataset %zu (%s) in %.2fs", index + 1, run.dataset_path, run.wall_time_s);
+}
+
+static void
+run_job(slambatch &sb, int job_index)
+{
+	if (sb.pin_jobs) {
+		pin_job_thread(job_index, sb.job_count);
+	}
+
+	while (!should_exit) {
+		size_t i = sb.next_run.fetch_add(1);
+		if (i >= sb.runs.size()) {
+			break;
+		}
+		run_dataset(sb.runs[i], i, sb.runs.size());
+	}
+}
+
+
+/*
+ *
+ * Report.
+ *
+ */
+
+static void
+print_summary(const slambatch &sb)
+{
+	printf("%-40s %8s %8s %10s %12s %12s %12s\n", "dataset", "time [s]", "poses", "ATE [m]", "RPE t [m]",
+	       "RPE r [deg]", "latency [ms]");
+	for (const slambatch_run &run : sb.runs) {
+		if (!run.done) {
+			printf("%-40s %8s\n", run.dataset_path, "not run");
+			continue;
+		}
+
+		printf("%-40s %8.2f %8zu ", run.dataset_path, run.wall_time_s, run.pose_count);
+		if (run.has_gt) {
+			printf("%10.4f %12.4f %12.4f ", run.ate_rmse_m, run.rpe_trans_rmse_m, run.rpe_rot_rmse_deg);
+		} else {
+			printf("%10s %12s %12s ", "-", "-", "-");
+		}
+		if (run.latency_ms.count > 0) {
+			printf("%12.2f\n", run.latency_ms.mean);
+		} else {
+			printf("%12s\n", "-");
+		}
+	}
+}
+
+static cJSON *
+stats_to_json(const slambatch_stats &s)
+{
+	cJSON *json = cJSON_CreateObject();
+	cJSON_AddNumberToObject(json, "count", (double)s.count);
+	cJSON_AddNumberToObject(json, "mean", s.mean);
+	cJSON_AddNumberToObject(json, "median", s.median);
+	cJSON_AddNumberToObject(json, "p95", s.p95);
+	cJSON_AddNumberToObject(json, "max", s.max);
+	return json;
+}
+
+static bool
+write_report(const slambatch &sb, double wall_time_s)
+{
+	cJSON *root = cJSON_CreateObject();
+	cJSON_AddNumberToObject(root, "jobs", sb.job_count);
+	cJSON_AddNumberToObject(root, "wall_time_s", wall_time_s);
+
+	vector<double> ates;
+	vector<double> rpe_ts;
+	vector<double> rpe_rs;
+	vector<double> latencies;
+
+	cJSON *datasets = cJSON_AddArrayToObject(root, "datasets");
+	for (const slambatch_run &run : sb.runs) {
+		cJSON *d = cJSON_CreateObject();
+		cJSON_AddStringToObject(d, "dataset", run.dataset_path);
+		cJSON_AddStringToObject(d, "slam_config", run.slam_config);
+		cJSON_AddStringToObject(d, "output", run.output_path);
+		cJSON_AddBoolToObject(d, "done", run.done);
+		cJSON_AddNumberToObject(d, "wall_time_s", run.wall_time_s);
+		cJSON_AddNumberToObject(d, "poses", (double)run.pose_count);
+
+		if (run.has_gt) {
+			cJSON_AddNumberToObject(d, "matched_poses", (double)run.matched_count);
+			cJSON_AddNumberToObject(d, "ate_rmse_m", run.ate_rmse_m);
+			cJSON_AddNumberToObject(d, "rpe_trans_rmse_m", run.rpe_trans_rmse_m);
+			cJSON_AddNumberToObject(d, "rpe_rot_rmse_deg", run.rpe_rot_rmse_deg);
+			ates.push_back(run.ate_rmse_m);
+			rpe_ts.push_back(run.rpe_trans_rmse_m);
+			rpe_rs.push_back(run.rpe_rot_rmse_deg);
+		}
+
+		if (run.latency_ms.count > 0) {
+			cJSON_AddItemToObject(d, "latency_ms", stats_to_json(run.latency_ms));
+			cJSON *stages = cJSON_AddObjectToObject(d, "stage_mean_ms");
+			for (const slambatch_stage &stage : run.stages) {
+				cJSON_AddNumberToObject(stages, stage.name.c_str(), stage.mean_ms);
+			}
+			latencies.push_back(run.latency_ms.mean);
+		}
+
+		cJSON_AddItemToArray(datasets, d);
+	}
+
+	cJSON *summary = cJSON_AddObjectToObject(root, "summary");
+	cJSON_AddItemToObject(summary, "ate_rmse_m", stats_to_json(compute_stats(ates)));
+	cJSON_AddItemToObject(summary, "rpe_trans_rmse_m", stats_to_json(compute_stats(rpe_ts)));
+	cJSON_AddItemToObject(summary, "rpe_rot_rmse_deg", stats_to_json(compute_stats(rpe_rs)));
+	cJSON_AddItemToObject(summary, "mean_latency_ms", stats_to_json(compute_stats(latencies)));
+
+	char *str = cJSON_Print(root);
+	cJSON_Delete(root);
+
+	FILE *file = fopen(sb.report_path, "w");
+	if (file == NULL) {
+		P("Failed to open report file '%s'.\n", sb.report_path);
+		cJSON_free(str);
+		return false;
+	}
+	fprintf(file, "%s\n", str);
+	fclose(file);
+	cJSON_free(str);
+	return true;
+}
+
+#endif
+
+int
+cli_cmd_slambatch(int argc, const char **argv)
+{
+
+#if !defined(XRT_FEATURE_SLAM)
+	P("No SLAM system built.\n");
+	return EXIT_FAILURE;
+#elif !defined(XRT_BUILD_DRIVER_EUROC)
+	P("Euroc driver not built, can't reproduce datasets.\n");
+	return EXIT_FAILURE;
+#else
+	slambatch sb{};
+
+	// Do not count "monado-cli" and "slambatch" as args
+	int arg = 2;
+	for (; arg < argc && argv[arg][0] == '-'; arg++) {
+		string opt = argv[arg];
+		if ((opt == "-j" || opt == "--jobs") && arg + 1 < argc) {
+			sb.job_count = std::max(1, atoi(argv[++arg]));
+		} else if (opt == "--report" && arg + 1 < argc) {
+			sb.report_path = argv[++arg];
+		} else if (opt == "--no-affinity") {
+			sb.pin_jobs = false;
+		} else {
+			P("Unknown option '%s'.\n", opt.c_str());
+			arg = argc; // Print usage
+			break;
+		}
+	}
+
+	int nof_args = argc - arg;
+	const char **args = &argv[arg];
+
+	if (nof_args <= 0 || nof_args % 3 != 0) {
+		P("Batch evaluator of SLAM datasets.\n");
+		P("Usage: %s %s [-j <jobs>] [--report <report.json>] [--no-affinity]\n", argv[0], argv[1]);
+		P("       [<euroc_path> <slam_config> <output_path>]...\n");
+		P("  -j, --jobs     Number of datasets to run at the same time (default 1).\n");
+		P("  --report       Write ATE/RPE and timing statistics of all runs as JSON.\n");
+		P("  --no-affinity  Do not split the CPUs between concurrent jobs.\n");
+		return EXIT_FAILURE;
+	}
+
+	int nof_datasets = nof_args / 3;
+	for (int i = 0; i < nof_datasets; i++) {
+		slambatch_run run{};
+		run.dataset_path = args[i * 3];
+		run.slam_config = args[i * 3 + 1];
+		run.output_path = args[i * 3 + 2];
+		sb.runs.push_back(run);
+	}
+	sb.job_count = std::min(sb.job_count, nof_datasets);
+
+	// Allow pressing enter to quit the program by launching a new thread
+	struct os_thread_helper wfk_thread;
+	os_thread_helper_init(&wfk_thread);
+	os_thread_helper_start(&wfk_thread, wait_for_exit_key, NULL);
+
+	timepoint_ns start_time = os_monotonic_get_ns();
+	vector<std::thread> jobs;
+	for (int i = 0; i < sb.job_count; i++) {
+		jobs.emplace_back(run_job, std::ref(sb), i);
+	}
+	for (std::thread &job : jobs) {
+		job.join();
+	}
+	timepoint_ns end_time = os_monotonic_get_ns();
+
+	pthread_cancel(wfk_thread.thread);
+
+	// Destroy also stops the thread.
+	os_thread_helper_destroy(&wfk_thread);
+
+	double wall_time_s = (double)(end_time - start_time) / U_TIME_1S_IN_NS;
+	print_summary(sb);
+	if (sb.report_path != NULL && !write_report(sb, wall_time_s)) {
+		return EXIT_FAILURE;
+	}
+
+	printf("Done in %.2fs.\n", wall_time_s);
+#endif
+	return EXIT_SUCCESS;
+}
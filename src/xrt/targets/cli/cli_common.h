@@ -20,6 +20,12 @@ cli_cmd_calibrate(int argc, const char **argv);
 int
 cli_cmd_calibration_dump(int argc, const char **argv);
 
+int
+cli_cmd_capture(int argc, const char **argv);
+
+int
+cli_cmd_htbench(int argc, const char **argv);
+
 int
 cli_cmd_info(int argc, const char **argv);
 
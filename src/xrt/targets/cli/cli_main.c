@@ -34,6 +34,8 @@ cli_print_help(int argc, const char **argv)
 	P("  calibrate  - Calibrate a camera and save config (not implemented yet).\n");
 	P("  calib-dump - Load and dump a calibration to stdout.\n");
 	P("  slambatch  - Runs a sequence of EuRoC datasets with the SLAM tracker.\n");
+	P("  capture    - Convert between capture files and EuRoC datasets.\n");
+	P("  htbench    - Benchmark hand tracking on a stereo EuRoC dataset.\n");
 
 	return 1;
 }
@@ -68,5 +70,11 @@ main(int argc, const char **argv)
 	if (strcmp(argv[1], "slambatch") == 0) {
 		return cli_cmd_slambatch(argc, argv);
 	}
+	if (strcmp(argv[1], "capture") == 0) {
+		return cli_cmd_capture(argc, argv);
+	}
+	if (strcmp(argv[1], "htbench") == 0) {
+		return cli_cmd_htbench(argc, argv);
+	}
 	return cli_print_help(argc, argv);
 }
@@ -46,6 +46,17 @@ struct hg_tuneable_values
 
 	// Stuff that's only really useful for dataset playback:
 	bool detection_model_in_both_views = false;
+
+	// Written every frame, for reading only. Stages that didn't run this frame have a batch size or count of 0.
+	float frame_ms = 0;
+	float detection_ms = 0; // Including detection_model_ms
+	float detection_model_ms = 0;
+	float keypoint_prepare_ms = 0; // Stereographic projection of every hand/view pair
+	float keypoint_model_ms = 0;
+	float optimizer_ms = 0;
+	int32_t detection_batch_size = 0;
+	int32_t keypoint_batch_size = 0;
+	int32_t optimizer_count = 0;
 };
 
 struct hg_tuneable_values *
@@ -37,116 +37,18 @@ namespace xrt::tracking::hand::mercury {
 
 constexpr int wsize = 128;
 
-template <typename T> using OutputSizedArray = Eigen::Array<T, wsize, wsize, Eigen::RowMajor>;
-using OutputSizedFloatArray = OutputSizedArray<float>;
-
-#define ARRAY_STACK_SIZE 20
-
-struct ArrayStack
-{
-	OutputSizedFloatArray arrays[ARRAY_STACK_SIZE];
-	size_t array_idx = 0;
-
-	OutputSizedFloatArray &
-	get()
-	{
-		if (array_idx == ARRAY_STACK_SIZE) {
-			abort();
-		}
-		return this->arrays[this->array_idx++];
-	};
-
-	void
-	dropAll()
-	{
-		this->array_idx = 0;
-	}
-};
+using OutputRowArray = Eigen::Array<float, 1, wsize>;
 
 struct projection_state
 {
-	cv::Mat &input;
-	Eigen::Map<OutputSizedArray<uint8_t>> distorted_image_eigen;
 	t_camera_model_params dist;
 
 	const projection_instructions &instructions;
 
-	ArrayStack stack = {};
-
-	OutputSizedArray<int16_t> image_x = {};
-	OutputSizedArray<int16_t> image_y = {};
-
-	projection_state(const projection_instructions &instructions, cv::Mat &input, cv::Mat &output)
-	    : input(input), distorted_image_eigen(output.data, 128, 128), instructions(instructions){};
+	projection_state(const projection_instructions &instructions) : instructions(instructions){};
 };
 
 
-// A private, purpose-optimized version of the Kannalla-Brandt projection function.
-static void
-project_kb4(projection_state &mi,
-            const OutputSizedFloatArray &x, //
-            const OutputSizedFloatArray &y, //
-            const OutputSizedFloatArray &z, //
-            OutputSizedFloatArray &out_x,   //
-            OutputSizedFloatArray &out_y)
-{
-	const t_camera_model_params &dist = mi.dist;
-	OutputSizedFloatArray r2 = mi.stack.get();
-	OutputSizedFloatArray r = mi.stack.get();
-
-	r2 = x * x + y * y;
-	r = sqrt(r2);
-
-#if 0
-		const I theta = atan2(r, z);
-#else
-	// This works here but will not work in eg. a nonlinear optimizer, or for more general applications.
-	// Takes about 200us off the runtime.
-	// Basically:
-	// * We can be sure that z won't be negative only because previous hand tracking code checks this for
-	// us.
-	// * x,y,z is normalized so we don't have to worry about numerical stability.
-	// If neither of these were true we'd definitely need atan2.
-	//
-	// Grrr, we really need a good library for fast approximations of trigonometric functions.
-	OutputSizedFloatArray theta = mi.stack.get();
-	theta = atan(r / z);
-#endif
-
-	OutputSizedFloatArray theta2 = mi.stack.get();
-	theta2 = theta * theta;
-
-
-#if 0
-		I r_theta = dist.fisheye.k4 * theta2;
-		r_theta += dist.fisheye.k3;
-		r_theta *= theta2;
-		r_theta += dist.fisheye.k2;
-		r_theta *= theta2;
-		r_theta += dist.fisheye.k1;
-		r_theta *= theta2;
-		r_theta += 1;
-		r_theta *= theta;
-#else
-	// This version gives the compiler more options to do FMAs and avoid temporaries. Down to floating point
-	// precision this should give the same result as the above.
-	OutputSizedFloatArray r_theta = mi.stack.get();
-	r_theta =
-	    (((((dist.fisheye.k4 * theta2) + dist.fisheye.k3) * theta2 + dist.fisheye.k2) * theta2 + dist.fisheye.k1) *
-	         theta2 +
-	     1) *
-	    theta;
-#endif
-
-	OutputSizedFloatArray mx = mi.stack.get();
-	mx = x * r_theta / r;
-	OutputSizedFloatArray my = mi.stack.get();
-	my = y * r_theta / r;
-
-	out_x = dist.fx * mx + dist.cx;
-	out_y = dist.fy * my + dist.cy;
-}
-
 template <typename T>
 T
 map_ranges(T value, T from_low, T from_high, T to_low, T to_high)
@@ -154,149 +56,204 @@ map_ranges(T value, T from_low, T from_high, T to_low, T to_high)
 	return (value - from_low) * (to_high - to_low) / (from_high - from_low) + to_low;
 }
 
-void
-naive_remap(OutputSizedArray<int16_t> &image_x,
-            OutputSizedArray<int16_t> &image_y,
-            cv::Mat &input,
-            Eigen::Map<OutputSizedArray<uint8_t>> &output)
+// Largest stereographic coordinate of any pixel on the image border, so that the lookup table spends its resolution on
+// directions the camera can actually see.
+static float
+camera_lut_extent(const t_camera_model_params &dist, xrt_size size)
 {
-	output = 0;
-
-	for (int y = 0; y < wsize; y++) {
-		for (int x = 0; x < wsize; x++) {
-			if (image_y(y, x) < 0) {
-				continue;
-			}
-			if (image_y(y, x) >= input.rows) {
-				continue;
-			}
-			if (image_x(y, x) < 0) {
-				continue;
-			}
-			if (image_x(y, x) >= input.cols) {
-				continue;
-			}
-			output(y, x) = input.at<uint8_t>(image_y(y, x), image_x(y, x));
+	float extent = 0;
+
+	auto add_pixel = [&](float x, float y) {
+		float dir_x = {};
+		float dir_y = {};
+		float dir_z = {};
+		if (!t_camera_models_unproject(&dist, x, y, &dir_x, &dir_y, &dir_z)) {
+			return;
 		}
+		// The direction is normalized.
+		extent = fmaxf(extent, fmaxf(fabsf(dir_x), fabsf(dir_y)) / (1 + dir_z));
+	};
+
+	for (int x = 0; x <= size.w; x += 8) {
+		add_pixel(x, 0);
+		add_pixel(x, size.h);
 	}
-}
+	for (int y = 0; y <= size.h; y += 8) {
+		add_pixel(0, y);
+		add_pixel(size.w, y);
+	}
+	add_pixel(size.w, size.h);
 
+	if (extent <= 0) {
+		extent = 1;
+	}
+
+	// A bit of margin so that lookups right at the image border stay inside of the table. 1.5 is ~113 degrees
+	// off-axis, none of the camera models are sensible past that.
+	return fminf(extent * 1.05f, 1.5f);
+}
 
+void
+make_stereographic_camera_lut(const t_camera_model_params &dist, xrt_size size, stereographic_camera_lut &out_lut)
+{
+	constexpr int N = stereographic_camera_lut::kSize;
+
+	out_lut.extent = camera_lut_extent(dist, size);
+	out_lut.fx = dist.fx;
+	out_lut.fy = dist.fy;
+	out_lut.cx = dist.cx;
+	out_lut.cy = dist.cy;
+	out_lut.xy.resize(N * N * 2);
+
+	float step = (2 * out_lut.extent) / (N - 1);
+	float scale = 1 << stereographic_camera_lut::kFracBits;
+
+	for (int i = 0; i < N; i++) {
+		for (int j = 0; j < N; j++) {
+			float sg_x = -out_lut.extent + j * step;
+			float sg_y = -out_lut.extent + i * step;
+
+			// Stereographic unprojection, but with +Z forward.
+			float r2 = sg_x * sg_x + sg_y * sg_y;
+			float denom = 1 + r2;
+
+			float x = {};
+			float y = {};
+			bool valid = t_camera_models_project(&dist, (2 * sg_x) / denom, (2 * sg_y) / denom,
+			                                     (1 - r2) / denom, &x, &y);
+
+			// Far outside of the image the distortion polynomials can fold back into it, don't trust those.
+			valid = valid && x > -0.5f * size.w && x < 1.5f * size.w && //
+			        y > -0.5f * size.h && y < 1.5f * size.h;
+
+			int32_t *entry = &out_lut.xy[(i * N + j) * 2];
+			entry[0] = valid ? (int32_t)lrintf(x * scale) : stereographic_camera_lut::kInvalid;
+			entry[1] = valid ? (int32_t)lrintf(y * scale) : stereographic_camera_lut::kInvalid;
+		}
+	}
+}
 
+// Makes fixed-point maps for cv::remap, which does the actual (vectorized) bilinear sampling.
 void
-StereographicDistort(projection_state &mi)
+make_remap_maps(const stereographic_camera_lut &lut,
+                const t_camera_model_params &dist,
+                const projection_instructions &instructions,
+                cv::Size input_size,
+                cv::Mat &map_xy,
+                cv::Mat &map_frac)
 {
 	XRT_TRACE_MARKER();
 
-	OutputSizedFloatArray &sg_x = mi.stack.get();
-	OutputSizedFloatArray &sg_y = mi.stack.get();
+	constexpr int N = stereographic_camera_lut::kSize;
+	constexpr int kInvalid = stereographic_camera_lut::kInvalid;
+	constexpr int kTabSize = cv::INTER_TAB_SIZE;
 
-	// Please vectorize me?
-	if (mi.instructions.flip) {
-		for (int x = 0; x < wsize; ++x) {
-			sg_x.col(x).setConstant(map_ranges<float>((float)x, 0.0f, (float)wsize,
-			                                          (float)mi.instructions.stereographic_radius,
-			                                          (float)-mi.instructions.stereographic_radius));
-		}
-	} else {
-		for (int x = 0; x < wsize; ++x) {
-			sg_x.col(x).setConstant(map_ranges<float>((float)x, 0.0f, (float)wsize,
-			                                          (float)-mi.instructions.stereographic_radius,
-			                                          (float)mi.instructions.stereographic_radius));
-		}
+	const float radius = instructions.stereographic_radius;
+	const Eigen::Quaternionf &q = instructions.rot_quat;
+
+	// Output pixels to stereographic coordinates is affine.
+	OutputRowArray sg_x;
+	for (int x = 0; x < wsize; ++x) {
+		sg_x(x) = map_ranges<float>((float)x, 0.0f, (float)wsize, -radius, radius);
 	}
-	// Ditto?
-	for (int y = 0; y < wsize; ++y) {
-		sg_y.row(y).setConstant(map_ranges<float>((float)y, 0.0f, (float)wsize,
-		                                          (float)mi.instructions.stereographic_radius,
-		                                          (float)-mi.instructions.stereographic_radius));
+	if (instructions.flip) {
+		sg_x = -sg_x;
 	}
 
+	// So are camera stereographic coordinates to table cells,
+	const float cells_per_unit = (N - 1) / (2 * lut.extent);
+	const float cell_center = (N - 1) / 2.0f;
 
-	// STEREOGRAPHIC DIRECTION TO 3D DIRECTION
-	// Note: we do not normalize the direction, because we don't need to. :)
+	// and table pixels to pixels at the current resolution, in remap's fixed-point.
+	const float ax = dist.fx / lut.fx;
+	const float ay = dist.fy / lut.fy;
+	const float scale_x = (ax * kTabSize) / (1 << stereographic_camera_lut::kFracBits);
+	const float scale_y = (ay * kTabSize) / (1 << stereographic_camera_lut::kFracBits);
+	const float offset_x = (dist.cx - lut.cx * ax) * kTabSize;
+	const float offset_y = (dist.cy - lut.cy * ay) * kTabSize;
 
-	OutputSizedFloatArray &dir_x = mi.stack.get();
-	OutputSizedFloatArray &dir_y = mi.stack.get();
-	OutputSizedFloatArray &dir_z = mi.stack.get();
+	// Anything outside of this samples only the border anyway, and is kept well within int16_t.
+	const int max_x = (input_size.width + 1) * kTabSize;
+	const int max_y = (input_size.height + 1) * kTabSize;
 
+	for (int y = 0; y < wsize; ++y) {
+		const float sg_y = map_ranges<float>((float)y, 0.0f, (float)wsize, radius, -radius);
 
-#if 0
-	dir_x = sg_x * 2;
-	dir_y = sg_y * 2;
-#else
-	// Adding something to itself is faster than multiplying itself by 2
-	// and unless you have fast-math the compiler won't do it for you. =/
-	dir_x = sg_x + sg_x;
-	dir_y = sg_y + sg_y;
-#endif
-
-	dir_z = (sg_x * sg_x) + (sg_y * sg_y) - 1;
-	// END STEREOGRAPHIC DIRECTION TO 3D DIRECTION
+		// STEREOGRAPHIC DIRECTION TO 3D DIRECTION
+		// Note: not normalized, its length is 1 + r2.
+		OutputRowArray r2 = (sg_x * sg_x) + (sg_y * sg_y);
+		OutputRowArray dir_x = sg_x + sg_x;
+		const float dir_y = sg_y + sg_y;
+		OutputRowArray dir_z = r2 - 1;
 
-	// QUATERNION ROTATING VECTOR
-	OutputSizedFloatArray &rot_dir_x = mi.stack.get();
-	OutputSizedFloatArray &rot_dir_y = mi.stack.get();
-	OutputSizedFloatArray &rot_dir_z = mi.stack.get();
+		// QUATERNION ROTATING VECTOR
+		OutputRowArray uv0 = q.y() * dir_z - q.z() * dir_y;
+		OutputRowArray uv1 = q.z() * dir_x - q.x() * dir_z;
+		OutputRowArray uv2 = q.x() * dir_y - q.y() * dir_x;
 
-	OutputSizedFloatArray &uv0 = mi.stack.get();
-	OutputSizedFloatArray &uv1 = mi.stack.get();
-	OutputSizedFloatArray &uv2 = mi.stack.get();
+		uv0 += uv0;
+		uv1 += uv1;
+		uv2 += uv2;
 
-	const Eigen::Quaternionf &q = mi.instructions.rot_quat;
+		OutputRowArray rot_dir_x = dir_x + q.w() * uv0 + (q.y() * uv2 - q.z() * uv1);
+		OutputRowArray rot_dir_y = dir_y + q.w() * uv1 + (q.z() * uv0 - q.x() * uv2);
+		OutputRowArray rot_dir_z = dir_z + q.w() * uv2 + (q.x() * uv1 - q.y() * uv0);
 
-	uv0 = q.y() * dir_z - q.z() * dir_y;
-	uv1 = q.z() * dir_x - q.x() * dir_z;
-	uv2 = q.x() * dir_y - q.y() * dir_x;
+		// To stereographic coordinates around the camera's optical axis. The camera is +Z forward -Y up, and
+		// rotating doesn't change the length, so this is just a division.
+		OutputRowArray inv_denom = cells_per_unit / ((1 + r2) - rot_dir_z);
+		OutputRowArray cell_x = rot_dir_x * inv_denom + cell_center;
+		OutputRowArray cell_y = cell_center - rot_dir_y * inv_denom;
 
-	uv0 += uv0;
-	uv1 += uv1;
-	uv2 += uv2;
+		cv::Vec2s *row_xy = map_xy.ptr<cv::Vec2s>(y);
+		uint16_t *row_frac = map_frac.ptr<uint16_t>(y);
 
-	rot_dir_x = dir_x + q.w() * uv0;
-	rot_dir_y = dir_y + q.w() * uv1;
-	rot_dir_z = dir_z + q.w() * uv2;
+		for (int x = 0; x < wsize; ++x) {
+			float u = cell_x(x);
+			float v = cell_y(x);
 
-	rot_dir_x += q.y() * uv2 - q.z() * uv1;
-	rot_dir_y += q.z() * uv0 - q.x() * uv2;
-	rot_dir_z += q.x() * uv1 - q.y() * uv0;
-	// END QUATERNION ROTATING VECTOR
+			// Written so that NaNs, from directions straight behind the camera, are caught too.
+			bool valid = u >= 0 && u < N - 1 && v >= 0 && v < N - 1;
 
+			int ix = 0;
+			int iy = 0;
 
+			if (valid) {
+				int j = (int)u;
+				int i = (int)v;
+				float fu = u - j;
+				float fv = v - i;
 
-	OutputSizedFloatArray &image_x_f = mi.stack.get();
-	OutputSizedFloatArray &image_y_f = mi.stack.get();
+				const int32_t *top = &lut.xy[(i * N + j) * 2];
+				const int32_t *bottom = top + N * 2;
 
+				valid = top[0] != kInvalid && top[2] != kInvalid && //
+				        bottom[0] != kInvalid && bottom[2] != kInvalid;
 
-	//!@todo optimize
-	rot_dir_y *= -1;
-	rot_dir_z *= -1;
+				if (valid) {
+					float px = (1 - fv) * ((1 - fu) * top[0] + fu * top[2]) +
+					           fv * ((1 - fu) * bottom[0] + fu * bottom[2]);
+					float py = (1 - fv) * ((1 - fu) * top[1] + fu * top[3]) +
+					           fv * ((1 - fu) * bottom[1] + fu * bottom[3]);
 
-	{
-		XRT_TRACE_IDENT(camera_projection);
+					ix = (int)lrintf(px * scale_x + offset_x);
+					iy = (int)lrintf(py * scale_y + offset_y);
 
-		switch (mi.dist.model) {
-		case T_DISTORTION_FISHEYE_KB4:
-			// This takes 250us vs 500 because of the removed atan2.
-			project_kb4(mi, rot_dir_x, rot_dir_y, rot_dir_z, image_x_f, image_y_f);
-			break;
-		case T_DISTORTION_OPENCV_RADTAN_8:
-			// Regular C is plenty fast for radtan :)
-			for (int i = 0; i < image_x_f.rows(); i++) {
-				for (int j = 0; j < image_x_f.cols(); j++) {
-					t_camera_models_project(&mi.dist, rot_dir_x(i, j), rot_dir_y(i, j),
-					                        rot_dir_z(i, j), &image_x_f(i, j), &image_y_f(i, j));
+					valid = ix > -kTabSize && ix < max_x && iy > -kTabSize && iy < max_y;
 				}
 			}
-			break;
-		default: assert(false);
-		}
-	}
 
-	mi.image_x = image_x_f.cast<int16_t>();
-	mi.image_y = image_y_f.cast<int16_t>();
+			if (!valid) {
+				// All four taps are outside of the image, so this is the border color.
+				row_xy[x] = cv::Vec2s(-2, -2);
+				row_frac[x] = 0;
+				continue;
+			}
 
-	naive_remap(mi.image_x, mi.image_y, mi.input, mi.distorted_image_eigen);
+			row_xy[x] = cv::Vec2s((int16_t)(ix >> cv::INTER_BITS), (int16_t)(iy >> cv::INTER_BITS));
+			row_frac[x] = (uint16_t)((iy & (kTabSize - 1)) * kTabSize + (ix & (kTabSize - 1)));
+		}
+	}
 }
 
 
@@ -599,25 +556,30 @@ make_projection_instructions_angular(xrt_vec3 direction_3d,
 
 
 void
-stereographic_project_image(const t_camera_model_params &dist,
+stereographic_project_image(const stereographic_camera_lut &lut,
+                            const t_camera_model_params &dist,
                             const projection_instructions &instructions,
                             cv::Mat &input_image,
                             cv::Mat *debug_image,
                             const cv::Scalar boundary_color,
                             cv::Mat &out)
-
 {
-	out = cv::Mat(cv::Size(wsize, wsize), CV_8U);
-	projection_state *mi_ptr = new projection_state(instructions, input_image, out);
-	projection_state &mi = *mi_ptr;
+	XRT_TRACE_MARKER();
 
-	mi.dist = dist;
+	cv::Mat map_xy(wsize, wsize, CV_16SC2);
+	cv::Mat map_frac(wsize, wsize, CV_16UC1);
 
-	StereographicDistort(mi);
+	make_remap_maps(lut, dist, instructions, input_image.size(), map_xy, map_frac);
+
+	{
+		XRT_TRACE_IDENT(remap);
+		cv::remap(input_image, out, map_xy, map_frac, cv::INTER_LINEAR, cv::BORDER_CONSTANT, cv::Scalar(0));
+	}
 
 	if (debug_image) {
+		projection_state mi(instructions);
+		mi.dist = dist;
 		draw_boundary(mi, boundary_color, *debug_image);
 	}
-	delete mi_ptr;
 }
 } // namespace xrt::tracking::hand::mercury
@@ -13,6 +13,9 @@
 #include "hg_image_math.inl"
 #include "hg_numerics_checker.hpp"
 
+#include "os/os_time.h"
+#include "util/u_time.h"
+
 
 #include <filesystem>
 #include <array>
@@ -264,7 +267,7 @@ normalizeGrayscaleImage(cv::Mat &data_in, cv::Mat &data_out)
 }
 
 void
-setup_ort_api(HandTracking *hgt, onnx_wrap *wrap, std::filesystem::path path)
+setup_ort_api(HandTracking *hgt, onnx_wrap *wrap, std::filesystem::path path, int intra_op_threads)
 {
 	wrap->api = OrtGetApiBase()->GetApi(ORT_API_VERSION);
 	OrtSessionOptions *opts = nullptr;
@@ -272,7 +275,11 @@ setup_ort_api(HandTracking *hgt, onnx_wrap *wrap, std::filesystem::path path)
 	ORT(CreateSessionOptions(&opts));
 
 	ORT(SetSessionGraphOptimizationLevel(opts, ORT_ENABLE_ALL));
-	ORT(SetIntraOpNumThreads(opts, 1));
+	ORT(SetIntraOpNumThreads(opts, intra_op_threads));
+	if (intra_op_threads > 1) {
+		// We only run once per frame, don't keep the threads spinning in between.
+		ORT(AddSessionConfigEntry(opts, "session.intra_op.allow_spinning", "0"));
+	}
 
 	ORT(CreateEnv(ORT_LOGGING_LEVEL_FATAL, "monado_ht", &wrap->env));
 
@@ -283,102 +290,290 @@ setup_ort_api(HandTracking *hgt, onnx_wrap *wrap, std::filesystem::path path)
 	wrap->api->ReleaseSessionOptions(opts);
 }
 
-void
-setup_model_image_input(HandTracking *hgt, onnx_wrap *wrap, const char *name, int64_t w, int64_t h)
+// Shape the model declares for one of its inputs or outputs, dynamic dimensions are -1.
+static std::vector<int64_t>
+get_model_tensor_shape(HandTracking *hgt, onnx_wrap *wrap, bool is_output, const char *name)
 {
-	model_input_wrap inputimg = {};
-	inputimg.name = name;
-	inputimg.dimensions[0] = 1;
-	inputimg.dimensions[1] = 1;
-	inputimg.dimensions[2] = h;
-	inputimg.dimensions[3] = w;
-	inputimg.num_dimensions = 4;
-	size_t data_size = w * h * sizeof(float);
-	inputimg.data = (float *)malloc(data_size);
-
-	ORT(CreateTensorWithDataAsOrtValue(wrap->meminfo,                       //
-	                                   inputimg.data,                       //
-	                                   data_size,                           //
-	                                   inputimg.dimensions,                 //
-	                                   inputimg.num_dimensions,             //
-	                                   ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT, //
-	                                   &inputimg.tensor));
-
-	assert(inputimg.tensor);
-	int is_tensor;
-	ORT(IsTensor(inputimg.tensor, &is_tensor));
-	assert(is_tensor);
-
-	wrap->wraps.push_back(inputimg);
+	OrtAllocator *allocator = nullptr;
+	ORT(GetAllocatorWithDefaultOptions(&allocator));
+
+	size_t count = 0;
+	if (is_output) {
+		ORT(SessionGetOutputCount(wrap->session, &count));
+	} else {
+		ORT(SessionGetInputCount(wrap->session, &count));
+	}
+
+	std::vector<int64_t> shape;
+
+	for (size_t i = 0; i < count; i++) {
+		char *model_name = nullptr;
+		if (is_output) {
+			ORT(SessionGetOutputName(wrap->session, i, allocator, &model_name));
+		} else {
+			ORT(SessionGetInputName(wrap->session, i, allocator, &model_name));
+		}
+		bool found = strcmp(model_name, name) == 0;
+		ORT(AllocatorFree(allocator, model_name));
+
+		if (!found) {
+			continue;
+		}
+
+		OrtTypeInfo *type_info = nullptr;
+		if (is_output) {
+			ORT(SessionGetOutputTypeInfo(wrap->session, i, &type_info));
+		} else {
+			ORT(SessionGetInputTypeInfo(wrap->session, i, &type_info));
+		}
+
+		const OrtTensorTypeAndShapeInfo *tensor_info = nullptr;
+		ORT(CastTypeInfoToTensorInfo(type_info, &tensor_info));
+
+		size_t num_dimensions = 0;
+		ORT(GetDimensionsCount(tensor_info, &num_dimensions));
+		shape.resize(num_dimensions);
+		ORT(GetDimensions(tensor_info, shape.data(), num_dimensions));
+
+		wrap->api->ReleaseTypeInfo(type_info);
+		break;
+	}
+
+	if (shape.empty()) {
+		HG_ERROR(hgt, "Model has no %s named '%s'!", is_output ? "output" : "input", name);
+	}
+
+	return shape;
 }
 
-void
-init_hand_detection(HandTracking *hgt, onnx_wrap *wrap)
+static void
+setup_model_tensor(HandTracking *hgt, onnx_wrap *wrap, const char *name, bool is_output, model_tensor_wrap &out)
+{
+	std::vector<int64_t> shape = get_model_tensor_shape(hgt, wrap, is_output, name);
+	assert(!shape.empty() && shape.size() <= ARRAY_SIZE(out.dimensions));
+
+	out.name = name;
+	out.num_dimensions = shape.size();
+	out.item_size = 1;
+
+	// The first dimension is the batch, the others have to be fixed for us to allocate outputs up front.
+	for (size_t i = 1; i < shape.size(); i++) {
+		if (shape[i] <= 0) {
+			HG_ERROR(hgt, "Dimension %zu of '%s' is dynamic!", i, name);
+			assert(false);
+		}
+		out.dimensions[i] = shape[i];
+		out.item_size *= shape[i];
+	}
+
+	out.data = (float *)calloc(wrap->max_batch * out.item_size, sizeof(float));
+
+	for (int batch = 1; batch <= wrap->max_batch; batch++) {
+		OrtValue *&tensor = out.tensors[batch - 1];
+		out.dimensions[0] = batch;
+
+		ORT(CreateTensorWithDataAsOrtValue(wrap->meminfo,                         //
+		                                   out.data,                              //
+		                                   batch * out.item_size * sizeof(float), //
+		                                   out.dimensions,                        //
+		                                   out.num_dimensions,                    //
+		                                   ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT,   //
+		                                   &tensor));
+
+		assert(tensor);
+		int is_tensor;
+		ORT(IsTensor(tensor, &is_tensor));
+		assert(is_tensor);
+	}
+}
+
+static void
+setup_model_tensors(HandTracking *hgt,
+                    onnx_wrap *wrap,
+                    const std::vector<const char *> &input_names,
+                    const std::vector<const char *> &output_names)
+{
+	for (const char *name : input_names) {
+		model_tensor_wrap input = {};
+		setup_model_tensor(hgt, wrap, name, false, input);
+		wrap->inputs.push_back(input);
+	}
+
+	for (const char *name : output_names) {
+		model_tensor_wrap output = {};
+		setup_model_tensor(hgt, wrap, name, true, output);
+		wrap->outputs.push_back(output);
+	}
+
+	for (int batch = 1; batch <= wrap->max_batch; batch++) {
+		OrtIoBinding *&binding = wrap->bindings[batch - 1];
+		ORT(CreateIoBinding(wrap->session, &binding));
+
+		for (model_tensor_wrap &input : wrap->inputs) {
+			ORT(BindInput(binding, input.name, input.tensors[batch - 1]));
+		}
+		for (model_tensor_wrap &output : wrap->outputs) {
+			ORT(BindOutput(binding, output.name, output.tensors[batch - 1]));
+		}
+	}
+}
+
+static void
+init_batched_model(HandTracking *hgt,
+                   onnx_batched_wrap *model,
+                   const char *filename,
+                   int capacity,
+                   const std::vector<const char *> &input_names,
+                   const std::vector<const char *> &output_names)
 {
 	std::filesystem::path path = hgt->models_folder;
 
-	path /= "grayscale_detection_160x160.onnx";
+	path /= filename;
+
+	onnx_wrap *first = &model->sessions[0];
+	setup_ort_api(hgt, first, path, 1);
+
+	// Models exported before batching have their batch dimension fixed to one.
+	bool dynamic_batch = true;
+	for (const char *name : input_names) {
+		std::vector<int64_t> shape = get_model_tensor_shape(hgt, first, false, name);
+		dynamic_batch = dynamic_batch && !shape.empty() && shape[0] < 0;
+	}
+	for (const char *name : output_names) {
+		std::vector<int64_t> shape = get_model_tensor_shape(hgt, first, true, name);
+		dynamic_batch = dynamic_batch && !shape.empty() && shape[0] < 0;
+	}
 
-	wrap->wraps.clear();
+	if (dynamic_batch && capacity > 1) {
+		// One session now does the work of several, let it use as many threads.
+		release_onnx_wrap(first);
+		*first = {};
+		setup_ort_api(hgt, first, path, capacity);
+	}
 
-	setup_ort_api(hgt, wrap, path);
+	model->session_batch = dynamic_batch ? capacity : 1;
+	model->session_count = capacity / model->session_batch;
 
-	setup_model_image_input(hgt, wrap, "inputImg", kDetectionInputSize, kDetectionInputSize);
+	for (int i = 0; i < model->session_count; i++) {
+		onnx_wrap *wrap = &model->sessions[i];
+		if (i > 0) {
+			setup_ort_api(hgt, wrap, path, 1);
+		}
+		wrap->max_batch = model->session_batch;
+		setup_model_tensors(hgt, wrap, input_names, output_names);
+	}
+
+	HG_DEBUG(hgt, "Loaded '%s' as %d session(s) taking %d item(s) each", filename, model->session_count,
+	         model->session_batch);
 }
 
+// Data of one item of the batch.
+static inline float *
+model_input(onnx_batched_wrap *model, size_t input_idx, int batch_idx)
+{
+	model_tensor_wrap &input = model->sessions[batch_idx / model->session_batch].inputs[input_idx];
+	return input.data + (batch_idx % model->session_batch) * input.item_size;
+}
+
+static inline float *
+model_output(onnx_batched_wrap *model, size_t output_idx, int batch_idx)
+{
+	model_tensor_wrap &output = model->sessions[batch_idx / model->session_batch].outputs[output_idx];
+	return output.data + (batch_idx % model->session_batch) * output.item_size;
+}
+
+struct model_run_info
+{
+	HandTracking *hgt;
+	onnx_wrap *wrap;
+	int batch;
+};
+
+static void
+run_model_session(void *ptr)
+{
+	XRT_TRACE_MARKER();
+
+	model_run_info *info = (model_run_info *)ptr;
+	HandTracking *hgt = info->hgt;
+	onnx_wrap *wrap = info->wrap;
+
+	ORT(RunWithBinding(wrap->session, nullptr, wrap->bindings[info->batch - 1]));
+}
+
+// Runs the model on the first count items of the batch, returns how long that took.
+static uint64_t
+run_batched_model(HandTracking *hgt, onnx_batched_wrap *model, int count)
+{
+	XRT_TRACE_IDENT(model);
+
+	uint64_t start_ns = os_monotonic_get_ns();
+
+	model_run_info runs[kMaxModelBatch];
+	int run_count = 0;
+
+	for (int first = 0; first < count; first += model->session_batch) {
+		runs[run_count].hgt = hgt;
+		runs[run_count].wrap = &model->sessions[run_count];
+		runs[run_count].batch = std::min(model->session_batch, count - first);
+		run_count++;
+	}
+
+	if (run_count == 1) {
+		run_model_session(&runs[0]);
+	} else {
+		for (int i = 0; i < run_count; i++) {
+			u_worker_group_push(hgt->group, run_model_session, &runs[i]);
+		}
+		u_worker_group_wait_all(hgt->group);
+	}
+
+	return os_monotonic_get_ns() - start_ns;
+}
 
 void
-run_hand_detection(void *ptr)
+init_hand_detection(HandTracking *hgt, onnx_batched_wrap *model)
+{
+	// Two views.
+	init_batched_model(hgt, model, "grayscale_detection_160x160.onnx", 2, {"inputImg"},
+	                   {"hand_exists", "cx", "cy", "size"});
+}
+
+static void
+prepare_hand_detection(void *ptr)
 {
 	XRT_TRACE_MARKER();
 
 	hand_detection_run_info *info = (hand_detection_run_info *)ptr;
 	ht_view *view = info->view;
 	HandTracking *hgt = view->hgt;
-	onnx_wrap *wrap = &view->detection;
 
 	cv::Mat &orig_data = view->run_model_on_this;
 
-	cv::Mat binned_uint8;
-
 	xrt_size desired_bin_size;
 	desired_bin_size.h = kDetectionInputSize;
 	desired_bin_size.w = kDetectionInputSize;
 
-	cv::Matx23f go_back = blackbar(orig_data, view->camera_info.camera_orientation, binned_uint8, desired_bin_size);
+	info->go_back = blackbar(orig_data, view->camera_info.camera_orientation, info->binned_uint8, desired_bin_size);
 
 	cv::Mat binned_float_wrapper_mat(cv::Size(kDetectionInputSize, kDetectionInputSize),
-	                                 CV_32FC1,            //
-	                                 wrap->wraps[0].data, //
+	                                 CV_32FC1,                                         //
+	                                 model_input(&hgt->detection, 0, info->batch_idx), //
 	                                 kDetectionInputSize * sizeof(float));
 
-	normalizeGrayscaleImage(binned_uint8, binned_float_wrapper_mat);
-
-	const OrtValue *inputs[] = {wrap->wraps[0].tensor};
-	const char *input_names[] = {wrap->wraps[0].name};
-
-	OrtValue *output_tensors[] = {nullptr, nullptr, nullptr, nullptr};
-	const char *output_names[] = {"hand_exists", "cx", "cy", "size"};
-
-	{
-		XRT_TRACE_IDENT(model);
-		static_assert(ARRAY_SIZE(input_names) == ARRAY_SIZE(inputs));
-		static_assert(ARRAY_SIZE(output_names) == ARRAY_SIZE(output_tensors));
-		ORT(Run(wrap->session, nullptr, input_names, inputs, ARRAY_SIZE(input_names), output_names,
-		        ARRAY_SIZE(output_names), output_tensors));
-	}
-
-	float *hand_exists = nullptr;
-	float *cx = nullptr;
-	float *cy = nullptr;
-	float *sizee = nullptr;
-
-	ORT(GetTensorMutableData(output_tensors[0], (void **)&hand_exists));
-	ORT(GetTensorMutableData(output_tensors[1], (void **)&cx));
-	ORT(GetTensorMutableData(output_tensors[2], (void **)&cy));
-	ORT(GetTensorMutableData(output_tensors[3], (void **)&sizee));
+	normalizeGrayscaleImage(info->binned_uint8, binned_float_wrapper_mat);
+}
 
+static void
+interpret_hand_detection(HandTracking *hgt, hand_detection_run_info *info)
+{
+	ht_view *view = info->view;
+	cv::Matx23f &go_back = info->go_back;
 
+	float *hand_exists = model_output(&hgt->detection, 0, info->batch_idx);
+	float *cx = model_output(&hgt->detection, 1, info->batch_idx);
+	float *cy = model_output(&hgt->detection, 2, info->batch_idx);
+	float *sizee = model_output(&hgt->detection, 3, info->batch_idx);
 
 	for (int hand_idx = 0; hand_idx < 2; hand_idx++) {
 		hand_region_of_interest &output = info->outputs[hand_idx];
@@ -420,131 +615,47 @@ run_hand_detection(void *ptr)
 			int start_y = top_of_rect_y + ((kDetectionInputSize + kVisSpacerSize) * view->view);
 			cv::Rect p = cv::Rect(left_of_rect_x, start_y, kDetectionInputSize, kDetectionInputSize);
 
-			binned_uint8.copyTo(hgt->visualizers.mat(p));
+			info->binned_uint8.copyTo(hgt->visualizers.mat(p));
 		}
 	}
-
-	for (size_t i = 0; i < ARRAY_SIZE(output_tensors); i++) {
-		wrap->api->ReleaseValue(output_tensors[i]);
-	}
 }
 
 void
-init_keypoint_estimation(HandTracking *hgt, onnx_wrap *wrap)
+run_hand_detection(HandTracking *hgt, hand_detection_run_info **infos, int count)
 {
+	XRT_TRACE_MARKER();
 
-	std::filesystem::path path = hgt->models_folder;
-
-	path /= "grayscale_keypoint_jan18.onnx";
-
-	wrap->wraps.clear();
-
-
-	wrap->api = OrtGetApiBase()->GetApi(ORT_API_VERSION);
-
-
-	OrtSessionOptions *opts = nullptr;
-	ORT(CreateSessionOptions(&opts));
-
-	// TODO review options, config for threads?
-	ORT(SetSessionGraphOptimizationLevel(opts, ORT_ENABLE_ALL));
-	ORT(SetIntraOpNumThreads(opts, 1));
-
-
-	ORT(CreateEnv(ORT_LOGGING_LEVEL_FATAL, "monado_ht", &wrap->env));
-
-	ORT(CreateCpuMemoryInfo(OrtArenaAllocator, OrtMemTypeDefault, &wrap->meminfo));
-
-	// HG_DEBUG(this->device, "Loading hand detection model from file '%s'", path.c_str());
-	ORT(CreateSession(wrap->env, path.c_str(), opts, &wrap->session));
-	assert(wrap->session != NULL);
-
-	// size_t input_size = wrap->input_shape[0] * wrap->input_shape[1] * wrap->input_shape[2] *
-	// wrap->input_shape[3];
-
-	// wrap->data = (float *)malloc(input_size * sizeof(float));
-	{
-		model_input_wrap inputimg = {};
-		inputimg.name = "inputImg";
-		inputimg.dimensions[0] = 1;
-		inputimg.dimensions[1] = 1;
-		inputimg.dimensions[2] = 128;
-		inputimg.dimensions[3] = 128;
-		inputimg.num_dimensions = 4;
-
-		inputimg.data = (float *)malloc(128 * 128 * sizeof(float)); // SORRY IM BUSY
-
-
-
-		ORT(CreateTensorWithDataAsOrtValue(wrap->meminfo,                       //
-		                                   inputimg.data,                       //
-		                                   128 * 128 * sizeof(float),           //
-		                                   inputimg.dimensions,                 //
-		                                   inputimg.num_dimensions,             //
-		                                   ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT, //
-		                                   &inputimg.tensor));
-
-		assert(inputimg.tensor);
-		int is_tensor;
-		ORT(IsTensor(inputimg.tensor, &is_tensor));
-		assert(is_tensor);
+	assert(count > 0 && count <= 2);
 
-		wrap->wraps.push_back(inputimg);
+	for (int i = 0; i < count; i++) {
+		infos[i]->batch_idx = i;
 	}
 
-	{
-		model_input_wrap inputimg = {};
-		inputimg.name = "lastKeypoints";
-		inputimg.dimensions[0] = 1;
-		inputimg.dimensions[1] = 42;
-		inputimg.num_dimensions = 2;
-
-		inputimg.data = (float *)malloc(1 * 42 * sizeof(float)); // SORRY IM BUSY
-
-
-
-		ORT(CreateTensorWithDataAsOrtValue(wrap->meminfo,                       //
-		                                   inputimg.data,                       //
-		                                   1 * 42 * sizeof(float),              //
-		                                   inputimg.dimensions,                 //
-		                                   inputimg.num_dimensions,             //
-		                                   ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT, //
-		                                   &inputimg.tensor));
-
-		assert(inputimg.tensor);
-		int is_tensor;
-		ORT(IsTensor(inputimg.tensor, &is_tensor));
-		assert(is_tensor);
-		wrap->wraps.push_back(inputimg);
+	if (count == 1) {
+		prepare_hand_detection(infos[0]);
+	} else {
+		for (int i = 0; i < count; i++) {
+			u_worker_group_push(hgt->group, prepare_hand_detection, infos[i]);
+		}
+		u_worker_group_wait_all(hgt->group);
 	}
 
-	{
-		model_input_wrap inputimg = {};
-		inputimg.name = "useLastKeypoints";
-		inputimg.dimensions[0] = 1;
-		inputimg.num_dimensions = 1;
-
-		inputimg.data = (float *)malloc(1 * sizeof(float)); // SORRY IM BUSY
-
+	uint64_t model_ns = run_batched_model(hgt, &hgt->detection, count);
+	hgt->tuneable_values.detection_model_ms = time_ns_to_ms_f(model_ns);
+	hgt->tuneable_values.detection_batch_size = count;
 
-
-		ORT(CreateTensorWithDataAsOrtValue(wrap->meminfo,                       //
-		                                   inputimg.data,                       //
-		                                   1 * sizeof(float),                   //
-		                                   inputimg.dimensions,                 //
-		                                   inputimg.num_dimensions,             //
-		                                   ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT, //
-		                                   &inputimg.tensor));
-
-		assert(inputimg.tensor);
-		int is_tensor;
-		ORT(IsTensor(inputimg.tensor, &is_tensor));
-		assert(is_tensor);
-		wrap->wraps.push_back(inputimg);
+	for (int i = 0; i < count; i++) {
+		interpret_hand_detection(hgt, infos[i]);
 	}
+}
 
-
-	wrap->api->ReleaseSessionOptions(opts);
+void
+init_keypoint_estimation(HandTracking *hgt, onnx_batched_wrap *model)
+{
+	// Two hands in two views.
+	init_batched_model(hgt, model, "grayscale_keypoint_jan18.onnx", kMaxModelBatch,
+	                   {"inputImg", "lastKeypoints", "useLastKeypoints"},
+	                   {"heatmap_xy", "heatmap_depth", "scalar_extras", "curls"});
 }
 
 enum xrt_hand_joint joints_ml_to_xr[21]{
@@ -633,24 +744,25 @@ set_predicted_zero(float *data)
 	}
 }
 
-void
-run_keypoint_estimation(void *ptr)
+static void
+prepare_keypoint_estimation(void *ptr)
 {
 	XRT_TRACE_MARKER();
-	keypoint_estimation_run_info info = *(keypoint_estimation_run_info *)ptr;
+	keypoint_estimation_run_info &info = *(keypoint_estimation_run_info *)ptr;
 
-	onnx_wrap *wrap = &info.view->keypoint[info.hand_idx];
 	struct HandTracking *hgt = info.view->hgt;
 
 	int view_idx = info.view->view;
 	int hand_idx = info.hand_idx;
 	one_frame_one_view &this_output = hgt->keypoint_outputs[hand_idx].views[view_idx];
-	MLOutput2D &px_coord = this_output.keypoints_in_scaled_stereographic;
-	// Factor out starting here
+
+	float *input_img = model_input(&hgt->keypoint, 0, info.batch_idx);
+	float *input_last_keypoints = model_input(&hgt->keypoint, 1, info.batch_idx);
+	float *input_use_last_keypoints = model_input(&hgt->keypoint, 2, info.batch_idx);
 
 	hand_region_of_interest &output = info.view->regions_of_interest_this_frame[hand_idx];
 
-	cv::Mat data_128x128_uint8;
+	cv::Mat &data_128x128_uint8 = info.data_128x128_uint8;
 
 	projection_instructions instr(info.view->hgdist);
 	instr.rot_quat = Eigen::Quaternionf::Identity();
@@ -709,8 +821,8 @@ run_keypoint_estimation(void *ptr)
 		make_projection_instructions_angular(center, hand_idx, angle,
 		                                     hgt->tuneable_values.after_detection_fac.val, twist, instr);
 
-		wrap->wraps[2].data[0] = 0.0f;
-		set_predicted_zero(wrap->wraps[1].data);
+		input_use_last_keypoints[0] = 0.0f;
+		set_predicted_zero(input_last_keypoints);
 	} else {
 		Eigen::Array<float, 3, 21> keypoints_in_camera;
 
@@ -736,21 +848,21 @@ run_keypoint_estimation(void *ptr)
 
 		if (hgt->tuneable_values.enable_pose_predicted_input) {
 			for (int ml_joint_idx = 0; ml_joint_idx < 21; ml_joint_idx++) {
-				float *data = wrap->wraps[1].data;
+				float *data = input_last_keypoints;
 				data[(ml_joint_idx * 2) + 0] = bleh[ml_joint_idx].pos_2d.x;
 				data[(ml_joint_idx * 2) + 1] = bleh[ml_joint_idx].pos_2d.y;
 				// data[(ml_joint_idx * 2) + 2] = bleh[ml_joint_idx].depth_relative_to_midpxm;
 			}
 
 
-			wrap->wraps[2].data[0] = 1.0f;
+			input_use_last_keypoints[0] = 1.0f;
 		} else {
-			wrap->wraps[2].data[0] = 0.0f;
-			set_predicted_zero(wrap->wraps[1].data);
+			input_use_last_keypoints[0] = 0.0f;
+			set_predicted_zero(input_last_keypoints);
 		}
 	}
 
-	stereographic_project_image(dist, instr, hgt->views[view_idx].run_model_on_this,
+	stereographic_project_image(info.view->camera_lut, dist, instr, hgt->views[view_idx].run_model_on_this,
 	                            &hgt->views[view_idx].debug_out_to_this, info.hand_idx ? RED : YELLOW,
 	                            data_128x128_uint8);
 
@@ -758,44 +870,29 @@ run_keypoint_estimation(void *ptr)
 	xrt::auxiliary::math::map_quat(this_output.look_dir) = instr.rot_quat;
 	this_output.stereographic_radius = instr.stereographic_radius;
 
-	bool is_hand = true;
-
 	{
 		XRT_TRACE_IDENT(convert_format);
 
-		// here!
-		cv::Mat data_128x128_float(cv::Size(128, 128), CV_32FC1, wrap->wraps[0].data, 128 * sizeof(float));
+		cv::Mat data_128x128_float(cv::Size(128, 128), CV_32FC1, input_img, 128 * sizeof(float));
 
-		is_hand = is_hand && normalizeGrayscaleImage(data_128x128_uint8, data_128x128_float);
+		info.is_hand = normalizeGrayscaleImage(data_128x128_uint8, data_128x128_float);
 	}
+}
 
+static void
+interpret_keypoint_estimation(HandTracking *hgt, keypoint_estimation_run_info &info)
+{
+	int view_idx = info.view->view;
+	int hand_idx = info.hand_idx;
+	one_frame_one_view &this_output = hgt->keypoint_outputs[hand_idx].views[view_idx];
+	MLOutput2D &px_coord = this_output.keypoints_in_scaled_stereographic;
 
-	// Ending here
-
-
-	const OrtValue *inputs[] = {wrap->wraps[0].tensor, wrap->wraps[1].tensor, wrap->wraps[2].tensor};
-	const char *input_names[] = {wrap->wraps[0].name, wrap->wraps[1].name, wrap->wraps[2].name};
-
-	OrtValue *output_tensors[] = {nullptr, nullptr, nullptr, nullptr};
-	const char *output_names[] = {"heatmap_xy", "heatmap_depth", "scalar_extras", "curls"};
-
-	{
-		XRT_TRACE_IDENT(model);
-		assert(ARRAY_SIZE(input_names) == ARRAY_SIZE(inputs));
-		assert(ARRAY_SIZE(output_names) == ARRAY_SIZE(output_tensors));
-		ORT(Run(wrap->session, nullptr, input_names, inputs, ARRAY_SIZE(input_names), output_names,
-		        ARRAY_SIZE(output_names), output_tensors));
-	}
-
-	// To here
+	bool is_hand = info.is_hand;
 
 	// Interpret model outputs!
 
 
-	float *out_data = nullptr;
-
-
-	ORT(GetTensorMutableData(output_tensors[0], (void **)&out_data));
+	float *out_data = model_output(&hgt->keypoint, 0, info.batch_idx);
 
 	// I don't know why this was added
 	// float *confidences = info.view->keypoint_outputs.views[hand_idx].confidences;
@@ -839,8 +936,7 @@ run_keypoint_estimation(void *ptr)
 	}
 
 
-	float *out_data_depth = nullptr;
-	ORT(GetTensorMutableData(output_tensors[1], (void **)&out_data_depth));
+	float *out_data_depth = model_output(&hgt->keypoint, 1, info.batch_idx);
 
 	for (int joint_idx = 0; joint_idx < 21; joint_idx++) {
 		float *p_ptr = &out_data_depth[(joint_idx * 22)];
@@ -860,8 +956,7 @@ run_keypoint_estimation(void *ptr)
 		}
 	}
 
-	float *out_data_extras = nullptr;
-	ORT(GetTensorMutableData(output_tensors[2], (void **)&out_data_extras));
+	float *out_data_extras = model_output(&hgt->keypoint, 2, info.batch_idx);
 
 	float is_hand_explicit = out_data_extras[0];
 
@@ -878,8 +973,7 @@ run_keypoint_estimation(void *ptr)
 	this_output.active = is_hand;
 
 
-	float *out_data_curls = nullptr;
-	ORT(GetTensorMutableData(output_tensors[3], (void **)&out_data_curls));
+	float *out_data_curls = model_output(&hgt->keypoint, 3, info.batch_idx);
 
 	for (int i = 0; i < 5; i++) {
 		float curl = out_data_curls[i];
@@ -905,7 +999,7 @@ run_keypoint_estimation(void *ptr)
 
 		cv::Rect p = cv::Rect(root_x, root_y, 128, 128);
 
-		data_128x128_uint8.copyTo(hgt->visualizers.mat(p));
+		info.data_128x128_uint8.copyTo(hgt->visualizers.mat(p));
 
 		make_keypoint_heatmap_output(info.view->view, hand_idx, 0, 0, out_data + (data_acc_idx * plane_size),
 		                             hgt->visualizers.mat);
@@ -965,22 +1059,76 @@ run_keypoint_estimation(void *ptr)
 			cv::line(hgt->visualizers.mat, center, pt2, {0}, 1);
 		}
 	}
+}
 
-	for (size_t i = 0; i < ARRAY_SIZE(output_tensors); i++) {
-		wrap->api->ReleaseValue(output_tensors[i]);
+void
+run_keypoint_estimation(HandTracking *hgt, keypoint_estimation_run_info **infos, int count)
+{
+	XRT_TRACE_MARKER();
+
+	assert(count <= kMaxModelBatch);
+
+	hgt->tuneable_values.keypoint_batch_size = count;
+
+	if (count == 0) {
+		hgt->tuneable_values.keypoint_prepare_ms = 0;
+		hgt->tuneable_values.keypoint_model_ms = 0;
+		return;
+	}
+
+	for (int i = 0; i < count; i++) {
+		infos[i]->batch_idx = i;
+	}
+
+	uint64_t prepare_start_ns = os_monotonic_get_ns();
+	if (count == 1) {
+		prepare_keypoint_estimation(infos[0]);
+	} else {
+		for (int i = 0; i < count; i++) {
+			u_worker_group_push(hgt->group, prepare_keypoint_estimation, infos[i]);
+		}
+		u_worker_group_wait_all(hgt->group);
+	}
+	hgt->tuneable_values.keypoint_prepare_ms = time_ns_to_ms_f(os_monotonic_get_ns() - prepare_start_ns);
+
+	uint64_t model_ns = run_batched_model(hgt, &hgt->keypoint, count);
+	hgt->tuneable_values.keypoint_model_ms = time_ns_to_ms_f(model_ns);
+
+	for (int i = 0; i < count; i++) {
+		interpret_keypoint_estimation(hgt, *infos[i]);
 	}
 }
 
 void
 release_onnx_wrap(onnx_wrap *wrap)
 {
+	for (OrtIoBinding *binding : wrap->bindings) {
+		if (binding != nullptr) {
+			wrap->api->ReleaseIoBinding(binding);
+		}
+	}
+	for (std::vector<model_tensor_wrap> *tensors : {&wrap->inputs, &wrap->outputs}) {
+		for (model_tensor_wrap &a : *tensors) {
+			for (OrtValue *tensor : a.tensors) {
+				if (tensor != nullptr) {
+					wrap->api->ReleaseValue(tensor);
+				}
+			}
+			free(a.data);
+		}
+	}
 	wrap->api->ReleaseMemoryInfo(wrap->meminfo);
 	wrap->api->ReleaseSession(wrap->session);
-	for (model_input_wrap &a : wrap->wraps) {
-		wrap->api->ReleaseValue(a.tensor);
-		free(a.data);
-	}
 	wrap->api->ReleaseEnv(wrap->env);
 }
 
+void
+release_onnx_batched_wrap(onnx_batched_wrap *model)
+{
+	for (int i = 0; i < model->session_count; i++) {
+		release_onnx_wrap(&model->sessions[i]);
+	}
+	model->session_count = 0;
+}
+
 } // namespace xrt::tracking::hand::mercury
@@ -19,6 +19,8 @@
 #include "xrt/xrt_defines.h"
 #include "xrt/xrt_frame.h"
 #include "xrt/xrt_tracking.h"
+#include "os/os_time.h"
+#include "util/u_time.h"
 
 
 #include <numeric>
@@ -30,6 +32,7 @@ namespace xrt::tracking::hand::mercury {
 DEBUG_GET_ONCE_LOG_OPTION(mercury_log, "MERCURY_LOG", U_LOGGING_WARN)
 DEBUG_GET_ONCE_BOOL_OPTION(mercury_optimize_hand_size, "MERCURY_optimize_hand_size", true)
 DEBUG_GET_ONCE_FLOAT_OPTION(mercury_min_detection_confidence, "MERCURY_MIN_DETECTION_CONFIDENCE", 0.3)
+DEBUG_GET_ONCE_BOOL_OPTION(mercury_pipelined, "MERCURY_PIPELINED", false)
 
 // Flags to tell state tracker that these are indeed valid joints
 static const enum xrt_space_relation_flags valid_flags_ht = (enum xrt_space_relation_flags)(
@@ -103,6 +106,9 @@ getCalibration(struct HandTracking *hgt, t_stereo_camera_calibration &calibratio
 		t_camera_model_params_from_t_camera_calibration(&calibration.view[view_idx], &view.hgdist_orig);
 
 		view.hgdist = view.hgdist_orig;
+
+		make_stereographic_camera_lut(view.hgdist_orig, calibration.view[view_idx].image_size_pixels,
+		                              view.camera_lut);
 	}
 
 	//!@todo Really? We can totally support cameras with varying resolutions.
@@ -155,12 +161,13 @@ static void
 back_project(struct HandTracking *hgt,        //
              Eigen::Array<float, 3, 21> &pts, //
              int hand_idx,                    //
-             bool also_debug_output,          //
+             cv::Mat *debug_views,            // Left and right view to scribble into, or NULL.
              int num_outside[2])
 {
+	bool also_debug_output = debug_views != NULL;
 
 	for (int view_idx = 0; view_idx < 2; view_idx++) {
-		cv::Mat debug = hgt->views[view_idx].debug_out_to_this;
+		cv::Mat debug = also_debug_output ? debug_views[view_idx] : cv::Mat();
 		xrt_pose move_amount = {};
 
 		if (view_idx == 0) {
@@ -250,14 +257,12 @@ back_project(struct HandTracking *hgt,        //
 }
 
 static void
-back_project_keypoint_output(struct HandTracking *hgt, //
-                             int hand_idx,             //
-                             int view_idx)
+back_project_keypoint_output(struct HandTracking *hgt,        //
+                             const one_frame_one_view &view, //
+                             int view_idx,                   //
+                             cv::Mat &debug)
 {
 
-	cv::Mat debug = hgt->views[view_idx].debug_out_to_this;
-	one_frame_one_view &view = hgt->keypoint_outputs[hand_idx].views[view_idx];
-
 	for (int i = 0; i < 21; i++) {
 
 		//!@todo We're trivially rewriting the stereographic projection for like the 2nd or 3rd time here. We
@@ -353,11 +358,11 @@ check_new_user_event(struct HandTracking *hgt)
 {
 	if (hgt->tuneable_values.new_user_event) {
 		hgt->tuneable_values.new_user_event = false;
-		hgt->hand_seen_before[0] = false;
-		hgt->hand_seen_before[1] = false;
-		hgt->refinement.hand_size_refinement_schedule_x = 0;
-		hgt->refinement.optimizing = true;
-		hgt->target_hand_size = STANDARD_HAND_SIZE;
+		hgt->opt_state.hand_seen_before[0] = false;
+		hgt->opt_state.hand_seen_before[1] = false;
+		hgt->opt_state.refinement.hand_size_refinement_schedule_x = 0;
+		hgt->opt_state.refinement.optimizing = true;
+		hgt->opt_state.target_hand_size = STANDARD_HAND_SIZE;
 	}
 }
 
@@ -379,11 +384,9 @@ void
 dispatch_and_process_hand_detections(struct HandTracking *hgt)
 {
 	if (hgt->tuneable_values.always_run_detection_model) {
-		// Pretend like nothing was detected last frame.
+		// Pretend like nothing was detected last frame, the optimizer clears its history.
 		for (int hand_idx = 0; hand_idx < 2; hand_idx++) {
 			hgt->this_frame_hand_detected[hand_idx] = false;
-
-			hgt->history_hands[hand_idx].clear();
 		}
 	}
 
@@ -411,15 +414,15 @@ dispatch_and_process_hand_detections(struct HandTracking *hgt)
 
 	int num_views = 0;
 
-	if (hgt->tuneable_values.always_run_detection_model || hgt->refinement.optimizing ||
+	if (hgt->tuneable_values.always_run_detection_model || hgt->opt_published.refinement.optimizing ||
 	    hgt->tuneable_values.detection_model_in_both_views) {
-		u_worker_group_push(hgt->group, run_hand_detection, &infos[0]);
-		u_worker_group_push(hgt->group, run_hand_detection, &infos[1]);
+		hand_detection_run_info *run_infos[2] = {&infos[0], &infos[1]};
 		num_views = 2;
-		u_worker_group_wait_all(hgt->group);
+		run_hand_detection(hgt, run_infos, num_views);
 	} else {
-		run_hand_detection(&infos[active_camera]);
+		hand_detection_run_info *run_infos[1] = {&infos[active_camera]};
 		num_views = 1;
+		run_hand_detection(hgt, run_infos, num_views);
 	}
 
 
@@ -432,7 +435,8 @@ dispatch_and_process_hand_detections(struct HandTracking *hgt)
 		}
 
 
-		if (hgt->tuneable_values.always_run_detection_model || !hgt->last_frame_hand_detected[hand_idx]) {
+		if (hgt->tuneable_values.always_run_detection_model ||
+		    !hgt->opt_published.last_frame_hand_detected[hand_idx]) {
 
 
 			bool good_to_go = true;
@@ -506,11 +510,12 @@ hand_joint_set_to_eigen_21(const xrt_hand_joint_set &set, Eigen::Array<float, 3,
 	}
 }
 
-// Most of the time, this codepath runs - we predict where the hand should be based on the last
+// Most of the time, this codepath runs - we predict where the hand should be at time_now based on the last
 // two frames.
 void
-predict_new_regions_of_interest(struct HandTracking *hgt)
+predict_new_regions_of_interest(struct HandTracking *hgt, uint64_t time_now)
 {
+	const optimizer_state &st = hgt->opt_published;
 
 	xrt_hand_masks_sample masks{}; // Zero initialization
 
@@ -519,21 +524,20 @@ predict_new_regions_of_interest(struct HandTracking *hgt)
 		// If we only have *one* frame, we just reuse the same bounding box and hope the hand
 		// hasn't moved too much. @todo
 
-		auto &hh = hgt->history_hands[hand_idx];
+		auto &hh = st.history_hands[hand_idx];
 
 
 		if (hh.size() < 2) {
-			HG_TRACE(hgt, "continuing, size is %zu", hgt->history_hands[hand_idx].size());
+			HG_TRACE(hgt, "continuing, size is %zu", hh.size());
 			continue;
 		}
 
 		// We can only do this *after* we know we're predicting - this would otherwise overwrite the detection
 		// model.
-		hgt->this_frame_hand_detected[hand_idx] = hgt->last_frame_hand_detected[hand_idx];
+		hgt->this_frame_hand_detected[hand_idx] = st.last_frame_hand_detected[hand_idx];
 
-		uint64_t time_two_frames_ago = *hgt->history_timestamps.get_at_age(1);
-		uint64_t time_one_frame_ago = *hgt->history_timestamps.get_at_age(0);
-		uint64_t time_now = hgt->current_frame_timestamp;
+		uint64_t time_two_frames_ago = *st.history_timestamps.get_at_age(1);
+		uint64_t time_one_frame_ago = *st.history_timestamps.get_at_age(0);
 
 
 
@@ -543,8 +547,8 @@ predict_new_regions_of_interest(struct HandTracking *hgt)
 		double dt_now = time_ns_to_s(time_now - time_one_frame_ago);
 
 
-		Eigen::Array<float, 3, 21> &n_minus_two = *hh.get_at_age(1);
-		Eigen::Array<float, 3, 21> &n_minus_one = *hh.get_at_age(0);
+		const Eigen::Array<float, 3, 21> &n_minus_two = *hh.get_at_age(1);
+		const Eigen::Array<float, 3, 21> &n_minus_one = *hh.get_at_age(0);
 
 
 		Eigen::Array<float, 3, 21> add;
@@ -556,9 +560,11 @@ predict_new_regions_of_interest(struct HandTracking *hgt)
 		hgt->pose_predicted_keypoints[hand_idx] = n_minus_one + add;
 
 
+		cv::Mat debug_views[2] = {hgt->views[0].debug_out_to_this, hgt->views[1].debug_out_to_this};
+		bool scribble = hgt->tuneable_values.scribble_predictions_into_next_frame && hgt->debug_scribble;
+
 		int num_outside[2];
-		back_project(hgt, hgt->pose_predicted_keypoints[hand_idx], hand_idx,
-		             hgt->tuneable_values.scribble_predictions_into_next_frame && hgt->debug_scribble,
+		back_project(hgt, hgt->pose_predicted_keypoints[hand_idx], hand_idx, scribble ? debug_views : NULL,
 		             num_outside);
 
 		for (int view_idx = 0; view_idx < 2; view_idx++) {
@@ -656,6 +662,285 @@ scribble_image_boundary(struct HandTracking *hgt)
 	}
 }
 
+/*
+ *
+ * Optimizer stage.
+ *
+ */
+
+// Runs the kinematic optimizer on one frame's keypoints. Only touches the job and opt_state, so in pipelined mode it
+// can run on optimizer_group while the models run on the next frame.
+static void
+run_optimizer(void *ptr)
+{
+	XRT_TRACE_MARKER();
+
+	struct optimizer_job *job = (struct optimizer_job *)ptr;
+	HandTracking *hgt = job->hgt;
+	optimizer_state &st = hgt->opt_state;
+
+	job->optimizer_ms = 0;
+	job->optimizer_count = 0;
+
+	if (job->clear_history) {
+		st.history_hands[0].clear();
+		st.history_hands[1].clear();
+	}
+
+	// Spaghetti logic for optimizing hand size
+	bool any_hands_are_only_visible_in_one_view = false;
+
+	for (int hand_idx = 0; hand_idx < 2; hand_idx++) {
+		any_hands_are_only_visible_in_one_view =      //
+		    any_hands_are_only_visible_in_one_view || //
+		    (job->roi_found[0][hand_idx] != job->roi_found[1][hand_idx]);
+	}
+
+	constexpr float mul_max = 1.0;
+	constexpr float frame_max = 100;
+	bool optimize_hand_size;
+
+	if ((st.refinement.hand_size_refinement_schedule_x > frame_max)) {
+		st.refinement.hand_size_refinement_schedule_y = mul_max;
+		optimize_hand_size = false;
+		st.refinement.optimizing = false;
+	} else {
+		st.refinement.hand_size_refinement_schedule_y =
+		    powf((st.refinement.hand_size_refinement_schedule_x / frame_max), 2) * mul_max;
+		optimize_hand_size = true;
+		st.refinement.optimizing = true;
+	}
+
+	if (any_hands_are_only_visible_in_one_view) {
+		optimize_hand_size = false;
+	}
+
+
+	// if either hand was not visible before the last new-user event but is visible now, reset the schedule
+	// a bit.
+	if ((job->hand_detected[0] && !st.hand_seen_before[0]) || (job->hand_detected[1] && !st.hand_seen_before[1])) {
+		st.refinement.hand_size_refinement_schedule_x =
+		    std::min(st.refinement.hand_size_refinement_schedule_x, frame_max / 2);
+	}
+
+	optimize_hand_size = optimize_hand_size && hgt->tuneable_values.optimize_hand_size;
+
+	int num_hands = 0;
+	float avg_hand_size = 0;
+
+	// Dispatch the optimizers!
+	for (int hand_idx = 0; hand_idx < 2; hand_idx++) {
+		one_frame_input &keypoint_output = job->keypoint_outputs[hand_idx];
+
+		for (int view_idx = 0; view_idx < 2; view_idx++) {
+			if (!job->roi_found[view_idx][hand_idx]) {
+				// to the next view
+				continue;
+			}
+
+			if (!keypoint_output.views[view_idx].active) {
+				HG_DEBUG(hgt, "Removing hand %d because keypoint estimator said to!", hand_idx);
+				job->hand_detected[hand_idx] = false;
+			}
+		}
+
+		if (!job->hand_detected[hand_idx]) {
+			continue;
+		}
+
+
+		for (int view = 0; view < 2; view++) {
+			if (!job->roi_found[view][hand_idx]) {
+				keypoint_output.views[view].active = false;
+			}
+		}
+
+		if (hgt->tuneable_values.scribble_keypoint_model_outputs && job->debug_scribble) {
+			for (int view_idx = 0; view_idx < 2; view_idx++) {
+
+				if (!keypoint_output.views[view_idx].active) {
+					continue;
+				}
+
+				back_project_keypoint_output(hgt, keypoint_output.views[view_idx], view_idx,
+				                             job->debug_views[view_idx]);
+			}
+		}
+
+		struct xrt_hand_joint_set *put_in_set = &job->hands[hand_idx];
+
+		lm::KinematicHandLM *hand = hgt->kinematic_hands[hand_idx];
+
+		float reprojection_error_threshold = hgt->tuneable_values.max_reprojection_error.val;
+		float smoothing_factor = hgt->tuneable_values.opt_smooth_factor.val;
+
+		if (st.last_frame_hand_detected[hand_idx]) {
+			if (hgt->tuneable_values.enable_framerate_based_smoothing) {
+				int64_t one_before = *st.history_timestamps.get_at_age(0);
+				int64_t now = job->timestamp;
+
+				uint64_t diff = now - one_before;
+				double diff_d = time_ns_to_s(diff);
+				smoothing_factor = hgt->tuneable_values.opt_smooth_factor.val * (1 / 60.0f) / diff_d;
+			}
+		} else {
+			reprojection_error_threshold = hgt->tuneable_values.max_reprojection_error.val;
+		}
+
+
+
+		float out_hand_size;
+
+		//!@todo optimize: We can have one of these on each thread
+		float reprojection_error;
+		uint64_t optimizer_start_ns = os_monotonic_get_ns();
+		lm::optimizer_run(hand,                                   //
+		                  keypoint_output,                        //
+		                  !st.last_frame_hand_detected[hand_idx], //
+		                  smoothing_factor,
+		                  optimize_hand_size,                            //
+		                  st.target_hand_size,                           //
+		                  st.refinement.hand_size_refinement_schedule_y, //
+		                  hgt->tuneable_values.amt_use_depth.val,
+		                  *put_in_set,   //
+		                  out_hand_size, //
+		                  reprojection_error);
+		job->optimizer_ms += time_ns_to_ms_f(os_monotonic_get_ns() - optimizer_start_ns);
+		job->optimizer_count++;
+
+
+
+		if (reprojection_error > reprojection_error_threshold) {
+			HG_DEBUG(hgt, "Reprojection error above threshold!");
+			job->hand_detected[hand_idx] = false;
+			continue;
+		}
+
+		if (hand_too_far(hgt, *put_in_set)) {
+			HG_DEBUG(hgt, "Hand too far away");
+			job->hand_detected[hand_idx] = false;
+			continue;
+		}
+
+
+		avg_hand_size += out_hand_size;
+		num_hands++;
+
+		if (!any_hands_are_only_visible_in_one_view) {
+			st.refinement.hand_size_refinement_schedule_x +=
+			    hand_confidence_value(reprojection_error, keypoint_output);
+		}
+
+		u_hand_joints_apply_joint_width(put_in_set);
+
+
+
+		put_in_set->hand_pose.pose = hgt->hand_pose_camera_offset;
+		put_in_set->hand_pose.relation_flags = valid_flags_ht;
+
+		Eigen::Array<float, 3, 21> asf = {};
+
+
+
+		hand_joint_set_to_eigen_21(*put_in_set, asf);
+
+		bool scribble = hgt->tuneable_values.scribble_optimizer_outputs && job->debug_scribble;
+
+		back_project(hgt,                                //
+		             asf,                                //
+		             hand_idx,                           //
+		             scribble ? job->debug_views : NULL, //
+		             NULL                                //
+		);
+
+		st.history_hands[hand_idx].push_back(asf);
+		st.hand_tracked_for_num_frames[hand_idx]++;
+	}
+
+	// Push our timestamp back as well
+	st.history_timestamps.push_back(job->timestamp);
+
+	// More hand-size-optimization spaghetti
+	if (num_hands > 0) {
+		st.target_hand_size = (float)avg_hand_size / (float)num_hands;
+	}
+
+	// State tracker tweaks
+	for (int hand_idx = 0; hand_idx < 2; hand_idx++) {
+		st.last_frame_hand_detected[hand_idx] = job->hand_detected[hand_idx];
+
+		st.hand_seen_before[hand_idx] = st.hand_seen_before[hand_idx] || job->hand_detected[hand_idx];
+
+		if (!st.last_frame_hand_detected[hand_idx]) {
+			st.history_hands[hand_idx].clear();
+			st.hand_tracked_for_num_frames[hand_idx] = 0;
+		}
+	}
+}
+
+// Hands what the optimizer made of a frame over to the caller and to the next frames' detection and pose
+// prediction. Must not be called while an optimizer job is running.
+static void
+finish_optimizer_job(struct HandTracking *hgt,
+                     struct optimizer_job *job,
+                     uint64_t predict_timestamp,
+                     struct xrt_hand_joint_set *out_xrt_hands[2],
+                     int64_t *out_timestamp_ns)
+{
+	hgt->opt_published = hgt->opt_state;
+
+	for (int hand_idx = 0; hand_idx < 2; hand_idx++) {
+		*out_xrt_hands[hand_idx] = job->hands[hand_idx];
+		out_xrt_hands[hand_idx]->is_active = job->hand_detected[hand_idx];
+		hgt->this_frame_hand_detected[hand_idx] = job->hand_detected[hand_idx];
+
+		if (!job->hand_detected[hand_idx]) {
+			hgt->views[0].regions_of_interest_this_frame[hand_idx].found = false;
+			hgt->views[1].regions_of_interest_this_frame[hand_idx].found = false;
+		}
+	}
+
+	// estimators next frame. Also, if next frame's hand will be outside of the camera's field of view, mark it as
+	// inactive this frame. This stops issues where our hand detector detects hands that are slightly too close to
+	// the edge, causing flickery hands.
+	if (!hgt->tuneable_values.always_run_detection_model) {
+		predict_new_regions_of_interest(hgt, predict_timestamp);
+		bool still_found[2] = {hgt->opt_published.last_frame_hand_detected[0],
+		                       hgt->opt_published.last_frame_hand_detected[1]};
+		still_found[0] = hgt->views[0].regions_of_interest_this_frame[0].found ||
+		                 hgt->views[1].regions_of_interest_this_frame[0].found;
+		still_found[1] = hgt->views[0].regions_of_interest_this_frame[1].found ||
+		                 hgt->views[1].regions_of_interest_this_frame[1].found;
+
+		for (int hand_idx = 0; hand_idx < 2; hand_idx++) {
+			out_xrt_hands[hand_idx]->is_active = still_found[hand_idx];
+		}
+	}
+
+	for (int hand_idx = 0; hand_idx < 2; hand_idx++) {
+		// Don't send the hand to OpenXR until it's been tracked for 4 frames
+		if (hgt->opt_published.hand_tracked_for_num_frames[hand_idx] <
+		    hgt->tuneable_values.num_frames_before_display) {
+			out_xrt_hands[hand_idx]->is_active = false;
+		}
+	}
+
+	*out_timestamp_ns = job->timestamp; // No filtering, fine to do this now. Also just a reminder
+	                                    // that this took you 2 HOURS TO DEBUG THAT ONE TIME.
+
+	hgt->tuneable_values.optimizer_ms = job->optimizer_ms;
+	hgt->tuneable_values.optimizer_count = job->optimizer_count;
+
+	// If the debug UI is active, push our debug frame
+	if (job->debug_frame != NULL) {
+		u_sink_debug_push_frame(&hgt->debug_sink_ann, job->debug_frame);
+		xrt_frame_reference(&job->debug_frame, NULL);
+	}
+	job->debug_views[0] = cv::Mat();
+	job->debug_views[1] = cv::Mat();
+}
+
+
 /*
  *
  * Member functions.
@@ -672,19 +957,23 @@ HandTracking::HandTracking()
 
 HandTracking::~HandTracking()
 {
+	// Let a pipelined optimizer job finish before tearing anything down.
+	if (this->job_in_flight != NULL) {
+		u_worker_group_wait_all(this->optimizer_group);
+	}
+	u_worker_group_reference(&this->optimizer_group, NULL);
+
+	for (optimizer_job &job : this->jobs) {
+		xrt_frame_reference(&job.debug_frame, NULL);
+	}
+
 	u_sink_debug_destroy(&this->debug_sink_ann);
 	u_sink_debug_destroy(&this->debug_sink_model);
 
 	xrt_frame_reference(&this->visualizers.old_frame, NULL);
 
-	release_onnx_wrap(&this->views[0].keypoint[0]);
-	release_onnx_wrap(&this->views[0].keypoint[1]);
-	release_onnx_wrap(&this->views[0].detection);
-
-
-	release_onnx_wrap(&this->views[1].keypoint[0]);
-	release_onnx_wrap(&this->views[1].keypoint[1]);
-	release_onnx_wrap(&this->views[1].detection);
+	release_onnx_batched_wrap(&this->keypoint);
+	release_onnx_batched_wrap(&this->detection);
 
 	u_worker_group_reference(&this->group, NULL);
 
@@ -711,6 +1000,14 @@ HandTracking::cCallbackProcess(struct t_hand_tracking_sync *ht_sync,
 
 	hgt->current_frame_timestamp = left_frame->timestamp;
 
+	uint64_t frame_start_ns = os_monotonic_get_ns();
+	hgt->tuneable_values.detection_ms = 0;
+	hgt->tuneable_values.detection_model_ms = 0;
+	hgt->tuneable_values.detection_batch_size = 0;
+	hgt->tuneable_values.keypoint_batch_size = 0;
+	hgt->tuneable_values.optimizer_ms = 0;
+	hgt->tuneable_values.optimizer_count = 0;
+
 	struct xrt_hand_joint_set *out_xrt_hands[2] = {out_left_hand, out_right_hand};
 
 
@@ -729,6 +1026,12 @@ HandTracking::cCallbackProcess(struct t_hand_tracking_sync *ht_sync,
 		xrt_size new_one_view_size;
 		new_one_view_size.h = left_frame->height;
 		new_one_view_size.w = left_frame->width;
+
+		// The optimizer reads the camera parameters too.
+		if (hgt->job_in_flight != NULL) {
+			u_worker_group_wait_all(hgt->optimizer_group);
+		}
+
 		// Could be an assert, should never happen after first frame.
 		if (!handle_changed_image_size(hgt, new_one_view_size)) {
 			return;
@@ -746,9 +1049,6 @@ HandTracking::cCallbackProcess(struct t_hand_tracking_sync *ht_sync,
 	hgt->views[1].run_model_on_this = cv::Mat(view_size, CV_8UC1, right_frame->data, right_frame->stride);
 
 
-	*out_timestamp_ns = hgt->current_frame_timestamp; // No filtering, fine to do this now. Also just a reminder
-	                                                  // that this took you 2 HOURS TO DEBUG THAT ONE TIME.
-
 	hgt->debug_scribble =
 	    u_sink_debug_is_active(&hgt->debug_sink_ann) && u_sink_debug_is_active(&hgt->debug_sink_model);
 
@@ -798,14 +1098,13 @@ HandTracking::cCallbackProcess(struct t_hand_tracking_sync *ht_sync,
 		}
 	}
 
-	check_new_user_event(hgt);
-
-
-
 	// Every now and then if we're not already tracking both hands, try to detect new hands.
-	bool saw_both_hands_last_frame = hgt->last_frame_hand_detected[0] && hgt->last_frame_hand_detected[1];
+	bool saw_both_hands_last_frame =
+	    hgt->opt_published.last_frame_hand_detected[0] && hgt->opt_published.last_frame_hand_detected[1];
 	if (!saw_both_hands_last_frame) {
+		uint64_t detection_start_ns = os_monotonic_get_ns();
 		dispatch_and_process_hand_detections(hgt);
+		hgt->tuneable_values.detection_ms = time_ns_to_ms_f(os_monotonic_get_ns() - detection_start_ns);
 	}
 
 	stop_everything_if_hands_are_overlapping(hgt);
@@ -821,7 +1120,10 @@ HandTracking::cCallbackProcess(struct t_hand_tracking_sync *ht_sync,
 	}
 
 
-	// Dispatch keypoint estimator neural nets
+	// Dispatch keypoint estimator neural nets, all hands in all views at once
+	struct keypoint_estimation_run_info *run_infos[kMaxModelBatch];
+	int num_run_infos = 0;
+
 	for (int hand_idx = 0; hand_idx < 2; hand_idx++) {
 		for (int view_idx = 0; view_idx < 2; view_idx++) {
 			if (!hgt->views[view_idx].regions_of_interest_this_frame[hand_idx].found) {
@@ -831,234 +1133,77 @@ HandTracking::cCallbackProcess(struct t_hand_tracking_sync *ht_sync,
 			struct keypoint_estimation_run_info &inf = hgt->views[view_idx].run_info[hand_idx];
 			inf.view = &hgt->views[view_idx];
 			inf.hand_idx = hand_idx;
-			u_worker_group_push(hgt->group, hgt->keypoint_estimation_run_func,
-			                    &hgt->views[view_idx].run_info[hand_idx]);
+			run_infos[num_run_infos++] = &inf;
 		}
 	}
-	u_worker_group_wait_all(hgt->group);
-
-	// Spaghetti logic for optimizing hand size
-	bool any_hands_are_only_visible_in_one_view = false;
-
-	for (int hand_idx = 0; hand_idx < 2; hand_idx++) {
-		any_hands_are_only_visible_in_one_view =                             //
-		    any_hands_are_only_visible_in_one_view ||                        //
-		    (hgt->views[0].regions_of_interest_this_frame[hand_idx].found != //
-		     hgt->views[1].regions_of_interest_this_frame[hand_idx].found);
-	}
+	run_keypoint_estimation(hgt, run_infos, num_run_infos);
 
-	constexpr float mul_max = 1.0;
-	constexpr float frame_max = 100;
-	bool optimize_hand_size;
 
-	if ((hgt->refinement.hand_size_refinement_schedule_x > frame_max)) {
-		hgt->refinement.hand_size_refinement_schedule_y = mul_max;
-		optimize_hand_size = false;
-		hgt->refinement.optimizing = false;
-	} else {
-		hgt->refinement.hand_size_refinement_schedule_y =
-		    powf((hgt->refinement.hand_size_refinement_schedule_x / frame_max), 2) * mul_max;
-		optimize_hand_size = true;
-		hgt->refinement.optimizing = true;
-	}
-
-	if (any_hands_are_only_visible_in_one_view) {
-		optimize_hand_size = false;
-	}
-
-
-	// if either hand was not visible before the last new-user event but is visible now, reset the schedule
-	// a bit.
-	if ((hgt->this_frame_hand_detected[0] && !hgt->hand_seen_before[0]) ||
-	    (hgt->this_frame_hand_detected[1] && !hgt->hand_seen_before[1])) {
-		hgt->refinement.hand_size_refinement_schedule_x =
-		    std::min(hgt->refinement.hand_size_refinement_schedule_x, frame_max / 2);
-	}
+	/*
+	 * Hand the frame over to the optimizer.
+	 */
 
-	optimize_hand_size = optimize_hand_size && hgt->tuneable_values.optimize_hand_size;
+	struct optimizer_job *job = &hgt->jobs[hgt->next_job];
+	hgt->next_job = (hgt->next_job + 1) % ARRAY_SIZE(hgt->jobs);
 
-	int num_hands = 0;
-	float avg_hand_size = 0;
+	job->hgt = hgt;
+	job->timestamp = hgt->current_frame_timestamp;
+	job->clear_history = hgt->tuneable_values.always_run_detection_model && !saw_both_hands_last_frame;
 
-	// Dispatch the optimizers!
 	for (int hand_idx = 0; hand_idx < 2; hand_idx++) {
-
+		job->keypoint_outputs[hand_idx] = hgt->keypoint_outputs[hand_idx];
+		job->hand_detected[hand_idx] = hgt->this_frame_hand_detected[hand_idx];
 
 		for (int view_idx = 0; view_idx < 2; view_idx++) {
-			if (!hgt->views[view_idx].regions_of_interest_this_frame[hand_idx].found) {
-				// to the next view
-				continue;
-			}
-
-			if (!hgt->keypoint_outputs[hand_idx].views[view_idx].active) {
-				HG_DEBUG(hgt, "Removing hand %d because keypoint estimator said to!", hand_idx);
-				hgt->this_frame_hand_detected[hand_idx] = false;
-			}
-		}
-
-		if (!hgt->this_frame_hand_detected[hand_idx]) {
-			continue;
+			job->roi_found[view_idx][hand_idx] =
+			    hgt->views[view_idx].regions_of_interest_this_frame[hand_idx].found;
 		}
-
-
-		for (int view = 0; view < 2; view++) {
-			hand_region_of_interest &from_model = hgt->views[view].regions_of_interest_this_frame[hand_idx];
-			if (!from_model.found) {
-				hgt->keypoint_outputs[hand_idx].views[view].active = false;
-			}
-		}
-
-		if (hgt->tuneable_values.scribble_keypoint_model_outputs && hgt->debug_scribble) {
-			for (int view_idx = 0; view_idx < 2; view_idx++) {
-
-				if (!hgt->keypoint_outputs[hand_idx].views[view_idx].active) {
-					continue;
-				}
-
-				back_project_keypoint_output(hgt, hand_idx, view_idx);
-			}
-		}
-
-		struct xrt_hand_joint_set *put_in_set = out_xrt_hands[hand_idx];
-
-		lm::KinematicHandLM *hand = hgt->kinematic_hands[hand_idx];
-
-		float reprojection_error_threshold = hgt->tuneable_values.max_reprojection_error.val;
-		float smoothing_factor = hgt->tuneable_values.opt_smooth_factor.val;
-
-		if (hgt->last_frame_hand_detected[hand_idx]) {
-			if (hgt->tuneable_values.enable_framerate_based_smoothing) {
-				int64_t one_before = *hgt->history_timestamps.get_at_age(0);
-				int64_t now = hgt->current_frame_timestamp;
-
-				uint64_t diff = now - one_before;
-				double diff_d = time_ns_to_s(diff);
-				smoothing_factor = hgt->tuneable_values.opt_smooth_factor.val * (1 / 60.0f) / diff_d;
-			}
-		} else {
-			reprojection_error_threshold = hgt->tuneable_values.max_reprojection_error.val;
-		}
-
-
-
-		float out_hand_size;
-
-		//!@todo optimize: We can have one of these on each thread
-		float reprojection_error;
-		lm::optimizer_run(hand,                                     //
-		                  hgt->keypoint_outputs[hand_idx],          //
-		                  !hgt->last_frame_hand_detected[hand_idx], //
-		                  smoothing_factor,
-		                  optimize_hand_size,                              //
-		                  hgt->target_hand_size,                           //
-		                  hgt->refinement.hand_size_refinement_schedule_y, //
-		                  hgt->tuneable_values.amt_use_depth.val,
-		                  *put_in_set,   //
-		                  out_hand_size, //
-		                  reprojection_error);
-
-
-
-		if (reprojection_error > reprojection_error_threshold) {
-			HG_DEBUG(hgt, "Reprojection error above threshold!");
-			hgt->this_frame_hand_detected[hand_idx] = false;
-			continue;
-		}
-
-		if (hand_too_far(hgt, *put_in_set)) {
-			HG_DEBUG(hgt, "Hand too far away");
-			hgt->this_frame_hand_detected[hand_idx] = false;
-			continue;
-		}
-
-
-		avg_hand_size += out_hand_size;
-		num_hands++;
-
-		if (!any_hands_are_only_visible_in_one_view) {
-			hgt->refinement.hand_size_refinement_schedule_x +=
-			    hand_confidence_value(reprojection_error, hgt->keypoint_outputs[hand_idx]);
-		}
-
-		u_hand_joints_apply_joint_width(put_in_set);
-
-
-
-		put_in_set->hand_pose.pose = hgt->hand_pose_camera_offset;
-		put_in_set->hand_pose.relation_flags = valid_flags_ht;
-
-		Eigen::Array<float, 3, 21> asf = {};
-
-
-
-		hand_joint_set_to_eigen_21(*put_in_set, asf);
-
-		back_project(hgt,                                                                    //
-		             asf,                                                                    //
-		             hand_idx,                                                               //
-		             hgt->tuneable_values.scribble_optimizer_outputs && hgt->debug_scribble, //
-		             NULL                                                                    //
-		);
-
-		hgt->history_hands[hand_idx].push_back(asf);
-		hgt->hand_tracked_for_num_frames[hand_idx]++;
 	}
 
-	// Push our timestamp back as well
-	hgt->history_timestamps.push_back(hgt->current_frame_timestamp);
-
-	// More hand-size-optimization spaghetti
-	if (num_hands > 0) {
-		hgt->target_hand_size = (float)avg_hand_size / (float)num_hands;
+	job->debug_scribble = hgt->debug_scribble;
+	if (hgt->debug_scribble) {
+		job->debug_views[0] = hgt->views[0].debug_out_to_this;
+		job->debug_views[1] = hgt->views[1].debug_out_to_this;
 	}
 
-	// State tracker tweaks
-	for (int hand_idx = 0; hand_idx < 2; hand_idx++) {
-		out_xrt_hands[hand_idx]->is_active = hgt->this_frame_hand_detected[hand_idx];
-		hgt->last_frame_hand_detected[hand_idx] = hgt->this_frame_hand_detected[hand_idx];
+	// The job keeps the annotated frame until it's pushed.
+	xrt_frame_reference(&job->debug_frame, debug_frame);
+	xrt_frame_reference(&debug_frame, NULL);
 
-		hgt->hand_seen_before[hand_idx] =
-		    hgt->hand_seen_before[hand_idx] || hgt->this_frame_hand_detected[hand_idx];
+	if (hgt->pipelined) {
+		// Hand out the previous frame, the models for this frame ran while it was being optimized.
+		if (hgt->job_in_flight != NULL) {
+			// Frames usually come at a steady rate, predict into the one after this.
+			uint64_t predict_timestamp =
+			    hgt->current_frame_timestamp + (hgt->current_frame_timestamp - hgt->job_in_flight->timestamp);
 
-		if (!hgt->last_frame_hand_detected[hand_idx]) {
-			hgt->views[0].regions_of_interest_this_frame[hand_idx].found = false;
-			hgt->views[1].regions_of_interest_this_frame[hand_idx].found = false;
-			hgt->history_hands[hand_idx].clear();
-			hgt->hand_tracked_for_num_frames[hand_idx] = 0;
+			u_worker_group_wait_all(hgt->optimizer_group);
+			finish_optimizer_job(hgt, hgt->job_in_flight, predict_timestamp, out_xrt_hands,
+			                     out_timestamp_ns);
+		} else {
+			out_xrt_hands[0]->is_active = false;
+			out_xrt_hands[1]->is_active = false;
+			*out_timestamp_ns = 0;
 		}
-	}
 
-	// estimators next frame. Also, if next frame's hand will be outside of the camera's field of view, mark it as
-	// inactive this frame. This stops issues where our hand detector detects hands that are slightly too close to
-	// the edge, causing flickery hands.
-	if (!hgt->tuneable_values.always_run_detection_model) {
-		predict_new_regions_of_interest(hgt);
-		bool still_found[2] = {hgt->last_frame_hand_detected[0], hgt->last_frame_hand_detected[1]};
-		still_found[0] = hgt->views[0].regions_of_interest_this_frame[0].found ||
-		                 hgt->views[1].regions_of_interest_this_frame[0].found;
-		still_found[1] = hgt->views[0].regions_of_interest_this_frame[1].found ||
-		                 hgt->views[1].regions_of_interest_this_frame[1].found;
+		check_new_user_event(hgt);
 
-		for (int hand_idx = 0; hand_idx < 2; hand_idx++) {
-			out_xrt_hands[hand_idx]->is_active = still_found[hand_idx];
-		}
-	}
+		hgt->job_in_flight = job;
+		u_worker_group_push(hgt->optimizer_group, run_optimizer, job);
+	} else {
+		check_new_user_event(hgt);
 
-	for (int hand_idx = 0; hand_idx < 2; hand_idx++) {
-		// Don't send the hand to OpenXR until it's been tracked for 4 frames
-		if (hgt->hand_tracked_for_num_frames[hand_idx] < hgt->tuneable_values.num_frames_before_display) {
-			out_xrt_hands[hand_idx]->is_active = false;
-		}
+		run_optimizer(job);
+		finish_optimizer_job(hgt, job, hgt->current_frame_timestamp, out_xrt_hands, out_timestamp_ns);
 	}
 
+	hgt->tuneable_values.frame_ms = time_ns_to_ms_f(os_monotonic_get_ns() - frame_start_ns);
+
 	// If the debug UI is active, push to the frame-timing widget
 	u_frame_times_widget_push_sample(&hgt->ft_widget, hgt->current_frame_timestamp);
 
-	// If the debug UI is active, push our debug frame
+	// If the debug UI is active, push the model inputs/outputs, the optimizer pushes the annotated camera feeds.
 	if (hgt->debug_scribble) {
-		u_sink_debug_push_frame(&hgt->debug_sink_ann, debug_frame);
-		xrt_frame_reference(&debug_frame, NULL);
-
 		// We don't dereference the model inputs/outputs frame here; we make a copy of it next frame and
 		// dereference it then.
 		u_sink_debug_push_frame(&hgt->debug_sink_model, hgt->visualizers.xrtframe);
@@ -1077,6 +1222,12 @@ HandTracking::cCallbackDestroy(t_hand_tracking_sync *ht_sync)
 	delete ht_ptr;
 }
 
+extern "C" struct hg_tuneable_values *
+t_hand_tracking_sync_mercury_get_tuneable_values_pointer(struct t_hand_tracking_sync *ht_sync)
+{
+	return &HandTracking::fromC(ht_sync).tuneable_values;
+}
+
 } // namespace xrt::tracking::hand::mercury
 
 
@@ -1121,16 +1272,6 @@ t_hand_tracking_sync_mercury_create(struct t_stereo_camera_calibration *calib,
 	hgt->views[0].camera_info = extra_camera_info.views[0];
 	hgt->views[1].camera_info = extra_camera_info.views[1];
 
-	init_hand_detection(hgt, &hgt->views[0].detection);
-	init_hand_detection(hgt, &hgt->views[1].detection);
-
-	init_keypoint_estimation(hgt, &hgt->views[0].keypoint[0]);
-	init_keypoint_estimation(hgt, &hgt->views[0].keypoint[1]);
-
-	init_keypoint_estimation(hgt, &hgt->views[1].keypoint[0]);
-	init_keypoint_estimation(hgt, &hgt->views[1].keypoint[1]);
-	hgt->keypoint_estimation_run_func = xrt::tracking::hand::mercury::run_keypoint_estimation;
-
 	hgt->views[0].view = 0;
 	hgt->views[1].view = 1;
 
@@ -1138,6 +1279,14 @@ t_hand_tracking_sync_mercury_create(struct t_stereo_camera_calibration *calib,
 	hgt->pool = u_worker_thread_pool_create(num_threads - 1, num_threads, "Hand Tracking");
 	hgt->group = u_worker_group_create(hgt->pool);
 
+	hgt->pipelined = debug_get_bool_option_mercury_pipelined();
+	if (hgt->pipelined) {
+		hgt->optimizer_group = u_worker_group_create(hgt->pool);
+	}
+
+	init_hand_detection(hgt, &hgt->detection);
+	init_keypoint_estimation(hgt, &hgt->keypoint);
+
 	lm::optimizer_create(hgt->left_in_right, false, hgt->log_level, &hgt->kinematic_hands[0]);
 	lm::optimizer_create(hgt->left_in_right, true, hgt->log_level, &hgt->kinematic_hands[1]);
 
@@ -1149,9 +1298,19 @@ t_hand_tracking_sync_mercury_create(struct t_stereo_camera_calibration *calib,
 	u_var_add_ro_f32(hgt, &hgt->ft_widget.fps, "FPS!");
 	u_var_add_f32_timing(hgt, hgt->ft_widget.debug_var, "Frame timing!");
 
-	u_var_add_f32(hgt, &hgt->target_hand_size, "Hand size (Meters between wrist and middle-proximal joint)");
-	u_var_add_ro_f32(hgt, &hgt->refinement.hand_size_refinement_schedule_x, "Schedule (X value)");
-	u_var_add_ro_f32(hgt, &hgt->refinement.hand_size_refinement_schedule_y, "Schedule (Y value)");
+	u_var_add_f32(hgt, &hgt->opt_state.target_hand_size,
+	              "Hand size (Meters between wrist and middle-proximal joint)");
+	u_var_add_ro_f32(hgt, &hgt->opt_state.refinement.hand_size_refinement_schedule_x, "Schedule (X value)");
+	u_var_add_ro_f32(hgt, &hgt->opt_state.refinement.hand_size_refinement_schedule_y, "Schedule (Y value)");
+
+	u_var_add_ro_f32(hgt, &hgt->tuneable_values.frame_ms, "Frame time (ms)");
+	u_var_add_ro_f32(hgt, &hgt->tuneable_values.detection_ms, "Detection time (ms)");
+	u_var_add_ro_f32(hgt, &hgt->tuneable_values.detection_model_ms, "Detection model time (ms)");
+	u_var_add_ro_i32(hgt, &hgt->tuneable_values.detection_batch_size, "Detection model batch size");
+	u_var_add_ro_f32(hgt, &hgt->tuneable_values.keypoint_prepare_ms, "Keypoint input projection time (ms)");
+	u_var_add_ro_f32(hgt, &hgt->tuneable_values.keypoint_model_ms, "Keypoint model time (ms)");
+	u_var_add_ro_i32(hgt, &hgt->tuneable_values.keypoint_batch_size, "Keypoint model batch size");
+	u_var_add_ro_f32(hgt, &hgt->tuneable_values.optimizer_ms, "Optimizer time (ms)");
 
 
 	u_var_add_bool(hgt, &hgt->tuneable_values.new_user_event, "Estimate hand sizes");
@@ -66,6 +66,9 @@ static constexpr uint16_t kKeypointInputSize = 128;
 static constexpr uint16_t kKeypointOutputHeatmapSize = 22;
 static constexpr uint16_t kVisSpacerSize = 8;
 
+// Most items the models are run on at once, two hands in two views.
+static constexpr int kMaxModelBatch = 4;
+
 static const cv::Scalar RED(255, 30, 30);
 static const cv::Scalar YELLOW(255, 255, 0);
 static const cv::Scalar PINK(255, 0, 255);
@@ -142,13 +145,36 @@ struct projection_instructions
 	projection_instructions(const t_camera_model_params &dist) : dist(dist) {}
 };
 
-struct model_input_wrap
+// Where camera space directions land in the image, so we don't have to evaluate the camera model for every pixel of
+// every crop. Directions are indexed by their stereographic coordinates around the optical axis (+Z forward, -Y up).
+struct stereographic_camera_lut
+{
+	static constexpr int kSize = 257;
+	static constexpr int kFracBits = 8;
+	static constexpr int32_t kInvalid = INT32_MIN;
+
+	// Half-width of the stereographic square covered by the table, just enough to contain the whole image.
+	float extent = 0;
+
+	// The camera intrinsics the table was built with, so it can be reused at other resolutions.
+	float fx, fy, cx, cy;
+
+	// kSize * kSize pairs of pixel coordinates, with kFracBits fractional bits. kInvalid if the camera can't see
+	// that direction.
+	std::vector<int32_t> xy = {};
+};
+
+// Input or output of a model, allocated once for the whole batch.
+struct model_tensor_wrap
 {
 	float *data = nullptr;
+	// Number of floats of one batch item.
+	size_t item_size = 0;
 	int64_t dimensions[4];
 	size_t num_dimensions = 0;
 
-	OrtValue *tensor = nullptr;
+	// Tensors over the first 1, 2, ... batch items of data.
+	OrtValue *tensors[kMaxModelBatch] = {};
 	const char *name;
 };
 
@@ -160,7 +186,23 @@ struct onnx_wrap
 	OrtMemoryInfo *meminfo = nullptr;
 	OrtSession *session = nullptr;
 
-	std::vector<model_input_wrap> wraps = {};
+	// Most items one run of this session takes.
+	int max_batch = 1;
+
+	std::vector<model_tensor_wrap> inputs = {};
+	std::vector<model_tensor_wrap> outputs = {};
+
+	// Inputs and outputs bound for batches of 1, 2, ... items, so running doesn't allocate.
+	OrtIoBinding *bindings[kMaxModelBatch] = {};
+};
+
+// One model, run on all of a frame's hands and views at once. Models exported with a fixed batch size of one
+// get a session per item instead.
+struct onnx_batched_wrap
+{
+	onnx_wrap sessions[kMaxModelBatch];
+	int session_count = 0;
+	int session_batch = 1;
 };
 
 // Multipurpose.
@@ -188,6 +230,11 @@ struct hand_detection_run_info
 	// If some hands are already tracked, we have logic that only copies new ROIs to this frame's regions of
 	// interest.
 	hand_region_of_interest outputs[2];
+
+	// Where this view is in the batch.
+	int batch_idx;
+	cv::Mat binned_uint8;
+	cv::Matx23f go_back;
 };
 
 
@@ -195,13 +242,16 @@ struct keypoint_estimation_run_info
 {
 	ht_view *view;
 	bool hand_idx;
+
+	// Where this hand/view pair is in the batch.
+	int batch_idx;
+	cv::Mat data_128x128_uint8;
+	bool is_hand;
 };
 
 struct ht_view
 {
 	HandTracking *hgt;
-	onnx_wrap detection;
-	onnx_wrap keypoint[2];
 	int view;
 
 	struct t_camera_extra_info_one_view camera_info;
@@ -210,6 +260,8 @@ struct ht_view
 	// With fx, fy, cx, cy scaled to the current camera resolution as appropriate.
 	t_camera_model_params hgdist;
 
+	// Built from hgdist_orig.
+	stereographic_camera_lut camera_lut;
 
 	cv::Mat run_model_on_this;
 	cv::Mat debug_out_to_this;
@@ -230,6 +282,61 @@ struct hand_size_refinement
 	bool optimizing = true;
 };
 
+// Everything that carries over from one frame's kinematic optimization to the next. Owned by the optimizer, the
+// detection and pose-prediction code only sees the copy taken between frames.
+struct optimizer_state
+{
+	// Used to track whether this hand has *ever* been seen during this user's session, so that we can spend some
+	// extra time optimizing their hand size if one of their hands isn't visible for the first bit.
+	bool hand_seen_before[2] = {false, false};
+
+	// Used to:
+	// * see if a hand is currently being tracked.
+	// * If so, don't replace the bounding box with that from a hand detection.
+	// * Also, if both hands are being tracked, we just don't run the hand detector.
+	bool last_frame_hand_detected[2] = {false, false};
+
+	// Used to determine pose-predicted regions of interest. Contains the last 2 hand keypoint positions, or less
+	// if the hand has just started being tracked.
+	HistoryBuffer<Eigen::Array<float, 3, 21>, 2> history_hands[2] = {};
+
+	// Contains the last 2 timestamps, or less if hand tracking has just started.
+	HistoryBuffer<uint64_t, 2> history_timestamps = {};
+
+	// It'd be a staring contest between your hand and the heat death of the universe!
+	uint64_t hand_tracked_for_num_frames[2] = {0, 0};
+
+	struct hand_size_refinement refinement = {};
+	float target_hand_size = STANDARD_HAND_SIZE;
+};
+
+// One frame's worth of work for the kinematic optimizer: what the models found and what the optimizer made of it.
+// In pipelined mode this runs on a worker thread while the next frame goes through the models.
+struct optimizer_job
+{
+	HandTracking *hgt;
+
+	uint64_t timestamp;
+
+	// The detection ran with always_run_detection_model, forget the hands' history.
+	bool clear_history;
+
+	// Copied from the models' outputs, left hand, right hand.
+	struct one_frame_input keypoint_outputs[2];
+	bool roi_found[2][2]; // view, hand
+	bool hand_detected[2];
+
+	// Annotated camera feeds of this frame, only set if we're scribbling.
+	bool debug_scribble;
+	xrt_frame *debug_frame;
+	cv::Mat debug_views[2];
+
+	// Outputs.
+	struct xrt_hand_joint_set hands[2];
+	float optimizer_ms;
+	int32_t optimizer_count;
+};
+
 struct model_output_visualizers
 {
 	// After setup, these reference the same piece of memory.
@@ -274,6 +381,9 @@ public:
 
 	u_worker_group *group;
 
+	onnx_batched_wrap detection;
+	onnx_batched_wrap keypoint;
+
 
 	float baseline = {};
 	xrt_pose hand_pose_camera_offset = {};
@@ -292,28 +402,22 @@ public:
 	// left hand, right hand THEN left view, right view
 	struct one_frame_input keypoint_outputs[2];
 
-	// Used to track whether this hand has *ever* been seen during this user's session, so that we can spend some
-	// extra time optimizing their hand size if one of their hands isn't visible for the first bit.
-	bool hand_seen_before[2] = {false, false};
-
-	// Used to:
-	// * see if a hand is currently being tracked.
-	// * If so, don't replace the bounding box with that from a hand detection.
-	// * Also, if both hands are being tracked, we just don't run the hand detector.
-	bool last_frame_hand_detected[2] = {false, false};
-
 	// Used to decide whether to run the keypoint estimator/nonlinear optimizer.
 	bool this_frame_hand_detected[2] = {false, false};
 
-	// Used to determine pose-predicted regions of interest. Contains the last 2 hand keypoint positions, or less
-	// if the hand has just started being tracked.
-	HistoryBuffer<Eigen::Array<float, 3, 21>, 2> history_hands[2] = {};
+	// Only touched by the optimizer, which in pipelined mode runs on optimizer_group.
+	struct optimizer_state opt_state = {};
 
-	// Contains the last 2 timestamps, or less if hand tracking has just started.
-	HistoryBuffer<uint64_t, 2> history_timestamps = {};
+	// What the detection and pose-prediction code reads, copied from opt_state once the optimizer is done with a
+	// frame.
+	struct optimizer_state opt_published = {};
 
-	// It'd be a staring contest between your hand and the heat death of the universe!
-	uint64_t hand_tracked_for_num_frames[2] = {0, 0};
+	// Run the optimizer for frame N while the models run on frame N+1, returning frame N's hands one frame late.
+	bool pipelined = false;
+	u_worker_group *optimizer_group = NULL;
+	struct optimizer_job jobs[2] = {};
+	struct optimizer_job *job_in_flight = NULL;
+	int next_job = 0;
 
 
 	// left hand, right hand
@@ -321,17 +425,10 @@ public:
 
 	int detection_counter = 0;
 
-	struct hand_size_refinement refinement = {};
-	float target_hand_size = STANDARD_HAND_SIZE;
-
 
 	xrt_frame *debug_frame;
 
 
-	// This should be removed.
-	void (*keypoint_estimation_run_func)(void *);
-
-
 
 	struct xrt_pose left_in_right = {};
 
@@ -363,20 +460,23 @@ public:
 
 
 void
-init_hand_detection(HandTracking *hgt, onnx_wrap *wrap);
+init_hand_detection(HandTracking *hgt, onnx_batched_wrap *model);
 
 void
-run_hand_detection(void *ptr);
+run_hand_detection(HandTracking *hgt, hand_detection_run_info **infos, int count);
 
 void
-init_keypoint_estimation(HandTracking *hgt, onnx_wrap *wrap);
+init_keypoint_estimation(HandTracking *hgt, onnx_batched_wrap *model);
 
 void
-run_keypoint_estimation(void *ptr);
+run_keypoint_estimation(HandTracking *hgt, keypoint_estimation_run_info **infos, int count);
 
 void
 release_onnx_wrap(onnx_wrap *wrap);
 
+void
+release_onnx_batched_wrap(onnx_batched_wrap *model);
+
 
 void
 make_projection_instructions(t_camera_model_params &dist,
@@ -397,7 +497,20 @@ make_projection_instructions_angular(xrt_vec3 direction_3d,
                                      projection_instructions &out_instructions);
 
 void
-stereographic_project_image(const t_camera_model_params &dist,
+make_stereographic_camera_lut(const t_camera_model_params &dist, xrt_size size, stereographic_camera_lut &out_lut);
+
+// Fills 128x128 fixed-point maps, CV_16SC2 and CV_16UC1, for cv::remap of one crop.
+void
+make_remap_maps(const stereographic_camera_lut &lut,
+                const t_camera_model_params &dist,
+                const projection_instructions &instructions,
+                cv::Size input_size,
+                cv::Mat &map_xy,
+                cv::Mat &map_frac);
+
+void
+stereographic_project_image(const stereographic_camera_lut &lut,
+                            const t_camera_model_params &dist,
                             const projection_instructions &instructions,
                             cv::Mat &input_image,
                             cv::Mat *debug_image,
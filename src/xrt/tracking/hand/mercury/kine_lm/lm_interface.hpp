@@ -12,6 +12,8 @@
 // #include "lm_defines.hpp"
 #include "../kine_common.hpp"
 
+#include <vector>
+
 namespace xrt::tracking::hand::mercury::lm {
 
 // Yes, this is a weird in-between-C-and-C++ API. Fight me, I like it this way.
@@ -57,6 +59,32 @@ optimizer_run(KinematicHandLM *hand,
               float &out_hand_size,
               float &out_reprojection_error);
 
+/*!
+ * For testing, evaluates the Jacobian of the optimizer's cost function both with autodiff and analytically. Takes the
+ * same parameters as @ref optimizer_run, and evaluates at the hand's current state plus @p params_offset.
+ *
+ * @param[out] out_autodiff: Column-major Jacobian from autodiff
+ * @param[out] out_analytic: Column-major Jacobian from the analytic path
+ * @param[out] out_num_residuals: The number of rows of the Jacobians
+ */
+void
+optimizer_eval_jacobians(KinematicHandLM *hand,
+                         one_frame_input &observation,
+                         bool hand_was_untracked_last_frame,
+                         float smoothing_factor,
+                         bool optimize_hand_size,
+                         float target_hand_size,
+                         float hand_size_err_mul,
+                         float amt_use_depth,
+                         const std::vector<float> &params_offset,
+                         std::vector<float> &out_autodiff,
+                         std::vector<float> &out_analytic,
+                         size_t &out_num_residuals);
+
+// Whether to use the analytic Jacobian or autodiff, defaults to MERCURY_LM_ANALYTIC_JACOBIAN.
+void
+optimizer_set_analytic_jacobian(KinematicHandLM *hand, bool enabled);
+
 // Destructor
 void
 optimizer_destroy(KinematicHandLM **hand);
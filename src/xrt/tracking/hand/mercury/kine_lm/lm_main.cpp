@@ -11,6 +11,7 @@
 #include "math/m_api.h"
 #include "math/m_vec3.h"
 #include "os/os_time.h"
+#include "util/u_debug.h"
 #include "util/u_misc.h"
 #include "util/u_trace_marker.h"
 
@@ -35,6 +36,8 @@ Everything templated with <typename T> is basically just a scalar template, usua
 
 */
 
+DEBUG_GET_ONCE_BOOL_OPTION(lm_analytic_jacobian, "MERCURY_LM_ANALYTIC_JACOBIAN", true)
+
 namespace xrt::tracking::hand::mercury::lm {
 
 template <typename T>
@@ -723,6 +726,475 @@ CostFunctor<optimize_hand_size>::operator()(const T *const x, T *residual) const
 	return true;
 }
 
+
+/*
+ *
+ * Analytic Jacobian.
+ *
+ * Autodiff carries the derivatives for every parameter through every bone, even though each finger only moves with
+ * the wrist, its own parameters and the hand size. Here we instead take the joint positions from a plain float
+ * evaluation, and get their derivatives from the angular velocity each parameter gives its bone:
+ * d(joint)/d(param) = omega x (joint - pivot). Everything per-joint is kept struct-of-arrays so that it vectorizes.
+ *
+ */
+
+// Only written for the default set of residuals and parameters.
+#if defined(USE_HAND_SIZE) && defined(USE_HAND_TRANSLATION) && defined(USE_HAND_ORIENTATION) &&                   \
+    defined(USE_EVERYTHING_ELSE) && !defined(USE_HAND_PLAUSIBILITY) && !defined(USE_HAND_CURLS) &&                 \
+    !defined(RESIDUALS_HACKING)
+#define LM_HAVE_ANALYTIC_JACOBIAN
+#endif
+
+#ifdef LM_HAVE_ANALYTIC_JACOBIAN
+
+// Where the parameters are in the input vector, see OptimizerHandPackIntoVector.
+static constexpr int kParamTranslation = 0;
+static constexpr int kParamOrientation = kParamTranslation + kHandTranslationDim;
+static constexpr int kParamThumb = kParamOrientation + kHandOrientationDim;
+static constexpr int kParamFingers = kParamThumb + kThumbDim;
+static constexpr int kParamHandSize = kParamFingers + kFingerDim * 4;
+
+static_assert((size_t)kParamHandSize == calc_input_size(false));
+
+using JointArray = Eigen::Array<HandScalar, kNumNNJoints, 1>;
+template <int kNumParams> using JointJacobianArray = Eigen::Array<HandScalar, kNumNNJoints, kNumParams>;
+
+// The 21 joints, and their derivatives with respect to each parameter (one column each).
+template <int kNumParams> struct JointsWithJacobian
+{
+	JointArray x, y, z;
+	JointJacobianArray<kNumParams> dx, dy, dz;
+};
+
+static inline int
+nn_joint_index(int finger, int joint)
+{
+	// See cjrc, the wrist and then joints 1-4 of each finger.
+	return 1 + (finger * 4) + (joint - 1);
+}
+
+// Angular velocities of the rotation `q`, in the frame it's applied in, when moving each of its parameters.
+// omega = 2 * vec(dq * conj(q)), jets are plenty fast for the three parameters this is used with.
+template <int N>
+static void
+angular_velocities(const Quat<ceres::Jet<HandScalar, N>> &q, Vec3<HandScalar> out_omega[N])
+{
+	const Quat<HandScalar> q_conj(-q.x.a, -q.y.a, -q.z.a, q.w.a);
+
+	for (int i = 0; i < N; i++) {
+		const Quat<HandScalar> dq(q.x.v[i], q.y.v[i], q.z.v[i], q.w.v[i]);
+		Quat<HandScalar> prod = {};
+		QuaternionProduct(dq, q_conj, prod);
+
+		out_omega[i] = Vec3<HandScalar>(prod.x * 2, prod.y * 2, prod.z * 2);
+	}
+}
+
+// Adds the motion of joints [first, first + count) rotating around pivot with angular velocity omega, to column param.
+template <int kNumParams>
+static void
+add_joints_rotation(JointsWithJacobian<kNumParams> &joints,
+                    bool is_right,
+                    int param,
+                    const Vec3<HandScalar> &omega,
+                    const Vec3<HandScalar> &pivot,
+                    int first,
+                    int count)
+{
+	// The hand is mirrored after rotating, so: mirror(omega x mirror(joint - pivot)).
+	const HandScalar mirror = is_right ? -1 : 1;
+
+	auto rel_x = (joints.x.segment(first, count) - pivot.x) * mirror;
+	auto rel_y = joints.y.segment(first, count) - pivot.y;
+	auto rel_z = joints.z.segment(first, count) - pivot.z;
+
+	joints.dx.col(param).segment(first, count) += (omega.y * rel_z - omega.z * rel_y) * mirror;
+	joints.dy.col(param).segment(first, count) += omega.z * rel_x - omega.x * rel_z;
+	joints.dz.col(param).segment(first, count) += omega.x * rel_y - omega.y * rel_x;
+}
+
+template <bool optimize_hand_size>
+static void
+eval_joints_with_jacobian(const KinematicHandLM &state,
+                          const HandScalar *x,
+                          OptimizerHand<HandScalar> &hand,
+                          JointsWithJacobian<calc_input_size(optimize_hand_size)> &out)
+{
+	using Jet3 = ceres::Jet<HandScalar, 3>;
+	using Jet2 = ceres::Jet<HandScalar, 2>;
+
+	// Same as CostFunctor.
+	Quat<HandScalar> tmp = state.this_frame_pre_rotation;
+	OptimizerHandInit<HandScalar>(hand, tmp);
+	OptimizerHandUnpackFromVector(x, state, hand);
+
+	Translations55<HandScalar> translations_absolute = {};
+	Orientations54<HandScalar> orientations_absolute = {};
+	eval_hand_with_orientation(state, hand, state.is_right, translations_absolute, orientations_absolute);
+
+	const Vec3<HandScalar> &wrist = hand.wrist_final_location;
+
+	out.x(0) = wrist.x;
+	out.y(0) = wrist.y;
+	out.z(0) = wrist.z;
+	for (int finger = 0; finger < 5; finger++) {
+		for (int joint = 1; joint < 5; joint++) {
+			const Vec3<HandScalar> &t = translations_absolute.t[finger][joint];
+			out.x(nn_joint_index(finger, joint)) = t.x;
+			out.y(nn_joint_index(finger, joint)) = t.y;
+			out.z(nn_joint_index(finger, joint)) = t.z;
+		}
+	}
+
+	out.dx.setZero();
+	out.dy.setZero();
+	out.dz.setZero();
+
+	// Translation moves everything.
+	out.dx.col(kParamTranslation + 0).setConstant(1);
+	out.dy.col(kParamTranslation + 1).setConstant(1);
+	out.dz.col(kParamTranslation + 2).setConstant(1);
+
+	// Orientation rotates everything around the wrist.
+	{
+		const Vec3<HandScalar> &aax = hand.wrist_post_orientation_aax;
+		Vec3<Jet3> aax_jet(Jet3(aax.x, 0), Jet3(aax.y, 1), Jet3(aax.z, 2));
+		Quat<Jet3> post_orientation = {};
+		AngleAxisToQuaternion<Jet3>(aax_jet, post_orientation);
+
+		Vec3<HandScalar> omega[3];
+		angular_velocities(post_orientation, omega);
+
+		for (int i = 0; i < 3; i++) {
+			// Post-rotation is applied after the pre-rotation.
+			Vec3<HandScalar> omega_world = {};
+			UnitQuaternionRotatePoint(state.this_frame_pre_rotation, omega[i], omega_world);
+			add_joints_rotation(out, state.is_right, kParamOrientation + i, omega_world, wrist, 0,
+			                    kNumNNJoints);
+		}
+	}
+
+	// Each rotation, with its (up to) three parameters, in its parent's frame.
+	auto add_bone = [&](int finger, int bone, int first_param, int num_params, const Vec3<HandScalar> *omega,
+	                    const minmax *limits) {
+		const Quat<HandScalar> &parent = orientations_absolute.q[finger][bone - 1];
+		const Vec3<HandScalar> &pivot = translations_absolute.t[finger][bone];
+
+		for (int i = 0; i < num_params; i++) {
+			int param = first_param + i;
+
+			Vec3<HandScalar> omega_world = {};
+			UnitQuaternionRotatePoint(parent, omega[i], omega_world);
+
+			HandScalar mul = LMToModelDerivative(x[param], limits[i]);
+			omega_world.x *= mul;
+			omega_world.y *= mul;
+			omega_world.z *= mul;
+
+			// Moves the joints after this bone.
+			add_joints_rotation(out, state.is_right, param, omega_world, pivot,
+			                    nn_joint_index(finger, bone + 1), 4 - bone);
+		}
+	};
+
+	// Curls are around X.
+	const Vec3<HandScalar> curl_omega(1.f, 0.f, 0.f);
+
+	// Thumb metacarpal, then curls.
+	{
+		const OptimizerMetacarpalBone<HandScalar> &mcp = hand.thumb.metacarpal;
+		Vec2<Jet3> swing(Jet3(mcp.swing.x, 0), Jet3(mcp.swing.y, 1));
+		Quat<Jet3> rotation = {};
+		SwingTwistToQuaternion(swing, Jet3(mcp.twist, 2), rotation);
+
+		Vec3<HandScalar> omega[3];
+		angular_velocities(rotation, omega);
+
+		const minmax limits[3] = {the_limit.thumb_mcp_swing_x, the_limit.thumb_mcp_swing_y,
+		                          the_limit.thumb_mcp_twist};
+		add_bone(0, 1, kParamThumb + 0, 3, omega, limits);
+		add_bone(0, 2, kParamThumb + 3, 1, &curl_omega, &the_limit.thumb_curls[0]);
+		add_bone(0, 3, kParamThumb + 4, 1, &curl_omega, &the_limit.thumb_curls[1]);
+	}
+
+	// Finger proximal swings, then curls.
+	for (int finger_idx = 0; finger_idx < 4; finger_idx++) {
+		const OptimizerFinger<HandScalar> &finger = hand.finger[finger_idx];
+		const FingerLimit &limit = the_limit.fingers[finger_idx];
+		const int first_param = kParamFingers + (finger_idx * kFingerDim);
+
+		Vec2<Jet2> swing(Jet2(finger.proximal_swing.x, 0), Jet2(finger.proximal_swing.y, 1));
+		Quat<Jet2> rotation = {};
+		SwingToQuaternion(swing, rotation);
+
+		Vec3<HandScalar> omega[2];
+		angular_velocities(rotation, omega);
+
+		const minmax limits[2] = {limit.pxm_swing_x, limit.pxm_swing_y};
+		add_bone(finger_idx + 1, 1, first_param + 0, 2, omega, limits);
+		add_bone(finger_idx + 1, 2, first_param + 2, 1, &curl_omega, &limit.curls[0]);
+		add_bone(finger_idx + 1, 3, first_param + 3, 1, &curl_omega, &limit.curls[1]);
+	}
+
+	// Hand size scales everything around the wrist.
+	if constexpr (optimize_hand_size) {
+		HandScalar mul = LMToModelDerivative(x[kParamHandSize], the_limit.hand_size) / hand.hand_size;
+		out.dx.col(kParamHandSize) = (out.x - wrist.x) * mul;
+		out.dy.col(kParamHandSize) = (out.y - wrist.y) * mul;
+		out.dz.col(kParamHandSize) = (out.z - wrist.z) * mul;
+	}
+}
+
+template <bool optimize_hand_size>
+static void
+jacobian_positions_part(const KinematicHandLM &state,
+                        const HandScalar *x,
+                        const OptimizerHand<HandScalar> &hand,
+                        const JointsWithJacobian<calc_input_size(optimize_hand_size)> &joints,
+                        Eigen::Map<Eigen::Matrix<HandScalar, Eigen::Dynamic, calc_input_size(optimize_hand_size)>> &J,
+                        size_t &row)
+{
+	constexpr int kNumParams = calc_input_size(optimize_hand_size);
+
+	for (int view = 0; view < 2; view++) {
+		const one_frame_one_view &obs = state.observation->views[view];
+		if (!obs.active) {
+			continue;
+		}
+
+		// Same transform as cjrc, into this view's rotated camera space.
+		Eigen::Quaternionf move_orientation = Eigen::Quaternionf::Identity();
+		Eigen::Vector3f move_direction = Eigen::Vector3f::Zero();
+		if (view != 0) {
+			const Quat<HandScalar> &q = state.left_in_right_orientation;
+			move_orientation = Eigen::Quaternionf(q.w, q.x, q.y, q.z);
+			move_direction = Eigen::Vector3f(state.left_in_right_translation.x,
+			                                 state.left_in_right_translation.y,
+			                                 state.left_in_right_translation.z);
+		}
+		xrt_quat extra_rot = obs.look_dir;
+		math_quat_invert(&extra_rot, &extra_rot);
+		Eigen::Quaternionf after_orientation(extra_rot.w, extra_rot.x, extra_rot.y, extra_rot.z);
+
+		const Eigen::Matrix3f K = (after_orientation * move_orientation).toRotationMatrix();
+		const Eigen::Vector3f offset = after_orientation * move_direction;
+
+		JointArray cx = K(0, 0) * joints.x + K(0, 1) * joints.y + K(0, 2) * joints.z + offset.x();
+		JointArray cy = K(1, 0) * joints.x + K(1, 1) * joints.y + K(1, 2) * joints.z + offset.y();
+		JointArray cz = K(2, 0) * joints.x + K(2, 1) * joints.y + K(2, 2) * joints.z + offset.z();
+
+		JointJacobianArray<kNumParams> dcx = K(0, 0) * joints.dx + K(0, 1) * joints.dy + K(0, 2) * joints.dz;
+		JointJacobianArray<kNumParams> dcy = K(1, 0) * joints.dx + K(1, 1) * joints.dy + K(1, 2) * joints.dz;
+		JointJacobianArray<kNumParams> dcz = K(2, 0) * joints.dx + K(2, 1) * joints.dy + K(2, 2) * joints.dz;
+
+		// Stereographic projection of the normalized direction: s = c.xy / (|c| - c.z)
+		JointArray len = (cx * cx + cy * cy + cz * cz).sqrt();
+		JointArray inv_d = (len - cz).inverse();
+		JointArray inv_d2 = inv_d * inv_d;
+		JointArray inv_len = len.inverse();
+
+		JointArray sx_cx = (inv_d - cx * cx * inv_len * inv_d2);
+		JointArray sx_cy = -cx * cy * inv_len * inv_d2;
+		JointArray sx_cz = cx * inv_len * inv_d;
+		JointArray sy_cx = sx_cy;
+		JointArray sy_cy = (inv_d - cy * cy * inv_len * inv_d2);
+		JointArray sy_cz = cy * inv_len * inv_d;
+
+		for (int i = 0; i < (int)kNumNNJoints; i++) {
+			if (len(i) <= FLT_EPSILON) {
+				// normalize_vector_inplace just sets z to -1 here.
+				sx_cx(i) = sy_cy(i) = 0.5f;
+				sx_cy(i) = sx_cz(i) = sy_cx(i) = sy_cz(i) = 0;
+			}
+		}
+
+		JointJacobianArray<kNumParams> dsx =
+		    dcx.colwise() * sx_cx + dcy.colwise() * sx_cy + dcz.colwise() * sx_cz;
+		JointJacobianArray<kNumParams> dsy =
+		    dcx.colwise() * sy_cx + dcy.colwise() * sy_cy + dcz.colwise() * sy_cz;
+
+		// Depth is relative to the index proximal, and scaled by the hand size.
+		const int mid = Joint21::INDX_PXM;
+		JointJacobianArray<kNumParams> dlen =
+		    (dcx.colwise() * cx + dcy.colwise() * cy + dcz.colwise() * cz).colwise() * inv_len;
+
+		HandScalar dsize = 0;
+		if constexpr (optimize_hand_size) {
+			dsize = LMToModelDerivative(x[kParamHandSize], the_limit.hand_size);
+		}
+
+		for (int i = 0; i < (int)kNumNNJoints; i++) {
+			const vec2_5 &kp = obs.keypoints_in_scaled_stereographic[i];
+
+			J.row(row++) = dsx.row(i).matrix() * kp.confidence_xy;
+			J.row(row++) = dsy.row(i).matrix() * kp.confidence_xy;
+
+			if (i == Joint21::MIDL_PXM) {
+				continue;
+			}
+
+			if (state.first_frame) {
+				// The residual is a constant zero.
+				row++;
+				continue;
+			}
+
+			HandScalar weight = HandScalar(pow(kp.confidence_depth, 3)) * state.depth_err_mul;
+
+			auto J_row = J.row(row++);
+			J_row = (dlen.row(i) - dlen.row(mid)).matrix() * (weight / hand.hand_size);
+			if constexpr (optimize_hand_size) {
+				J_row(kParamHandSize) -=
+				    weight * (len(i) - len(mid)) * dsize / (hand.hand_size * hand.hand_size);
+			}
+		}
+	}
+}
+
+template <bool optimize_hand_size>
+static void
+jacobian_stability_part(const KinematicHandLM &state,
+                        const HandScalar *x,
+                        const OptimizerHand<HandScalar> &hand,
+                        Eigen::Map<Eigen::Matrix<HandScalar, Eigen::Dynamic, calc_input_size(optimize_hand_size)>> &J,
+                        size_t &row)
+{
+	HandStability stab(state.smoothing_factor);
+	const OptimizerHand<HandScalar> &last_hand = state.last_frame;
+
+	// Residuals that are a weighted model parameter.
+	auto add_param = [&](int param, minmax limit, HandScalar weight) {
+		J(row++, param) = weight * LMToModelDerivative(x[param], limit);
+	};
+
+	if constexpr (optimize_hand_size) {
+		add_param(kParamHandSize, the_limit.hand_size, stab.stabilityHandSize * state.hand_size_err_mul);
+	}
+
+	if (state.first_frame) {
+		return;
+	}
+
+	for (int i = 0; i < 3; i++) {
+		J(row++, kParamTranslation + i) = stab.stabilityRootPosition;
+	}
+
+	const HandScalar orientation_weights[3] = {stab.stabilityHandOrientationXY, stab.stabilityHandOrientationXY,
+	                                           stab.stabilityHandOrientationZ};
+	const Vec3<HandScalar> &aax = hand.wrist_post_orientation_aax;
+
+	// Same branch as computeResidualStability.
+	const float epsilon = 0.001;
+	if (aax.x < epsilon && aax.y < epsilon && aax.z < epsilon) {
+		for (int i = 0; i < 3; i++) {
+			J(row++, kParamOrientation + i) = orientation_weights[i];
+		}
+	} else {
+		// d/da of 2sin(|a|/2) * a/|a|
+		Eigen::Vector3f a(aax.x, aax.y, aax.z);
+		HandScalar theta = a.norm();
+		Eigen::Vector3f u = a / theta;
+		Eigen::Matrix3f uut = u * u.transpose();
+		Eigen::Matrix3f d = cos(theta / 2) * uut + (2 * sin(theta / 2) / theta) * (Eigen::Matrix3f::Identity() - uut);
+
+		for (int i = 0; i < 3; i++) {
+			J.row(row++).template segment<3>(kParamOrientation) = d.row(i) * orientation_weights[i];
+		}
+	}
+
+	add_param(kParamThumb + 0, the_limit.thumb_mcp_swing_x, stab.stabilityThumbMCPSwing);
+	add_param(kParamThumb + 1, the_limit.thumb_mcp_swing_y, stab.stabilityThumbMCPSwing);
+	add_param(kParamThumb + 2, the_limit.thumb_mcp_twist, stab.stabilityThumbMCPTwist);
+	add_param(kParamThumb + 3, the_limit.thumb_curls[0], stab.stabilityCurlRoot);
+	add_param(kParamThumb + 4, the_limit.thumb_curls[1], stab.stabilityCurlRoot);
+
+	for (int finger_idx = 0; finger_idx < 4; finger_idx++) {
+		const FingerLimit &limit = the_limit.fingers[finger_idx];
+		const int first_param = kParamFingers + (finger_idx * kFingerDim);
+
+		HandScalar obs_curl = HandScalar(get_avg_curl_value(*state.observation, finger_idx + 1));
+		HandScalar curl_sub_mul = calc_stability_curl_multiplier(last_hand.finger[finger_idx], obs_curl);
+
+		add_param(first_param + 0, limit.pxm_swing_x, stab.stabilityFingerPXMSwingX * curl_sub_mul);
+		add_param(first_param + 1, limit.pxm_swing_y, stab.stabilityFingerPXMSwingY);
+		add_param(first_param + 2, limit.curls[0], stab.stabilityCurlRoot * curl_sub_mul);
+		add_param(first_param + 3, limit.curls[1], stab.stabilityCurlRoot * curl_sub_mul);
+	}
+}
+
+/*!
+ * Computes the same Jacobian autodiff would for CostFunctor, column-major.
+ */
+template <bool optimize_hand_size>
+static void
+eval_analytic_jacobian(const KinematicHandLM &state, const HandScalar *x, size_t num_residuals, HandScalar *jacobian)
+{
+	XRT_TRACE_MARKER();
+
+	constexpr int kNumParams = calc_input_size(optimize_hand_size);
+
+	Eigen::Map<Eigen::Matrix<HandScalar, Eigen::Dynamic, kNumParams>> J(jacobian, num_residuals, kNumParams);
+	J.setZero();
+
+	OptimizerHand<HandScalar> hand = {};
+	JointsWithJacobian<kNumParams> joints;
+	eval_joints_with_jacobian<optimize_hand_size>(state, x, hand, joints);
+
+	size_t row = 0;
+	jacobian_positions_part<optimize_hand_size>(state, x, hand, joints, J, row);
+	jacobian_stability_part<optimize_hand_size>(state, x, hand, J, row);
+
+	assert(row == num_residuals);
+}
+
+#endif // LM_HAVE_ANALYTIC_JACOBIAN
+
+/*!
+ * Solver function using CostFunctor for the residuals, like TinySolverAutoDiffFunction, but with an analytic Jacobian
+ * if we have one for the current set of residuals.
+ */
+template <bool optimize_hand_size> struct AnalyticCostFunction
+{
+	using Scalar = HandScalar;
+	enum
+	{
+		NUM_RESIDUALS = Eigen::Dynamic,
+		NUM_PARAMETERS = calc_input_size(optimize_hand_size),
+	};
+
+	const CostFunctor<optimize_hand_size> &cost_functor;
+
+	explicit AnalyticCostFunction(const CostFunctor<optimize_hand_size> &cost_functor) : cost_functor(cost_functor)
+	{}
+
+	bool
+	operator()(const HandScalar *parameters, HandScalar *residuals, HandScalar *jacobian) const
+	{
+		if (!cost_functor(parameters, residuals)) {
+			return false;
+		}
+		if (jacobian != nullptr) {
+#ifdef LM_HAVE_ANALYTIC_JACOBIAN
+			eval_analytic_jacobian<optimize_hand_size>(cost_functor.parent, parameters, NumResiduals(),
+			                                           jacobian);
+#else
+			// Fall back to autodiff when hacking on the residuals.
+			ceres::TinySolverAutoDiffFunction<CostFunctor<optimize_hand_size>, Eigen::Dynamic,
+			                                  NUM_PARAMETERS, HandScalar>
+			    autodiff(cost_functor);
+			return autodiff(parameters, residuals, jacobian);
+#endif
+		}
+		return true;
+	}
+
+	int
+	NumResiduals() const
+	{
+		return (int)cost_functor.NumResiduals();
+	}
+};
+
 // look at tests_quat_change_of_basis
 #if 0
 template <typename T>
@@ -840,25 +1312,13 @@ eval_to_viz_hand(KinematicHandLM &state,
 	out_viz_hand.is_active = true;
 }
 
-template <bool optimize_hand_size>
-inline float
-opt_run(KinematicHandLM &state, one_frame_input &observation, xrt_hand_joint_set &out_viz_hand)
+template <typename Function>
+static void
+opt_solve(KinematicHandLM &state, const Function &f)
 {
-	constexpr size_t input_size = calc_input_size(optimize_hand_size);
-
-	size_t residual_size = calc_residual_size(state.use_stability, optimize_hand_size, state.num_observation_views);
-
-	LM_DEBUG(state, "Running with %zu inputs and %zu residuals, viewed in %d cameras", input_size, residual_size,
-	         state.num_observation_views);
-
-	CostFunctor<optimize_hand_size> cf(state, residual_size);
+	constexpr size_t input_size = Function::NUM_PARAMETERS;
 
-	using AutoDiffCostFunctor =
-	    ceres::TinySolverAutoDiffFunction<CostFunctor<optimize_hand_size>, Eigen::Dynamic, input_size, HandScalar>;
-
-	AutoDiffCostFunctor f(cf);
-
-	ceres::TinySolver<AutoDiffCostFunctor> solver = {};
+	ceres::TinySolver<Function> solver = {};
 	solver.options.max_num_iterations = 30;
 
 	//!@todo We don't yet know what "good" termination conditions are.
@@ -912,6 +1372,31 @@ opt_run(KinematicHandLM &state, one_frame_input &observation, xrt_hand_joint_set
 			LM_DEBUG(state, "Suspiciouisly low number of iterations!");
 		}
 	}
+}
+
+template <bool optimize_hand_size>
+inline float
+opt_run(KinematicHandLM &state, one_frame_input &observation, xrt_hand_joint_set &out_viz_hand)
+{
+	constexpr size_t input_size = calc_input_size(optimize_hand_size);
+
+	size_t residual_size = calc_residual_size(state.use_stability, optimize_hand_size, state.num_observation_views);
+
+	LM_DEBUG(state, "Running with %zu inputs and %zu residuals, viewed in %d cameras", input_size, residual_size,
+	         state.num_observation_views);
+
+	CostFunctor<optimize_hand_size> cf(state, residual_size);
+
+	if (state.use_analytic_jacobian) {
+		AnalyticCostFunction<optimize_hand_size> f(cf);
+		opt_solve(state, f);
+	} else {
+		using AutoDiffCostFunctor = ceres::TinySolverAutoDiffFunction<CostFunctor<optimize_hand_size>,
+		                                                              Eigen::Dynamic, input_size, HandScalar>;
+		AutoDiffCostFunctor f(cf);
+		opt_solve(state, f);
+	}
+
 	return 0;
 }
 
@@ -950,22 +1435,17 @@ optimizer_finish(KinematicHandLM &state, xrt_hand_joint_set &out_viz_hand, float
 	out_reprojection_error = sum;
 }
 
-void
-optimizer_run(KinematicHandLM *hand,
-              one_frame_input &observation,
-              bool hand_was_untracked_last_frame,
-              float smoothing_factor, //!<- Unused if this is the first frame
-              bool optimize_hand_size,
-              float target_hand_size,
-              float hand_size_err_mul,
-              float amt_use_depth,
-              xrt_hand_joint_set &out_viz_hand,
-              float &out_hand_size,
-              float &out_reprojection_error) // NOLINT(bugprone-easily-swappable-parameters)
+// Sets up the hand's state for optimizing against this observation.
+static void
+optimizer_prepare(KinematicHandLM &state,
+                  one_frame_input &observation,
+                  bool hand_was_untracked_last_frame,
+                  float smoothing_factor,
+                  bool optimize_hand_size,
+                  float target_hand_size,
+                  float hand_size_err_mul,
+                  float amt_use_depth) // NOLINT(bugprone-easily-swappable-parameters)
 {
-	numerics_checker::set_floating_exceptions();
-
-	KinematicHandLM &state = *hand;
 	state.smoothing_factor = smoothing_factor;
 
 	xrt_pose blah = XRT_POSE_IDENTITY;
@@ -1047,7 +1527,26 @@ optimizer_run(KinematicHandLM *hand,
 
 
 #endif
+}
+
+void
+optimizer_run(KinematicHandLM *hand,
+              one_frame_input &observation,
+              bool hand_was_untracked_last_frame,
+              float smoothing_factor, //!<- Unused if this is the first frame
+              bool optimize_hand_size,
+              float target_hand_size,
+              float hand_size_err_mul,
+              float amt_use_depth,
+              xrt_hand_joint_set &out_viz_hand,
+              float &out_hand_size,
+              float &out_reprojection_error) // NOLINT(bugprone-easily-swappable-parameters)
+{
+	numerics_checker::set_floating_exceptions();
 
+	KinematicHandLM &state = *hand;
+	optimizer_prepare(state, observation, hand_was_untracked_last_frame, smoothing_factor, optimize_hand_size,
+	                  target_hand_size, hand_size_err_mul, amt_use_depth);
 
 	// For now, we have to statically instantiate different versions of the optimizer depending on
 	// how many input parameters there are. For now, there are only two cases - either we are
@@ -1095,6 +1594,63 @@ optimizer_run(KinematicHandLM *hand,
 	numerics_checker::remove_floating_exceptions();
 }
 
+template <bool optimize_hand_size>
+static void
+eval_jacobians(KinematicHandLM &state,
+               const std::vector<float> &params_offset,
+               std::vector<float> &out_autodiff,
+               std::vector<float> &out_analytic,
+               size_t &out_num_residuals)
+{
+	constexpr size_t input_size = calc_input_size(optimize_hand_size);
+
+	size_t residual_size = calc_residual_size(state.use_stability, optimize_hand_size, state.num_observation_views);
+
+	Eigen::Matrix<HandScalar, input_size, 1> x = state.TinyOptimizerInput.head<input_size>();
+	for (size_t i = 0; i < input_size && i < params_offset.size(); i++) {
+		x[i] += params_offset[i];
+	}
+
+	CostFunctor<optimize_hand_size> cf(state, residual_size);
+	std::vector<HandScalar> residuals(residual_size);
+
+	out_autodiff.resize(residual_size * input_size);
+	ceres::TinySolverAutoDiffFunction<CostFunctor<optimize_hand_size>, Eigen::Dynamic, input_size, HandScalar>
+	    autodiff(cf);
+	autodiff(x.data(), residuals.data(), out_autodiff.data());
+
+	out_analytic.resize(residual_size * input_size);
+	AnalyticCostFunction<optimize_hand_size> analytic(cf);
+	analytic(x.data(), residuals.data(), out_analytic.data());
+
+	out_num_residuals = residual_size;
+}
+
+void
+optimizer_eval_jacobians(KinematicHandLM *hand,
+                         one_frame_input &observation,
+                         bool hand_was_untracked_last_frame,
+                         float smoothing_factor,
+                         bool optimize_hand_size,
+                         float target_hand_size,
+                         float hand_size_err_mul,
+                         float amt_use_depth,
+                         const std::vector<float> &params_offset,
+                         std::vector<float> &out_autodiff,
+                         std::vector<float> &out_analytic,
+                         size_t &out_num_residuals) // NOLINT(bugprone-easily-swappable-parameters)
+{
+	KinematicHandLM &state = *hand;
+	optimizer_prepare(state, observation, hand_was_untracked_last_frame, smoothing_factor, optimize_hand_size,
+	                  target_hand_size, hand_size_err_mul, amt_use_depth);
+
+	if (optimize_hand_size) {
+		eval_jacobians<true>(state, params_offset, out_autodiff, out_analytic, out_num_residuals);
+	} else {
+		eval_jacobians<false>(state, params_offset, out_autodiff, out_analytic, out_num_residuals);
+	}
+}
+
 
 
 void
@@ -1105,6 +1661,7 @@ optimizer_create(xrt_pose left_in_right, bool is_right, u_logging_level log_leve
 	hand->is_right = is_right;
 	hand->left_in_right = left_in_right;
 	hand->log_level = log_level;
+	hand->use_analytic_jacobian = debug_get_bool_option_lm_analytic_jacobian();
 
 	hand->left_in_right_translation.x = left_in_right.position.x;
 	hand->left_in_right_translation.y = left_in_right.position.y;
@@ -1118,6 +1675,12 @@ optimizer_create(xrt_pose left_in_right, bool is_right, u_logging_level log_leve
 	*out_kinematic_hand = hand;
 }
 
+void
+optimizer_set_analytic_jacobian(KinematicHandLM *hand, bool enabled)
+{
+	hand->use_analytic_jacobian = enabled;
+}
+
 void
 optimizer_destroy(KinematicHandLM **hand)
 {
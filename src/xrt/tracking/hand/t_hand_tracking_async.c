@@ -118,6 +118,13 @@ ht_async_mainloop(void *ptr)
 		xrt_frame_reference(&hta->frames[0], NULL);
 		xrt_frame_reference(&hta->frames[1], NULL);
 
+		// A pipelined tracker has nothing for us on its first frame.
+		if (hta->working.timestamp == 0) {
+			hta->hand_tracking_work_active = false;
+			os_thread_helper_lock(&hta->mainloop);
+			continue;
+		}
+
 
 		/*
 		 * Post process.
@@ -0,0 +1,27 @@
+// Copyright 2025, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Utilities for tests involving poses
+ * @author agent <agent@local>
+ */
+
+#pragma once
+
+#include "xrt/xrt_defines.h"
+
+#include "math/m_api.h"
+
+#include <random>
+
+
+//! A pose with a random normalized orientation and a position in the [-1, 1] cube.
+static inline xrt_pose
+random_pose(std::mt19937 &rng)
+{
+	std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+
+	xrt_pose pose = {{dist(rng), dist(rng), dist(rng), dist(rng)}, {dist(rng), dist(rng), dist(rng)}};
+	math_quat_normalize(&pose.orientation);
+	return pose;
+}
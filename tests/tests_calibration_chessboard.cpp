@@ -0,0 +1,114 @@
+// Copyright 2025, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Tests for the coarse chessboard search of the calibration.
+ * @author agent <agent@local>
+ */
+
+#include <tracking/t_calibration_opencv.hpp>
+
+#include "catch_amalgamated.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+
+using xrt::auxiliary::tracking::calibration_find_chessboard_corners;
+
+namespace {
+
+constexpr int kWidth = 1280;
+constexpr int kHeight = 960;
+constexpr int kSquare = 80;
+constexpr int kCols = 10;
+constexpr int kRows = 8;
+
+/*!
+ * A rotated and slightly shrunk board, returns the true positions of the inner
+ * corners in @p out_corners.
+ */
+cv::Mat
+make_board(std::vector<cv::Point2f> &out_corners)
+{
+	cv::Mat flat(kHeight, kWidth, CV_8UC1, cv::Scalar(255));
+
+	int x0 = (kWidth - kCols * kSquare) / 2;
+	int y0 = (kHeight - kRows * kSquare) / 2;
+	for (int r = 0; r < kRows; r++) {
+		for (int c = 0; c < kCols; c++) {
+			if ((r + c) % 2 == 0) {
+				flat(cv::Rect(x0 + c * kSquare, y0 + r * kSquare, kSquare, kSquare)) = cv::Scalar(0);
+			}
+		}
+	}
+
+	cv::Mat M = cv::getRotationMatrix2D(cv::Point2f(kWidth / 2.0f, kHeight / 2.0f), 10, 0.9);
+
+	cv::Mat board;
+	cv::warpAffine(flat, board, M, flat.size(), cv::INTER_LINEAR, cv::BORDER_CONSTANT, cv::Scalar(255));
+	cv::GaussianBlur(board, board, cv::Size(3, 3), 0);
+
+	// Square edges are between pixels, half a pixel before the pixel centers.
+	std::vector<cv::Point2f> flat_corners;
+	for (int r = 1; r < kRows; r++) {
+		for (int c = 1; c < kCols; c++) {
+			flat_corners.emplace_back(x0 + c * kSquare - 0.5f, y0 + r * kSquare - 0.5f);
+		}
+	}
+	cv::transform(flat_corners, out_corners, M);
+
+	return board;
+}
+
+//! Largest distance from a corner in @p a to the closest corner in @p b.
+float
+max_distance(const std::vector<cv::Point2f> &a, const std::vector<cv::Point2f> &b)
+{
+	float max = 0;
+	for (const cv::Point2f &p : a) {
+		float closest = INFINITY;
+		for (const cv::Point2f &q : b) {
+			closest = std::min(closest, (float)cv::norm(p - q));
+		}
+		max = std::max(max, closest);
+	}
+	return max;
+}
+
+} // namespace
+
+
+TEST_CASE("Coarse chessboard search")
+{
+	std::vector<cv::Point2f> truth;
+	cv::Mat gray = make_board(truth);
+	cv::Size dims(kCols - 1, kRows - 1);
+
+	// Full resolution search with subpixel refinement.
+	std::vector<cv::Mat> full_pyramid;
+	std::vector<cv::Point2f> full;
+	REQUIRE(calibration_find_chessboard_corners(gray, dims, 0, true, 5, full_pyramid, full));
+	CHECK(full_pyramid.empty());
+
+	// Searched at half resolution, refined on the full one.
+	std::vector<cv::Mat> coarse_pyramid;
+	std::vector<cv::Point2f> coarse;
+	REQUIRE(calibration_find_chessboard_corners(gray, dims, kWidth / 2, false, 5, coarse_pyramid, coarse));
+	REQUIRE(coarse_pyramid.size() == 1);
+	CHECK(coarse_pyramid[0].cols == kWidth / 2);
+
+	REQUIRE(full.size() == truth.size());
+	REQUIRE(coarse.size() == truth.size());
+
+	// Both end up on the same corners, which are where the board has them.
+	CHECK(max_distance(coarse, full) < 0.1f);
+	CHECK(max_distance(full, truth) < 0.25f);
+	CHECK(max_distance(coarse, truth) < 0.25f);
+
+	// The pyramid is reused for the next frame.
+	const uint8_t *data = coarse_pyramid[0].data;
+	REQUIRE(calibration_find_chessboard_corners(gray, dims, kWidth / 2, false, 5, coarse_pyramid, coarse));
+	CHECK(coarse_pyramid[0].data == data);
+}
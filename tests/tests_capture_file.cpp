@@ -0,0 +1,170 @@
+// Copyright 2025, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Capture file writer and reader tests.
+ * @author agent <agent@local>
+ */
+
+#include <tracking/t_capture.h>
+
+#include "catch_amalgamated.hpp"
+
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+
+namespace {
+
+constexpr uint32_t kWidth = 5;
+constexpr uint32_t kHeight = 3;
+constexpr uint32_t kStride = 8; // Padded, the writer should drop the padding.
+constexpr uint32_t kFrameCount = 4;
+
+std::string
+temp_path()
+{
+	return (std::filesystem::temp_directory_path() / "tests_capture_file.xrtcap").string();
+}
+
+uint8_t
+pixel_value(uint32_t cam, uint32_t frame, uint32_t x, uint32_t y)
+{
+	return (uint8_t)(cam * 100 + frame * 10 + y * kWidth + x);
+}
+
+void
+write_test_file(const std::string &path)
+{
+	struct t_capture_writer *writer = nullptr;
+	REQUIRE(t_capture_writer_create(path.c_str(), 2, &writer) == 0);
+
+	std::vector<uint8_t> pixels(kStride * kHeight);
+	for (uint32_t f = 0; f < kFrameCount; f++) {
+		// Write the second camera first, the reader sorts by timestamp per camera.
+		for (uint32_t cam : {1u, 0u}) {
+			for (uint32_t y = 0; y < kHeight; y++) {
+				for (uint32_t x = 0; x < kWidth; x++) {
+					pixels[y * kStride + x] = pixel_value(cam, f, x, y);
+				}
+			}
+
+			struct xrt_frame xf = {};
+			xf.width = kWidth;
+			xf.height = kHeight;
+			xf.stride = kStride;
+			xf.data = pixels.data();
+			xf.format = XRT_FORMAT_L8;
+			xf.timestamp = 1000 + f * 100;
+			CHECK(t_capture_writer_write_frame(writer, cam, &xf) == 0);
+		}
+	}
+
+	struct xrt_imu_sample imus[3] = {
+	    {10, {1, 2, 3}, {4, 5, 6}},
+	    {20, {7, 8, 9}, {10, 11, 12}},
+	    {30, {13, 14, 15}, {16, 17, 18}},
+	};
+	CHECK(t_capture_writer_write_imu(writer, imus, 2) == 0);
+	CHECK(t_capture_writer_write_imu(writer, &imus[2], 1) == 0);
+
+	struct xrt_pose_sample gt = {50, {{0, 0, 0, 1}, {1, 2, 3}}};
+	CHECK(t_capture_writer_write_gt(writer, &gt, 1) == 0);
+
+	REQUIRE(t_capture_writer_destroy(&writer) == 0);
+	CHECK(writer == nullptr);
+}
+
+void
+check_test_file(const std::string &path)
+{
+	REQUIRE(t_capture_is_capture_file(path.c_str()));
+
+	struct t_capture_reader *reader = nullptr;
+	REQUIRE(t_capture_reader_open(path.c_str(), &reader) == 0);
+
+	CHECK(reader->cam_count == 2);
+	CHECK(reader->frame_counts[0] == kFrameCount);
+	CHECK(reader->frame_counts[1] == kFrameCount);
+	REQUIRE(reader->imu_count == 3);
+	CHECK(reader->imus[2].timestamp_ns == 30);
+	CHECK(reader->imus[2].gyro_rad_secs.z == 18);
+	REQUIRE(reader->gt_count == 1);
+	CHECK(reader->gts[0].pose.position.y == 2.0f);
+	CHECK(reader->gts[0].pose.orientation.w == 1.0f);
+
+	uint32_t index = 0;
+	CHECK_FALSE(t_capture_reader_find_frame(reader, 1, 1050, &index));
+	REQUIRE(t_capture_reader_find_frame(reader, 1, 1200, &index));
+	CHECK(index == 2);
+
+	struct xrt_frame *xf = nullptr;
+	t_capture_reader_wrap_frame(reader, 1, index, &xf);
+	REQUIRE(xf != nullptr);
+
+	// The frame keeps the mapping alive.
+	t_capture_reader_reference(&reader, nullptr);
+
+	CHECK(xf->width == kWidth);
+	CHECK(xf->height == kHeight);
+	CHECK(xf->stride == kWidth);
+	CHECK(xf->format == XRT_FORMAT_L8);
+	CHECK(xf->timestamp == 1200);
+	bool pixels_match = true;
+	for (uint32_t y = 0; y < kHeight; y++) {
+		for (uint32_t x = 0; x < kWidth; x++) {
+			pixels_match = pixels_match && xf->data[y * xf->stride + x] == pixel_value(1, 2, x, y);
+		}
+	}
+	CHECK(pixels_match);
+
+	// Writing to the frame is allowed, but must not change the file.
+	xf->data[0] = 0xff;
+	xrt_frame_reference(&xf, nullptr);
+}
+
+} // namespace
+
+
+TEST_CASE("t_capture")
+{
+	std::string path = temp_path();
+	write_test_file(path);
+
+	SECTION("closed file uses the index")
+	{
+		check_test_file(path);
+		check_test_file(path);
+	}
+
+	SECTION("file without index is scanned")
+	{
+		// Pretend the recording was never closed.
+		FILE *file = fopen(path.c_str(), "r+b");
+		REQUIRE(file != nullptr);
+		uint64_t zero = 0;
+		fseek(file, offsetof(struct t_capture_file_header, index_offset), SEEK_SET);
+		fwrite(&zero, sizeof(zero), 1, file);
+		fclose(file);
+
+		check_test_file(path);
+	}
+
+	SECTION("other files are rejected")
+	{
+		FILE *file = fopen(path.c_str(), "wb");
+		REQUIRE(file != nullptr);
+		fputs("#timestamp [ns],filename\n", file);
+		fclose(file);
+
+		CHECK_FALSE(t_capture_is_capture_file(path.c_str()));
+		struct t_capture_reader *reader = nullptr;
+		CHECK(t_capture_reader_open(path.c_str(), &reader) != 0);
+		CHECK(reader == nullptr);
+	}
+
+	std::remove(path.c_str());
+}
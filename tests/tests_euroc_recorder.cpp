@@ -0,0 +1,210 @@
+// Copyright 2025, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief EuRoC recorder tests.
+ * @author agent <agent@local>
+ */
+
+#include <tracking/t_euroc_recorder.h>
+#include <util/u_frame.h>
+#include <os/os_time.h>
+
+#include "catch_amalgamated.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace {
+
+constexpr uint32_t kWidth = 640;
+constexpr uint32_t kHeight = 480;
+constexpr uint32_t kFrameSets = 60;
+
+std::vector<std::string>
+read_rows(const std::filesystem::path &path)
+{
+	std::ifstream file(path);
+	REQUIRE(file.is_open());
+
+	std::vector<std::string> rows;
+	std::string line;
+	while (std::getline(file, line)) {
+		if (!line.empty() && line[0] != '#') {
+			rows.push_back(line);
+		}
+	}
+	return rows;
+}
+
+std::vector<std::filesystem::path>
+find_datasets(const std::filesystem::path &dir, const std::string &prefix)
+{
+	std::vector<std::filesystem::path> datasets;
+	for (const auto &entry : std::filesystem::directory_iterator(dir)) {
+		if (entry.path().filename().string().rfind(prefix + "_", 0) == 0) {
+			datasets.push_back(entry.path());
+		}
+	}
+	return datasets;
+}
+
+std::filesystem::path
+find_dataset(const std::filesystem::path &dir, const std::string &prefix)
+{
+	for (const auto &entry : std::filesystem::directory_iterator(dir)) {
+		if (entry.path().filename().string().rfind(prefix + "_", 0) == 0) {
+			return entry.path();
+		}
+	}
+	FAIL("No dataset directory found");
+	return {};
+}
+
+} // namespace
+
+
+TEST_CASE("euroc_recorder drops whole frame sets")
+{
+	/*
+	 * One encoding thread forces drops, the odd limit has room for a frame
+	 * of a second stereo pair but not for both of them.
+	 */
+	setenv("EUROC_RECORDER_THREADS", "1", 1);
+	setenv("EUROC_RECORDER_MAX_PENDING", "3", 1);
+
+	std::filesystem::path dir = std::filesystem::temp_directory_path() / "tests_euroc_recorder";
+	std::filesystem::remove_all(dir);
+	std::filesystem::create_directories(dir);
+	std::string prefix = "rec";
+
+	struct xrt_frame_context xfctx = {};
+	struct xrt_slam_sinks *sinks = euroc_recorder_create(&xfctx, (dir / prefix).c_str(), 2, true);
+	REQUIRE(sinks != nullptr);
+
+	// Noise makes the images slow to encode.
+	std::mt19937 rng(7);
+	std::vector<struct xrt_frame *> frames;
+	for (uint32_t i = 0; i < kFrameSets; i++) {
+		for (uint32_t cam = 0; cam < 2; cam++) {
+			struct xrt_frame *xf = nullptr;
+			u_frame_create_one_off(XRT_FORMAT_L8, kWidth, kHeight, &xf);
+			REQUIRE(xf != nullptr);
+			for (uint32_t k = 0; k < xf->size; k++) {
+				xf->data[k] = (uint8_t)rng();
+			}
+			xf->timestamp = 1000000 + i * 1000;
+			frames.push_back(xf);
+		}
+	}
+
+	// Push them all at once, much faster than they can be encoded.
+	for (size_t i = 0; i < frames.size(); i++) {
+		xrt_sink_push_frame(sinks->cams[i % 2], frames[i]);
+	}
+
+	// The queues hold a reference until the frame has been handed to the recorder.
+	for (int i = 0; i < 10000; i++) {
+		bool delivered = true;
+		for (struct xrt_frame *xf : frames) {
+			delivered = delivered && xrt_atomic_s32_cmpxchg(&xf->reference.count, 1, 1) == 1;
+		}
+		if (delivered) {
+			break;
+		}
+		os_nanosleep(U_TIME_1MS_IN_NS);
+	}
+
+	euroc_recorder_stop(sinks);
+	xrt_frame_context_destroy_nodes(&xfctx);
+
+	for (struct xrt_frame *xf : frames) {
+		xrt_frame_reference(&xf, nullptr);
+	}
+
+	std::filesystem::path dataset = find_dataset(dir, prefix);
+	std::vector<std::string> cam0 = read_rows(dataset / "mav0/cam0/data.csv");
+	std::vector<std::string> cam1 = read_rows(dataset / "mav0/cam1/data.csv");
+
+	// Some frames were dropped, but always on both cameras.
+	CHECK(cam0.size() > 0);
+	CHECK(cam0.size() < kFrameSets);
+	CHECK(cam0 == cam1);
+
+	for (const std::string &row : cam0) {
+		std::string filename = row.substr(row.find(',') + 1);
+		if (!filename.empty() && filename.back() == '\r') {
+			filename.pop_back();
+		}
+		CHECK(std::filesystem::exists(dataset / "mav0/cam0/data" / filename));
+		CHECK(std::filesystem::exists(dataset / "mav0/cam1/data" / filename));
+	}
+
+	std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("euroc_recorder restarts while frames arrive")
+{
+	setenv("EUROC_RECORDER_THREADS", "2", 1);
+	setenv("EUROC_RECORDER_MAX_PENDING", "8", 1);
+
+	std::filesystem::path dir = std::filesystem::temp_directory_path() / "tests_euroc_recorder_restart";
+	std::filesystem::remove_all(dir);
+	std::filesystem::create_directories(dir);
+	std::string prefix = "rec";
+
+	struct xrt_frame_context xfctx = {};
+	struct xrt_slam_sinks *sinks = euroc_recorder_create(&xfctx, (dir / prefix).c_str(), 2, true);
+	REQUIRE(sinks != nullptr);
+
+	std::atomic<bool> running{true};
+	std::thread producer([&] {
+		for (uint64_t i = 0; running; i++) {
+			for (uint32_t cam = 0; cam < 2; cam++) {
+				struct xrt_frame *xf = nullptr;
+				u_frame_create_one_off(XRT_FORMAT_L8, 64, 64, &xf);
+				xf->timestamp = 1000000 + i * 1000;
+				xrt_sink_push_frame(sinks->cams[cam], xf);
+				xrt_frame_reference(&xf, nullptr);
+			}
+
+			struct xrt_imu_sample sample = {};
+			sample.timestamp_ns = 1000000 + i * 1000;
+			xrt_sink_push_imu(sinks->imu, &sample);
+
+			os_nanosleep(U_TIME_1MS_IN_NS / 4);
+		}
+	});
+
+	// The datasets are named by the second, so wait one out between recordings.
+	for (int i = 0; i < 2; i++) {
+		os_nanosleep(U_TIME_1S_IN_NS + U_TIME_1MS_IN_NS * 100);
+		euroc_recorder_stop(sinks);
+		euroc_recorder_start(sinks);
+	}
+	os_nanosleep(U_TIME_1MS_IN_NS * 100);
+
+	running = false;
+	producer.join();
+
+	euroc_recorder_stop(sinks);
+	xrt_frame_context_destroy_nodes(&xfctx);
+
+	std::vector<std::filesystem::path> datasets = find_datasets(dir, prefix);
+	CHECK(datasets.size() == 3);
+	for (const std::filesystem::path &dataset : datasets) {
+		std::vector<std::string> cam0 = read_rows(dataset / "mav0/cam0/data.csv");
+		std::vector<std::string> cam1 = read_rows(dataset / "mav0/cam1/data.csv");
+		CHECK(!cam0.empty());
+		CHECK(cam0 == cam1);
+	}
+
+	std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,177 @@
+// Copyright 2025, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Filter fifo tests.
+ * @author agent <agent@local>
+ */
+
+#include <math/m_filter_fifo.h>
+
+#include "catch_amalgamated.hpp"
+
+#include <random>
+#include <vector>
+
+
+namespace {
+
+struct Sample
+{
+	xrt_vec3 value;
+	uint64_t timestamp_ns;
+};
+
+//! Plain scan over the last @p num samples, how the fifo used to average.
+size_t
+reference_filter(const std::vector<Sample> &pushed, size_t num, uint64_t start_ns, uint64_t stop_ns, xrt_vec3 &out)
+{
+	double x = 0, y = 0, z = 0;
+	size_t count = 0;
+
+	// The fifo starts out full of zero samples at timepoint zero.
+	for (size_t i = 0; i < num; i++) {
+		Sample s = i < pushed.size() ? pushed[pushed.size() - 1 - i] : Sample{{0, 0, 0}, 0};
+		if (s.timestamp_ns < start_ns || s.timestamp_ns > stop_ns) {
+			continue;
+		}
+		x += s.value.x;
+		y += s.value.y;
+		z += s.value.z;
+		count++;
+	}
+
+	out = {0, 0, 0};
+	if (count > 0) {
+		out = {(float)(x / count), (float)(y / count), (float)(z / count)};
+	}
+	return count;
+}
+
+} // namespace
+
+
+TEST_CASE("m_ff_vec3_f32")
+{
+	constexpr size_t kNum = 64;
+
+	std::mt19937 rng(7);
+	std::uniform_real_distribution<float> value(-10.0f, 10.0f);
+	std::uniform_int_distribution<uint64_t> step(0, 3);
+
+	struct m_ff_vec3_f32 *ff = NULL;
+	m_ff_vec3_f32_alloc(&ff, kNum);
+
+	std::vector<Sample> pushed;
+	uint64_t ts = 1;
+
+	SECTION("windows match a plain scan while wrapping")
+	{
+		for (int i = 0; i < 1000; i++) {
+			// Repeated timestamps are allowed.
+			ts += step(rng);
+			Sample s = {{value(rng), value(rng), 9.81f + value(rng)}, ts};
+			m_ff_vec3_f32_push(ff, &s.value, s.timestamp_ns);
+			pushed.push_back(s);
+
+			std::uniform_int_distribution<uint64_t> when(0, ts + 2);
+			for (int k = 0; k < 4; k++) {
+				uint64_t a = when(rng);
+				uint64_t b = when(rng);
+
+				xrt_vec3 got = {};
+				xrt_vec3 expected = {};
+				size_t got_count = m_ff_vec3_f32_filter(ff, a, b, &got);
+				size_t expected_count = reference_filter(pushed, kNum, a, b, expected);
+
+				REQUIRE(got_count == expected_count);
+				CHECK(got.x == Catch::Approx(expected.x).margin(1e-4));
+				CHECK(got.y == Catch::Approx(expected.y).margin(1e-4));
+				CHECK(got.z == Catch::Approx(expected.z).margin(1e-4));
+			}
+		}
+	}
+
+	SECTION("batch push is the same as single pushes")
+	{
+		struct m_ff_vec3_f32 *single = NULL;
+		m_ff_vec3_f32_alloc(&single, kNum);
+
+		for (int packet = 0; packet < 50; packet++) {
+			xrt_vec3 values[10];
+			uint64_t timestamps[10];
+			size_t count = 3 + packet % 8;
+			for (size_t i = 0; i < count; i++) {
+				ts += 1 + step(rng);
+				values[i] = {value(rng), value(rng), value(rng)};
+				timestamps[i] = ts;
+				m_ff_vec3_f32_push(single, &values[i], ts);
+			}
+			m_ff_vec3_f32_push_batch(ff, values, timestamps, count);
+		}
+
+		for (size_t i = 0; i < kNum; i++) {
+			xrt_vec3 a, b;
+			uint64_t a_ts, b_ts;
+			REQUIRE(m_ff_vec3_f32_get(ff, i, &a, &a_ts));
+			REQUIRE(m_ff_vec3_f32_get(single, i, &b, &b_ts));
+			CHECK(a_ts == b_ts);
+			CHECK(a.x == b.x);
+		}
+
+		xrt_vec3 a, b;
+		CHECK(m_ff_vec3_f32_filter(ff, ts - 40, ts, &a) == m_ff_vec3_f32_filter(single, ts - 40, ts, &b));
+		CHECK(a.x == b.x);
+		CHECK(a.y == b.y);
+		CHECK(a.z == b.z);
+
+		m_ff_vec3_f32_free(&single);
+	}
+
+	SECTION("empty and reversed windows")
+	{
+		xrt_vec3 v = {1, 2, 3};
+		m_ff_vec3_f32_push(ff, &v, 100);
+
+		xrt_vec3 out = {5, 5, 5};
+		CHECK(m_ff_vec3_f32_filter(ff, 101, 200, &out) == 0);
+		CHECK(out.x == 0.0f);
+		CHECK(m_ff_vec3_f32_filter(ff, 100, 50, &out) == 0);
+		CHECK(m_ff_vec3_f32_filter(ff, 100, 100, &out) == 1);
+		CHECK(out.z == 3.0f);
+	}
+
+	m_ff_vec3_f32_free(&ff);
+	CHECK(ff == NULL);
+}
+
+TEST_CASE("m_ff_f64")
+{
+	constexpr size_t kNum = 16;
+
+	struct m_ff_f64 *ff = NULL;
+	m_ff_f64_alloc(&ff, kNum);
+
+	double values[5] = {1, 2, 3, 4, 5};
+	uint64_t timestamps[5] = {10, 20, 30, 40, 50};
+	for (int i = 0; i < 10; i++) {
+		m_ff_f64_push_batch(ff, values, timestamps, 5);
+		for (uint64_t &t : timestamps) {
+			t += 50;
+		}
+	}
+
+	// Last pushed are 1..5 at 460..500.
+	double out = 0;
+	CHECK(m_ff_f64_filter(ff, 460, 500, &out) == 5);
+	CHECK(out == Catch::Approx(3.0));
+	CHECK(m_ff_f64_filter(ff, 470, 490, &out) == 3);
+	CHECK(out == Catch::Approx(3.0));
+	CHECK(m_ff_f64_filter(ff, 440, 460, &out) == 3);
+	CHECK(out == Catch::Approx(3.0 + 1.0 / 3.0));
+	// Only the last 16 samples are kept, the oldest is 5 at 350.
+	CHECK(m_ff_f64_filter(ff, 0, 500, &out) == 16);
+	CHECK(m_ff_f64_filter(ff, 0, 330, &out) == 0);
+
+	m_ff_f64_free(&ff);
+}
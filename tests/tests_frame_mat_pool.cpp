@@ -0,0 +1,92 @@
+// Copyright 2025, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Pooled FrameMat tests.
+ * @author agent <agent@local>
+ */
+
+#include <tracking/t_frame_cv_mat_wrapper.hpp>
+
+#include "catch_amalgamated.hpp"
+
+
+using xrt::auxiliary::tracking::FrameMat;
+using xrt::auxiliary::tracking::FrameMatPool;
+
+
+TEST_CASE("FrameMatPool")
+{
+	std::shared_ptr<FrameMatPool> pool = FrameMatPool::create();
+	xrt_frame *xf = nullptr;
+	cv::Mat mat;
+
+	SECTION("memory is reused for the same format and size")
+	{
+		pool->allocR8G8B8(4, 6, &xf, mat);
+		REQUIRE(xf != nullptr);
+		CHECK(xf->format == XRT_FORMAT_R8G8B8);
+		CHECK(xf->width == 6);
+		CHECK(xf->height == 4);
+		CHECK(xf->stride == 18);
+		CHECK(mat.data == xf->data);
+
+		xrt_frame *first = xf;
+		uint8_t *first_data = xf->data;
+		xrt_frame_reference(&xf, NULL);
+
+		for (int i = 0; i < 10; i++) {
+			FrameMat::Params params = {XRT_STEREO_FORMAT_NONE, (uint64_t)i};
+			pool->allocR8G8B8(4, 6, &xf, mat, params);
+			CHECK(xf == first);
+			CHECK(xf->data == first_data);
+			CHECK(xf->timestamp == (uint64_t)i);
+			xrt_frame_reference(&xf, NULL);
+		}
+
+		// Different format, different memory.
+		pool->allocL8(4, 6, &xf, mat);
+		CHECK(xf->format == XRT_FORMAT_L8);
+		CHECK(xf->data != first_data);
+		xrt_frame_reference(&xf, NULL);
+	}
+
+	SECTION("wrapped matrices are let go of when the frame is returned")
+	{
+		cv::Mat ext(3, 3, CV_8UC1);
+
+		pool->wrapL8(ext, &xf, {XRT_STEREO_FORMAT_NONE, 42});
+		CHECK(xf->data == ext.data);
+		CHECK(xf->timestamp == 42);
+		CHECK(ext.u->refcount == 2);
+
+		xrt_frame *first = xf;
+		xrt_frame_reference(&xf, NULL);
+		CHECK(ext.u->refcount == 1);
+
+		// The wrapper is reused, without any fields from the last use.
+		pool->wrapL8(ext, &xf);
+		CHECK(xf == first);
+		CHECK(xf->timestamp == 0);
+		xrt_frame_reference(&xf, NULL);
+	}
+
+	SECTION("frames in use keep the pool alive")
+	{
+		pool->allocL8(2, 2, &xf, mat);
+		pool.reset();
+		mat.data[0] = 1;
+		xrt_frame_reference(&xf, NULL);
+	}
+
+	SECTION("more frames in use than are kept")
+	{
+		xrt_frame *frames[FrameMatPool::kMaxFree * 2] = {};
+		for (xrt_frame *&f : frames) {
+			pool->allocL8(2, 2, &f, mat);
+		}
+		for (xrt_frame *&f : frames) {
+			xrt_frame_reference(&f, NULL);
+		}
+	}
+}
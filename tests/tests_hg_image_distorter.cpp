@@ -0,0 +1,267 @@
+// Copyright 2025, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Tests for the camera lookup table of the hand tracking image distorter.
+ * @author agent <agent@local>
+ */
+
+#include "tracking/t_camera_models.h"
+
+#include "hg_sync.hpp"
+#include "hg_stereographic_unprojection.hpp"
+
+#include "catch_amalgamated.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+
+using namespace xrt::tracking::hand::mercury;
+
+namespace {
+
+constexpr int kCropSize = 128;
+constexpr float kMaxError = 0.05f;
+
+t_camera_model_params
+make_kb4_camera()
+{
+	t_camera_model_params dist = {};
+	dist.model = T_DISTORTION_FISHEYE_KB4;
+	dist.fx = 270;
+	dist.fy = 270;
+	dist.cx = 480;
+	dist.cy = 480;
+	dist.fisheye.k1 = 0.03f;
+	dist.fisheye.k2 = 0.01f;
+	dist.fisheye.k3 = -0.005f;
+	dist.fisheye.k4 = 0.001f;
+	return dist;
+}
+
+t_camera_model_params
+make_rt8_camera()
+{
+	t_camera_model_params dist = {};
+	dist.model = T_DISTORTION_OPENCV_RADTAN_8;
+	dist.fx = 420;
+	dist.fy = 420;
+	dist.cx = 320;
+	dist.cy = 240;
+	dist.rt8.k1 = -0.3f;
+	dist.rt8.k2 = 0.1f;
+	return dist;
+}
+
+t_camera_model_params
+scale_camera(const t_camera_model_params &dist, float scale)
+{
+	t_camera_model_params scaled = dist;
+	scaled.fx *= scale;
+	scaled.fy *= scale;
+	scaled.cx *= scale;
+	scaled.cy *= scale;
+	return scaled;
+}
+
+bool
+in_image(float x, float y, xrt_size size)
+{
+	return x >= 0 && y >= 0 && x < size.w && y < size.h;
+}
+
+// Bilinear lookup of the table at stereographic coordinates around the optical axis.
+bool
+lut_lookup(const stereographic_camera_lut &lut, float sg_x, float sg_y, float &out_x, float &out_y)
+{
+	constexpr int N = stereographic_camera_lut::kSize;
+	constexpr int32_t kInvalid = stereographic_camera_lut::kInvalid;
+
+	float u = (sg_x + lut.extent) * (N - 1) / (2 * lut.extent);
+	float v = (sg_y + lut.extent) * (N - 1) / (2 * lut.extent);
+	if (!(u >= 0 && u < N - 1 && v >= 0 && v < N - 1)) {
+		return false;
+	}
+
+	int j = (int)u;
+	int i = (int)v;
+	float fu = u - j;
+	float fv = v - i;
+
+	const int32_t *top = &lut.xy[(i * N + j) * 2];
+	const int32_t *bottom = top + N * 2;
+	if (top[0] == kInvalid || top[2] == kInvalid || bottom[0] == kInvalid || bottom[2] == kInvalid) {
+		return false;
+	}
+
+	float scale = 1.0f / (1 << stereographic_camera_lut::kFracBits);
+	out_x = ((1 - fv) * ((1 - fu) * top[0] + fu * top[2]) + fv * ((1 - fu) * bottom[0] + fu * bottom[2])) * scale;
+	out_y = ((1 - fv) * ((1 - fu) * top[1] + fu * top[3]) + fv * ((1 - fu) * bottom[1] + fu * bottom[3])) * scale;
+	return true;
+}
+
+void
+check_lut(const t_camera_model_params &dist, xrt_size size)
+{
+	stereographic_camera_lut lut;
+	make_stereographic_camera_lut(dist, size, lut);
+
+	// Several samples per table cell, so that the middle of the cells are covered.
+	constexpr int kSteps = 1000;
+
+	float max_error = 0;
+	int checked = 0;
+	// Pixels in the image that the table says the camera can't see.
+	int missing = 0;
+
+	for (int i = 0; i < kSteps; i++) {
+		for (int j = 0; j < kSteps; j++) {
+			float sg_x = lut.extent * (2 * (j + 0.5f) / kSteps - 1);
+			float sg_y = lut.extent * (2 * (i + 0.5f) / kSteps - 1);
+
+			float r2 = sg_x * sg_x + sg_y * sg_y;
+			float denom = 1 + r2;
+
+			float x = {};
+			float y = {};
+			if (!t_camera_models_project(&dist, (2 * sg_x) / denom, (2 * sg_y) / denom, (1 - r2) / denom, &x,
+			                             &y) ||
+			    !in_image(x, y, size)) {
+				continue;
+			}
+
+			float lut_x = {};
+			float lut_y = {};
+			if (!lut_lookup(lut, sg_x, sg_y, lut_x, lut_y)) {
+				missing++;
+				continue;
+			}
+
+			max_error = std::max(max_error, std::hypot(lut_x - x, lut_y - y));
+			checked++;
+		}
+	}
+
+	CHECK(missing == 0);
+	CHECK(checked > kSteps * kSteps / 4);
+	CHECK(max_error < kMaxError);
+}
+
+void
+check_remap_maps(const t_camera_model_params &dist, xrt_size size, float scale)
+{
+	stereographic_camera_lut lut;
+	make_stereographic_camera_lut(dist, size, lut);
+
+	// The maps are made at a different resolution than the table.
+	t_camera_model_params scaled = scale_camera(dist, scale);
+	xrt_size scaled_size = {(int)(size.w * scale), (int)(size.h * scale)};
+
+	std::mt19937 rng(3);
+	std::uniform_real_distribution<float> unit(-1, 1);
+
+	float max_error = 0;
+	int checked = 0;
+	// Pixels in the image that the table says the camera can't see.
+	int missing = 0;
+
+	for (int crop = 0; crop < 50; crop++) {
+		projection_instructions instructions(scaled);
+
+		// Crops from around the middle to near the corners, -Z forward.
+		Eigen::Vector3f direction(unit(rng) * 0.6f, unit(rng) * 0.6f, -1);
+		direction.normalize();
+
+		instructions.rot_quat = Eigen::Quaternionf::FromTwoVectors(-Eigen::Vector3f::UnitZ(), direction) *
+		                        Eigen::Quaternionf(Eigen::AngleAxisf(unit(rng) * 3, Eigen::Vector3f::UnitZ()));
+		instructions.stereographic_radius = 0.2f + 0.3f * std::fabs(unit(rng));
+		instructions.flip = (crop & 1) != 0;
+
+		cv::Mat map_xy(kCropSize, kCropSize, CV_16SC2);
+		cv::Mat map_frac(kCropSize, kCropSize, CV_16UC1);
+		make_remap_maps(lut, scaled, instructions, cv::Size(scaled_size.w, scaled_size.h), map_xy, map_frac);
+
+		const float radius = instructions.stereographic_radius;
+
+		for (int y = 0; y < kCropSize; y++) {
+			for (int x = 0; x < kCropSize; x++) {
+				float sg_x = -radius + (2 * radius * x) / kCropSize;
+				float sg_y = radius - (2 * radius * y) / kCropSize;
+				if (instructions.flip) {
+					sg_x = -sg_x;
+				}
+
+				Eigen::Vector3f dir = instructions.rot_quat * stereographic_unprojection(sg_x, sg_y);
+
+				float px = {};
+				float py = {};
+				if (!t_camera_models_flip_and_project(&scaled, dir.x(), dir.y(), dir.z(), &px, &py) ||
+				    !in_image(px, py, scaled_size)) {
+					continue;
+				}
+
+				cv::Vec2s xy = map_xy.at<cv::Vec2s>(y, x);
+				uint16_t frac = map_frac.at<uint16_t>(y, x);
+
+				// Invalid entries point at the border.
+				if (xy[0] == -2 && xy[1] == -2 && frac == 0) {
+					missing++;
+					continue;
+				}
+
+				float map_x = xy[0] + (float)(frac % cv::INTER_TAB_SIZE) / cv::INTER_TAB_SIZE;
+				float map_y = xy[1] + (float)(frac / cv::INTER_TAB_SIZE) / cv::INTER_TAB_SIZE;
+
+				max_error = std::max(max_error, std::hypot(map_x - px, map_y - py));
+				checked++;
+			}
+		}
+	}
+
+	CHECK(missing == 0);
+	CHECK(checked > 0);
+	CHECK(max_error < kMaxError);
+}
+
+} // namespace
+
+
+TEST_CASE("Camera LUT KB4")
+{
+	t_camera_model_params dist = make_kb4_camera();
+	xrt_size size = {960, 960};
+
+	SECTION("Table")
+	{
+		check_lut(dist, size);
+	}
+	SECTION("Remap maps")
+	{
+		check_remap_maps(dist, size, 1.0f);
+	}
+	SECTION("Remap maps at half resolution")
+	{
+		check_remap_maps(dist, size, 0.5f);
+	}
+}
+
+TEST_CASE("Camera LUT RT8")
+{
+	t_camera_model_params dist = make_rt8_camera();
+	xrt_size size = {640, 480};
+
+	SECTION("Table")
+	{
+		check_lut(dist, size);
+	}
+	SECTION("Remap maps")
+	{
+		check_remap_maps(dist, size, 1.0f);
+	}
+	SECTION("Remap maps at half resolution")
+	{
+		check_remap_maps(dist, size, 0.5f);
+	}
+}
@@ -7,6 +7,7 @@
  */
 
 #include <math/m_relation_history.h>
+#include <math/m_vec3.h>
 #include <util/u_time.h>
 #include <util/u_template_historybuf.hpp>
 #include <iostream>
@@ -210,6 +211,134 @@ TEST_CASE("RelationHistory")
 	}
 }
 
+static xrt_space_relation
+make_moving_relation(double t)
+{
+	xrt_space_relation relation = XRT_SPACE_RELATION_ZERO;
+	relation.relation_flags = (xrt_space_relation_flags)( //
+	    XRT_SPACE_RELATION_POSITION_VALID_BIT |           //
+	    XRT_SPACE_RELATION_ORIENTATION_VALID_BIT |        //
+	    XRT_SPACE_RELATION_LINEAR_VELOCITY_VALID_BIT |    //
+	    XRT_SPACE_RELATION_ANGULAR_VELOCITY_VALID_BIT);   //
+
+	// Cubic position, and a rotation about y that speeds up.
+	relation.pose.position = {(float)(t * t * t), (float)(2 * t), 0.0f};
+	relation.linear_velocity = {(float)(3 * t * t), 2.0f, 0.0f};
+
+	double angle = 3.0 * t * t;
+	relation.pose.orientation = {0.0f, (float)sin(angle / 2), 0.0f, (float)cos(angle / 2)};
+	relation.angular_velocity = {0.0f, (float)(6.0 * t), 0.0f};
+	return relation;
+}
+
+static double
+quat_distance(const xrt_quat &a, const xrt_quat &b)
+{
+	double minus = 0;
+	double plus = 0;
+	const float av[4] = {a.x, a.y, a.z, a.w};
+	const float bv[4] = {b.x, b.y, b.z, b.w};
+	for (int i = 0; i < 4; i++) {
+		minus += (av[i] - (double)bv[i]) * (av[i] - (double)bv[i]);
+		plus += (av[i] + (double)bv[i]) * (av[i] + (double)bv[i]);
+	}
+	return 2.0 * sqrt(fmin(minus, plus));
+}
+
+TEST_CASE("m_relation_history lookups")
+{
+	using xrt::auxiliary::math::RelationHistory;
+	RelationHistory rh;
+
+	constexpr int64_t T0 = 20 * (int64_t)U_TIME_1S_IN_NS;
+	constexpr int64_t kStep = 11 * (int64_t)U_TIME_1MS_IN_NS;
+
+	xrt_space_relation relation = XRT_SPACE_RELATION_ZERO;
+	relation.relation_flags = XRT_SPACE_RELATION_POSITION_VALID_BIT;
+
+	auto push = [&](int i) {
+		// Uneven steps, position is the time since T0 in steps.
+		int64_t ts = T0 + i * kStep + (i % 3) * U_TIME_1MS_IN_NS;
+		relation.pose.position.x = (float)((double)(ts - T0) / kStep);
+		CHECK(rh.push(relation, ts));
+		return ts;
+	};
+
+	// More than the buffer holds, so the oldest are dropped while querying.
+	int64_t newest = 0;
+	for (int i = 0; i < 5000; i++) {
+		newest = push(i);
+
+		// Late latching style queries, a bit behind the newest and moving forward.
+		for (int k = 0; k < 3; k++) {
+			int64_t at = newest - kStep * 2 + k * kStep / 3;
+			if (at <= T0) {
+				continue;
+			}
+
+			xrt_space_relation out = XRT_SPACE_RELATION_ZERO;
+			auto result = rh.get(at, &out);
+			REQUIRE((result == M_RELATION_HISTORY_RESULT_INTERPOLATED || result == M_RELATION_HISTORY_RESULT_EXACT));
+			CHECK(out.pose.position.x == Catch::Approx((double)(at - T0) / kStep).epsilon(1e-4));
+		}
+	}
+
+	// Jump around the whole buffer.
+	for (int i = 1000; i < 5000; i += 97) {
+		int64_t at = T0 + i * kStep + kStep / 2;
+		xrt_space_relation out = XRT_SPACE_RELATION_ZERO;
+		CHECK(rh.get(at, &out) == M_RELATION_HISTORY_RESULT_INTERPOLATED);
+		CHECK(out.pose.position.x == Catch::Approx((double)(at - T0) / kStep).epsilon(1e-4));
+	}
+
+	xrt_space_relation out = XRT_SPACE_RELATION_ZERO;
+	CHECK(rh.get(T0 + 100 * kStep, &out) == M_RELATION_HISTORY_RESULT_REVERSE_PREDICTED);
+	CHECK(rh.get(newest + kStep, &out) == M_RELATION_HISTORY_RESULT_PREDICTED);
+	CHECK(rh.get(newest, &out) == M_RELATION_HISTORY_RESULT_EXACT);
+}
+
+TEST_CASE("m_relation_history hermite")
+{
+	using xrt::auxiliary::math::RelationHistory;
+	RelationHistory linear;
+	RelationHistory hermite;
+	hermite.set_interpolation(M_RELATION_HISTORY_INTERPOLATION_HERMITE);
+
+	// Entries at 50Hz, over a second.
+	constexpr int64_t kStep = 20 * (int64_t)U_TIME_1MS_IN_NS;
+	for (int i = 0; i <= 50; i++) {
+		xrt_space_relation relation = make_moving_relation(time_ns_to_s(i * kStep));
+		CHECK(linear.push(relation, U_TIME_1S_IN_NS + i * kStep));
+		CHECK(hermite.push(relation, U_TIME_1S_IN_NS + i * kStep));
+	}
+
+	double linear_pos_error = 0;
+	double hermite_pos_error = 0;
+	double linear_rot_error = 0;
+	double hermite_rot_error = 0;
+
+	for (int64_t at = kStep / 4; at < 50 * kStep; at += kStep / 4) {
+		xrt_space_relation expected = make_moving_relation(time_ns_to_s(at));
+		xrt_space_relation a = XRT_SPACE_RELATION_ZERO;
+		xrt_space_relation b = XRT_SPACE_RELATION_ZERO;
+		linear.get(U_TIME_1S_IN_NS + at, &a);
+		CHECK(hermite.get(U_TIME_1S_IN_NS + at, &b) != M_RELATION_HISTORY_RESULT_INVALID);
+
+		linear_pos_error = fmax(linear_pos_error, m_vec3_len(a.pose.position - expected.pose.position));
+		hermite_pos_error = fmax(hermite_pos_error, m_vec3_len(b.pose.position - expected.pose.position));
+		linear_rot_error = fmax(linear_rot_error, quat_distance(a.pose.orientation, expected.pose.orientation));
+		hermite_rot_error = fmax(hermite_rot_error, quat_distance(b.pose.orientation, expected.pose.orientation));
+
+		CHECK(b.linear_velocity.x == Catch::Approx(expected.linear_velocity.x).margin(1e-3));
+	}
+
+	// A cubic is followed exactly, the rotation much closer.
+	CHECK(hermite_pos_error < 1e-5);
+	CHECK(hermite_pos_error < linear_pos_error / 10);
+	CHECK(hermite_rot_error < linear_rot_error / 4);
+}
+
+
 TEST_CASE("u_template_historybuf")
 {
 	HistoryBuffer<int, 4> buffer;
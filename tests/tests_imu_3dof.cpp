@@ -0,0 +1,138 @@
+// Copyright 2025, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief 3dof IMU fusion tests.
+ * @author agent <agent@local>
+ */
+
+#include <math/m_api.h>
+#include <math/m_imu_3dof.h>
+
+#include "catch_amalgamated.hpp"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+
+namespace {
+
+constexpr size_t kPacket = 4;
+
+struct Replay
+{
+	std::vector<uint64_t> timestamps_ns;
+	std::vector<xrt_vec3> accels;
+	std::vector<xrt_vec3> gyros;
+};
+
+/*!
+ * A device that turns around a few axes at 1kHz, with a still stretch in the
+ * middle so that gravity correction kicks in.
+ */
+Replay
+make_replay(size_t count)
+{
+	std::mt19937 rng(99);
+	std::normal_distribution<float> noise(0.0f, 0.02f);
+
+	Replay r;
+	uint64_t ts = 1000000000;
+	for (size_t i = 0; i < count; i++) {
+		// Some jitter in the timing.
+		ts += 1000000 + (uint64_t)(std::abs(noise(rng)) * 10000000);
+
+		float t = i / 1000.0f;
+		bool still = i > count / 3 && i < count / 2;
+		xrt_vec3 gyro = {0, 0, 0};
+		if (!still) {
+			gyro = {1.5f * std::sin(t), 0.8f * std::cos(2 * t), 0.3f};
+		}
+
+		r.timestamps_ns.push_back(ts);
+		r.gyros.push_back({gyro.x + noise(rng), gyro.y + noise(rng), gyro.z + noise(rng)});
+		r.accels.push_back({0.3f + noise(rng), 9.8f + noise(rng), -0.2f + noise(rng)});
+	}
+	return r;
+}
+
+//! Roughly the angle between the two, acos of the dot product is too coarse in float.
+float
+angle_between(const xrt_quat &a, const xrt_quat &b)
+{
+	double minus = 0;
+	double plus = 0;
+	const float av[4] = {a.x, a.y, a.z, a.w};
+	const float bv[4] = {b.x, b.y, b.z, b.w};
+	for (int i = 0; i < 4; i++) {
+		minus += (av[i] - (double)bv[i]) * (av[i] - (double)bv[i]);
+		plus += (av[i] + (double)bv[i]) * (av[i] + (double)bv[i]);
+	}
+	return (float)(2.0 * std::sqrt(std::fmin(minus, plus)));
+}
+
+} // namespace
+
+
+TEST_CASE("m_imu_3dof_update_batch")
+{
+	int flags = GENERATE(0, M_IMU_3DOF_USE_GRAVITY_DUR_20MS, M_IMU_3DOF_USE_GRAVITY_DUR_300MS);
+	CAPTURE(flags);
+
+	Replay r = make_replay(5000);
+
+	struct m_imu_3dof single;
+	struct m_imu_3dof batch;
+	m_imu_3dof_init(&single, flags);
+	m_imu_3dof_init(&batch, flags);
+
+	for (size_t i = 0; i < r.timestamps_ns.size(); i += kPacket) {
+		for (size_t k = i; k < i + kPacket; k++) {
+			m_imu_3dof_update(&single, r.timestamps_ns[k], &r.accels[k], &r.gyros[k]);
+		}
+		m_imu_3dof_update_batch(&batch, &r.timestamps_ns[i], &r.accels[i], &r.gyros[i], kPacket);
+
+		// Fire the bias in the still stretch, on both.
+		if (i == 2000) {
+			single.gyro_bias.manually_fire = true;
+			batch.gyro_bias.manually_fire = true;
+		}
+
+		REQUIRE(angle_between(single.rot, batch.rot) < 1e-4f);
+	}
+
+	CHECK(batch.last.timestamp_ns == single.last.timestamp_ns);
+	CHECK(batch.last.delta_ms == Catch::Approx(single.last.delta_ms));
+	CHECK(batch.last.gyro_biased_length == Catch::Approx(single.last.gyro_biased_length));
+	CHECK(batch.gyro_bias.value.x == single.gyro_bias.value.x);
+	CHECK(batch.grav.error_angle == Catch::Approx(single.grav.error_angle).margin(1e-4));
+
+	struct xrt_quat rot = batch.rot;
+	math_quat_normalize(&rot);
+	CHECK(angle_between(rot, batch.rot) < 1e-6f);
+
+	m_imu_3dof_close(&single);
+	m_imu_3dof_close(&batch);
+}
+
+TEST_CASE("m_imu_3dof_update_batch splits big batches")
+{
+	Replay r = make_replay(100);
+
+	struct m_imu_3dof single;
+	struct m_imu_3dof batch;
+	m_imu_3dof_init(&single, M_IMU_3DOF_USE_GRAVITY_DUR_20MS);
+	m_imu_3dof_init(&batch, M_IMU_3DOF_USE_GRAVITY_DUR_20MS);
+
+	for (size_t i = 0; i < r.timestamps_ns.size(); i++) {
+		m_imu_3dof_update(&single, r.timestamps_ns[i], &r.accels[i], &r.gyros[i]);
+	}
+	m_imu_3dof_update_batch(&batch, r.timestamps_ns.data(), r.accels.data(), r.gyros.data(), r.gyros.size());
+
+	CHECK(angle_between(single.rot, batch.rot) < 1e-4f);
+	CHECK(batch.last.timestamp_ns == r.timestamps_ns.back());
+
+	m_imu_3dof_close(&single);
+	m_imu_3dof_close(&batch);
+}
@@ -25,17 +25,9 @@
 
 using namespace xrt::tracking::hand::mercury;
 
-TEST_CASE("LevenbergMarquardt")
+static void
+make_test_input(struct one_frame_input &input)
 {
-	// This does very little at the moment:
-	// * It will explode if any floating point exceptions are generated
-	// * You should run it with `valgrind --track-origins=yes` (and compile without optimizations so that origin
-	// tracking works well) to see if we are using any uninitialized values.
-
-	fetestexcept(FE_ALL_EXCEPT);
-
-	struct one_frame_input input = {};
-
 	for (int view = 0; view < 2; view++) {
 		input.views[view].active = true;
 		input.views[view].stereographic_radius = 0.5;
@@ -57,6 +49,19 @@ TEST_CASE("LevenbergMarquardt")
 			input.views[view].keypoints_in_scaled_stereographic[i].confidence_xy = 1.0f;
 		}
 	}
+}
+
+TEST_CASE("LevenbergMarquardt")
+{
+	// This does very little at the moment:
+	// * It will explode if any floating point exceptions are generated
+	// * You should run it with `valgrind --track-origins=yes` (and compile without optimizations so that origin
+	// tracking works well) to see if we are using any uninitialized values.
+
+	fetestexcept(FE_ALL_EXCEPT);
+
+	struct one_frame_input input = {};
+	make_test_input(input);
 
 	lm::KinematicHandLM *hand;
 
@@ -84,3 +89,114 @@ TEST_CASE("LevenbergMarquardt")
 	CHECK(std::isfinite(out_reprojection_error));
 	CHECK(std::isfinite(out_hand_size));
 }
+
+static void
+check_jacobians(lm::KinematicHandLM *hand,
+                one_frame_input &input,
+                bool hand_was_untracked_last_frame,
+                bool optimize_hand_size,
+                const std::vector<float> &params_offset)
+{
+	std::vector<float> autodiff;
+	std::vector<float> analytic;
+	size_t num_residuals = 0;
+
+	lm::optimizer_eval_jacobians(hand, input, hand_was_untracked_last_frame, 2.0f, optimize_hand_size, 0.09f,
+	                             0.5f, 0.5f, params_offset, autodiff, analytic, num_residuals);
+
+	REQUIRE(num_residuals > 0);
+	REQUIRE(autodiff.size() == analytic.size());
+	REQUIRE(autodiff.size() % num_residuals == 0);
+
+	float max_error = 0.0f;
+	size_t max_error_idx = 0;
+	for (size_t i = 0; i < autodiff.size(); i++) {
+		REQUIRE(std::isfinite(analytic[i]));
+		float error = fabsf(autodiff[i] - analytic[i]) / (1.0f + fabsf(autodiff[i]));
+		if (error > max_error) {
+			max_error = error;
+			max_error_idx = i;
+		}
+	}
+
+	// Column-major.
+	INFO("Worst at residual " << max_error_idx % num_residuals << ", parameter " << max_error_idx / num_residuals
+	                          << ": autodiff " << autodiff[max_error_idx] << " analytic "
+	                          << analytic[max_error_idx]);
+	CHECK(max_error < 1e-3f);
+}
+
+TEST_CASE("LevenbergMarquardt analytic Jacobian")
+{
+	struct one_frame_input input = {};
+	make_test_input(input);
+
+	// Look a bit to the side in the second view, so that the stereographic projection isn't symmetric.
+	input.views[1].look_dir = {0.1f, -0.2f, 0.05f, 0.97f};
+	math_quat_normalize(&input.views[1].look_dir);
+
+	xrt_pose left_in_right = XRT_POSE_IDENTITY;
+	left_in_right.position.x = 0.1f;
+
+	// Away from the rest pose, so that the wrist orientation isn't small and the joints aren't at their limits.
+	// Enough for every parameter, including the hand size.
+	std::vector<float> params_offset(28);
+	for (size_t i = 0; i < params_offset.size(); i++) {
+		params_offset[i] = 0.2f * sinf(i + 1.0f);
+	}
+
+	for (bool is_right : {false, true}) {
+		for (bool optimize_hand_size : {false, true}) {
+			CAPTURE(is_right, optimize_hand_size);
+
+			lm::KinematicHandLM *hand;
+			lm::optimizer_create(left_in_right, is_right, U_LOGGING_WARN, &hand);
+
+			// First frame, without stability residuals.
+			check_jacobians(hand, input, true, optimize_hand_size, {});
+
+			xrt_hand_joint_set out = {};
+			float out_hand_size = 0.0f;
+			float out_reprojection_error = 0.0f;
+			lm::optimizer_run(hand, input, true, 2.0f, optimize_hand_size, 0.09f, 0.5f, 0.5f, out,
+			                  out_hand_size, out_reprojection_error);
+
+			// Tracked, with stability residuals.
+			check_jacobians(hand, input, false, optimize_hand_size, {});
+			check_jacobians(hand, input, false, optimize_hand_size, params_offset);
+
+			lm::optimizer_destroy(&hand);
+		}
+	}
+}
+
+TEST_CASE("LevenbergMarquardt benchmark", "[.][benchmark]")
+{
+	struct one_frame_input input = {};
+	make_test_input(input);
+
+	xrt_pose left_in_right = XRT_POSE_IDENTITY;
+	left_in_right.position.x = 0.1f;
+
+	for (bool analytic : {false, true}) {
+		lm::KinematicHandLM *hand;
+		lm::optimizer_create(left_in_right, false, U_LOGGING_WARN, &hand);
+		lm::optimizer_set_analytic_jacobian(hand, analytic);
+
+		xrt_hand_joint_set out = {};
+		float out_hand_size = 0.0f;
+		float out_reprojection_error = 0.0f;
+		lm::optimizer_run(hand, input, true, 2.0f, false, 0.09f, 0.5f, 0.5f, out, out_hand_size,
+		                  out_reprojection_error);
+
+		// The optimizer always runs 30 iterations.
+		BENCHMARK(analytic ? "30 iterations, analytic Jacobian" : "30 iterations, autodiff")
+		{
+			lm::optimizer_run(hand, input, false, 2.0f, false, 0.09f, 0.5f, 0.5f, out, out_hand_size,
+			                  out_reprojection_error);
+			return out_reprojection_error;
+		};
+
+		lm::optimizer_destroy(&hand);
+	}
+}
@@ -0,0 +1,180 @@
+// Copyright 2025, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Fixed size point Kalman filter tests.
+ * @author agent <agent@local>
+ */
+
+#include "xrt/xrt_config_have.h"
+
+#include <tracking/t_point_filter.hpp>
+
+#ifdef XRT_HAVE_OPENCV
+#include <opencv2/video/tracking.hpp>
+#endif
+
+#include "catch_amalgamated.hpp"
+
+#include <Eigen/Dense>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+
+using xrt::auxiliary::tracking::PointFilter;
+
+namespace {
+
+struct Sample
+{
+	float dt;
+	Eigen::Vector3f measurement;
+	bool measured;
+};
+
+/*!
+ * A LED moving on a circle with noise, sometimes not seen, with the same dt
+ * pattern the PSVR tracker uses: a half step predict, then a correct.
+ */
+std::vector<Sample>
+make_replay()
+{
+	std::mt19937 rng(1234);
+	std::normal_distribution<float> noise(0.0f, 0.01f);
+	std::uniform_real_distribution<float> drop(0.0f, 1.0f);
+
+	std::vector<Sample> samples;
+	for (int i = 0; i < 300; i++) {
+		float t = i / 60.0f;
+		Sample s;
+		s.dt = (i % 7 == 0) ? 1.0f : 0.5f;
+		s.measurement = {0.3f * std::cos(t) + noise(rng), 1.5f + 0.1f * std::sin(3 * t) + noise(rng),
+		                 -0.5f + 0.3f * std::sin(t) + noise(rng)};
+		s.measured = drop(rng) > 0.1f;
+		samples.push_back(s);
+	}
+	return samples;
+}
+
+//! Textbook Kalman filter with dynamic matrices, predicted and corrected state kept apart.
+struct ReferenceFilter
+{
+	Eigen::MatrixXf state_pre = Eigen::MatrixXf::Zero(6, 1);
+	Eigen::MatrixXf state_post = Eigen::MatrixXf::Zero(6, 1);
+	Eigen::MatrixXf cov_pre = Eigen::MatrixXf::Zero(6, 6);
+	Eigen::MatrixXf cov_post = Eigen::MatrixXf::Zero(6, 6);
+	Eigen::MatrixXf measurement_matrix = Eigen::MatrixXf::Identity(3, 6);
+	Eigen::MatrixXf process_noise;
+	Eigen::MatrixXf measurement_noise;
+
+	ReferenceFilter(float process_cov, float meas_cov)
+	    : process_noise(Eigen::MatrixXf::Identity(6, 6) * process_cov),
+	      measurement_noise(Eigen::MatrixXf::Identity(3, 3) * meas_cov)
+	{}
+
+	Eigen::Vector3f
+	predict(float dt)
+	{
+		Eigen::MatrixXf transition = Eigen::MatrixXf::Identity(6, 6);
+		transition(0, 3) = transition(1, 4) = transition(2, 5) = dt;
+		state_pre = transition * state_post;
+		cov_pre = transition * cov_post * transition.transpose() + process_noise;
+		state_post = state_pre;
+		cov_post = cov_pre;
+		return state_pre.topRows(3);
+	}
+
+	void
+	correct(const Eigen::Vector3f &measurement)
+	{
+		const Eigen::MatrixXf &h = measurement_matrix;
+		Eigen::MatrixXf s = h * cov_pre * h.transpose() + measurement_noise;
+		Eigen::MatrixXf gain = cov_pre * h.transpose() * s.inverse();
+		state_post = state_pre + gain * (measurement - h * state_pre);
+		cov_post = cov_pre - gain * h * cov_pre;
+	}
+};
+
+} // namespace
+
+
+TEST_CASE("point_filter")
+{
+	std::vector<Sample> replay = make_replay();
+
+	SECTION("matches the textbook filter on a replay")
+	{
+		// The LED and the pose noise settings from the PSVR tracker.
+		for (float meas_cov : {1.0f, 100.0f}) {
+			float process_cov = meas_cov == 1.0f ? 0.1f : 0.5f;
+			PointFilter filter(process_cov, meas_cov);
+			ReferenceFilter reference(process_cov, meas_cov);
+
+			for (const Sample &s : replay) {
+				Eigen::Vector3f got = filter.predict(s.dt);
+				Eigen::Vector3f expected = reference.predict(s.dt);
+				CHECK(got.isApprox(expected, 1e-4f));
+
+				if (s.measured) {
+					filter.correct(s.measurement);
+					reference.correct(s.measurement);
+				}
+				CHECK(filter.state_post.isApprox(Eigen::Matrix<float, 6, 1>(reference.state_post), 1e-4f));
+			}
+		}
+	}
+
+	SECTION("follows a constant velocity")
+	{
+		PointFilter filter(0.1f, 1.0f);
+		Eigen::Vector3f velocity(0.5f, -0.25f, 1.0f);
+		for (int i = 0; i < 200; i++) {
+			filter.predict(1.0f);
+			filter.correct(velocity * (float)(i + 1));
+		}
+		CHECK(filter.state_post.tail<3>().isApprox(velocity, 1e-3f));
+	}
+}
+
+#ifdef XRT_HAVE_OPENCV
+
+TEST_CASE("point_filter_matches_cv_kalman")
+{
+	std::vector<Sample> replay = make_replay();
+
+	// Set up like the PSVR tracker used to.
+	cv::KalmanFilter kf(6, 3);
+	cv::setIdentity(kf.measurementMatrix, cv::Scalar::all(1.0f));
+	cv::setIdentity(kf.errorCovPost, cv::Scalar::all(0.0f));
+	cv::setIdentity(kf.processNoiseCov, cv::Scalar::all(0.1f));
+	cv::setIdentity(kf.measurementNoiseCov, cv::Scalar::all(1.0f));
+
+	PointFilter filter(0.1f, 1.0f);
+
+	for (const Sample &s : replay) {
+		kf.transitionMatrix.at<float>(0, 3) = s.dt;
+		kf.transitionMatrix.at<float>(1, 4) = s.dt;
+		kf.transitionMatrix.at<float>(2, 5) = s.dt;
+
+		cv::Mat prediction = kf.predict();
+		Eigen::Vector3f got = filter.predict(s.dt);
+		for (int i = 0; i < 3; i++) {
+			CHECK(got[i] == Catch::Approx(prediction.at<float>(i, 0)).margin(1e-5));
+		}
+
+		if (!s.measured) {
+			continue;
+		}
+
+		cv::Mat measurement = (cv::Mat_<float>(3, 1) << s.measurement[0], s.measurement[1], s.measurement[2]);
+		kf.correct(measurement);
+		filter.correct(s.measurement);
+		for (int i = 0; i < 6; i++) {
+			CHECK(filter.state_post[i] == Catch::Approx(kf.statePost.at<float>(i, 0)).margin(1e-5));
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,202 @@
+// Copyright 2025, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Batch pose math tests.
+ * @author agent <agent@local>
+ */
+
+#include <math/m_api.h>
+#include <math/m_pose_batch.h>
+
+#include "catch_amalgamated.hpp"
+#include "pose_utils.hpp"
+
+#include <random>
+
+
+namespace {
+
+void
+check_pose(const xrt_pose &got, xrt_pose expected)
+{
+	// Both q and -q are the same rotation.
+	if (math_quat_dot(&got.orientation, &expected.orientation) < 0) {
+		expected.orientation = {-expected.orientation.x, -expected.orientation.y, -expected.orientation.z,
+		                        -expected.orientation.w};
+	}
+
+	CHECK(got.position.x == Catch::Approx(expected.position.x).margin(1e-5));
+	CHECK(got.position.y == Catch::Approx(expected.position.y).margin(1e-5));
+	CHECK(got.position.z == Catch::Approx(expected.position.z).margin(1e-5));
+	CHECK(got.orientation.x == Catch::Approx(expected.orientation.x).margin(1e-5));
+	CHECK(got.orientation.y == Catch::Approx(expected.orientation.y).margin(1e-5));
+	CHECK(got.orientation.z == Catch::Approx(expected.orientation.z).margin(1e-5));
+	CHECK(got.orientation.w == Catch::Approx(expected.orientation.w).margin(1e-5));
+}
+
+} // namespace
+
+
+TEST_CASE("m_pose_batch")
+{
+	std::mt19937 rng(4711);
+
+	// A hands worth of joints.
+	constexpr uint32_t kCount = XRT_HAND_JOINT_COUNT;
+
+	xrt_pose poses[kCount];
+	xrt_pose others[kCount];
+	for (uint32_t i = 0; i < kCount; i++) {
+		poses[i] = random_pose(rng);
+		others[i] = random_pose(rng);
+	}
+
+	// Some close and some opposite orientations for the slerp corner cases.
+	others[0].orientation = poses[0].orientation;
+	others[1].orientation = {-poses[1].orientation.x, -poses[1].orientation.y, -poses[1].orientation.z,
+	                         -poses[1].orientation.w};
+
+	struct m_pose_batch batch;
+	struct m_pose_batch other_batch;
+	struct m_pose_batch out_batch;
+	m_pose_batch_load(&batch, poses, kCount);
+	m_pose_batch_load(&other_batch, others, kCount);
+
+	xrt_pose out[kCount];
+
+	SECTION("load and store")
+	{
+		m_pose_batch_store(&batch, out);
+		for (uint32_t i = 0; i < kCount; i++) {
+			check_pose(out[i], poses[i]);
+		}
+	}
+
+	SECTION("transform")
+	{
+		xrt_pose transform = random_pose(rng);
+		m_pose_batch_transform(&transform, &batch, &out_batch);
+		REQUIRE(out_batch.count == kCount);
+		m_pose_batch_store(&out_batch, out);
+
+		for (uint32_t i = 0; i < kCount; i++) {
+			xrt_pose expected;
+			math_pose_transform(&transform, &poses[i], &expected);
+			check_pose(out[i], expected);
+		}
+
+		// In place.
+		m_pose_batch_transform(&transform, &batch, &batch);
+		m_pose_batch_store(&batch, poses);
+		for (uint32_t i = 0; i < kCount; i++) {
+			check_pose(poses[i], out[i]);
+		}
+	}
+
+	SECTION("invert")
+	{
+		m_pose_batch_invert(&batch, &out_batch);
+		m_pose_batch_store(&out_batch, out);
+
+		for (uint32_t i = 0; i < kCount; i++) {
+			xrt_pose expected;
+			math_pose_invert(&poses[i], &expected);
+			check_pose(out[i], expected);
+		}
+	}
+
+	SECTION("interpolate")
+	{
+		for (float t : {0.0f, 0.25f, 0.5f, 1.0f}) {
+			m_pose_batch_interpolate(&batch, &other_batch, t, &out_batch);
+			m_pose_batch_store(&out_batch, out);
+
+			for (uint32_t i = 0; i < kCount; i++) {
+				xrt_pose expected;
+				math_pose_interpolate(&poses[i], &others[i], t, &expected);
+				check_pose(out[i], expected);
+			}
+		}
+	}
+
+	SECTION("relations with missing components")
+	{
+		xrt_space_relation rel = {};
+		rel.pose = poses[2];
+		rel.relation_flags = XRT_SPACE_RELATION_ORIENTATION_VALID_BIT;
+		m_pose_batch_set_relation(&batch, 2, &rel);
+
+		rel.relation_flags = XRT_SPACE_RELATION_POSITION_VALID_BIT;
+		m_pose_batch_set_relation(&batch, 3, &rel);
+
+		m_pose_batch_get(&batch, 2, &out[2]);
+		m_pose_batch_get(&batch, 3, &out[3]);
+
+		check_pose(out[2], {poses[2].orientation, XRT_VEC3_ZERO});
+		check_pose(out[3], {XRT_QUAT_IDENTITY, poses[2].position});
+	}
+}
+
+TEST_CASE("m_pose_batch benchmark", "[.][benchmark]")
+{
+	std::mt19937 rng(1);
+
+	xrt_pose poses[M_POSE_BATCH_MAX];
+	xrt_pose others[M_POSE_BATCH_MAX];
+	for (uint32_t i = 0; i < M_POSE_BATCH_MAX; i++) {
+		poses[i] = random_pose(rng);
+		others[i] = random_pose(rng);
+	}
+	xrt_pose transform = random_pose(rng);
+
+	struct m_pose_batch batch;
+	struct m_pose_batch other_batch;
+	struct m_pose_batch out_batch;
+	m_pose_batch_load(&batch, poses, M_POSE_BATCH_MAX);
+	m_pose_batch_load(&other_batch, others, M_POSE_BATCH_MAX);
+
+	xrt_pose out[M_POSE_BATCH_MAX];
+
+	BENCHMARK("transform, scalar")
+	{
+		for (uint32_t i = 0; i < M_POSE_BATCH_MAX; i++) {
+			math_pose_transform(&transform, &poses[i], &out[i]);
+		}
+		return out[0].position.x;
+	};
+
+	BENCHMARK("transform, batch")
+	{
+		m_pose_batch_transform(&transform, &batch, &out_batch);
+		return out_batch.px[0];
+	};
+
+	BENCHMARK("invert, scalar")
+	{
+		for (uint32_t i = 0; i < M_POSE_BATCH_MAX; i++) {
+			math_pose_invert(&poses[i], &out[i]);
+		}
+		return out[0].position.x;
+	};
+
+	BENCHMARK("invert, batch")
+	{
+		m_pose_batch_invert(&batch, &out_batch);
+		return out_batch.px[0];
+	};
+
+	BENCHMARK("interpolate, scalar")
+	{
+		for (uint32_t i = 0; i < M_POSE_BATCH_MAX; i++) {
+			math_pose_interpolate(&poses[i], &others[i], 0.3f, &out[i]);
+		}
+		return out[0].position.x;
+	};
+
+	BENCHMARK("interpolate, batch")
+	{
+		m_pose_batch_interpolate(&batch, &other_batch, 0.3f, &out_batch);
+		return out_batch.px[0];
+	};
+}
@@ -0,0 +1,160 @@
+// Copyright 2025, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief u_pose_cache tests.
+ * @author agent <agent@local>
+ */
+
+#include <util/u_pose_cache.h>
+#include <xrt/xrt_device.h>
+
+#include "catch_amalgamated.hpp"
+
+
+namespace {
+
+struct counting_device
+{
+	struct xrt_device base;
+	int tracked_calls;
+	int view_calls;
+};
+
+xrt_result_t
+counting_get_tracked_pose(struct xrt_device *xdev,
+                          enum xrt_input_name name,
+                          int64_t at_timestamp_ns,
+                          struct xrt_space_relation *out_relation)
+{
+	auto *cd = reinterpret_cast<counting_device *>(xdev);
+	cd->tracked_calls++;
+
+	*out_relation = XRT_SPACE_RELATION_ZERO;
+	out_relation->pose.orientation.w = 1.0f;
+	out_relation->pose.position.x = (float)at_timestamp_ns;
+	out_relation->relation_flags = XRT_SPACE_RELATION_ORIENTATION_VALID_BIT;
+
+	return XRT_SUCCESS;
+}
+
+void
+counting_get_view_poses(struct xrt_device *xdev,
+                        const struct xrt_vec3 *default_eye_relation,
+                        int64_t at_timestamp_ns,
+                        uint32_t view_count,
+                        struct xrt_space_relation *out_head_relation,
+                        struct xrt_fov *out_fovs,
+                        struct xrt_pose *out_poses)
+{
+	auto *cd = reinterpret_cast<counting_device *>(xdev);
+	cd->view_calls++;
+
+	*out_head_relation = XRT_SPACE_RELATION_ZERO;
+	for (uint32_t i = 0; i < view_count; i++) {
+		out_fovs[i] = {};
+		out_poses[i] = XRT_POSE_IDENTITY;
+		out_poses[i].position.x = default_eye_relation->x * (i == 0 ? -0.5f : 0.5f);
+	}
+}
+
+counting_device
+make_device()
+{
+	counting_device cd = {};
+	cd.base.get_tracked_pose = counting_get_tracked_pose;
+	cd.base.get_view_poses = counting_get_view_poses;
+	return cd;
+}
+
+} // namespace
+
+
+TEST_CASE("u_pose_cache")
+{
+	counting_device cd = make_device();
+	struct u_pose_cache upc;
+
+	SECTION("same timestamp is fetched once")
+	{
+		// Long max age so the test can't be flaky.
+		REQUIRE(u_pose_cache_init(&upc, 1000LL * 1000 * 1000 * 60) == 0);
+
+		struct xrt_space_relation a = XRT_SPACE_RELATION_ZERO;
+		struct xrt_space_relation b = XRT_SPACE_RELATION_ZERO;
+		CHECK(u_pose_cache_get_tracked_pose(&upc, &cd.base, XRT_INPUT_GENERIC_HEAD_POSE, 10, &a) == XRT_SUCCESS);
+		CHECK(u_pose_cache_get_tracked_pose(&upc, &cd.base, XRT_INPUT_GENERIC_HEAD_POSE, 10, &b) == XRT_SUCCESS);
+		CHECK(cd.tracked_calls == 1);
+		CHECK(a.pose.position.x == b.pose.position.x);
+		CHECK(a.relation_flags == b.relation_flags);
+		CHECK(upc.stats.hits == 1);
+		CHECK(upc.stats.misses == 1);
+		CHECK(upc.stats.hit_rate == 50.0f);
+
+		// Different timestamp and different input are misses.
+		CHECK(u_pose_cache_get_tracked_pose(&upc, &cd.base, XRT_INPUT_GENERIC_HEAD_POSE, 20, &b) == XRT_SUCCESS);
+		CHECK(b.pose.position.x == 20.0f);
+		CHECK(u_pose_cache_get_tracked_pose(&upc, &cd.base, XRT_INPUT_GENERIC_STAGE_SPACE_POSE, 20, &b) ==
+		      XRT_SUCCESS);
+		CHECK(cd.tracked_calls == 3);
+
+		u_pose_cache_fini(&upc);
+	}
+
+	SECTION("more keys than entries")
+	{
+		REQUIRE(u_pose_cache_init(&upc, 1000LL * 1000 * 1000 * 60) == 0);
+
+		struct xrt_space_relation rel = XRT_SPACE_RELATION_ZERO;
+		for (int64_t ts = 0; ts < U_POSE_CACHE_MAX_ENTRIES * 2; ts++) {
+			u_pose_cache_get_tracked_pose(&upc, &cd.base, XRT_INPUT_GENERIC_HEAD_POSE, ts, &rel);
+			CHECK(rel.pose.position.x == (float)ts);
+		}
+		CHECK(cd.tracked_calls == U_POSE_CACHE_MAX_ENTRIES * 2);
+
+		// The most recent ones are still there.
+		u_pose_cache_get_tracked_pose(&upc, &cd.base, XRT_INPUT_GENERIC_HEAD_POSE,
+		                              U_POSE_CACHE_MAX_ENTRIES * 2 - 1, &rel);
+		CHECK(cd.tracked_calls == U_POSE_CACHE_MAX_ENTRIES * 2);
+
+		u_pose_cache_fini(&upc);
+	}
+
+	SECTION("zero max age disables the cache")
+	{
+		REQUIRE(u_pose_cache_init(&upc, 0) == 0);
+
+		struct xrt_space_relation rel = XRT_SPACE_RELATION_ZERO;
+		u_pose_cache_get_tracked_pose(&upc, &cd.base, XRT_INPUT_GENERIC_HEAD_POSE, 10, &rel);
+		u_pose_cache_get_tracked_pose(&upc, &cd.base, XRT_INPUT_GENERIC_HEAD_POSE, 10, &rel);
+		CHECK(cd.tracked_calls == 2);
+
+		u_pose_cache_fini(&upc);
+	}
+
+	SECTION("view poses depend on the eye relation")
+	{
+		REQUIRE(u_pose_cache_init(&upc, 1000LL * 1000 * 1000 * 60) == 0);
+
+		struct xrt_vec3 eye_a = {0.063f, 0.0f, 0.0f};
+		struct xrt_vec3 eye_b = {0.070f, 0.0f, 0.0f};
+		struct xrt_space_relation head = XRT_SPACE_RELATION_ZERO;
+		struct xrt_fov fovs[XRT_MAX_VIEWS] = {};
+		struct xrt_pose poses[XRT_MAX_VIEWS] = {};
+
+		u_pose_cache_get_view_poses(&upc, &cd.base, &eye_a, 10, 2, &head, fovs, poses);
+		u_pose_cache_get_view_poses(&upc, &cd.base, &eye_a, 10, 2, &head, fovs, poses);
+		CHECK(cd.view_calls == 1);
+		CHECK(poses[1].position.x == eye_a.x * 0.5f);
+
+		u_pose_cache_get_view_poses(&upc, &cd.base, &eye_b, 10, 2, &head, fovs, poses);
+		CHECK(cd.view_calls == 2);
+		CHECK(poses[1].position.x == eye_b.x * 0.5f);
+
+		// View poses and tracked poses don't collide.
+		u_pose_cache_get_tracked_pose(&upc, &cd.base, XRT_INPUT_GENERIC_HEAD_POSE, 10, &head);
+		CHECK(cd.tracked_calls == 1);
+
+		u_pose_cache_fini(&upc);
+	}
+}
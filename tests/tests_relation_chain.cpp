@@ -12,6 +12,9 @@
 #include "math/m_space.h"
 
 #include "catch_amalgamated.hpp"
+#include "pose_utils.hpp"
+
+#include <random>
 
 
 /*
@@ -237,3 +240,142 @@ TEST_CASE("Relation Chain Flags")
 		TEST_FLAGS(XRT_SPACE_RELATION_POSITION_VALID_BIT, VNT, ONLY_POSITION, P);
 	}
 }
+
+
+/*
+ *
+ * Offsets and velocities.
+ *
+ */
+
+/*!
+ * A deep space graph: a moving device with offsets on both sides, like an
+ * action space on a controller located in a stage space.
+ */
+static void
+make_deep_chain(std::mt19937 &rng, uint32_t step_count, xrt_relation_chain &xrc)
+{
+	std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+
+	xrc = {};
+	for (uint32_t i = 0; i < step_count; i++) {
+		if (i != step_count / 2) {
+			xrt_pose pose = random_pose(rng);
+			m_relation_chain_push_pose(&xrc, &pose);
+			continue;
+		}
+
+		xrt_space_relation rel = {};
+		rel.relation_flags = XRT_SPACE_RELATION_BITMASK_ALL;
+		rel.pose = random_pose(rng);
+		rel.linear_velocity = {dist(rng), dist(rng), dist(rng)};
+		rel.angular_velocity = {dist(rng), dist(rng), dist(rng)};
+		m_relation_chain_push_relation(&xrc, &rel);
+	}
+}
+
+//! Resolves one link at a time, what the chain did before offsets were precomposed.
+static void
+resolve_step_by_step(const xrt_relation_chain &xrc, xrt_space_relation &out)
+{
+	out = xrc.steps[0];
+	for (uint32_t i = 1; i < xrc.step_count; i++) {
+		xrt_relation_chain pair = {};
+		m_relation_chain_push_relation(&pair, &out);
+		m_relation_chain_push_relation(&pair, &xrc.steps[i]);
+		m_relation_chain_resolve(&pair, &out);
+	}
+}
+
+static void
+check_vec3(const xrt_vec3 &got, const xrt_vec3 &expected)
+{
+	CHECK(got.x == Catch::Approx(expected.x).margin(1e-4));
+	CHECK(got.y == Catch::Approx(expected.y).margin(1e-4));
+	CHECK(got.z == Catch::Approx(expected.z).margin(1e-4));
+}
+
+static void
+check_quat(const xrt_quat &got, const xrt_quat &expected)
+{
+	CHECK(got.x == Catch::Approx(expected.x).margin(1e-4));
+	CHECK(got.y == Catch::Approx(expected.y).margin(1e-4));
+	CHECK(got.z == Catch::Approx(expected.z).margin(1e-4));
+	CHECK(got.w == Catch::Approx(expected.w).margin(1e-4));
+}
+
+TEST_CASE("Relation Chain Offsets")
+{
+	std::mt19937 rng(42);
+
+	for (uint32_t step_count = 1; step_count <= XRT_RELATION_CHAIN_CAPACITY; step_count++) {
+		CAPTURE(step_count);
+
+		xrt_relation_chain xrc;
+		make_deep_chain(rng, step_count, xrc);
+
+		xrt_space_relation expected;
+		resolve_step_by_step(xrc, expected);
+
+		xrt_space_relation result;
+		m_relation_chain_resolve(&xrc, &result);
+
+		CHECK(result.relation_flags == expected.relation_flags);
+		check_vec3(result.pose.position, expected.pose.position);
+		check_quat(result.pose.orientation, expected.pose.orientation);
+		check_vec3(result.linear_velocity, expected.linear_velocity);
+		check_vec3(result.angular_velocity, expected.angular_velocity);
+
+		xrt_space_relation pose_only;
+		m_relation_chain_resolve_pose(&xrc, &pose_only);
+
+		CHECK(pose_only.relation_flags == kFlagsValidTracked);
+		check_vec3(pose_only.pose.position, expected.pose.position);
+		check_quat(pose_only.pose.orientation, expected.pose.orientation);
+		check_vec3(pose_only.linear_velocity, XRT_VEC3_ZERO);
+		check_vec3(pose_only.angular_velocity, XRT_VEC3_ZERO);
+	}
+
+	SECTION("Pose only keeps the pose flags")
+	{
+		xrt_relation_chain xrc = {};
+		m_relation_chain_push_pose(&xrc, &kPoseOneY);
+		m_relation_chain_push_relation(&xrc, &kSpaceRelationOnlyOrientation);
+
+		xrt_space_relation result;
+		m_relation_chain_resolve_pose(&xrc, &result);
+		CHECK(result.relation_flags == kFlagsValid);
+		check_vec3(result.pose.position, kPoseOneY.position);
+	}
+}
+
+TEST_CASE("Relation Chain Benchmark", "[.][benchmark]")
+{
+	std::mt19937 rng(1);
+
+	for (uint32_t step_count : {2u, 4u, (uint32_t)XRT_RELATION_CHAIN_CAPACITY}) {
+		xrt_relation_chain xrc;
+		make_deep_chain(rng, step_count, xrc);
+		xrt_space_relation out;
+
+		std::string depth = std::to_string(step_count) + " steps";
+
+		BENCHMARK("step by step, " + depth)
+		{
+			resolve_step_by_step(xrc, out);
+			return out.pose.position.x;
+		};
+
+		BENCHMARK("resolve, " + depth)
+		{
+			m_relation_chain_resolve(&xrc, &out);
+			return out.pose.position.x;
+		};
+
+		BENCHMARK("resolve pose, " + depth)
+		{
+			m_relation_chain_resolve_pose(&xrc, &out);
+			return out.pose.position.x;
+		};
+	}
+}
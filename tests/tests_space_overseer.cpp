@@ -0,0 +1,120 @@
+// Copyright 2025, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief u_space_overseer benchmarks.
+ * @author agent <agent@local>
+ */
+
+#include <math/m_api.h>
+#include <util/u_space_cache.h>
+#include <util/u_space_overseer.h>
+#include <xrt/xrt_device.h>
+#include <xrt/xrt_space.h>
+#include <xrt/xrt_tracking.h>
+
+#include "catch_amalgamated.hpp"
+
+
+namespace {
+
+constexpr uint32_t kLayerCount = 16;
+constexpr uint32_t kSpaceCount = 4;
+
+/*!
+ * Same as locate_head_in_space in oxr_session_frame_end.c, layers sharing a
+ * space share the locate of the head in it.
+ */
+void
+locate_cached(struct xrt_space_overseer *xso,
+              struct u_space_cache *cache,
+              struct xrt_space *xs,
+              const struct xrt_pose *offset,
+              int64_t at_timestamp_ns,
+              struct xrt_device *xdev,
+              struct xrt_space_relation *out_relation)
+{
+	bool located = false;
+	if (u_space_cache_find(cache, xs, &located, out_relation)) {
+		return;
+	}
+
+	xrt_space_overseer_locate_device(xso, xs, offset, at_timestamp_ns, xdev, out_relation);
+
+	u_space_cache_add(cache, xs, out_relation->relation_flags != 0, out_relation);
+}
+
+} // namespace
+
+
+TEST_CASE("Layer space locate benchmark", "[.][benchmark]")
+{
+	struct xrt_tracking_origin origin = {};
+	origin.initial_offset = XRT_POSE_IDENTITY;
+
+	struct xrt_device head = {};
+	head.tracking_origin = &origin;
+
+	struct xrt_device *xdevs[1] = {&head};
+	struct xrt_pose local_offset = {{0, 0, 0, 1}, {0, 1.6f, 0}};
+
+	struct u_space_overseer *uso = u_space_overseer_create(nullptr);
+	u_space_overseer_legacy_setup(uso, xdevs, 1, &head, &local_offset, false, false);
+	struct xrt_space_overseer *xso = (struct xrt_space_overseer *)uso;
+
+	// Like the reference spaces of an app, all of the layers are in one of these.
+	struct xrt_space *spaces[kSpaceCount] = {};
+	struct xrt_pose offsets[kSpaceCount] = {};
+	for (uint32_t i = 0; i < kSpaceCount; i++) {
+		struct xrt_pose pose = {{0, 0, 0, 1}, {0.1f * i, 0, -1.0f}};
+		u_space_overseer_create_offset_space(uso, i % 2 == 0 ? xso->semantic.local : xso->semantic.stage, &pose,
+		                                     &spaces[i]);
+		offsets[i] = {{0, 0.1f * i, 0, 1}, {0, 0, 0.5f}};
+		math_quat_normalize(&offsets[i].orientation);
+	}
+
+	// Both give the same relations.
+	struct u_space_cache cache = {};
+	for (uint32_t i = 0; i < kLayerCount; i++) {
+		struct xrt_space_relation per_layer = XRT_SPACE_RELATION_ZERO;
+		struct xrt_space_relation cached = XRT_SPACE_RELATION_ZERO;
+		xrt_space_overseer_locate_device(xso, spaces[i % kSpaceCount], &offsets[i % kSpaceCount], 1000, &head,
+		                                 &per_layer);
+		locate_cached(xso, &cache, spaces[i % kSpaceCount], &offsets[i % kSpaceCount], 1000, &head, &cached);
+		CHECK(per_layer.relation_flags == cached.relation_flags);
+		CHECK(per_layer.pose.position.x == cached.pose.position.x);
+		CHECK(per_layer.pose.position.y == cached.pose.position.y);
+		CHECK(per_layer.pose.position.z == cached.pose.position.z);
+	}
+	CHECK(cache.count == kSpaceCount);
+
+	BENCHMARK("16 layers, locate per layer")
+	{
+		struct xrt_space_relation rel = XRT_SPACE_RELATION_ZERO;
+		float sum = 0;
+		for (uint32_t i = 0; i < kLayerCount; i++) {
+			xrt_space_overseer_locate_device(xso, spaces[i % kSpaceCount], &offsets[i % kSpaceCount], 1000,
+			                                 &head, &rel);
+			sum += rel.pose.position.x;
+		}
+		return sum;
+	};
+
+	BENCHMARK("16 layers, locate per frame cache")
+	{
+		struct u_space_cache frame_cache = {};
+		struct xrt_space_relation rel = XRT_SPACE_RELATION_ZERO;
+		float sum = 0;
+		for (uint32_t i = 0; i < kLayerCount; i++) {
+			locate_cached(xso, &frame_cache, spaces[i % kSpaceCount], &offsets[i % kSpaceCount], 1000,
+			              &head, &rel);
+			sum += rel.pose.position.x;
+		}
+		return sum;
+	};
+
+	for (uint32_t i = 0; i < kSpaceCount; i++) {
+		xrt_space_reference(&spaces[i], nullptr);
+	}
+	xrt_space_overseer_destroy(&xso);
+}
@@ -0,0 +1,298 @@
+// Copyright 2025, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Sparse blob extraction tests.
+ * @author agent <agent@local>
+ */
+
+#include "xrt/xrt_config_have.h"
+
+#include <tracking/t_sparse_blobs.hpp>
+
+#ifdef XRT_HAVE_OPENCV
+#include <tracking/t_calibration_opencv.hpp>
+#endif
+
+#include "catch_amalgamated.hpp"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+
+using xrt::auxiliary::tracking::find_bright_blobs;
+using xrt::auxiliary::tracking::SparseBlob;
+using xrt::auxiliary::tracking::SparseBlobParams;
+
+namespace {
+
+struct Image
+{
+	uint32_t width;
+	uint32_t height;
+	size_t stride;
+	std::vector<uint8_t> pixels;
+
+	Image(uint32_t w, uint32_t h) : width(w), height(h), stride(w + 13), pixels(stride * h, 10) {}
+
+	void
+	disc(float cx, float cy, float r, uint8_t value)
+	{
+		for (uint32_t y = 0; y < height; y++) {
+			for (uint32_t x = 0; x < width; x++) {
+				if ((x - cx) * (x - cx) + (y - cy) * (y - cy) <= r * r) {
+					pixels[y * stride + x] = value;
+				}
+			}
+		}
+	}
+
+	std::vector<SparseBlob>
+	find(const SparseBlobParams &params = {}) const
+	{
+		std::vector<SparseBlob> blobs;
+		find_bright_blobs(pixels.data(), width, height, stride, params, blobs);
+		return blobs;
+	}
+};
+
+} // namespace
+
+
+TEST_CASE("find_bright_blobs")
+{
+	SECTION("discs give their centers")
+	{
+		Image img(97, 61);
+		img.disc(20.0f, 15.0f, 4.0f, 255);
+		img.disc(70.5f, 40.0f, 6.0f, 40);
+		img.disc(50.0f, 50.0f, 3.0f, 32); // Not brighter than the threshold.
+
+		std::vector<SparseBlob> blobs = img.find();
+		REQUIRE(blobs.size() == 2);
+		CHECK(blobs[0].x == Catch::Approx(20.0f));
+		CHECK(blobs[0].y == Catch::Approx(15.0f));
+		CHECK(blobs[1].x == Catch::Approx(70.5f));
+		CHECK(blobs[1].y == Catch::Approx(40.0f));
+	}
+
+	SECTION("diagonal neighbours are one blob")
+	{
+		Image img(16, 16);
+		for (uint32_t i = 0; i < 4; i++) {
+			img.pixels[(4 + i) * img.stride + 4 + i] = 255;
+			img.pixels[(4 + i) * img.stride + 5 + i] = 255;
+		}
+
+		std::vector<SparseBlob> blobs = img.find();
+		REQUIRE(blobs.size() == 1);
+		CHECK(blobs[0].area == 8);
+	}
+
+	SECTION("close blobs are not merged")
+	{
+		// Centers 4 pixels apart, the old blob detector kept them apart too.
+		Image img(32, 32);
+		for (uint32_t y = 10; y < 13; y++) {
+			for (uint32_t x = 10; x < 13; x++) {
+				img.pixels[y * img.stride + x] = 255;
+				img.pixels[y * img.stride + x + 4] = 255;
+			}
+		}
+
+		std::vector<SparseBlob> blobs = img.find();
+		REQUIRE(blobs.size() == 2);
+		CHECK(blobs[0].x == Catch::Approx(11.0f));
+		CHECK(blobs[1].x == Catch::Approx(15.0f));
+	}
+
+	SECTION("single rows and columns are dropped")
+	{
+		Image img(32, 32);
+		for (uint32_t i = 0; i < 10; i++) {
+			img.pixels[3 * img.stride + 5 + i] = 255;
+			img.pixels[(10 + i) * img.stride + 20] = 255;
+		}
+		img.pixels[25 * img.stride + 3] = 255;
+
+		CHECK(img.find().empty());
+	}
+
+	SECTION("convexity filter")
+	{
+		Image img(64, 64);
+		img.disc(15.0f, 15.0f, 6.0f, 255);
+		// An L shape.
+		for (uint32_t y = 30; y < 50; y++) {
+			for (uint32_t x = 30; x < 50; x++) {
+				if (x < 34 || y >= 46) {
+					img.pixels[y * img.stride + x] = 255;
+				}
+			}
+		}
+
+		SparseBlobParams params;
+		params.min_convexity = 0.8f;
+		std::vector<SparseBlob> blobs = img.find(params);
+		REQUIRE(blobs.size() == 1);
+		CHECK(blobs[0].x == Catch::Approx(15.0f));
+		CHECK(blobs[0].convexity > 0.8f);
+	}
+}
+
+#ifdef XRT_HAVE_OPENCV
+
+using xrt::auxiliary::tracking::calibration_undistort_points;
+using xrt::auxiliary::tracking::StereoRectificationMaps;
+
+/*
+ * Renders LEDs at known rectified positions into distorted frames and checks
+ * that the sparse path finds them at least as accurately as remapping the
+ * whole frame and running the blob detector on it, like the trackers did.
+ */
+TEST_CASE("sparse_blobs_rectified_accuracy")
+{
+	constexpr int kWidth = 640;
+	constexpr int kHeight = 480;
+	constexpr int kFrameCount = 20;
+	constexpr int kLedCount = 8;
+	constexpr float kLedRadius = 4.0f;
+
+	struct t_stereo_camera_calibration *data = NULL;
+	t_stereo_camera_calibration_alloc(&data, T_DISTORTION_OPENCV_RADTAN_5);
+	for (auto &view : data->view) {
+		view.image_size_pixels = {kWidth, kHeight};
+		view.intrinsics[0][0] = 520.0;
+		view.intrinsics[1][1] = 515.0;
+		view.intrinsics[0][2] = 322.0;
+		view.intrinsics[1][2] = 238.0;
+		view.intrinsics[2][2] = 1.0;
+		view.rt5 = {-0.12, 0.02, 0.0008, -0.0005, 0.0};
+	}
+	data->camera_translation[0] = -0.06;
+	data->camera_rotation[0][0] = 1.0;
+	data->camera_rotation[1][1] = 1.0;
+	data->camera_rotation[2][2] = 1.0;
+
+	StereoRectificationMaps rectify(data);
+	auto &calib = data->view[0];
+	auto &rect = rectify.view[0];
+
+	// Where every raw pixel lands in the rectified image, for rendering.
+	std::vector<cv::Point2f> raw_to_rect;
+	for (int y = 0; y < kHeight; y++) {
+		for (int x = 0; x < kWidth; x++) {
+			raw_to_rect.emplace_back((float)x, (float)y);
+		}
+	}
+	calibration_undistort_points(calib, rect.rotation_mat, rect.projection_mat, raw_to_rect);
+
+	cv::SimpleBlobDetector::Params blob_params;
+	blob_params.filterByArea = false;
+	blob_params.filterByConvexity = false;
+	blob_params.filterByInertia = false;
+	blob_params.filterByColor = true;
+	blob_params.blobColor = 255;
+	blob_params.minThreshold = 50;
+	blob_params.maxThreshold = 51;
+	blob_params.thresholdStep = 1;
+	blob_params.minDistBetweenBlobs = 5;
+	blob_params.minRepeatability = 1;
+	cv::Ptr<cv::SimpleBlobDetector> sbd = cv::SimpleBlobDetector::create(blob_params);
+
+	std::mt19937 rng(42);
+	std::uniform_real_distribution<float> dist_x(100.0f, kWidth - 100.0f);
+	std::uniform_real_distribution<float> dist_y(100.0f, kHeight - 100.0f);
+
+	double sparse_error_sum = 0;
+	double legacy_error_sum = 0;
+	float sparse_error_max = 0;
+	int sparse_found = 0;
+	int legacy_found = 0;
+
+	for (int f = 0; f < kFrameCount; f++) {
+		std::vector<cv::Point2f> leds;
+		while (leds.size() < kLedCount) {
+			cv::Point2f p{dist_x(rng), dist_y(rng)};
+			bool apart = true;
+			for (const cv::Point2f &o : leds) {
+				apart = apart && cv::norm(p - o) > 6 * kLedRadius;
+			}
+			if (apart) {
+				leds.push_back(p);
+			}
+		}
+
+		cv::Mat grey(kHeight, kWidth, CV_8UC1, cv::Scalar(12));
+		for (int y = 0; y < kHeight; y++) {
+			for (int x = 0; x < kWidth; x++) {
+				const cv::Point2f &r = raw_to_rect[y * kWidth + x];
+				for (const cv::Point2f &led : leds) {
+					if (cv::norm(r - led) <= kLedRadius) {
+						grey.at<uint8_t>(y, x) = 230;
+					}
+				}
+			}
+		}
+
+		// Sparse path.
+		SparseBlobParams params;
+		std::vector<SparseBlob> blobs;
+		find_bright_blobs(grey.data, grey.cols, grey.rows, grey.step, params, blobs);
+		std::vector<cv::Point2f> sparse;
+		for (const SparseBlob &b : blobs) {
+			sparse.emplace_back(b.x, b.y);
+		}
+		calibration_undistort_points(calib, rect.rotation_mat, rect.projection_mat, sparse);
+
+		// Full frame path.
+		cv::Mat rectified;
+		cv::remap(grey, rectified, rect.rectify.remap_x, rect.rectify.remap_y, cv::INTER_NEAREST,
+		          cv::BORDER_CONSTANT, cv::Scalar(0, 0, 0));
+		cv::threshold(rectified, rectified, 32.0, 255.0, 0);
+		std::vector<cv::KeyPoint> keypoints;
+		sbd->detect(rectified, keypoints, cv::noArray());
+
+		for (const cv::Point2f &led : leds) {
+			float best = INFINITY;
+			for (const cv::Point2f &p : sparse) {
+				best = std::min(best, (float)cv::norm(p - led));
+			}
+			if (best < kLedRadius) {
+				sparse_error_sum += best;
+				sparse_error_max = std::max(sparse_error_max, best);
+				sparse_found++;
+			}
+
+			best = INFINITY;
+			for (const cv::KeyPoint &kp : keypoints) {
+				best = std::min(best, (float)cv::norm(kp.pt - led));
+			}
+			if (best < kLedRadius) {
+				legacy_error_sum += best;
+				legacy_found++;
+			}
+		}
+
+		CHECK(sparse.size() == leds.size());
+	}
+
+	t_stereo_camera_calibration_reference(&data, NULL);
+
+	// With a single threshold level minDistBetweenBlobs merges nothing, like the sparse path.
+	cv::Mat close(32, 32, CV_8UC1, cv::Scalar(0));
+	close(cv::Rect(10, 10, 3, 3)) = cv::Scalar(255);
+	close(cv::Rect(14, 10, 3, 3)) = cv::Scalar(255);
+	std::vector<cv::KeyPoint> close_keypoints;
+	sbd->detect(close, close_keypoints, cv::noArray());
+	CHECK(close_keypoints.size() == 2);
+
+	CHECK(sparse_found == kFrameCount * kLedCount);
+	CHECK(sparse_found >= legacy_found);
+	CHECK(sparse_error_max < 0.5f);
+	// Allow a little slack, both are well below a pixel.
+	CHECK(sparse_error_sum / sparse_found <= legacy_error_sum / legacy_found + 0.05);
+}
+
+#endif